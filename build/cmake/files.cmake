@@ -10,6 +10,7 @@ set(BASE_UNIX_AND_DARWIN_SRC
     src/unix/epolldispatcher.cpp
     src/unix/evtloopunix.cpp
     src/unix/fdiounix.cpp
+    src/unix/iouringdispatcher.cpp
     src/unix/snglinst.cpp
     src/unix/stackwalk.cpp
     src/unix/timerunx.cpp
@@ -452,6 +453,7 @@ set(BASE_CMN_SRC
     src/common/tarstrm.cpp
     src/common/textbuf.cpp
     src/common/textfile.cpp
+    src/common/threadpool.cpp
     src/common/time.cpp
     src/common/timercmn.cpp
     src/common/timerimpl.cpp
@@ -602,6 +604,7 @@ set(BASE_CMN_HDR
     wx/textbuf.h
     wx/textfile.h
     wx/thread.h
+    wx/threadpool.h
     wx/thrimpl.cpp
     wx/time.h
     wx/timer.h
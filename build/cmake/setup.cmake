@@ -576,6 +576,9 @@ else()
         set(wxUSE_SELECT_DISPATCHER ON)
     endif()
     check_include_file(sys/epoll.h wxUSE_EPOLL_DISPATCHER)
+    if(wxUSE_EPOLL_DISPATCHER)
+        check_include_file(linux/io_uring.h wxHAS_IO_URING)
+    endif()
 endif()
 check_include_file(sys/select.h HAVE_SYS_SELECT_H)
 
@@ -375,7 +375,8 @@ public:
     // the handlers with pending events
     void RemovePendingEventHandler(wxEvtHandler* toRemove);
 
-    // adds an event handler to the list of the handlers with pending events
+    // adds an event handler to the list of the handlers with pending events,
+    // this doesn't use any locks and can be called from any thread
     void AppendPendingEventHandler(wxEvtHandler* toAppend);
 
     // moves the event handler from the list of the handlers with pending events
@@ -544,11 +545,21 @@ protected:
     // pending events)
     wxEvtHandlerArray m_handlersWithPendingDelayedEvents;
 
+    // the handlers added by AppendPendingEventHandler() since the last time
+    // they were moved to m_handlersWithPendingEvents, in the reverse order and
+    // linked by wxEvtHandler::m_nextHandlerWithPendingEvents: this list is
+    // updated atomically and so doesn't need any locking
+    std::atomic<wxEvtHandler*> m_handlersWithIncomingEvents{nullptr};
+
 #if wxUSE_THREADS
-    // this critical section protects both the lists above
+    // this critical section protects both the arrays above
     wxCriticalSection m_handlersWithPendingEventsLocker;
 #endif
 
+    // move the handlers from m_handlersWithIncomingEvents to the end of
+    // m_handlersWithPendingEvents, must be called with the lock held
+    void TakeHandlersWithIncomingEvents();
+
     // flag modified by Suspend/ResumeProcessingOfPendingEvents()
     bool m_bDoPendingEventProcessing = true;
 
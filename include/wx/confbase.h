@@ -64,7 +64,8 @@ enum
     wxCONFIG_USE_NO_ESCAPE_CHARACTERS = 8,
     wxCONFIG_USE_SUBDIR = 16,
     wxCONFIG_USE_XDG = 32,
-    wxCONFIG_USE_HOME = 64
+    wxCONFIG_USE_HOME = 64,
+    wxCONFIG_USE_JOURNAL = 128
 };
 
 // ----------------------------------------------------------------------------
@@ -126,6 +126,10 @@ public:
 
     virtual void Resort() = 0;
 
+    // called before and after a batch of changes, see wxDataViewModel
+    virtual void BeginBatch() { }
+    virtual void EndBatch() { }
+
     void SetOwner( wxDataViewModel *owner ) { m_owner = owner; }
     wxDataViewModel *GetOwner() const       { return m_owner; }
 
@@ -260,6 +264,11 @@ public:
     bool BeforeReset();
     bool AfterReset();
 
+    // group several notifications together, the batches may be nested
+    void BeginBatch();
+    void EndBatch();
+    bool IsBatching() const { return m_batchCount > 0; }
+
 
     // delegated action
     virtual void Resort();
@@ -304,6 +313,9 @@ protected:
 
 private:
     wxDataViewModelNotifiers  m_notifiers;
+
+    // nesting level of BeginBatch() calls
+    int m_batchCount;
 };
 
 // ----------------------------------------------------------------------------
@@ -36,6 +36,8 @@
 #include "wx/meta/convertible.h"
 #include "wx/meta/removeref.h"
 
+#include <atomic>
+
 // This is now always defined, but keep it for backwards compatibility.
 #define wxHAS_CALL_AFTER
 
@@ -1003,6 +1005,11 @@ public:
     void Skip(bool skip = true) { m_skipped = skip; }
     bool GetSkipped() const { return m_skipped; }
 
+    // Allow QueueEvent() to replace a still pending event with the same type,
+    // id and event object with this one instead of queuing it.
+    void SetCoalescable(bool coalescable = true) { m_isCoalescable = coalescable; }
+    bool IsCoalescable() const { return m_isCoalescable; }
+
     // This function is used to create a copy of the event polymorphically and
     // all derived classes must implement it because otherwise wxPostEvent()
     // for them wouldn't work (it needs to do a copy of the event)
@@ -1129,6 +1136,9 @@ protected:
     // this one.
     bool m_willBeProcessedAgain;
 
+    // Set by SetCoalescable().
+    bool m_isCoalescable;
+
 protected:
     wxEvent(const wxEvent&);            // for implementing Clone()
     wxEvent& operator=(const wxEvent&); // for derived classes operator=()
@@ -4105,18 +4115,47 @@ protected:
 
     struct DynamicEvents
     {
+        DynamicEvents() = default;
+        ~DynamicEvents();
+
         wxVector<wxDynamicEventTableEntry*> m_entries;
         wxRecursionGuardFlag m_flag = 0;
+
+        // number of the null, i.e. unbound but not removed yet, m_entries
+        size_t m_numUnbound = 0;
+
+        // remove the null entries if there are enough of them, must not be
+        // called while iterating over m_entries
+        void PruneUnbound();
+
+        // index of m_entries by event type and id, only created when there
+        // are many entries and destroyed when the unbound ones are pruned
+        struct Index;
+        Index* m_index = nullptr;
+
+        wxDECLARE_NO_COPY_CLASS(DynamicEvents);
     };
     // use wxSharedPtr so that SearchDynamicEventTable() can use another
     // instance of wxSharedPtr to extend the life of the wxRecursionGuardFlag
     // to outlive wxRecursionGuard
     wxSharedPtr<DynamicEvents> m_dynamicEvents;
 
-    wxList*             m_pendingEvents;
+    // The events queued for this handler are first pushed, in the reverse
+    // order and without any locking, to m_incomingEvents by QueueEvent() and
+    // then moved in batches to the m_pendingEvents list, in the correct order,
+    // by ProcessPendingEvents().
+    struct PendingEventNode;
+    std::atomic<PendingEventNode*> m_incomingEvents;
+    PendingEventNode*   m_pendingEvents;
+    PendingEventNode*   m_pendingEventsLast;
+
+    // The pending coalescable events, allocated when first needed.
+    struct CoalescableEvents;
+    CoalescableEvents*  m_coalescableEvents;
 
 #if wxUSE_THREADS
-    // critical section protecting m_pendingEvents
+    // critical section protecting m_pendingEvents, it is not used by
+    // QueueEvent() and so only serializes the consumers of the events
     wxCriticalSection m_pendingEventsLock;
 #endif // wxUSE_THREADS
 
@@ -4155,9 +4194,30 @@ private:
     // try to process events in all handlers chained to this one
     bool DoTryChain(wxEvent& event);
 
+    // move the events from m_incomingEvents to m_pendingEvents, return false
+    // if there were none, can't be called concurrently with itself
+    bool TakeIncomingEvents();
+
+    // append the node to m_pendingEvents and return true or return false if
+    // its event was coalesced with an already pending one and node was deleted
+    bool AppendPendingEvent(PendingEventNode* node);
+
+    // remove this handler from the list of handlers with pending events after
+    // processing all of them, must be called with m_pendingEventsLock held
+    void LeavePendingEventHandlers();
+
     // Head of the event filter linked list.
     static wxEventFilter* ms_filterList;
 
+    // Used by wxAppConsoleBase to maintain the list of handlers with pending
+    // events: the flag is set while this handler is in this list, which
+    // allows adding it only once without searching for it, and the pointer
+    // links the handlers added to it by QueueEvent() without locking.
+    std::atomic<bool>   m_hasPendingEvents;
+    wxEvtHandler*       m_nextHandlerWithPendingEvents;
+
+    friend class wxAppConsoleBase;
+
     wxDECLARE_DYNAMIC_CLASS_NO_COPY(wxEvtHandler);
 };
 
@@ -250,6 +250,25 @@ private:
   void ResetDirty() { m_isDirty = false; }
   bool IsDirty() const { return m_isDirty; }
 
+  // Flush() implementation, always rewrites the local file if compact is true
+  // and there are any changes saved only in the journal
+  bool DoFlush(bool compact);
+
+  // create the directory containing the local file if necessary
+  bool CreateLocalFileDir();
+
+  // journal support used with wxCONFIG_USE_JOURNAL: the changes are appended
+  // to the journal file on flush and the local file is only rewritten when
+  // the journal is compacted
+  bool IsJournaling() const
+    { return (GetStyle() & wxCONFIG_USE_JOURNAL) && !m_isReplayingJournal; }
+  wxFileName GetJournalFile() const;
+  wxString GetLocalFileSignature() const;
+  void AddJournalRecord(const wxString& record);
+  bool AppendToJournal();
+  void ReplayJournal();
+  void RemoveJournal();
+
 
   // member variables
   // ----------------
@@ -272,6 +291,12 @@ private:
   bool m_isDirty;                       // if true, we have unsaved changes
   bool m_autosave;                      // if true, save changes on destruction
 
+  wxString m_journalPending;            // records not written to journal yet
+  wxFileOffset m_journalSize = 0;       // size of the journal we can append to
+  wxFileOffset m_localFileSize = 0;     // size of the local file when read
+  bool m_mustCompactJournal = false;    // can't append to the existing journal
+  bool m_isReplayingJournal = false;    // don't record the changes if true
+
   wxDECLARE_NO_COPY_CLASS(wxFileConfig);
   wxDECLARE_ABSTRACT_CLASS(wxFileConfig);
 };
@@ -87,6 +87,21 @@ enum wxGridRenderStyle
                           wxGRID_DRAW_BOX_RECT
 };
 
+// Flags used with wxGrid::SetAutoSizeMode() to select how the cells are
+// measured when auto-sizing columns or rows.
+enum wxGridAutoSizeMode
+{
+    // Measure all cells, this is the default.
+    wxGRID_AUTOSIZE_ALL = 0x000,
+
+    // Measure only a sample of the cells, see wxGridAutoSizeSample.
+    wxGRID_AUTOSIZE_SAMPLE = 0x001,
+
+    // Measure the text of the cells using the standard string renderer in
+    // the worker threads.
+    wxGRID_AUTOSIZE_PARALLEL = 0x002
+};
+
 // ----------------------------------------------------------------------------
 // forward declarations
 // ----------------------------------------------------------------------------
@@ -96,7 +111,9 @@ class WXDLLIMPEXP_FWD_CORE wxGridCellAttr;
 class WXDLLIMPEXP_FWD_CORE wxGridCellAttrProviderData;
 class WXDLLIMPEXP_FWD_CORE wxGridColLabelWindow;
 class WXDLLIMPEXP_FWD_CORE wxGridCornerLabelWindow;
+class WXDLLIMPEXP_FWD_CORE wxGridDamage;
 class WXDLLIMPEXP_FWD_CORE wxGridEvent;
+class WXDLLIMPEXP_FWD_CORE wxGridLineOffsets;
 class WXDLLIMPEXP_FWD_CORE wxGridRowLabelWindow;
 class WXDLLIMPEXP_FWD_CORE wxGridWindow;
 class WXDLLIMPEXP_FWD_CORE wxGridSubwindow;
@@ -824,6 +841,9 @@ public:
     wxNODISCARD wxGridCellAttr *Clone() const;
     void MergeWith(wxGridCellAttr *mergefrom);
 
+    // returns true if this attribute has the same values as the other one
+    bool IsSameAs(const wxGridCellAttr& other) const;
+
     // setters
     void SetTextColour(const wxColour& colText) { m_colText = colText; }
     void SetBackgroundColour(const wxColour& colBack) { m_colBack = colBack; }
@@ -1542,6 +1562,37 @@ struct WXDLLIMPEXP_CORE wxGridSizesInfo
     wxUnsignedToIntHashMap m_customSizes;
 };
 
+// ----------------------------------------------------------------------------
+// wxGridAutoSizeSample describes the cells measured in wxGRID_AUTOSIZE_SAMPLE
+// mode.
+// ----------------------------------------------------------------------------
+
+struct wxGridAutoSizeSample
+{
+    wxGridAutoSizeSample(int head = 100,
+                         int tail = 100,
+                         int random = 1000,
+                         bool visible = true)
+        : m_head(head),
+          m_tail(tail),
+          m_random(random),
+          m_visible(visible)
+    {
+    }
+
+    // number of the first and last rows (or columns) to measure
+    int m_head,
+        m_tail;
+
+    // number of rows (or columns) between the first and the last ones to
+    // measure, they are chosen randomly with approximately equal distance
+    // between them
+    int m_random;
+
+    // if true, also measure all currently visible rows (or columns)
+    bool m_visible;
+};
+
 // ----------------------------------------------------------------------------
 // wxGrid
 // ----------------------------------------------------------------------------
@@ -1790,6 +1841,19 @@ public:
     //
     void     ForceRefresh();
 
+    // Collect the cells changed by SetCellValue() and refresh all of them
+    // at once, instead of refreshing each of them immediately.
+    void EnableDeferredRefresh(bool enable = true);
+    bool IsDeferredRefreshEnabled() const { return m_damage != nullptr; }
+
+    // Refresh the cells collected since the last call to this function now.
+    void FlushDeferredRefresh();
+
+    // Keep the contents of the grid in a bitmap and only redraw the changed
+    // parts of it when repainting.
+    void UseBackBuffer(bool use = true);
+    bool IsUsingBackBuffer() const { return m_useBackBuffer; }
+
 
     // ------ edit control functions
     //
@@ -2253,6 +2317,17 @@ public:
     void     AutoSizeColumns( bool setAsMin = true );
     void     AutoSizeRows( bool setAsMin = true );
 
+    // choose how the cells are measured by the functions above, mode is a
+    // combination of wxGridAutoSizeMode flags
+    void SetAutoSizeMode(int mode) { m_autoSizeMode = mode; }
+    int GetAutoSizeMode() const { return m_autoSizeMode; }
+
+    // choose the cells measured in wxGRID_AUTOSIZE_SAMPLE mode
+    void SetAutoSizeSample(const wxGridAutoSizeSample& sample)
+        { m_autoSizeSample = sample; }
+    const wxGridAutoSizeSample& GetAutoSizeSample() const
+        { return m_autoSizeSample; }
+
     // auto size the grid, that is make the columns/rows of the "right" size
     // and also set the grid size to just fit its contents
     void     AutoSize();
@@ -2594,21 +2669,27 @@ protected:
     // NB: *never* access m_row/col arrays directly because they are created
     //     on demand, *always* use accessor functions instead!
 
-    // init the m_rowHeights/Bottoms arrays with default values
+    // init the m_rowHeights array and m_rowOffsets with default values
     void InitRowHeights();
 
+    // update m_rowOffsets after changing the heights or order of the rows
+    void UpdateRowOffsets();
+
     int        m_defaultRowHeight;
     int        m_minAcceptableRowHeight;
     wxArrayInt m_rowHeights;
-    wxArrayInt m_rowBottoms;
+    wxGridLineOffsets *m_rowOffsets;
 
-    // init the m_colWidths/Rights arrays
+    // init the m_colWidths array and m_colOffsets
     void InitColWidths();
 
+    // update m_colOffsets after changing the widths or order of the columns
+    void UpdateColOffsets();
+
     int        m_defaultColWidth;
     int        m_minAcceptableColWidth;
     wxArrayInt m_colWidths;
-    wxArrayInt m_colRights;
+    wxGridLineOffsets *m_colOffsets;
 
     int m_sortCol;
     bool m_sortIsAscending;
@@ -2667,6 +2748,13 @@ protected:
     // common part of AutoSizeColumn/Row()
     void AutoSizeColOrRow(int n, bool setAsMin, wxGridDirection direction);
 
+    // get the indices of the lines to measure in AutoSizeColOrRow() in
+    // wxGRID_AUTOSIZE_SAMPLE mode
+    wxVector<int> GetAutoSizeSampleLines(wxGridDirection direction) const;
+
+    int m_autoSizeMode;
+    wxGridAutoSizeSample m_autoSizeSample;
+
     // Calculate the minimum acceptable size for labels area
     wxCoord CalcColOrRowLabelAreaMinSize(wxGridDirection direction);
 
@@ -2721,6 +2809,14 @@ protected:
 
     int  m_batchCount;
 
+    // The cells to refresh, only non-null if deferred refresh is enabled.
+    wxGridDamage *m_damage;
+
+    // Set while a call to FlushDeferredRefresh() is pending.
+    bool m_deferredRefreshPending;
+
+    bool m_useBackBuffer;
+
 
     wxGridTypeRegistry*    m_typeRegistry;
 
@@ -13,6 +13,7 @@
 #include "wx/containr.h"
 #include "wx/scrolwin.h"
 #include "wx/textctrl.h"
+#include "wx/vector.h"
 
 #if wxUSE_DRAG_AND_DROP
 class WXDLLIMPEXP_FWD_CORE wxDropTarget;
@@ -25,6 +26,15 @@ class WXDLLIMPEXP_FWD_CORE wxDropTarget;
 class WXDLLIMPEXP_FWD_CORE wxListHeaderWindow;
 class WXDLLIMPEXP_FWD_CORE wxListMainWindow;
 
+// flags for wxGenericListCtrl::SortItemsByColumn()
+enum
+{
+    wxLIST_SORT_TEXT       = 0,     // compare items text
+    wxLIST_SORT_NOCASE     = 1,     // ignore case when comparing text
+    wxLIST_SORT_NUMERIC    = 2,     // compare items as numbers
+    wxLIST_SORT_DESCENDING = 4      // sort in descending order
+};
+
 //-----------------------------------------------------------------------------
 // wxListCtrl
 //-----------------------------------------------------------------------------
@@ -155,6 +165,13 @@ public:
     bool ScrollList( int dx, int dy );
     bool SortItems( wxListCtrlCompare fn, wxIntPtr data );
 
+    // sort the items by the contents of the given column and keep them sorted
+    // when new items are inserted, until called with wxNOT_FOUND
+    bool SortItemsByColumn( int col, int flags = wxLIST_SORT_TEXT );
+
+    // add many items at once, each row contains the texts of the columns
+    void AppendItems( const wxVector<wxArrayString>& rows );
+
     // do we have a header window?
     bool HasHeader() const
         { return InReportView() && !HasFlag(wxLC_NO_HEADER); }
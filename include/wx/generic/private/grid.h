@@ -18,7 +18,9 @@
 #include "wx/headerctrl.h"
 
 #ifndef WX_PRECOMP
+    #include "wx/bitmap.h"
     #include "wx/dc.h"
+    #include "wx/region.h"
 #endif // WX_PRECOMP
 
 // for wxGridOperations
@@ -423,13 +425,38 @@ public:
 
     virtual void ScrollWindow( int dx, int dy, const wxRect *rect ) override;
 
+    virtual void Refresh(bool eraseBackground = true,
+                         const wxRect *rect = nullptr) override;
+
     virtual bool AcceptsFocus() const override { return true; }
 
     wxGridWindowType GetType() const { return m_type; }
 
+    // Mark the given rectangle, in window coordinates, or the entire window if
+    // it is null, as needing to be redrawn in the back buffer. Does nothing if
+    // the back buffer is not used.
+    void InvalidateBackBuffer(const wxRect *rect = nullptr);
+
+    // Free the back buffer when it is not used any more.
+    void FreeBackBuffer();
+
 private:
     const wxGridWindowType m_type;
 
+    // Draw the grid contents in the given region on the DC which must have
+    // been already prepared with wxGrid::PrepareDCFor().
+    void DrawContents( wxDC& dc, const wxRegion& reg );
+
+    // Paint the window using the back buffer, redrawing only its dirty part.
+    void PaintUsingBackBuffer( wxDC& dc );
+
+    // The back buffer used if wxGrid::IsUsingBackBuffer() returns true, the
+    // part of it which needs to be redrawn and the device origin used when
+    // drawing it, as its contents can't be reused after scrolling.
+    wxBitmap m_backBuffer;
+    wxRegion m_backBufferDirty;
+    wxPoint m_backBufferOrigin;
+
     void OnPaint( wxPaintEvent &event );
     void OnMouseWheel( wxMouseEvent& event );
     void OnMouseEvent( wxMouseEvent& event );
@@ -442,14 +469,76 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxGridWindow);
 };
 
+// ----------------------------------------------------------------------------
+// wxGridDamage: the cells which need to be refreshed
+// ----------------------------------------------------------------------------
+
+// This class is used by wxGrid when deferred refresh is enabled to collect the
+// cells changed during the current event loop iteration and refresh all of
+// them at once later.
+//
+// The cells are stored using their indices, which makes adding them cheap, and
+// are only converted to positions and merged into rectangular blocks when the
+// damage is flushed.
+class WXDLLIMPEXP_ADV wxGridDamage
+{
+public:
+    wxGridDamage() = default;
+
+    // Add a single cell. The same cell may be added any number of times.
+    void AddCell(int row, int col);
+
+    // Add the entire row, e.g. because the text of its cell may overflow.
+    void AddRow(int row) { AddCell(row, -1); }
+
+    bool IsEmpty() const { return m_cells.empty(); }
+
+    void Clear();
+
+    // Return the blocks covering all the cells added since the last call to
+    // this function and clear the damage.
+    //
+    // The returned blocks use positions and not indices of rows and columns
+    // and are sorted by their top row position. The blocks are computed by
+    // merging the adjacent cells of the same row first and then merging the
+    // same column ranges of the adjacent rows. Cells outside of the grid,
+    // e.g. because the rows or columns were deleted after adding them, are
+    // ignored.
+    wxVector<wxGridBlockCoords> TakeBlocks(const wxGrid& grid);
+
+private:
+    // Sort the cells and remove the duplicates.
+    void Compact();
+
+    wxVector<wxGridCellCoords> m_cells;
+
+    // The number of cells at which Compact() is called from AddCell().
+    size_t m_compactAt = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridDamage);
+};
+
 // ----------------------------------------------------------------------------
 // the internal data representation used by wxGridCellAttrProvider
 // ----------------------------------------------------------------------------
 
 // this class stores attributes set for cells
+//
+// The attributes are stored by columns, with each column containing the runs
+// of consecutive rows using the same attribute object, indexed by their first
+// row. Each attribute is referenced only once per run and not once per cell,
+// so setting the same attribute for many adjacent cells of the same column
+// uses very little memory, and inserting or deleting rows only needs to shift
+// the runs.
+//
+// Adjacent cells with different attribute objects are merged into a single
+// run too if their attributes are equal and not referenced from anywhere
+// else. Such merged runs are split again when the attribute of one of their
+// cells is requested for modification by GetOwnAttr().
 class WXDLLIMPEXP_ADV wxGridCellAttrData
 {
 public:
+    wxGridCellAttrData() = default;
     ~wxGridCellAttrData();
 
     void SetAttr(wxGridCellAttr *attr, int row, int col);
@@ -457,11 +546,53 @@ public:
     void UpdateAttrRows( size_t pos, int numRows );
     void UpdateAttrCols( size_t pos, int numCols );
 
+    // Return the attribute of the given cell which can be modified without
+    // affecting any other cells, unless the same attribute object was
+    // explicitly set for them, or nullptr if the cell has no attribute.
+    wxGridCellAttr *GetOwnAttr(int row, int col);
+
+    // Return the number of runs, only used for testing.
+    size_t GetRunsCount() const;
+
 private:
-    // Tries to search for the attr for given cell.
-    wxGridCoordsToAttrMap::iterator FindIndex(int row, int col) const;
+    struct Run
+    {
+        int last;
+        wxGridCellAttr *attr;
+
+        // True if this run contains cells which had different, but equal,
+        // attributes.
+        bool merged;
+    };
+
+    using Runs = std::map<int, Run>;
+
+    // Return the run containing the given row or, if there is none, the first
+    // run after it, which may be the end iterator.
+    static Runs::iterator FindRun(Runs& runs, int row);
+    static Runs::const_iterator FindRun(const Runs& runs, int row);
+
+    // Merge the given run with the next one if they are adjacent and either
+    // use the same attribute or equal attributes which can be shared.
+    static void MergeWithNext(Runs& runs, Runs::iterator it);
+
+    // Return the attribute to use for the new run created by splitting the
+    // given one, the caller takes ownership of it.
+    static wxGridCellAttr* GetAttrForSplit(const Run& run);
+
+    // Remove the given row from the runs.
+    static void EraseRow(Runs& runs, int row);
+
+    // Move the attributes of the multicells into the given map, as they may
+    // need to be adjusted when inserting or deleting rows or columns, and put
+    // them back after doing it.
+    void ExtractSpanAttrs(wxGridCoordsToAttrMap& attrs);
+    void RestoreSpanAttrs(const wxGridCoordsToAttrMap& attrs);
+
+    // The runs for all columns up to the last one having any attributes.
+    wxVector<Runs> m_cols;
 
-    mutable wxGridCoordsToAttrMap m_attrs;
+    wxDECLARE_NO_COPY_CLASS(wxGridCellAttrData);
 };
 
 // this class stores attributes set for rows or columns
@@ -491,6 +622,107 @@ public:
                            m_colAttrs;
 };
 
+// ----------------------------------------------------------------------------
+// wxGridLineOffsets: positions of the grid rows or columns in pixels
+// ----------------------------------------------------------------------------
+
+// This class stores the sizes of the rows or columns in the order of their
+// positions, which is different from the order of their indices if they were
+// reordered, with the hidden lines having zero size.
+//
+// It uses a Fenwick tree to allow changing the size of a line, getting the
+// offset of a line and finding the line containing the given offset in
+// logarithmic time. Inserting or deleting lines is not logarithmic: the part
+// of the tree after the first affected line has to be rebuilt, which takes
+// time proportional to the number of the lines after it, just as shifting
+// their sizes does. Appending or removing the last lines is cheap.
+class WXDLLIMPEXP_ADV wxGridLineOffsets
+{
+public:
+    wxGridLineOffsets() = default;
+
+    // The object is empty when all lines use the default size, as the lines
+    // offsets are trivial to compute in this case.
+    bool IsEmpty() const { return m_sizes.empty(); }
+
+    void Clear();
+
+    // Set the sizes of all lines in the order of their positions.
+    void Assign(wxVector<int>&& sizes);
+
+    int GetCount() const { return static_cast<int>(m_sizes.size()); }
+
+    int GetSize(int pos) const { return m_sizes[pos]; }
+    void SetSize(int pos, int size);
+
+    // Return the offset of the start or end of the line at the given position.
+    int GetStart(int pos) const;
+    int GetEnd(int pos) const { return GetStart(pos) + m_sizes[pos]; }
+
+    // Return the position of the first line ending after the given offset or
+    // wxNOT_FOUND if the offset is after the end of the last line.
+    int FindPos(int offset) const;
+
+    // Insert the lines of the given size before the given position or remove
+    // the lines starting at it.
+    void Insert(int pos, int count, int size);
+    void Remove(int pos, int count);
+
+private:
+    // Rebuild m_tree from m_sizes after changing the sizes of the lines
+    // starting from the given position, or inserting or deleting them there.
+    void Rebuild(int from);
+
+    // Line sizes by position.
+    wxVector<int> m_sizes;
+
+    // Fenwick tree of the line sizes, using 1-based indices: m_tree[n] stores
+    // the sum of the sizes of the lines in (n - (n & -n), n] range.
+    wxVector<int> m_tree;
+
+    // The greatest power of 2 not greater than the number of lines.
+    int m_topBit = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridLineOffsets);
+};
+
+// ----------------------------------------------------------------------------
+// wxGridTextMeasurer: measures text without using wxDC
+// ----------------------------------------------------------------------------
+
+// This class measures the widths of the characters of the given font once,
+// in the main thread, and after this can be used to compute the extents of
+// strings in any thread. It is used by wxGRID_AUTOSIZE_PARALLEL mode.
+//
+// Notice that the extents computed by it don't take kerning into account and
+// so can be slightly different from those returned by wxDC.
+class WXDLLIMPEXP_ADV wxGridTextMeasurer
+{
+public:
+    wxGridTextMeasurer(wxReadOnlyDC& dc, const wxFont& font);
+
+    const wxFont& GetFont() const { return m_font; }
+
+    // Return the width (for wxGRID_COLUMN) or the height (for wxGRID_ROW) of
+    // the given, possibly multiline, text or -1 if it contains characters
+    // other than the printable Latin-1 ones and new lines, which can't be
+    // measured by this class.
+    //
+    // This function can be called from any thread.
+    int GetExtent(const wxString& text, wxGridDirection direction) const;
+
+private:
+    // Only used in the main thread to find the measurer for the given font.
+    const wxFont m_font;
+
+    // Widths of the characters in 0..255 range or -1 for the unsupported ones.
+    int m_widths[256];
+
+    int m_lineHeight;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridTextMeasurer);
+};
+
 // ----------------------------------------------------------------------------
 // operations classes abstracting the difference between operating on rows and
 // columns
@@ -587,8 +819,8 @@ public:
     // Get the height/width of the given row/column
     virtual int GetLineSize(const wxGrid *grid, int line) const = 0;
 
-    // Get wxGrid::m_rowBottoms/m_colRights array
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const = 0;
+    // Get wxGrid::m_rowOffsets/m_colOffsets object
+    virtual const wxGridLineOffsets& GetLineOffsets(const wxGrid *grid) const = 0;
 
     // Get default height row height or column width
     virtual int GetDefaultLineSize(const wxGrid *grid) const = 0;
@@ -747,8 +979,8 @@ public:
         { return grid->GetRowBottom(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const override
         { return grid->GetRowHeight(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const override
-        { return grid->m_rowBottoms; }
+    virtual const wxGridLineOffsets& GetLineOffsets(const wxGrid *grid) const override
+        { return *grid->m_rowOffsets; }
     virtual int GetDefaultLineSize(const wxGrid *grid) const override
         { return grid->GetDefaultRowSize(); }
     virtual int GetMinimalAcceptableLineSize(const wxGrid *grid) const override
@@ -903,8 +1135,8 @@ public:
         { return grid->GetColRight(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const override
         { return grid->GetColWidth(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const override
-        { return grid->m_colRights; }
+    virtual const wxGridLineOffsets& GetLineOffsets(const wxGrid *grid) const override
+        { return *grid->m_colOffsets; }
     virtual int GetDefaultLineSize(const wxGrid *grid) const override
         { return grid->GetDefaultColSize(); }
     virtual int GetMinimalAcceptableLineSize(const wxGrid *grid) const override
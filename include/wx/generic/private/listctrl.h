@@ -697,9 +697,11 @@ public:
     long FindItem( const wxPoint& pt );
     long HitTest( int x, int y, int &flags ) const;
     void InsertItem( wxListItem &item );
+    void AppendItems( const wxVector<wxArrayString>& rows );
     long InsertColumn( long col, const wxListItem &item );
     int GetItemWidthWithImage(wxListItem * item);
     void SortItems( wxListCtrlCompare fn, wxIntPtr data );
+    void SortItemsByColumn( int col, int flags );
 
     size_t GetItemCount() const;
     bool IsEmpty() const { return GetItemCount() == 0; }
@@ -827,6 +829,11 @@ protected:
 
     bool m_hasCheckBoxes;
 
+    // the column used by SortItemsByColumn() if the items are kept sorted by
+    // it or wxNOT_FOUND, and the wxLIST_SORT_XXX flags used for sorting
+    int m_sortColumn;
+    int m_sortFlags;
+
 protected:
     wxWindow *GetMainWindowOfCompositeControl() override { return GetParent(); }
 
@@ -887,6 +894,14 @@ private:
     // initialize the current item if needed
     void UpdateCurrent();
 
+    // return the index at which the given line must be inserted to keep the
+    // items sorted by m_sortColumn, only used if it is valid
+    size_t FindSortedPosition(const wxListLineData& line) const;
+
+    // move the line with the given index to its sorted position after its
+    // sort key changed and return its new index
+    size_t MoveToSortedPosition(size_t n);
+
     // change the current (== focused) item, without sending any event
     // return true if m_current really changed.
     bool ChangeCurrentWithoutEvent(size_t current);
@@ -10,144 +10,196 @@
 #ifndef _WX_PRIVATE_ROWHEIGHTCACHE_H_
 #define _WX_PRIVATE_ROWHEIGHTCACHE_H_
 
-#include <unordered_map>
 #include <vector>
 
-// struct describing a range of rows which contains rows <from> .. <to-1>
-struct RowRange
-{
-    unsigned int from;
-    unsigned int to;
-};
-
 /**
-    A helper class that manages a set of RowRange objects.
+    HeightCache implements a cache mechanism for wxDataViewCtrl.
+
+    It gives fast access to:
+    * the height of one line (GetLineHeight)
+    * the y-coordinate where a row starts (GetLineStart)
+    * and vice versa (GetLineAt)
+
+    The rows are stored as a sequence of runs of consecutive rows having the
+    same height, with the rows whose height is not known yet forming runs of
+    their own. The runs are kept in a balanced binary tree (a treap using the
+    row index as implicit key) in which every node also stores the total
+    number of rows, the number of unknown rows and the sum of the known
+    heights of its subtree.
+
+    An example:
+    @code
+    [0..10]: 22, [11..12]: 42, [13..14]: 62, [15..17]: 22, [18..19]: ?, ...
+    @endcode
+
+    This allows to answer all queries by descending the tree, i.e. in
+    O(log(number of runs)) time, which is typically much smaller than the
+    number of rows as most of the rows usually have the same height.
+
+    Examples
+    ========
+
+    GetLineStart
+    ------------
+    To retrieve the y-coordinate of row 1000 descend the tree looking for the
+    run containing it and sum the heights of all subtrees and runs left of the
+    path. This only succeeds if the heights of all rows before the given one
+    are known.
 
-    It stores the indices that are members of a group in a memory
-    efficient way.
+    GetLineAt
+    ---------
+    To retrieve the row that starts at a specific y-coordinate descend the
+    tree using the subtree height sums, which is the same as the previous
+    operation but using the height instead of the row index as key.
+
+    Modifying the cache
+    -------------------
+    Setting the height of a row splits the run containing it and merges the
+    result with its neighbours having the same height if possible. Inserting
+    or deleting rows shifts the heights of all the following rows, without
+    forgetting them, as this only affects the nodes along a single path.
+    All these operations are O(log(number of runs)) too.
 */
-class WXDLLIMPEXP_CORE RowRanges
+class WXDLLIMPEXP_CORE HeightCache
 {
 public:
+    HeightCache();
+    ~HeightCache();
+
     /**
-        Adds a row index to this group by adding it to an existing RowRange
-        or by creating a new one.
+        Gets the y-coordinate of the start of the given row.
+
+        Returns false if the height of any row before the given one is not
+        known. Notice that the height of the row itself doesn't need to be
+        known, so this can be used to get the total height of all rows by
+        passing the row count to it.
     */
-    void Add(unsigned int row);
+    bool GetLineStart(unsigned int row, int& start) const;
 
     /**
-        Removes a row index and all indices after idx from this group.
+        Gets the height of the given row if it's known.
     */
-    void Remove(unsigned int row);
+    bool GetLineHeight(unsigned int row, int& height) const;
 
     /**
-        Checks whether a row index is contained in this group.
+        Gets the row containing the given y-coordinate.
+
+        Returns false if y is before the first row or after the last one or
+        if the height of any row before the one containing y is not known.
     */
-    bool Has(unsigned int row) const;
+    bool GetLineAt(int y, unsigned int& row) const;
 
     /**
-        Returns the number of row indices that are contained in this group.
+        Gets both the start and the height of the given row.
+
+        Returns false unless the heights of this row and all the rows before
+        it are known.
     */
-    unsigned int CountAll() const;
+    bool GetLineInfo(unsigned int row, int &start, int &height) const;
 
     /**
-        Returns the number of rows that are in this group before the given row
-        index.
+        Returns the index of the first row whose height is unknown.
 
-        Not that this doesn't include the given row.
+        Notice that all rows after the last one for which Put() was called are
+        considered to be unknown.
     */
-    unsigned int CountTo(unsigned int row) const;
+    unsigned int GetFirstUnknown() const;
 
     /**
-        Returns the size of the range.
+        Stores the height of the given row, which must be strictly positive.
+    */
+    void Put(unsigned int row, int height);
 
-        This is only used for testing and debugging.
-     */
-    unsigned int GetSize() const { return m_ranges.size(); }
+    /**
+        Forgets the stored height of the given row only.
+    */
+    void Invalidate(unsigned int row);
 
-private:
-    std::vector<RowRange> m_ranges;
+    /**
+        Removes the stored height of the given row from the cache and
+        invalidates all cached rows (including the given one).
+    */
+    void Remove(unsigned int row);
 
     /**
-        If a new row index was inserted, Cleanup() checks if the neighbour
-        ranges of idx can includes the same row indices and discards
-        unnecessary RowRange objects.
+        Inserts the given number of rows with unknown height before the given
+        row, shifting the heights of all the subsequent rows.
     */
-    void CleanUp(unsigned int idx);
-};
+    void InsertRows(unsigned int row, unsigned int count);
 
-/**
-    HeightCache implements a cache mechanism for wxDataViewCtrl.
+    /**
+        Deletes the given number of rows starting at the given one, shifting
+        the heights of all the subsequent rows.
+    */
+    void DeleteRows(unsigned int row, unsigned int count);
 
-    It gives fast access to:
-    * the height of one line (GetLineHeight)
-    * the y-coordinate where a row starts (GetLineStart)
-    * and vice versa (GetLineAt)
+    void Clear();
 
-    The layout of the cache is a hashmap where the keys are all existing row
-    heights in pixels. The values are RowRange objects that represent all rows
-    having the specified height.
+    /**
+        Returns the number of runs of rows with the same height.
 
-    An example:
-    @code
+        This is only used for testing and debugging.
+     */
+    unsigned int GetRunsCount() const
+        { return static_cast<unsigned int>(m_nodes.size() - m_free.size() - 1); }
+
+private:
+    // Index of the node in m_nodes used as null pointer.
+    static const unsigned int Nil = 0;
+
+    struct Node
     {
-    22: RowRange([0..10], [15..17], [20..2000]),
-    42: RowRange([11..12], [18..18]),
-    62: RowRange([13..14], [19..19])
-    }
-    @endcode
+        // The height of all rows of this run or 0 if it is unknown.
+        int height;
 
-    Examples
-    ========
+        // The number of rows in this run.
+        unsigned int count;
 
-    GetLineStart
-    ------------
-    To retrieve the y-coordinate of item 1000 it is necessary to look into
-    each key of the hashmap *m_heightToRowRange*. Get the row count of
-    indices lower than 1000 (RowRange::CountTo) and multiplies it which the
-    according height.
+        // Random priority used to keep the tree balanced.
+        unsigned int priority;
 
-    RowRange([0..10], [15..17], [20..2000]).CountTo(1000)
-    --> 0..10 are 11 items, 15..17 are 3 items and 20..1000 are 980 items (1000-20)
-    = 11 + 3 + 980 = 994 items
+        unsigned int left,
+                     right;
 
-    GetLineStart(1000) --> (22 * 994) + (42 * 3) + (62 * 3) = 22180
+        // The values for the whole subtree rooted at this node: the number
+        // of rows, the number of rows with unknown height and the sum of all
+        // known heights.
+        unsigned int rows;
+        unsigned int unknown;
+        int sum;
+    };
 
-    GetLineHeight
-    -------------
-    To retrieve the line height look into each key and check if row is
-    contained in RowRange (RowRange::Has)
+    unsigned int NewNode(int height, unsigned int count);
+    void FreeTree(unsigned int t);
+    void Update(unsigned int t);
 
-    GetLineAt
-    ---------
-    To retrieve the row that starts at a specific y-coordinate.
-    Look into each key and count all rows.
-    Use bisect algorithm in combination with GetLineStart() to
-    find the appropriate item
-*/
-class WXDLLIMPEXP_CORE HeightCache
-{
-public:
-    ~HeightCache();
-    bool GetLineStart(unsigned int row, int& start);
-    bool GetLineHeight(unsigned int row, int& height);
-    bool GetLineAt(int y, unsigned int& row);
-    bool GetLineInfo(unsigned int row, int &start, int &height);
+    // Splits the tree t in two parts with l containing its first k rows.
+    void Split(unsigned int t, unsigned int k, unsigned int& l, unsigned int& r);
 
-    void Put(unsigned int row, int height);
+    // Concatenates the two trees.
+    unsigned int Merge(unsigned int l, unsigned int r);
 
-    /**
-        Removes the stored height of the given row from the cache and
-        invalidates all cached rows (including the given one).
-    */
-    void Remove(unsigned int row);
+    // Concatenates the two trees merging the adjacent runs if they have the
+    // same height.
+    unsigned int Join(unsigned int l, unsigned int r);
 
-    void Clear();
+    // Helper of Join() changing the number of rows in the last run.
+    void GrowLast(unsigned int t, unsigned int count);
 
-private:
-    using HeightToRowRangesMap = std::unordered_map<int, RowRanges>;
+    // Changes the height of the given row, which may be 0 to forget it.
+    void DoSet(unsigned int row, int height);
+
+    unsigned int GetRowCount() const { return m_nodes[m_root].rows; }
+
+    // All nodes, including the unused ones whose indices are in m_free, and
+    // the sentinel node at index 0.
+    std::vector<Node> m_nodes;
+    std::vector<unsigned int> m_free;
+
+    unsigned int m_root;
 
-    HeightToRowRangesMap m_heightToRowRange;
+    // State of the pseudo-random generator used for priorities.
+    unsigned int m_seed;
 };
 
 
@@ -279,6 +279,20 @@ protected:
 
     bool                 m_dropEffectAboveItem;
 
+    // the layout cache: the generation of the items layout data which is
+    // still valid, the line height used for it and the width of the widest
+    // item laid out so far (see InvalidateLayout())
+    mutable unsigned int m_layoutGen;
+    mutable int          m_layoutLineHeight;
+    mutable int          m_layoutWidth;
+
+    // true if m_layoutWidth changed since the scrollbars were last adjusted
+    mutable bool         m_layoutWidthChanged;
+
+    // true if m_layoutWidth may be too big because some items were hidden or
+    // deleted since it was computed (see InvalidateLayoutWidth())
+    bool                 m_layoutWidthStale;
+
     // the common part of all ctors
     void Init();
 
@@ -325,12 +339,68 @@ protected:
 
     void CalculateLineHeight();
     int  GetLineHeight(wxGenericTreeItem *item) const;
-    void PaintLevel( wxGenericTreeItem *item, wxDC& dc, int level, int &y );
+    void PaintLevel( wxGenericTreeItem *item, wxDC& dc, int level, int y,
+                     int yStart, int yEnd );
     void PaintItem( wxGenericTreeItem *item, wxDC& dc);
 
-    void CalculateLevel( wxGenericTreeItem *item, wxReadOnlyDC &dc, int level, int &y );
+    void CalculateLevel( wxGenericTreeItem *item, wxReadOnlyDC &dc, int level, int y,
+                         int yStart, int yEnd );
     void CalculatePositions();
 
+    // the items positions are computed lazily from the cached heights of the
+    // items subtrees and offsets of their children: these functions forget
+    // the cached data for all items or for the given item, its ancestors and
+    // its children starting from firstChild (or none by default)
+    void InvalidateLayout();
+    void InvalidateItemLayout(wxGenericTreeItem *item,
+                              size_t firstChild = (size_t)-1);
+
+    // recompute the layout width from the remaining visible items when the
+    // scrollbars are adjusted the next time, called after hiding some items
+    void InvalidateLayoutWidth();
+
+    // get the width of the widest already measured visible item in the
+    // subtree of the given item at the given level
+    int  GetMeasuredSubtreeWidth(wxGenericTreeItem *item, int level) const;
+
+    // get the position of the left side of the items at the given level
+    int  GetLevelX(int level) const;
+
+    // invalidate the layout if the fixed line height changed since it was
+    // computed
+    void CheckLayoutLineHeight() const;
+
+    // get the height of the item itself, without its children
+    int  GetItemOwnHeight(wxGenericTreeItem *item,
+                          wxReadOnlyDC *dc = nullptr) const;
+
+    // get the height of the item with all its visible descendants
+    int  GetSubtreeHeight(wxGenericTreeItem *item,
+                          wxReadOnlyDC *dc = nullptr) const;
+
+    // get the offset of the given child from the bottom of the parent line
+    int  GetChildOffset(wxGenericTreeItem *parent, size_t index,
+                        wxReadOnlyDC *dc = nullptr) const;
+
+    // get the index of the child containing the given offset from the bottom
+    // of the parent line (the first or the last one if it's out of range)
+    size_t FindChildAt(wxGenericTreeItem *parent, int offset,
+                       wxReadOnlyDC *dc = nullptr) const;
+
+    // get the index of the child if its offset is known or wxNOT_FOUND
+    int  FindLaidOutChild(wxGenericTreeItem *parent,
+                          wxGenericTreeItem *child) const;
+
+    // compute the position of the given item and set it, measuring the item
+    // using the given DC or a temporary one if it's null (the same is done by
+    // the functions above if the items have variable height)
+    void CalculateItemPosition(wxGenericTreeItem *item) const;
+    void SetItemPosition(wxGenericTreeItem *item, int level, int y,
+                         wxReadOnlyDC *dc = nullptr) const;
+
+    // recalculate the item size after changing it
+    void RecalculateItemSize(wxGenericTreeItem *item);
+
     void RefreshSubtree( wxGenericTreeItem *item );
     void RefreshLine( wxGenericTreeItem *item );
 
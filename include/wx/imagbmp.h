@@ -53,9 +53,11 @@ public:
 #if wxUSE_STREAMS
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) override;
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) override;
+    virtual size_t GetHeaderSize() const override { return 2; }
 
 protected:
     virtual bool DoCanRead( wxInputStream& stream ) override;
+    virtual bool DoCanReadHeader( const unsigned char* header ) const override;
     bool SaveDib(wxImage *image, wxOutputStream& stream, bool verbose,
                  bool IsBmp, bool IsMask);
     bool LoadDib(wxImage *image, wxInputStream& stream, bool verbose, bool IsBmp);
@@ -85,10 +87,12 @@ public:
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) override;
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) override;
     virtual bool DoLoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index );
+    virtual size_t GetHeaderSize() const override { return 6; }
 
 protected:
     virtual int DoGetImageCount( wxInputStream& stream ) override;
     virtual bool DoCanRead( wxInputStream& stream ) override;
+    virtual bool DoCanReadHeader( const unsigned char* header ) const override;
 #endif // wxUSE_STREAMS
 
 private:
@@ -118,6 +122,7 @@ public:
 protected:
 #if wxUSE_STREAMS
     virtual bool DoCanRead( wxInputStream& stream ) override;
+    virtual bool DoCanReadHeader( const unsigned char* header ) const override;
 #endif // wxUSE_STREAMS
 
 private:
@@ -143,6 +148,9 @@ public:
     virtual bool SaveFile( wxImage *WXUNUSED(image), wxOutputStream& WXUNUSED(stream), bool WXUNUSED(verbose=true) ) override{return false ;}
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) override;
 
+    // ANI files can only be recognized by looking for a chunk inside them
+    virtual size_t GetHeaderSize() const override { return 0; }
+
 protected:
     virtual int DoGetImageCount( wxInputStream& stream ) override;
     virtual bool DoCanRead( wxInputStream& stream ) override;
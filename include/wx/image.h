@@ -62,6 +62,7 @@ enum wxImageResizeQuality
     wxIMAGE_QUALITY_BILINEAR = 1,
     wxIMAGE_QUALITY_BICUBIC = 2,
     wxIMAGE_QUALITY_BOX_AVERAGE = 3,
+    wxIMAGE_QUALITY_LANCZOS = 7,
 
     // default quality, suitable for most icons
     wxIMAGE_QUALITY_NORMAL = 0,
@@ -98,6 +99,59 @@ class WXDLLIMPEXP_FWD_CORE wxImageHandler;
 class WXDLLIMPEXP_FWD_CORE wxImage;
 class WXDLLIMPEXP_FWD_CORE wxPalette;
 
+//-----------------------------------------------------------------------------
+// wxImageRowSink: receives the rows of the image loaded by wxImageHandler
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageRowSink
+{
+public:
+    wxImageRowSink() = default;
+    virtual ~wxImageRowSink() = default;
+
+    // called once before any rows are passed to ProcessRow(), returning false
+    // from it or from ProcessRow() stops loading the image
+    virtual bool Start(int width, int height, bool hasAlpha) = 0;
+
+    // called for all rows from top to bottom, data contains 3*width bytes of
+    // RGB data and alpha is either null or contains width bytes
+    virtual bool ProcessRow(int y,
+                            const unsigned char* data,
+                            const unsigned char* alpha) = 0;
+
+private:
+    wxDECLARE_NO_COPY_CLASS(wxImageRowSink);
+};
+
+#if wxUSE_STREAMS
+
+//-----------------------------------------------------------------------------
+// wxDetectedImageHeader: the first bytes of the stream being identified
+//-----------------------------------------------------------------------------
+
+class wxDetectedImageHeader
+{
+public:
+    // the header must contain the first len bytes of the stream, which must
+    // be positioned at its start, i.e. they must not have been consumed
+    wxDetectedImageHeader(wxInputStream& stream, const void* data, size_t len)
+        : m_stream(stream), m_data(data), m_len(len)
+        { }
+
+    wxInputStream& GetStream() const { return m_stream; }
+    const void* GetData() const { return m_data; }
+    size_t GetLength() const { return m_len; }
+
+private:
+    wxInputStream& m_stream;
+    const void* const m_data;
+    const size_t m_len;
+
+    wxDECLARE_NO_ASSIGN_CLASS(wxDetectedImageHeader);
+};
+
+#endif // wxUSE_STREAMS
+
 //-----------------------------------------------------------------------------
 // wxImageHandler
 //-----------------------------------------------------------------------------
@@ -130,8 +184,33 @@ public:
 
     bool CanRead( wxInputStream& stream ) { return CallDoCanRead(stream); }
     bool CanRead( const wxString& name );
+
+    // same as CanRead(stream) but avoids reading the header from the stream
+    // again if possible
+    bool CanRead( const wxDetectedImageHeader& header )
+        { return DoCanReadDetected(header); }
+
+    // returns the number of bytes at the start of the image which are needed
+    // by CanReadHeader() or 0 if this handler can't recognize its images by
+    // their header alone and CanRead() needs to be used
+    virtual size_t GetHeaderSize() const { return 0; }
+
+    // check if the header, i.e. the first len bytes of the stream, is in the
+    // format supported by this handler
+    bool CanReadHeader( const void* header, size_t len ) const;
+
+    // load the image passing its rows to the sink instead of storing all of
+    // them in memory, optionally making it smaller by the given factor which
+    // must be a power of 2
+    bool LoadRows( wxImageRowSink& sink, wxInputStream& stream,
+                   int scale = 1, bool verbose = true, int index = -1 );
 #endif // wxUSE_STREAMS
 
+    // returns the power of 2 by which the image of the given size needs to be
+    // reduced to fit into the given maximal size, 0 means no limit
+    static int GetScaleForMaxSize(unsigned width, unsigned height,
+                                  unsigned maxWidth, unsigned maxHeight);
+
     void SetName(const wxString& name) { m_name = name; }
     void SetExtension(const wxString& ext) { m_extension = ext; }
     void SetAltExtensions(const wxArrayString& exts) { m_altExtensions = exts; }
@@ -156,6 +235,22 @@ protected:
 
     // save the stream position, call DoCanRead() and restore the position
     bool CallDoCanRead(wxInputStream& stream);
+
+    // called by CanReadHeader() with at least GetHeaderSize() bytes, must be
+    // overridden if GetHeaderSize() is
+    virtual bool DoCanReadHeader( const unsigned char* WXUNUSED(header) ) const
+        { return false; }
+
+    // called by CanRead(header), the default implementation calls DoCanRead()
+    // with the header data if GetHeaderSize() is non-zero and with the stream
+    // itself otherwise
+    virtual bool DoCanReadDetected( const wxDetectedImageHeader& header );
+
+    // the default implementation loads the entire image using LoadFile() and
+    // then passes its rows to the sink, the derived classes can override it
+    // to avoid allocating memory for the entire image
+    virtual bool DoLoadRows( wxImageRowSink& sink, wxInputStream& stream,
+                             int scale, bool verbose, int index );
 #endif // wxUSE_STREAMS
 
     // helper for the derived classes SaveFile() implementations: returns the
@@ -358,17 +453,23 @@ public:
                   wxImageResizeQuality quality = wxIMAGE_QUALITY_NORMAL) const
         { return Scale(size.GetWidth(), size.GetHeight(), quality); }
 
-    // box averager and bicubic filters for up/down sampling
+    // box averager, bicubic and Lanczos filters for up/down sampling
     wxImage ResampleNearest(int width, int height) const;
     wxImage ResampleBox(int width, int height) const;
     wxImage ResampleBilinear(int width, int height) const;
     wxImage ResampleBicubic(int width, int height) const;
+    wxImage ResampleLanczos(int width, int height) const;
 
     // blur the image according to the specified pixel radius
     wxImage Blur(int radius) const;
     wxImage BlurHorizontal(int radius) const;
     wxImage BlurVertical(int radius) const;
 
+    // set the number of threads used by the functions above, 0 means to use
+    // as many threads as there are CPUs
+    static void SetMaxThreads(int count);
+    static int GetMaxThreads();
+
     wxImage ShrinkBy( int xFactor , int yFactor ) const ;
 
     // rescales the image in place
@@ -603,6 +704,7 @@ public:
 
 protected:
     static wxList   sm_handlers;
+    static int      sm_maxThreads;
 
     // return the index of the point with the given coordinates or -1 if the
     // image is invalid of the coordinates are out of range
@@ -616,10 +718,18 @@ protected:
 private:
     friend class WXDLLIMPEXP_FWD_CORE wxImageHandler;
 
-    // Helper function used internally by wxImage class only: it applies the
-    // given functor, which is passed the pixel data for each image pixel.
+    // Helper functions used internally by wxImage class only: they apply the
+    // given functor to all image pixels. The new pixel value must depend only
+    // on its old value, as the results are reused for the pixels of the same
+    // colour.
+    //
+    // The functor is passed the data of a single pixel by ApplyToAllPixels()
+    // and an array of pointers to the data of several pixels and their number
+    // by ApplyToPixelBatches().
     template <typename F>
     void ApplyToAllPixels(const F& func);
+    template <typename F>
+    void ApplyToPixelBatches(const F& func);
 
     // Possible values for MakeEmptyClone() flags.
     enum
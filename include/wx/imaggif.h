@@ -45,6 +45,7 @@ public:
                           bool verbose = true, int index = -1) override;
     virtual bool SaveFile(wxImage *image, wxOutputStream& stream,
                           bool verbose=true) override;
+    virtual size_t GetHeaderSize() const override { return 3; }
 
     // Save animated gif
     bool SaveAnimation(const std::vector<wxImage>& images, wxOutputStream *stream,
@@ -53,6 +54,7 @@ public:
 protected:
     virtual int DoGetImageCount(wxInputStream& stream) override;
     virtual bool DoCanRead(wxInputStream& stream) override;
+    virtual bool DoCanReadHeader(const unsigned char* header) const override;
 
     bool DoSaveFile(const wxImage&, wxOutputStream *, bool verbose,
         bool first, int delayMilliSecs, bool loop,
@@ -31,8 +31,11 @@ public:
 #if wxUSE_STREAMS
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) override;
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) override;
+    virtual size_t GetHeaderSize() const override { return 1; }
+
 protected:
     virtual bool DoCanRead( wxInputStream& stream ) override;
+    virtual bool DoCanReadHeader( const unsigned char* header ) const override;
 #endif // wxUSE_STREAMS
 
 private:
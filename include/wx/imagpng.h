@@ -53,8 +53,13 @@ public:
 #if wxUSE_STREAMS
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) override;
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) override;
+    virtual size_t GetHeaderSize() const override { return 4; }
+
 protected:
     virtual bool DoCanRead( wxInputStream& stream ) override;
+    virtual bool DoCanReadHeader( const unsigned char* header ) const override;
+    virtual bool DoLoadRows( wxImageRowSink& sink, wxInputStream& stream,
+                             int scale, bool verbose, int index ) override;
 #endif
 
 private:
@@ -34,8 +34,11 @@ public:
                             bool verbose = true, int index = -1) override;
     virtual bool SaveFile(wxImage* image, wxOutputStream& stream,
                              bool verbose = true) override;
+    virtual size_t GetHeaderSize() const override { return 18; }
+
 protected:
     virtual bool DoCanRead(wxInputStream& stream) override;
+    virtual bool DoCanReadHeader(const unsigned char* header) const override;
 #endif // wxUSE_STREAMS
 
     wxDECLARE_DYNAMIC_CLASS(wxTGAHandler);
@@ -61,8 +61,11 @@ public:
     virtual bool LoadFile(wxImage* image, wxInputStream& stream, bool verbose = true, int index = -1) override;
     virtual bool SaveFile(wxImage* image, wxOutputStream& stream, bool verbose = true) override;
     virtual bool LoadAnimation(std::vector<wxWebPAnimationFrame>& frames, wxInputStream& stream, bool verbose = true);
+    virtual size_t GetHeaderSize() const override { return 12; }
+
 protected:
     virtual bool DoCanRead(wxInputStream& stream) override;
+    virtual bool DoCanReadHeader(const unsigned char* header) const override;
     virtual int DoGetImageCount(wxInputStream& stream) override;
 #endif // wxUSE_STREAMS
 
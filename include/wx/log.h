@@ -422,6 +422,10 @@ public:
         return IsEnabled() && level <= GetComponentLevel(component);
     }
 
+    // overload used by the logging macros, it avoids constructing wxString
+    // from the component name unless component levels are really used
+    static bool IsLevelEnabled(wxLogLevel level, const char* component);
+
 
     // enable/disable messages at wxLOG_Verbose level (only relevant if the
     // current log level is greater or equal to it)
@@ -602,6 +606,12 @@ protected:
     // this one as the default implementation of it simply asserts
     virtual void DoLogText(const wxString& msg);
 
+    // override this method to return true if DoLogRecord() may be called from
+    // any thread concurrently: in this case the messages logged by the threads
+    // other than main are passed to it immediately instead of being buffered
+    // until the next Flush() call from the main thread
+    virtual bool IsThreadSafe() const { return false; }
+
     // log a message indicating the number of times the previous message was
     // repeated if previous repetition counter is strictly positive, does
     // nothing otherwise; return the old value of repetition counter
@@ -877,6 +887,56 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxLogInterposerTemp);
 };
 
+#if wxUSE_THREADS
+
+// ----------------------------------------------------------------------------
+// asynchronous log target: passes all messages to the real log target in a
+// background thread
+//
+// logging a message only adds it to a lock-free queue, so it is cheap and can
+// be done from any thread without locking, while the messages are formatted
+// and output by the real log target in its own thread
+// ----------------------------------------------------------------------------
+
+class wxLogAsyncThread;
+
+class WXDLLIMPEXP_BASE wxLogAsync : public wxLog
+{
+public:
+    // takes ownership of the target, which must be usable from a thread other
+    // than main, and creates a queue for at least the given number of
+    // messages: if it becomes full, logging blocks until there is space in it
+    explicit wxLogAsync(wxLog *target, size_t capacity = 1024);
+
+    // logs all the still queued messages before destroying the target
+    virtual ~wxLogAsync();
+
+    // return the log target used for the real output
+    wxLog *GetTarget() const { return m_target; }
+
+    // wait until all the messages logged so far are passed to the target and
+    // flush it
+    void Drain();
+
+protected:
+    virtual void DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info) override;
+
+    virtual bool IsThreadSafe() const override;
+
+private:
+    // the real log target
+    wxLog *const m_target;
+
+    // the thread using it, may be null if it couldn't be started
+    wxLogAsyncThread *m_thread;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsync);
+};
+
+#endif // wxUSE_THREADS
+
 #if wxUSE_GUI
     // include GUI log targets:
     #include "wx/generic/logg.h"
@@ -941,7 +1001,7 @@ public:
     {
         // remember that fatal errors can't be disabled
         if ( m_level == wxLOG_FatalError ||
-                wxLog::IsLevelEnabled(m_level, wxASCII_STR(m_info.component)) )
+                wxLog::IsLevelEnabled(m_level, m_info.component) )
             DoCallOnLog(wxString::FormatV(format, argptr));
     }
 
@@ -1054,7 +1114,7 @@ public:
     template <typename... Targs>
     void LogAtLevel(wxLogLevel level, const wxString& format, Targs... args)
     {
-        if ( !wxLog::IsLevelEnabled(level, wxASCII_STR(m_info.component)) )
+        if ( !wxLog::IsLevelEnabled(level, m_info.component) )
             return;
 
         DoCallOnLog(level, wxString::Format(format, args...));
@@ -1062,7 +1122,7 @@ public:
 
     void LogAtLevel(wxLogLevel level, const wxString& s)
     {
-        if ( !wxLog::IsLevelEnabled(level, wxASCII_STR(m_info.component)) )
+        if ( !wxLog::IsLevelEnabled(level, m_info.component) )
             return;
 
         DoCallOnLog(level, s);
@@ -1189,7 +1249,7 @@ WXDLLIMPEXP_BASE wxString wxSysErrorMsgStr(unsigned long nErrCode = 0);
 
 // Macro evaluating to true if logging at the given level is enabled.
 #define wxLOG_IS_ENABLED(level) \
-    wxLog::IsLevelEnabled(wxLOG_##level, wxASCII_STR(wxLOG_COMPONENT))
+    wxLog::IsLevelEnabled(wxLOG_##level, wxLOG_COMPONENT)
 
 // Macro used to define most of the actual wxLogXXX() macros: just calls
 // wxLogger::Log(), if logging at the specified level is enabled.
@@ -21,6 +21,8 @@
 #include "wx/stopwatch.h"
 
 #include "wx/beforestd.h"
+#include <atomic>
+#include <new>
 #include <queue>
 #include <utility>
 #include "wx/afterstd.h"
@@ -29,7 +31,8 @@ enum wxMessageQueueError
 {
     wxMSGQUEUE_NO_ERROR = 0, // operation completed successfully
     wxMSGQUEUE_TIMEOUT,      // no messages received before timeout expired
-    wxMSGQUEUE_MISC_ERROR    // some unexpected (and fatal) error has occurred
+    wxMSGQUEUE_MISC_ERROR,   // some unexpected (and fatal) error has occurred
+    wxMSGQUEUE_FULL          // bounded queue has no space for the message
 };
 
 // ---------------------------------------------------------------------------
@@ -180,6 +183,408 @@ private:
     std::queue<T>   m_messages;
 };
 
+// ---------------------------------------------------------------------------
+// Bounded message queue with the same interface as wxMessageQueue.
+//
+// This queue uses a fixed size ring buffer and doesn't lock any mutexes when
+// posting or receiving messages unless some thread needs to wait, which makes
+// it much faster than wxMessageQueue when many threads use it concurrently.
+//
+// Post() doesn't block and returns wxMSGQUEUE_FULL if there is no space in the
+// queue, use PostTimeout() to wait until the receivers catch up.
+//
+// Notice that the copy or move ctor of T must not throw, as the slot reserved
+// for the message would be lost otherwise.
+// ---------------------------------------------------------------------------
+template <typename T>
+class wxBoundedMessageQueue
+{
+public:
+    // The type of the messages transported by this queue
+    typedef T Message;
+
+    // Create a queue able to hold at least the given number of messages, the
+    // capacity is rounded up to the next power of 2.
+    explicit wxBoundedMessageQueue(size_t capacity)
+        : m_conditionNotEmpty(m_mutex),
+          m_conditionNotFull(m_mutex)
+    {
+        size_t size = 2;
+        while ( size < capacity )
+            size *= 2;
+
+        m_mask = size - 1;
+        m_cells = new Cell[size];
+        for ( size_t n = 0; n < size; n++ )
+            m_cells[n].sequence.store(n, std::memory_order_relaxed);
+    }
+
+    ~wxBoundedMessageQueue()
+    {
+        DoClear();
+
+        delete [] m_cells;
+    }
+
+    // Return the maximal number of messages in the queue.
+    size_t GetCapacity() const { return m_mask + 1; }
+
+    // Add a message to this queue if it's not full and wake up a thread
+    // waiting for messages, if any.
+    //
+    // This method is safe to call from multiple threads in parallel.
+    wxMessageQueueError Post(const Message& msg)
+    {
+        return DoPost(msg);
+    }
+
+    // Overload for move-only types, msg is left unchanged if the queue is full.
+    wxMessageQueueError Post(Message&& msg)
+    {
+        return DoPost(std::move(msg));
+    }
+
+    // Wait no more than timeout milliseconds until there is space for the
+    // message in the queue. Setting timeout to 0 is equivalent to Post().
+    wxMessageQueueError PostTimeout(long timeout, const Message& msg)
+    {
+        return DoPostTimeout(timeout, msg);
+    }
+
+    wxMessageQueueError PostTimeout(long timeout, Message&& msg)
+    {
+        return DoPostTimeout(timeout, std::move(msg));
+    }
+
+    // Post as many of the given messages as fit in the queue and return their
+    // number, the remaining messages are not posted.
+    //
+    // This is more efficient than calling Post() for each of them as the
+    // waiting threads are only woken up once.
+    size_t PostMany(const Message* msgs, size_t count)
+    {
+        size_t n;
+        for ( n = 0; n < count; n++ )
+        {
+            if ( !TryPush(msgs[n]) )
+                break;
+        }
+
+        if ( n )
+            NotifyWaiting(m_numWaitingReceivers, m_conditionNotEmpty, n > 1);
+
+        return n;
+    }
+
+    // Remove all messages from the queue.
+    wxMessageQueueError Clear()
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        if ( DoClear() )
+            NotifyWaiting(m_numWaitingSenders, m_conditionNotFull, true);
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Wait no more than timeout milliseconds until a message becomes
+    // available. Setting timeout to 0 just checks if there is any message.
+    wxMessageQueueError ReceiveTimeout(long timeout, T& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        return DoReceive(timeout, msg);
+    }
+
+    // Same as ReceiveTimeout() but waits for as long as it takes for a message
+    // to become available (so it can't return wxMSGQUEUE_TIMEOUT)
+    wxMessageQueueError Receive(T& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        return DoReceive(-1, msg);
+    }
+
+    // Wait for a message as ReceiveTimeout() does, then also get all the
+    // other available messages, up to maxCount, without waiting.
+    //
+    // The number of received messages is returned in count.
+    wxMessageQueueError ReceiveManyTimeout(long timeout,
+                                           T* msgs,
+                                           size_t maxCount,
+                                           size_t& count)
+    {
+        count = 0;
+
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+        wxCHECK( maxCount, wxMSGQUEUE_MISC_ERROR );
+
+        // don't wake up the senders after getting the first message, do it
+        // once for all of them below
+        const wxMessageQueueError
+            rc = Wait(timeout, m_numWaitingReceivers, m_conditionNotEmpty,
+                      [&]() { return TryPop(msgs[0]); });
+        if ( rc != wxMSGQUEUE_NO_ERROR )
+            return rc;
+
+        for ( count = 1; count < maxCount; count++ )
+        {
+            if ( !TryPop(msgs[count]) )
+                break;
+        }
+
+        NotifyWaiting(m_numWaitingSenders, m_conditionNotFull, count > 1);
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Same as ReceiveManyTimeout() but waits for as long as necessary.
+    wxMessageQueueError ReceiveMany(T* msgs, size_t maxCount, size_t& count)
+    {
+        return ReceiveManyTimeout(-1, msgs, maxCount, count);
+    }
+
+    // Return false only if there was a fatal error in ctor
+    bool IsOk() const
+    {
+        return m_conditionNotEmpty.IsOk() && m_conditionNotFull.IsOk();
+    }
+
+private:
+    // Each cell contains the sequence number indicating its state: if it's
+    // equal to the position of the cell, the cell is free and can be written
+    // to, if it is one more than it, the cell contains a message that can be
+    // read and once it is read, it is incremented by the queue size to make
+    // the cell free for the next pass over the ring buffer.
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* GetMessage() { return reinterpret_cast<T*>(storage); }
+    };
+
+    // Number of times to try the operation before blocking.
+    enum { SPIN_COUNT = 64 };
+
+    // Find the next cell to write to or read from and return it, or nullptr
+    // if the queue is full or empty. This is the algorithm of the bounded
+    // MPMC queue by Dmitry Vyukov.
+    Cell* AcquireCell(std::atomic<size_t>& position, size_t offset, size_t& pos)
+    {
+        pos = position.load(std::memory_order_relaxed);
+        for ( ;; )
+        {
+            Cell* const cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const ptrdiff_t diff = static_cast<ptrdiff_t>(seq - (pos + offset));
+            if ( diff == 0 )
+            {
+                if ( position.compare_exchange_weak(pos, pos + 1,
+                                                    std::memory_order_relaxed) )
+                    return cell;
+            }
+            else if ( diff < 0 )
+            {
+                return nullptr;
+            }
+            else
+            {
+                // another thread got this cell, try the next one
+                pos = position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename U>
+    bool TryPush(U&& msg)
+    {
+        size_t pos;
+        Cell* const cell = AcquireCell(m_writePos, 0, pos);
+        if ( !cell )
+            return false;
+
+        new (cell->GetMessage()) T(std::forward<U>(msg));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool TryPop(T& msg)
+    {
+        size_t pos;
+        Cell* const cell = AcquireCell(m_readPos, 1, pos);
+        if ( !cell )
+            return false;
+
+        T* const p = cell->GetMessage();
+        msg = std::move(*p);
+        p->~T();
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Remove all messages and return true if there were any.
+    bool DoClear()
+    {
+        bool removed = false;
+        for ( ;; )
+        {
+            size_t pos;
+            Cell* const cell = AcquireCell(m_readPos, 1, pos);
+            if ( !cell )
+                return removed;
+
+            cell->GetMessage()->~T();
+            cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+            removed = true;
+        }
+    }
+
+    // Wake up one or all of the threads blocked on the given condition after
+    // making the queue non-empty or non-full.
+    void NotifyWaiting(std::atomic<int>& numWaiting,
+                       wxCondition& condition,
+                       bool all)
+    {
+        // this fence pairs with the one in Wait() to ensure that either we
+        // see the waiting thread or it sees the change to the queue
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ( !numWaiting.load(std::memory_order_relaxed) )
+            return;
+
+        wxMutexLocker locker(m_mutex);
+
+        if ( all )
+            condition.Broadcast();
+        else
+            condition.Signal();
+    }
+
+    // Call tryOp() until it succeeds or the timeout, which is infinite if
+    // negative, expires. We spin for a short time first, as the other side
+    // is often just about to post or receive a message, and only then block.
+    template <typename F>
+    wxMessageQueueError Wait(long timeout,
+                             std::atomic<int>& numWaiting,
+                             wxCondition& condition,
+                             F tryOp)
+    {
+        for ( int n = 0; n < SPIN_COUNT; n++ )
+        {
+            if ( tryOp() )
+                return wxMSGQUEUE_NO_ERROR;
+
+            if ( !timeout )
+                return wxMSGQUEUE_TIMEOUT;
+
+            if ( n >= SPIN_COUNT / 2 )
+                wxThread::Yield();
+        }
+
+        wxMutexLocker locker(m_mutex);
+
+        wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        const wxMilliClock_t waitUntil = wxGetLocalTimeMillis() + timeout;
+        for ( ;; )
+        {
+            numWaiting++;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if ( tryOp() )
+            {
+                numWaiting--;
+                return wxMSGQUEUE_NO_ERROR;
+            }
+
+            const wxCondError result = timeout < 0
+                                        ? condition.Wait()
+                                        : condition.WaitTimeout(timeout);
+            numWaiting--;
+
+            if ( result == wxCOND_NO_ERROR )
+                continue;
+
+            wxCHECK( result == wxCOND_TIMEOUT, wxMSGQUEUE_MISC_ERROR );
+
+            const wxMilliClock_t now = wxGetLocalTimeMillis();
+            if ( now >= waitUntil )
+                return tryOp() ? wxMSGQUEUE_NO_ERROR : wxMSGQUEUE_TIMEOUT;
+
+            timeout = (waitUntil - now).ToLong();
+        }
+    }
+
+    template <typename U>
+    wxMessageQueueError DoPost(U&& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        if ( !TryPush(std::forward<U>(msg)) )
+            return wxMSGQUEUE_FULL;
+
+        NotifyWaiting(m_numWaitingReceivers, m_conditionNotEmpty, false);
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    template <typename U>
+    wxMessageQueueError DoPostTimeout(long timeout, U&& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        // TryPush() only uses msg if it succeeds, so it's safe to call it
+        // repeatedly even with an rvalue reference
+        const wxMessageQueueError
+            rc = Wait(timeout, m_numWaitingSenders, m_conditionNotFull,
+                      [&]() { return TryPush(std::forward<U>(msg)); });
+        if ( rc == wxMSGQUEUE_TIMEOUT )
+            return wxMSGQUEUE_FULL;
+
+        if ( rc == wxMSGQUEUE_NO_ERROR )
+            NotifyWaiting(m_numWaitingReceivers, m_conditionNotEmpty, false);
+
+        return rc;
+    }
+
+    wxMessageQueueError DoReceive(long timeout, T& msg)
+    {
+        const wxMessageQueueError
+            rc = Wait(timeout, m_numWaitingReceivers, m_conditionNotEmpty,
+                      [&]() { return TryPop(msg); });
+
+        if ( rc == wxMSGQUEUE_NO_ERROR )
+            NotifyWaiting(m_numWaitingSenders, m_conditionNotFull, false);
+
+        return rc;
+    }
+
+
+    Cell* m_cells;
+    size_t m_mask;
+
+    // the positions are modified by the different threads, so keep them in
+    // different cache lines to avoid false sharing
+    char m_padding1[64];
+    std::atomic<size_t> m_writePos{0};
+    char m_padding2[64];
+    std::atomic<size_t> m_readPos{0};
+    char m_padding3[64];
+
+    // the number of threads blocked in Wait() for each condition
+    std::atomic<int> m_numWaitingReceivers{0};
+    std::atomic<int> m_numWaitingSenders{0};
+
+    mutable wxMutex m_mutex;
+    wxCondition     m_conditionNotEmpty;
+    wxCondition     m_conditionNotFull;
+
+    wxDECLARE_NO_COPY_TEMPLATE_CLASS(wxBoundedMessageQueue, T);
+};
+
 #endif // wxUSE_THREADS
 
 #endif // _WX_MSGQUEUE_H_
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/imagerows.h
+// Purpose:     Helpers for loading images row by row
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IMAGEROWS_H_
+#define _WX_PRIVATE_IMAGEROWS_H_
+
+#include "wx/image.h"
+#include "wx/vector.h"
+
+// ----------------------------------------------------------------------------
+// wxImageRowReducer: makes the image smaller before passing it to another sink
+// ----------------------------------------------------------------------------
+
+// This sink averages the pixels in the blocks of scale*scale size and passes
+// the resulting rows to the real sink, using memory only for a single row of
+// the reduced image. If the image size is not a multiple of scale, the extra
+// pixels at the right and bottom are ignored.
+class wxImageRowReducer : public wxImageRowSink
+{
+public:
+    explicit wxImageRowReducer(wxImageRowSink& sink, int scale = 1)
+        : m_sink(sink),
+          m_scale(scale)
+    {
+    }
+
+    // can be used to change the scale before calling Start()
+    void SetScale(int scale) { m_scale = scale; }
+
+    virtual bool Start(int width, int height, bool hasAlpha) override;
+    virtual bool ProcessRow(int y,
+                            const unsigned char* data,
+                            const unsigned char* alpha) override;
+
+private:
+    wxImageRowSink& m_sink;
+    int m_scale;
+
+    // Size of the blocks which are averaged, which may be less than scale if
+    // the image is smaller than it.
+    int m_blockWidth = 0,
+        m_blockHeight = 0;
+
+    // Size of the reduced image.
+    int m_width = 0,
+        m_height = 0;
+
+    bool m_hasAlpha = false;
+
+    // Sums of the (alpha-weighted if we have alpha) colour components and of
+    // alpha values for the current row of the reduced image.
+    wxVector<wxUint64> m_sums;
+    wxVector<wxUint64> m_sumsAlpha;
+
+    // The buffers for the reduced row.
+    wxVector<unsigned char> m_data;
+    wxVector<unsigned char> m_alpha;
+};
+
+// ----------------------------------------------------------------------------
+// wxImageRowWriter: stores the rows in wxImage
+// ----------------------------------------------------------------------------
+
+class wxImageRowWriter : public wxImageRowSink
+{
+public:
+    explicit wxImageRowWriter(wxImage& image)
+        : m_image(image)
+    {
+    }
+
+    virtual bool Start(int width, int height, bool hasAlpha) override;
+    virtual bool ProcessRow(int y,
+                            const unsigned char* data,
+                            const unsigned char* alpha) override;
+
+private:
+    wxImage& m_image;
+};
+
+#endif // _WX_PRIVATE_IMAGEROWS_H_
@@ -3736,7 +3736,9 @@ private:
   // existing code and consistency with std::string::c_str() so returning a
   // temporary buffer won't do and we need to cache the conversion results
 
-  // TODO-UTF8: benchmark various approaches to keeping compatibility buffers
+  // the buffers are only reallocated when they need to grow or are much
+  // bigger than needed, so that repeated conversions of the same string, or
+  // of the strings of similar length, don't allocate memory
   template<typename T>
   struct ConvertedBuffer
   {
@@ -3748,12 +3750,19 @@ private:
 
       bool Extend(size_t len)
       {
-          // add extra 1 for the trailing NUL
-          void * const str = realloc(m_str, sizeof(T)*(len + 1));
-          if ( !str )
-              return false;
+          // don't waste too much memory on the conversions of the strings
+          // which became much shorter than they used to be
+          if ( !m_str || len > m_size || m_size > 2*len + 16 )
+          {
+              // add extra 1 for the trailing NUL
+              void * const str = realloc(m_str, sizeof(T)*(len + 1));
+              if ( !str )
+                  return false;
+
+              m_str = static_cast<T *>(str);
+              m_size = len;
+          }
 
-          m_str = static_cast<T *>(str);
           m_len = len;
 
           return true;
@@ -3766,6 +3775,7 @@ private:
 
       T *m_str{nullptr};     // pointer to the string data
       size_t m_len{0}; // length, not size, i.e. in chars and without last NUL
+      size_t m_size{0}; // allocated length, without the last NUL
   };
 
 
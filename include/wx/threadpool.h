@@ -0,0 +1,360 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     wxThreadPool and wxTaskFuture classes
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_THREADPOOL_H_
+#define _WX_THREADPOOL_H_
+
+#include "wx/thread.h"
+
+#if wxUSE_THREADS
+
+#include "wx/vector.h"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+
+class wxThreadPool;
+template <typename T> class wxTaskFuture;
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolTaskBase: base class for the tasks executed by wxThreadPool
+// ----------------------------------------------------------------------------
+
+// This class is an implementation detail of wxThreadPool and wxTaskFuture and
+// shouldn't be used directly.
+class WXDLLIMPEXP_BASE wxThreadPoolTaskBase
+{
+public:
+    wxThreadPoolTaskBase() = default;
+    virtual ~wxThreadPoolTaskBase() = default;
+
+    // run the task unless it was cancelled, called by wxThreadPool only
+    void Execute();
+
+    // cancel the task if it hadn't started yet and return true or return
+    // false if it's already running or done, but note that running tasks can
+    // still check for cancellation requests using wxThreadPool::TestCancel()
+    bool Cancel();
+
+    // cancel the task if it hadn't started yet, just as Cancel(), but don't
+    // request the cancellation of the task if it's already running
+    bool CancelIfPending();
+
+    // return true if the task has completed or was cancelled
+    bool IsDone() const { return m_state >= State_Done; }
+
+    bool IsCancelled() const { return m_state == State_Cancelled; }
+
+    // wait until the task is done
+    void Wait();
+
+    // set the function to call, in the thread completing the task, when it is
+    // done or immediately if it's already done
+    void SetContinuation(const std::function<void ()>& func);
+
+    // rethrow the exception thrown by the task, if any
+    void RethrowIfFailed() const;
+
+protected:
+    virtual void DoRun() = 0;
+
+private:
+    // called when the task is done or cancelled
+    void Finish();
+
+    enum
+    {
+        State_Pending,
+        State_Running,
+        State_Done,
+        State_Cancelled
+    };
+
+    std::atomic<int> m_state{State_Pending};
+
+    // set by Cancel() to allow the running task to check for it
+    std::atomic<bool> m_cancelRequested{false};
+
+    // the pool running this task, set when it is submitted
+    wxThreadPool *m_pool = nullptr;
+
+    // continuation and the flag used to ensure it is called exactly once
+    std::function<void ()> m_continuation;
+    std::atomic<int> m_continuationState{0};
+
+#if wxUSE_EXCEPTIONS
+    std::exception_ptr m_exception;
+#endif // wxUSE_EXCEPTIONS
+
+    friend class wxThreadPool;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolTaskBase);
+};
+
+// Task computing a value of type T.
+template <typename T>
+class wxThreadPoolTask : public wxThreadPoolTaskBase
+{
+public:
+    template <typename F>
+    explicit wxThreadPoolTask(F&& func) : m_func(std::forward<F>(func)) { }
+
+    // only valid if the task has completed successfully
+    const T& GetResult() const { return *m_result; }
+
+protected:
+    virtual void DoRun() override
+    {
+        m_result.reset(new T(m_func()));
+        m_func = nullptr;
+    }
+
+private:
+    std::function<T ()> m_func;
+    std::unique_ptr<T> m_result;
+};
+
+template <>
+class wxThreadPoolTask<void> : public wxThreadPoolTaskBase
+{
+public:
+    template <typename F>
+    explicit wxThreadPoolTask(F&& func) : m_func(std::forward<F>(func)) { }
+
+protected:
+    virtual void DoRun() override
+    {
+        m_func();
+        m_func = nullptr;
+    }
+
+private:
+    std::function<void ()> m_func;
+};
+
+// ----------------------------------------------------------------------------
+// wxTaskFuture: allows to wait for the result of a task run by wxThreadPool
+// ----------------------------------------------------------------------------
+
+template <typename T>
+class wxTaskFuture
+{
+public:
+    // default ctor creates an invalid object, use wxThreadPool::Run() to get
+    // a valid one
+    wxTaskFuture() = default;
+
+    bool IsOk() const { return m_task != nullptr; }
+
+    // return true if the task has completed, successfully or not, or was
+    // cancelled
+    bool IsReady() const
+    {
+        wxCHECK_MSG( m_task, false, "invalid future" );
+
+        return m_task->IsDone();
+    }
+
+    bool IsCancelled() const
+    {
+        wxCHECK_MSG( m_task, false, "invalid future" );
+
+        return m_task->IsCancelled();
+    }
+
+    // cancel the task if it hasn't started running yet, return true if it
+    // was cancelled
+    bool Cancel()
+    {
+        wxCHECK_MSG( m_task, false, "invalid future" );
+
+        return m_task->Cancel();
+    }
+
+    // wait until the task is done, running other tasks of the same pool in
+    // the meanwhile
+    void Wait() const
+    {
+        wxCHECK_RET( m_task, "invalid future" );
+
+        m_task->Wait();
+    }
+
+    // wait until the task is done and return its result, the task must not
+    // have been cancelled
+    //
+    // if the task threw an exception, it is rethrown from here
+    T Get() const
+    {
+        Wait();
+
+        return DoGet(static_cast<T*>(nullptr));
+    }
+
+    // call the given function in the main thread, using wxApp::CallAfter(),
+    // once the task is done, this can be only called once for each task
+    void CallAfter(const std::function<void (const wxTaskFuture<T>&)>& func);
+
+private:
+    explicit wxTaskFuture(const std::shared_ptr<wxThreadPoolTask<T>>& task)
+        : m_task(task)
+    {
+    }
+
+    template <typename U>
+    U DoGet(U*) const
+    {
+        wxCHECK_MSG( !m_task->IsCancelled(), U(),
+                     "can't get the result of a cancelled task" );
+
+        m_task->RethrowIfFailed();
+
+        return m_task->GetResult();
+    }
+
+    void DoGet(void*) const
+    {
+        m_task->RethrowIfFailed();
+    }
+
+    std::shared_ptr<wxThreadPoolTask<T>> m_task;
+
+    friend class wxThreadPool;
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPool: runs tasks in a fixed number of worker threads
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolWorker;
+
+class WXDLLIMPEXP_BASE wxThreadPool
+{
+public:
+    // create a pool with the given number of threads or as many as there are
+    // CPUs if it is 0
+    explicit wxThreadPool(int numThreads = 0);
+
+    // waits until all the tasks submitted to the pool are done
+    ~wxThreadPool();
+
+    // get the global pool shared by the whole application
+    static wxThreadPool& Get();
+
+    // return the number of worker threads in this pool
+    int GetThreadCount() const { return static_cast<int>(m_workers.size()); }
+
+    // run the given function, taking no arguments, in one of the worker
+    // threads and return the future which can be used to retrieve its result
+    template <typename F>
+    auto Run(F&& func) -> wxTaskFuture<decltype(func())>
+    {
+        using Result = decltype(func());
+
+        std::shared_ptr<wxThreadPoolTask<Result>>
+            task(new wxThreadPoolTask<Result>(std::forward<F>(func)));
+
+        Submit(task);
+
+        return wxTaskFuture<Result>(task);
+    }
+
+    // call the given function for the consecutive subranges of [from, to) in
+    // parallel, using the calling thread and the pool threads, and return
+    // when all of them are done
+    //
+    // the range is split in at most the given number of chunks or as many as
+    // necessary to balance the load between the threads if it is 0
+    void ParallelFor(int from,
+                     int to,
+                     const std::function<void (int, int)>& func,
+                     int maxChunks = 0);
+
+    // return true if the task being executed in the current thread was asked
+    // to be cancelled
+    static bool TestCancel();
+
+    // call the given function in the main thread, used by wxTaskFuture only
+    static void CallInMainThread(const std::function<void ()>& func);
+
+private:
+    // add the task to the queue of the current worker, if we're called from
+    // one of our workers, or to the shared queue
+    void Submit(const std::shared_ptr<wxThreadPoolTaskBase>& task);
+
+    // find and run a queued task, return false if there are none
+    bool RunQueuedTask(wxThreadPoolWorker *worker);
+
+    // wait until the given task is done, running the other tasks meanwhile
+    void WaitFor(wxThreadPoolTaskBase& task);
+
+    // called when a task is done or cancelled
+    void OnTaskDone();
+
+    // main loop of the worker threads
+    void WorkerLoop(wxThreadPoolWorker *worker);
+
+
+    // the worker threads, each with its own queue
+    wxVector<wxThreadPoolWorker*> m_workers;
+
+    // the queue used for the tasks submitted from the other threads
+    class TaskQueue;
+    TaskQueue *m_sharedQueue = nullptr;
+
+    // the total number of tasks in all the queues
+    std::atomic<size_t> m_numQueued{0};
+
+    // the number of idle workers waiting for m_workAvailable and the number
+    // of threads waiting for some task to be done using m_taskDone
+    std::atomic<int> m_numIdle{0};
+    std::atomic<int> m_numWaiting{0};
+
+    // used to choose the worker to steal the tasks from
+    std::atomic<unsigned> m_nextVictim{0};
+
+    wxMutex m_mutex;
+    wxCondition m_workAvailable;
+    wxCondition m_taskDone;
+
+    // set when the pool is being destroyed
+    bool m_stopping = false;
+
+    friend class wxThreadPoolTaskBase;
+    friend class wxThreadPoolWorker;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPool);
+};
+
+// ----------------------------------------------------------------------------
+// inline functions implementation
+// ----------------------------------------------------------------------------
+
+template <typename T>
+inline void
+wxTaskFuture<T>::CallAfter(const std::function<void (const wxTaskFuture<T>&)>& func)
+{
+    wxCHECK_RET( m_task, "invalid future" );
+
+    const std::shared_ptr<wxThreadPoolTask<T>> task = m_task;
+    m_task->SetContinuation([task, func]()
+    {
+        wxThreadPool::CallInMainThread([task, func]()
+        {
+            func(wxTaskFuture<T>(task));
+        });
+    });
+}
+
+#endif // wxUSE_THREADS
+
+#endif // _WX_THREADPOOL_H_
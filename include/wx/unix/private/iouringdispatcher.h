@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/unix/private/iouringdispatcher.h
+// Purpose:     wxIoUringDispatcher class
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IOURINGDISPATCHER_H_
+#define _WX_PRIVATE_IOURINGDISPATCHER_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_EPOLL_DISPATCHER && defined(wxHAS_IO_URING)
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+
+// we need the system call numbers and the extended io_uring_enter() arguments
+// added in Linux 5.11, which may be missing from older headers
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_EXT_ARG)
+    #define wxHAS_IO_URING_DISPATCHER
+#endif
+
+#endif // wxUSE_EPOLL_DISPATCHER && wxHAS_IO_URING
+
+#ifdef wxHAS_IO_URING_DISPATCHER
+
+#include "wx/private/fdiodispatcher.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+#include <unordered_map>
+
+// This dispatcher uses io_uring poll requests instead of epoll_ctl() and
+// epoll_wait(): the changes to the registered descriptors are queued and
+// submitted together with the request to wait for the events, and the events
+// which are already available are retrieved without any system calls at all.
+//
+// Dispatch() may only be called from a single thread, but the descriptors
+// may be registered, modified and unregistered from any thread, as with
+// wxEpollDispatcher: the requests queued while Dispatch() is blocked are
+// submitted immediately.
+class WXDLLIMPEXP_BASE wxIoUringDispatcher : public wxFDIODispatcher
+{
+public:
+    // create a new instance of this class, can return nullptr if io_uring is
+    // not supported by the running kernel or disabled on this system
+    //
+    // the caller should delete the returned pointer
+    static wxIoUringDispatcher *Create();
+
+    virtual ~wxIoUringDispatcher();
+
+    // implement base class pure virtual methods
+    virtual bool RegisterFD(int fd, wxFDIOHandler* handler, int flags = wxFDIO_ALL) override;
+    virtual bool ModifyFD(int fd, wxFDIOHandler* handler, int flags = wxFDIO_ALL) override;
+    virtual bool UnregisterFD(int fd) override;
+    virtual bool HasPending() const override;
+    virtual int Dispatch(int timeout = TIMEOUT_INFINITE) override;
+
+private:
+    // information about a registered descriptor
+    struct FDInfo
+    {
+        wxFDIOHandler *handler = nullptr;
+        int flags = 0;
+
+        // incremented every time a new poll request is made for this
+        // descriptor to recognize the completions of the old ones
+        wxUint32 generation = 0;
+
+        // true if there is a poll request for this descriptor in progress
+        bool armed = false;
+    };
+
+    using FDInfoMap = std::unordered_map<int, FDInfo>;
+
+    // a completed request copied from the completion queue
+    struct Completion
+    {
+        wxUint64 userData;
+        int result;
+    };
+
+    // ctor is private, use Create()
+    explicit wxIoUringDispatcher(int ringDescriptor);
+
+    // map the submission and completion queues into our address space
+    bool MapRings(const io_uring_params& params);
+
+    // add a request to the submission queue without submitting it
+    bool QueueRequest(const io_uring_sqe& sqe);
+
+    // queue a request to poll the given descriptor or to cancel such request
+    bool QueuePoll(int fd, FDInfo& info);
+    bool QueuePollRemove(int fd, const FDInfo& info);
+
+    // call io_uring_enter() to submit all the queued requests and, possibly,
+    // wait for completions
+    int Enter(unsigned minComplete,
+              unsigned flags = 0,
+              const io_uring_getevents_arg *arg = nullptr) const;
+
+    // submit the queued requests, if any, without waiting
+    void Submit() const;
+
+    // submit the queued requests and wait for completions for up to the
+    // given time, return false on error
+    bool DoWait(int timeout);
+
+    // helper of DoWait() called without locking
+    bool WaitForCompletions(int timeout) const;
+
+    // return true if the completion queue is not empty
+    bool HasCompletions() const;
+
+
+    int m_ringDescriptor;
+
+    // the memory shared with the kernel: rings and submission queue entries
+    void *m_ring = nullptr;
+    size_t m_ringSize = 0;
+    io_uring_sqe *m_sqes = nullptr;
+    size_t m_sqesSize = 0;
+
+    // pointers into m_ring
+    unsigned *m_sqHead = nullptr;
+    unsigned *m_sqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned m_sqEntries = 0;
+    unsigned *m_cqHead = nullptr;
+    unsigned *m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe *m_cqes = nullptr;
+
+    // all the registered descriptors
+    FDInfoMap m_fds;
+
+    // the last used generation value
+    wxUint32 m_generation = 0;
+
+    // buffer reused by Dispatch() to avoid allocating it every time
+    wxVector<Completion> m_completions;
+
+    // true while Dispatch() is blocked waiting for the completions
+    bool m_waiting = false;
+
+#if wxUSE_THREADS
+    // protects all the fields above which are not constant after creation
+    mutable wxCriticalSection m_cs;
+#endif // wxUSE_THREADS
+
+    wxDECLARE_NO_COPY_CLASS(wxIoUringDispatcher);
+};
+
+#endif // wxHAS_IO_URING_DISPATCHER
+
+#endif // _WX_PRIVATE_IOURINGDISPATCHER_H_
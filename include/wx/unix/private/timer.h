@@ -13,8 +13,7 @@
 #if wxUSE_TIMER
 
 #include "wx/private/timer.h"
-
-#include <list>
+#include "wx/vector.h"
 
 // the type used for milliseconds is large enough for microseconds too but
 // introduce a synonym for it to avoid confusion
@@ -45,8 +44,17 @@ public:
         m_isRunning = false;
     }
 
+    // the value of m_heapIndex for the timers not in wxTimerScheduler
+    static constexpr size_t NOT_SCHEDULED = static_cast<size_t>(-1);
+
 private:
     bool m_isRunning;
+
+    // the position of this timer in wxTimerScheduler heap or NOT_SCHEDULED,
+    // allows to remove a timer without searching for it
+    size_t m_heapIndex;
+
+    friend class wxTimerScheduler;
 };
 
 // ----------------------------------------------------------------------------
@@ -61,15 +69,34 @@ struct wxTimerSchedule
     {
     }
 
+    // return true if this timer must be notified before the other one: timers
+    // expiring at the same time are notified in the order they were added
+    bool IsBefore(const wxTimerSchedule& other) const
+    {
+        if ( m_expiration != other.m_expiration )
+            return m_expiration < other.m_expiration;
+
+        return m_sequence < other.m_sequence;
+    }
+
     // the timer itself (we don't own this pointer)
     wxUnixTimerImpl *m_timer;
 
     // the time of its next expiration, in usec
     wxUsecClock_t m_expiration;
+
+    // the number of the timers scheduled before this one, used to order the
+    // timers with the same expiration time
+    wxUint64 m_sequence = 0;
 };
 
-// the linked list of all active timers, we keep it sorted by expiration time
-using wxTimerList = std::list<wxTimerSchedule>;
+// all active timers, stored as a binary min-heap ordered by expiration time
+using wxTimerHeap = wxVector<wxTimerSchedule>;
+
+#if wxUSE_EPOLL_DISPATCHER
+    // epoll is only available under Linux, where timerfd is available too
+    class wxTimerFDHandler;
+#endif // wxUSE_EPOLL_DISPATCHER
 
 // ----------------------------------------------------------------------------
 // wxTimerScheduler: class responsible for updating all timers
@@ -97,10 +124,10 @@ public:
         }
     }
 
-    // adds timer which should expire at the given absolute time to the list
+    // adds timer which should expire at the given absolute time
     void AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration);
 
-    // remove timer from the list, called automatically from timer dtor
+    // remove timer from the scheduler, called automatically from timer dtor
     void RemoveTimer(wxUnixTimerImpl *timer);
 
 
@@ -117,18 +144,50 @@ public:
     // if any did
     bool NotifyExpired();
 
+    // return true if the scheduler wakes up the event loop on its own when
+    // the next timer expires, in which case the event loop doesn't need to
+    // limit its timeout using GetNext()
+    bool UsesTimerFD() const
+    {
+#if wxUSE_EPOLL_DISPATCHER
+        return m_timerFD != nullptr;
+#else
+        return false;
+#endif
+    }
+
 private:
     // ctor and dtor are private, this is a singleton class only created by
     // Get() and destroyed by Shutdown()
-    wxTimerScheduler() = default;
-    ~wxTimerScheduler() = default;
+    wxTimerScheduler();
+    ~wxTimerScheduler();
+
+    // add the given timer schedule to the heap
+    void DoAddTimer(wxTimerSchedule s);
+
+    // remove the timer at the given position from the heap
+    void DoRemoveAt(size_t n);
+
+    // helpers for maintaining the heap invariant
+    void PlaceAt(size_t n, const wxTimerSchedule& s);
+    void SiftUp(size_t n);
+    void SiftDown(size_t n);
+
+    // arm the timer descriptor, if any, to expire with the first timer
+    void UpdateTimerFD();
+
 
-    // add the given timer schedule to the list in the right place
-    void DoAddTimer(const wxTimerSchedule& s);
+    // all currently active timers, the one expiring first is at the top
+    wxTimerHeap m_timers;
 
+    // the sequence number of the next timer added to m_timers
+    wxUint64 m_nextSequence = 0;
 
-    // the list of all currently active timers sorted by expiration
-    wxTimerList m_timers;
+#if wxUSE_EPOLL_DISPATCHER
+    // the timer descriptor waking up the event loop or null if we failed to
+    // create it and the event loop must use GetNext() instead
+    wxTimerFDHandler *m_timerFD = nullptr;
+#endif // wxUSE_EPOLL_DISPATCHER
 
     static wxTimerScheduler *ms_instance;
 };
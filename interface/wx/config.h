@@ -60,7 +60,24 @@ enum
 
         @since 3.3.0
      */
-    wxCONFIG_USE_HOME = 64
+    wxCONFIG_USE_HOME = 64,
+
+    /**
+        Save the changes to a journal instead of rewriting the whole file.
+
+        This flag is only used by wxFileConfig. If it is set, wxFileConfig::Flush()
+        appends only the changes made since the previous flush to a journal file
+        next to the local file. The local file itself is rewritten, and the
+        journal is removed, when the object is destroyed or when the journal
+        becomes bigger than the local file. This is more efficient for
+        programs that change a few values in a big file often.
+
+        The journal is always applied when the file is read, even if this flag
+        is not used.
+
+        @since 3.3.3
+     */
+    wxCONFIG_USE_JOURNAL = 128
 };
 
 
@@ -109,6 +109,51 @@ public:
     */
     void AddNotifier(wxDataViewModelNotifier* notifier);
 
+    /**
+        Starts a batch of changes to the model.
+
+        All notifications sent by the model, e.g. ItemAdded(), ItemDeleted()
+        or ValueChanged(), until the matching call to EndBatch() may be
+        accumulated by the control instead of being processed immediately.
+        The control is then updated only once when the batch ends, which is
+        much more efficient when many items change at once.
+
+        The calls to BeginBatch() and EndBatch() must be balanced but may be
+        nested, in which case only the outermost batch is taken into account.
+
+        Notice that the control may not reflect the current state of the model
+        while the batch is in progress, so the application shouldn't query it
+        (or let it process any events, e.g. by calling wxYield()) before
+        calling EndBatch().
+
+        Currently only the generic implementation of wxDataViewCtrl makes use
+        of the batches, the changes are still applied immediately in the
+        native ones.
+
+        @see wxDataViewModelNotifier::BeginBatch()
+
+        @since 3.3.3
+    */
+    void BeginBatch();
+
+    /**
+        Ends a batch of changes started by BeginBatch().
+
+        If this is the outermost batch, the control is updated to reflect all
+        the changes made during it.
+
+        @since 3.3.3
+    */
+    void EndBatch();
+
+    /**
+        Returns @true if BeginBatch() had been called without the matching
+        EndBatch() yet.
+
+        @since 3.3.3
+    */
+    bool IsBatching() const;
+
     /**
         Change the value of the given item and update the control to reflect
         it.
@@ -361,6 +406,10 @@ public:
 
     /**
         Remove the @a notifier from the list of notifiers.
+
+        If this is called during a batch of changes, i.e. after BeginBatch()
+        but before the matching EndBatch(), wxDataViewModelNotifier::EndBatch()
+        is called for the notifier before removing it.
     */
     void RemoveNotifier(wxDataViewModelNotifier* notifier);
 
@@ -1790,11 +1839,32 @@ public:
     */
     virtual ~wxDataViewModelNotifier();
 
+    /**
+        Called by owning model when the outermost batch of changes starts.
+
+        The notifier may defer processing the notifications received until
+        EndBatch() is called. The default implementation does nothing.
+
+        @see wxDataViewModel::BeginBatch()
+
+        @since 3.3.3
+    */
+    virtual void BeginBatch();
+
     /**
         Called by owning model.
     */
     virtual bool Cleared() = 0;
 
+    /**
+        Called by owning model when the outermost batch of changes ends.
+
+        The default implementation does nothing.
+
+        @since 3.3.3
+    */
+    virtual void EndBatch();
+
     /**
         Get owning wxDataViewModel.
     */
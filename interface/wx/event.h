@@ -178,6 +178,34 @@ public:
     */
     bool GetSkipped() const;
 
+    /**
+        Returns @true if this event can be coalesced with the other events.
+
+        @see SetCoalescable()
+
+        @since 3.3.3
+    */
+    bool IsCoalescable() const;
+
+    /**
+        Allows coalescing this event with the other pending events.
+
+        When a coalescable event is queued using wxEvtHandler::QueueEvent()
+        while another coalescable event with the same event type, identifier
+        and event object is still pending for the same handler, the older
+        event is replaced with the new one, which takes its position in the
+        queue. This is useful for the events which only carry the latest
+        state of something, such as the progress notifications sent by a
+        worker thread, as it ensures that only the most recent state is
+        delivered and that the number of pending events remains bounded even
+        if they are queued faster than they can be processed.
+
+        The events are not coalescable by default.
+
+        @since 3.3.3
+    */
+    void SetCoalescable(bool coalescable = true);
+
     /**
         Gets the timestamp for the event. The timestamp is the time in milliseconds
         since some fixed moment (not necessarily the standard Unix Epoch, so only
@@ -446,6 +474,10 @@ public:
             }
         @endcode
 
+        If the events are queued faster than they can be processed and only
+        the latest one of them matters, wxEvent::SetCoalescable() can be used
+        to replace the pending event with the new one instead of queuing it.
+
         Finally, notice that this method automatically wakes up the event loop
         if it is currently idle by calling ::wxWakeUpIdle() so there is no need
         to do it manually when using it.
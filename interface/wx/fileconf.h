@@ -37,6 +37,16 @@
     default file path to `~/.config/appname/appname.conf` -- and allow the
     program to store other files in the same `~/.config/appname` directory.
 
+    @section fileconf_journal Saving Changes Incrementally
+
+    By default, Flush() rewrites the whole local file. Programs which have big
+    configuration files and save a few changed values often may use the
+    ::wxCONFIG_USE_JOURNAL style to only append the changes to a journal file
+    with the same name as the local file and `.journal` extension instead. The
+    journal is applied when the file is read and merged into the file, which
+    is then rewritten, when wxFileConfig is destroyed or when the journal
+    becomes bigger than the file itself.
+
     @library{wxbase}
     @category{cfg}
 
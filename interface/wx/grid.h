@@ -1401,6 +1401,18 @@ public:
     */
     bool IsReadOnly() const;
 
+    /**
+        Returns @true if this attribute has the same values as the other one.
+
+        The renderers and editors are compared by identity, i.e. the
+        attributes must use the same renderer and editor objects to be
+        considered equal. Attributes with any client data associated with
+        them are never considered to be the same.
+
+        @since 3.3.3
+    */
+    bool IsSameAs(const wxGridCellAttr& other) const;
+
     /**
         Sets the alignment. @a hAlign can be one of @c wxALIGN_LEFT,
         @c wxALIGN_CENTRE or @c wxALIGN_RIGHT and @a vAlign can be one of
@@ -1736,6 +1748,13 @@ public:
         or column (set with SetRowAttr() or SetColAttr() respectively), with
         the cell attribute having the highest precedence.
 
+        If wxGridCellAttr::Cell is used, the returned attribute can be
+        modified to change the appearance of this cell only: the default
+        implementation may use a single attribute object for adjacent cells
+        with equal attributes and gives the cell its own copy of the
+        attribute in this case. Cells for which the same attribute object was
+        explicitly set with SetAttr() still share it.
+
         Notice that the caller must call DecRef() on the returned pointer if it
         is non-null. GetAttrPtr() method can be used to do this automatically.
 
@@ -2820,6 +2839,50 @@ struct wxGridSizesInfo
 
 
 
+/**
+    @class wxGridAutoSizeSample
+
+    wxGridAutoSizeSample describes the cells measured by wxGrid auto-sizing
+    functions in wxGRID_AUTOSIZE_SAMPLE mode.
+
+    When auto-sizing a column, the cells in the selected rows are measured,
+    and when auto-sizing a row, the cells in the selected columns are. The
+    lines used always include the first and last ones, the given number of
+    lines chosen randomly, but with approximately the same distance between
+    them, in between and, optionally, all the currently visible lines.
+
+    @see wxGrid::SetAutoSizeSample()
+
+    @library{wxcore}
+    @category{grid}
+
+    @since 3.3.3
+ */
+struct wxGridAutoSizeSample
+{
+    /**
+        Constructor initializing all fields.
+     */
+    wxGridAutoSizeSample(int head = 100,
+                         int tail = 100,
+                         int random = 1000,
+                         bool visible = true);
+
+    /// Number of the first rows or columns to measure.
+    int m_head;
+
+    /// Number of the last rows or columns to measure.
+    int m_tail;
+
+    /// Number of the randomly chosen rows or columns to measure.
+    int m_random;
+
+    /// If @true, also measure all currently visible rows or columns.
+    bool m_visible;
+};
+
+
+
 /**
     Rendering styles supported by wxGrid::Render() method.
 
@@ -2864,6 +2927,44 @@ enum wxGridRenderStyle
                           wxGRID_DRAW_BOX_RECT
 };
 
+/**
+    Flags used with wxGrid::SetAutoSizeMode() to select how the cells are
+    measured when auto-sizing rows or columns.
+
+    @since 3.3.3
+ */
+enum wxGridAutoSizeMode
+{
+    /// Measure all cells, this is the default.
+    wxGRID_AUTOSIZE_ALL = 0x000,
+
+    /**
+        Measure only the cells in the rows or columns selected by
+        wxGrid::SetAutoSizeSample().
+
+        This is much faster for big grids, but the resulting size may be too
+        small if the widest cell is not part of the sample.
+     */
+    wxGRID_AUTOSIZE_SAMPLE = 0x001,
+
+    /**
+        Measure the text of the cells using the standard string renderer in
+        several threads.
+
+        The widths of all characters of the cell font are measured once and
+        used to compute the size of the cells text in the threads of the
+        global wxThreadPool returned by wxThreadPool::Get(), so
+        this only works for the cells using wxGridCellStringRenderer itself
+        and not any class deriving from it, and not spanning multiple cells.
+        All the other cells are still measured in the main thread. Notice that
+        this mode doesn't take kerning into account, so the resulting size
+        may be slightly different from the one computed without using it.
+
+        This flag may be combined with wxGRID_AUTOSIZE_SAMPLE.
+     */
+    wxGRID_AUTOSIZE_PARALLEL = 0x002
+};
+
 
 
 /**
@@ -4087,6 +4188,41 @@ public:
     */
     void AutoSizeRows(bool setAsMin = true);
 
+    /**
+        Sets how the cells are measured by the auto-sizing functions.
+
+        By default all cells are measured, which may be very slow for grids
+        with many rows or columns. Use wxGRID_AUTOSIZE_SAMPLE to measure only
+        some of them and/or wxGRID_AUTOSIZE_PARALLEL to measure them faster.
+
+        @param mode
+            Combination of wxGridAutoSizeMode flags.
+
+        @since 3.3.3
+     */
+    void SetAutoSizeMode(int mode);
+
+    /**
+        Returns the mode set by SetAutoSizeMode().
+
+        @since 3.3.3
+     */
+    int GetAutoSizeMode() const;
+
+    /**
+        Selects the cells measured in wxGRID_AUTOSIZE_SAMPLE mode.
+
+        @since 3.3.3
+     */
+    void SetAutoSizeSample(const wxGridAutoSizeSample& sample);
+
+    /**
+        Returns the value set by SetAutoSizeSample().
+
+        @since 3.3.3
+     */
+    const wxGridAutoSizeSample& GetAutoSizeSample() const;
+
     /**
         Returns the cell fitting mode.
 
@@ -5799,6 +5935,79 @@ public:
     */
     void ForceRefresh();
 
+    /**
+        Enables or disables deferring the refresh of the changed cells.
+
+        By default, SetCellValue() refreshes the cell, or the entire row
+        containing it if the cell contents can overflow into the adjacent
+        cells, immediately. This is fine when only a few cells change at once,
+        but if many cells are changed very often, e.g. when showing real time
+        data, refreshing each of them separately becomes expensive.
+
+        When deferred refresh is enabled, the grid only remembers the changed
+        cells and refreshes all of them at once during the next event loop
+        iteration, merging the adjacent cells into rectangular blocks and
+        ignoring the cells which are not currently visible. Notice that the
+        cells whose text can overflow still result in refreshing the entire
+        row, so it is recommended to disable overflow, e.g. by calling
+        SetDefaultCellOverflow() with @false, when using this feature.
+
+        Call FlushDeferredRefresh() to refresh the changed cells immediately,
+        e.g. before calling wxWindow::Update().
+
+        @see UseBackBuffer()
+
+        @since 3.3.3
+    */
+    void EnableDeferredRefresh(bool enable = true);
+
+    /**
+        Returns @true if deferred refresh is enabled.
+
+        @see EnableDeferredRefresh()
+
+        @since 3.3.3
+    */
+    bool IsDeferredRefreshEnabled() const;
+
+    /**
+        Refreshes the cells changed since the last refresh immediately.
+
+        Does nothing unless deferred refresh is enabled.
+
+        @see EnableDeferredRefresh()
+
+        @since 3.3.3
+    */
+    void FlushDeferredRefresh();
+
+    /**
+        Enables or disables using the back buffer for drawing the grid.
+
+        When the back buffer is used, the grid keeps the bitmap with its
+        contents and only redraws the parts of it that were refreshed since the
+        last repaint, just copying the rest of it to the screen. This makes
+        repainting the grid when it is exposed, e.g. after being covered by
+        another window, much cheaper, at the expense of using the memory for
+        the bitmap of the size of the grid window.
+
+        Notice that scrolling the grid still redraws its entire visible area.
+
+        @see EnableDeferredRefresh()
+
+        @since 3.3.3
+    */
+    void UseBackBuffer(bool use = true);
+
+    /**
+        Returns @true if the back buffer is used for drawing the grid.
+
+        @see UseBackBuffer()
+
+        @since 3.3.3
+    */
+    bool IsUsingBackBuffer() const;
+
     /**
         Returns the number of times that BeginBatch() has been called without
         (yet) matching calls to EndBatch(). While the grid's batch count is
@@ -52,6 +52,17 @@ enum wxImageResizeQuality
     */
     wxIMAGE_QUALITY_BOX_AVERAGE,
 
+    /**
+        Lanczos resampling algorithm.
+
+        This algorithm produces sharper results than wxIMAGE_QUALITY_BICUBIC
+        both when enlarging and reducing the image size, while being faster
+        than it.
+
+        @since 3.3.3
+     */
+    wxIMAGE_QUALITY_LANCZOS,
+
     /**
         Default image resizing algorithm used by wxImage::Scale().
 
@@ -175,6 +186,109 @@ enum
 };
 
 
+/**
+    @class wxImageRowSink
+
+    Abstract base class for the objects receiving the image rows when using
+    wxImageHandler::LoadRows().
+
+    This allows to process the images too big to fit into memory, e.g. to
+    compute some statistics about them or to write them to another file, as
+    the handlers supporting it only keep a few rows of the image in memory.
+
+    @library{wxcore}
+    @category{gdi}
+
+    @since 3.3.3
+*/
+class wxImageRowSink
+{
+public:
+    /// Default constructor.
+    wxImageRowSink();
+
+    /// Trivial but virtual destructor.
+    virtual ~wxImageRowSink();
+
+    /**
+        Called once before ProcessRow() is called for any rows.
+
+        @param width
+            The width of the image, possibly reduced, in pixels.
+        @param height
+            The height of the image, possibly reduced, in pixels.
+        @param hasAlpha
+            @true if the image has alpha channel. If this parameter is @true,
+            ProcessRow() may still be called with null alpha pointer, meaning
+            that all pixels in this row are opaque.
+        @return @true to continue loading or @false to stop it, which makes
+            wxImageHandler::LoadRows() return @false.
+    */
+    virtual bool Start(int width, int height, bool hasAlpha) = 0;
+
+    /**
+        Called for every row of the image, from top to bottom.
+
+        @param y
+            The index of the row, starting from 0.
+        @param data
+            RGB data of the row, with 3*width bytes in it. The pointer is only
+            valid during this function execution.
+        @param alpha
+            Alpha channel of the row with width bytes in it or null.
+        @return @true to continue loading or @false to stop it, which makes
+            wxImageHandler::LoadRows() return @false.
+    */
+    virtual bool ProcessRow(int y,
+                            const unsigned char* data,
+                            const unsigned char* alpha) = 0;
+};
+
+
+/**
+    @class wxDetectedImageHeader
+
+    The first bytes of a stream whose image format is being determined.
+
+    Objects of this class are created by wxImage when loading an image without
+    specifying its type and passed to wxImageHandler::CanRead() for all the
+    handlers, so that the header is read from the stream only once.
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImageHandler::DoCanReadDetected()
+
+    @since 3.3.3
+*/
+class wxDetectedImageHeader
+{
+public:
+    /**
+        Constructor.
+
+        @param stream
+            The stream positioned at the start of the image, the header must
+            not have been consumed from it.
+        @param data
+            The first bytes of the stream, may be @NULL only if @a len is 0.
+        @param len
+            The number of bytes in @a data, which may be less than needed by
+            the handler if the stream is too short.
+    */
+    wxDetectedImageHeader(wxInputStream& stream, const void* data, size_t len);
+
+    /// Returns the stream containing the image.
+    wxInputStream& GetStream() const;
+
+    /// Returns the first bytes of the stream.
+    const void* GetData() const;
+
+    /// Returns the number of bytes returned by GetData().
+    size_t GetLength() const;
+};
+
+
 /**
     @class wxImageHandler
 
@@ -257,6 +371,53 @@ public:
     */
     bool CanRead( const wxString& filename );
 
+    /**
+        Returns @true if this handler supports the image format contained in the
+        stream with the given header.
+
+        This function is used by wxImage to determine the image format and
+        calls DoCanReadDetected(), see its description for more details.
+
+        @since 3.3.3
+    */
+    bool CanRead( const wxDetectedImageHeader& header );
+
+    /**
+        Returns the number of bytes at the start of the image needed by
+        CanReadHeader().
+
+        Returns 0 if this handler can't recognize its images by looking at
+        their header alone, which is the default. The handlers overriding
+        this function must also override DoCanReadHeader().
+
+        When loading an image without specifying its type, wxImage reads the
+        header of the image only once and, for all handlers for which this
+        function returns non-zero value, DoCanRead() reads it from memory
+        instead of the stream, see DoCanReadDetected(). This is faster than
+        using CanRead() with the stream for all of them and also works for
+        non-seekable streams.
+
+        @since 3.3.3
+    */
+    virtual size_t GetHeaderSize() const;
+
+    /**
+        Returns @true if the image header is in the format supported by this
+        handler.
+
+        This function must only be called for the handlers for which
+        GetHeaderSize() returns a non-zero value.
+
+        @param header
+            The first bytes of the image, must be non-null.
+        @param len
+            The number of bytes in @a header. If it is less than the value
+            returned by GetHeaderSize(), this function returns @false.
+
+        @since 3.3.3
+    */
+    bool CanReadHeader(const void* header, size_t len) const;
+
     /**
         Gets the preferred file extension associated with this handler.
 
@@ -330,6 +491,99 @@ public:
     virtual bool LoadFile(wxImage* image, wxInputStream& stream,
                           bool verbose = true, int index = -1);
 
+    /**
+        Loads an image from a stream passing its rows to the given sink.
+
+        Unlike LoadFile(), this function doesn't need to store the entire
+        image in memory when using the handlers that support loading images
+        row by row, which is currently the case for JPEG, PNG (except for the
+        interlaced images) and TIFF (for the most common image types) ones. For
+        the other handlers, the image is loaded using LoadFile() and its rows
+        are passed to the sink after it.
+
+        The image can also be reduced while loading it by the given @a scale
+        factor, which must be a power of 2. JPEG handler uses libjpeg ability
+        to decode the image at smaller size in this case, while for the
+        other formats the pixels in each scale*scale block are averaged.
+
+        Here is an example of computing the average brightness of a huge
+        image:
+        @code
+        class BrightnessSink : public wxImageRowSink
+        {
+        public:
+            bool Start(int width, int WXUNUSED(height),
+                       bool WXUNUSED(hasAlpha)) override
+            {
+                m_rowSize = 3 * width;
+                return true;
+            }
+
+            bool ProcessRow(int WXUNUSED(y), const unsigned char* data,
+                            const unsigned char* WXUNUSED(alpha)) override
+            {
+                for ( int n = 0; n < m_rowSize; n++ )
+                    m_sum += data[n];
+                m_count += m_rowSize;
+                return true;
+            }
+
+            double GetAverage() const { return m_sum / m_count; }
+
+        private:
+            int m_rowSize = 0;
+            double m_sum = 0,
+                   m_count = 0;
+        };
+
+        wxFileInputStream stream("huge.png");
+        BrightnessSink sink;
+        wxImage::FindHandler(wxBITMAP_TYPE_PNG)->LoadRows(sink, stream);
+        @endcode
+
+        @param sink
+            The object receiving the image rows.
+        @param stream
+            Opened input stream for reading image data.
+        @param scale
+            The factor by which the image should be reduced, 1 by default.
+            If the image size is not a multiple of @a scale, the reduced size
+            is rounded down, except that it is never less than 1.
+        @param verbose
+            If set to @true, errors reported by the image handler will produce
+            wxLogMessages.
+        @param index
+            The index of the image in the file (starting from zero).
+
+        @return @true if the operation succeeded, @false otherwise, including
+            if the sink stopped loading.
+
+        @since 3.3.3
+    */
+    bool LoadRows(wxImageRowSink& sink, wxInputStream& stream,
+                  int scale = 1, bool verbose = true, int index = -1);
+
+    /**
+        Returns the power of 2 by which the image of the given size needs to
+        be reduced to fit into the given maximal size.
+
+        This helper is used by the handlers to support
+        @c wxIMAGE_OPTION_MAX_WIDTH and @c wxIMAGE_OPTION_MAX_HEIGHT options.
+
+        @param width
+            The width of the image.
+        @param height
+            The height of the image.
+        @param maxWidth
+            The maximal width or 0 if there is no limit.
+        @param maxHeight
+            The maximal height or 0 if there is no limit.
+
+        @since 3.3.3
+    */
+    static int GetScaleForMaxSize(unsigned width, unsigned height,
+                                  unsigned maxWidth, unsigned maxHeight);
+
     /**
         Saves an image in the output stream.
 
@@ -425,6 +679,45 @@ protected:
              since CallDoCanRead() will take care of restoring it later
     */
     virtual bool DoCanRead( wxInputStream& stream ) = 0;
+
+    /**
+       Called by CanReadHeader() to check the image header.
+
+       This function is only called if GetHeaderSize() returns non-zero value
+       and @a header contains at least this number of bytes.
+
+       @since 3.3.3
+    */
+    virtual bool DoCanReadHeader(const unsigned char* header) const;
+
+    /**
+       Called by CanRead() to test if this handler can read an image from the
+       stream whose header was already read.
+
+       If GetHeaderSize() returns non-zero value, the default implementation
+       calls DoCanRead() with a memory stream containing just the header. If
+       DoCanRead() tries to read past its end, e.g. because it is overridden
+       in a derived class and needs more data, or if GetHeaderSize() returns
+       0, DoCanRead() is called with the original stream, which must be
+       seekable for this to work, as with CanRead().
+
+       The derived classes can override this function to check the header
+       directly.
+
+       @since 3.3.3
+    */
+    virtual bool DoCanReadDetected(const wxDetectedImageHeader& header);
+
+    /**
+       Called by LoadRows() to load the image row by row.
+
+       The default implementation loads the entire image using LoadFile(), the
+       derived classes should override it if they can avoid doing this.
+
+       @since 3.3.3
+    */
+    virtual bool DoLoadRows(wxImageRowSink& sink, wxInputStream& stream,
+                            int scale, bool verbose, int index);
 };
 
 
@@ -1069,6 +1362,48 @@ public:
     wxImage Size(const wxSize& size, const wxPoint& pos, int red = -1,
                  int green = -1, int blue = -1) const;
 
+    /**
+        Sets the maximal number of threads used for image processing.
+
+        By default, all image processing is done in the calling thread, but
+        Scale() and the resampling functions used by it, as well as Blur(),
+        BlurHorizontal() and BlurVertical() can split the image in bands of
+        lines processed by several worker threads in parallel if this function
+        is called with @a count different from 1. The result is exactly the
+        same as when using a single thread.
+
+        The work is done by the threads of the global wxThreadPool, so the
+        number of threads actually used is also limited by its size.
+
+        Notice that threads are only used for sufficiently big images, as the
+        overhead of using them is not worth it for the small ones.
+
+        This function should be called only once, during the program
+        initialization, and not while any images are being processed.
+
+        @param count
+            The maximal number of threads to use, including the calling one,
+            or 0 to use as many threads as there are CPUs in the system (see
+            wxThread::GetCPUCount()). Setting it to 1 disables using threads.
+            This parameter is ignored if wxUSE_THREADS is 0.
+
+        @see GetMaxThreads()
+
+        @since 3.3.3
+    */
+    static void SetMaxThreads(int count);
+
+    /**
+        Returns the maximal number of threads used for image processing.
+
+        The default value is 1, meaning that no additional threads are used.
+
+        @see SetMaxThreads()
+
+        @since 3.3.3
+    */
+    static int GetMaxThreads();
+
     ///@}
 
 
@@ -1371,8 +1706,8 @@ public:
             max width given if it is not 0 @em and its height is less than the
             max height given if it is not 0. This is typically used for loading
             thumbnails and the advantage of using these options compared to
-            calling Rescale() after loading is that some handlers (only JPEG
-            one right now) support rescaling the image during loading which is
+            calling Rescale() after loading is that some handlers (JPEG, PNG
+            and TIFF ones) support rescaling the image during loading which is
             vastly more efficient than loading the entire huge image and
             rescaling it later (if these options are not supported by the
             handler, this is still what happens however). These options must be
@@ -1608,6 +1943,12 @@ public:
         @remarks Depending on how wxWidgets has been configured, not all formats
                  may be available.
 
+        @remarks Since wxWidgets 3.3.3, the format can be autodetected even
+                 when loading from a non-seekable stream if it can be
+                 recognized using just the image header, which is the case for
+                 BMP, CUR, GIF, ICO, IFF, JPEG, PCX, PNG, TGA, TIFF, WebP and
+                 XPM formats, see wxImageHandler::GetHeaderSize().
+
         @note
             You can use GetOptionInt() to get the hotspot when loading cursor files:
             @code
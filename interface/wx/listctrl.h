@@ -113,6 +113,19 @@ enum
     wxLIST_FIND_RIGHT
 };
 
+/**
+    Flags for wxListCtrl::SortItemsByColumn() (generic version only).
+
+    @since 3.3.3
+*/
+enum
+{
+    wxLIST_SORT_TEXT       = 0,     ///< Compare items text.
+    wxLIST_SORT_NOCASE     = 1,     ///< Ignore case when comparing text.
+    wxLIST_SORT_NUMERIC    = 2,     ///< Compare items as numbers.
+    wxLIST_SORT_DESCENDING = 4      ///< Sort in descending order.
+};
+
 
 
 
@@ -968,6 +981,29 @@ public:
                       int format = wxLIST_FORMAT_LEFT,
                       int width = wxLIST_AUTOSIZE);
 
+    /**
+        Appends many items to the control at once.
+
+        Each element of @a rows contains the texts of the columns of a new
+        item, with extra strings ignored and missing ones left empty. This is
+        much faster than calling InsertItem() and SetItem() for each of them
+        as the control is laid out and refreshed only once and the widths of
+        the columns are computed only if they are needed.
+
+        A @c wxEVT_LIST_INSERT_ITEM event is still sent for each new item. If
+        the items are kept sorted by SortItemsByColumn(), the new items are
+        inserted at their sorted positions, otherwise they are appended at
+        the end.
+
+        This function can't be used with virtual controls.
+
+        @note It is currently only implemented in the generic version, i.e.
+              in wxGenericListCtrl and in wxListCtrl in the ports using it.
+
+        @since 3.3.3
+    */
+    void AppendItems(const wxVector<wxArrayString>& rows);
+
     /**
         Inserts an item, returning the index of the new item if successful, -1 otherwise.
 
@@ -1370,6 +1406,47 @@ public:
     */
     bool SortItems(wxListCtrlCompare fnSortCallBack, wxIntPtr data);
 
+    /**
+        Sorts the items by the contents of the given column.
+
+        Unlike SortItems(), this function doesn't require associating any
+        data with the items, and it computes the sort key of each item only
+        once, making it more efficient for big controls. The sort is stable,
+        so items with equal keys keep their relative order.
+
+        After calling this function, the control keeps the items sorted:
+        items added by InsertItem() or AppendItems() are put at their sorted
+        position, after all the existing items with the same key, instead of
+        the position specified for them. Changing the text of an existing
+        item in the sort column, e.g. with SetItem(), moves it to its new
+        sorted position too, so the index of the item may change after such
+        call. This notably happens when the items are added by calling
+        InsertItem() and then SetItem() for the other columns, as the new
+        item is initially inserted as if it had an empty value in the sort
+        column if it is not the first one. Call this function with
+        @c wxNOT_FOUND column to stop keeping the items sorted, calling
+        SortItems() or deleting the sort column does it too.
+
+        As with SortItems(), the selection and the current item are reset.
+
+        @param col
+            The index of the column to sort by or @c wxNOT_FOUND.
+        @param flags
+            Combination of @c wxLIST_SORT_NOCASE, @c wxLIST_SORT_NUMERIC
+            and @c wxLIST_SORT_DESCENDING, or the default @c wxLIST_SORT_TEXT.
+            With @c wxLIST_SORT_NUMERIC, the items which are not numbers are
+            sorted before all the numbers, and are compared as text.
+        @return
+            @true if the items were sorted or @false if the column is
+            invalid or the control is virtual.
+
+        @note It is currently only implemented in the generic version, i.e.
+              in wxGenericListCtrl and in wxListCtrl in the ports using it.
+
+        @since 3.3.3
+    */
+    bool SortItemsByColumn(int col, int flags = wxLIST_SORT_TEXT);
+
     /**
         Returns true if checkboxes are enabled for list items.
 
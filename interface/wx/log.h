@@ -252,6 +252,10 @@ public:
     /**
         Add the @a mask to the list of allowed masks for wxLogTrace().
 
+        As with SetComponentLevel(), the list of masks is copied by this
+        function, as well as RemoveTraceMask() and ClearTraceMasks(), so they
+        shouldn't be called very often.
+
         @see RemoveTraceMask(), GetTraceMasks()
     */
     static void AddTraceMask(const wxString& mask);
@@ -431,8 +435,9 @@ public:
         @a level is less than or equal to the maximal log level enabled for the
         given @a component.
 
-        Note that this function is *not* thread-safe and should only be used
-        from the main thread.
+        Since wxWidgets 3.3.3 this function may be called from any thread,
+        and it doesn't lock any mutexes, but the log levels should still be
+        changed from the main thread only.
 
         @see IsEnabled(), SetLogLevel(), GetLogLevel(), SetComponentLevel()
 
@@ -440,6 +445,21 @@ public:
      */
     static bool IsLevelEnabled(wxLogLevel level, wxString component);
 
+    /**
+        Returns true if logging at this level is enabled for the current thread.
+
+        This overload is used by the logging macros and behaves in the same
+        way as the other one, but only creates a wxString from @a component
+        if a level was set for some component using SetComponentLevel() and
+        the result depends on it, which makes checking for disabled messages
+        very cheap.
+
+        @a component may be @NULL, which is the same as an empty string.
+
+        @since 3.3.3
+     */
+    static bool IsLevelEnabled(wxLogLevel level, const char* component);
+
     /**
         Sets the log level for the given component.
 
@@ -458,6 +478,13 @@ public:
             Maximal level of log messages from this component which will be
             handled instead of being simply discarded.
 
+        Note that, to allow checking the component levels from any thread
+        without locking, each call to this function makes a new copy of all
+        the levels set so far. The previous copy is freed only when no other
+        thread is checking the log level at the time of the next call, so
+        this function is meant to be used for configuring logging and
+        shouldn't be called very often.
+
         @since 2.9.1
      */
     static void SetComponentLevel(const wxString& component, wxLogLevel level);
@@ -692,6 +719,26 @@ protected:
     */
     virtual void DoLogText(const wxString& msg);
 
+    /**
+        Override to return @true if DoLogRecord() can be called from any
+        thread.
+
+        By default, the messages logged by the threads other than the main
+        one, and which don't have their own log target set with
+        SetThreadActiveTarget(), are buffered and only passed to the active
+        log target when it is flushed from the main thread. If this function
+        returns @true for the active log target, its DoLogRecord() is called
+        immediately from the thread logging the message instead, which means
+        that it must be safe to call it from several threads at once.
+
+        The default implementation returns @false.
+
+        @see wxLogAsync
+
+        @since 3.3.3
+     */
+    virtual bool IsThreadSafe() const;
+
     ///@}
 };
 
@@ -777,6 +824,74 @@ public:
 
 
 
+/**
+    @class wxLogAsync
+
+    Log target passing the messages to another log target in a background
+    thread.
+
+    Logging a message using this target only adds it to a lock-free queue, so
+    it is cheap and doesn't block the thread logging it, unless the queue is
+    full. The messages are then formatted and output by the real log target
+    in a dedicated thread, which makes this class useful when logging to a
+    file or the standard error stream from performance-sensitive code.
+
+    This log target is thread-safe (see wxLog::IsThreadSafe()), so the
+    messages logged from the threads other than main are passed to it
+    immediately instead of being buffered until the main thread flushes them.
+
+    Notice that the real log target must be usable from a thread other than
+    the main one, e.g. wxLogStderr or wxLogStream, but not wxLogGui.
+
+    Example of usage:
+    @code
+    wxLog::SetActiveTarget(new wxLogAsync(new wxLogStderr));
+    ...
+    // all the threads must stop logging before this is done
+    delete wxLog::SetActiveTarget(nullptr);
+    @endcode
+
+    This class is only available if @c wxUSE_THREADS is 1.
+
+    @library{wxbase}
+    @category{logging}
+
+    @since 3.3.3
+*/
+class wxLogAsync : public wxLog
+{
+public:
+    /**
+        Creates the background thread using the given log target.
+
+        @param target The log target for the real output, not @NULL. This
+            object takes ownership of it.
+        @param capacity The minimal number of messages which can be queued
+            before logging blocks waiting for the background thread to
+            output some of them.
+    */
+    explicit wxLogAsync(wxLog* target, size_t capacity = 1024);
+
+    /**
+        Logs all the still queued messages, stops the background thread and
+        destroys the real log target.
+    */
+    virtual ~wxLogAsync();
+
+    /**
+        Returns the log target used for the real output.
+    */
+    wxLog* GetTarget() const;
+
+    /**
+        Waits until all the messages logged so far are output by the real log
+        target and flushes it.
+    */
+    void Drain();
+};
+
+
+
 /**
     @class wxLogInterposer
 
@@ -26,7 +26,17 @@ enum wxMessageQueueError
     wxMSGQUEUE_TIMEOUT,
 
     /// Some unexpected (and fatal) error has occurred.
-    wxMSGQUEUE_MISC_ERROR
+    wxMSGQUEUE_MISC_ERROR,
+
+    /**
+        Indicates that the message couldn't be posted because the queue is
+        full.
+
+        This return value is only used by wxBoundedMessageQueue<>.
+
+        @since 3.3.3
+     */
+    wxMSGQUEUE_FULL
 };
 
 /**
@@ -119,3 +129,153 @@ public:
     wxMessageQueueError ReceiveTimeout(long timeout, T& msg);
 };
 
+
+/**
+    Bounded message queue which doesn't use locking in the common case.
+
+    This class provides the same functions as wxMessageQueue, but stores the
+    messages in a ring buffer of fixed size instead of an unbounded queue
+    protected by a mutex. Posting and receiving messages only uses atomic
+    operations, so this class performs much better than wxMessageQueue when
+    several threads use the queue at the same time. The threads which have to
+    wait for a message, or for space in the queue, spin for a short time
+    before blocking.
+
+    As the size of the queue is limited, Post() may fail if the consumers
+    don't keep up with the producers, and returns wxMSGQUEUE_FULL in this
+    case. The caller can then drop the message, retry later or use
+    PostTimeout() to wait until there is space in the queue.
+
+    PostMany() and ReceiveMany() can be used to transfer several messages at
+    once, which reduces the number of thread wake-ups.
+
+    @tparam T
+        The type of messages. Its copy or move constructor, as used by
+        Post(), must not throw.
+
+    @since 3.3.3
+
+    @nolibrary
+    @category{threading}
+
+    @see wxMessageQueue
+*/
+template <typename T>
+class wxBoundedMessageQueue<T>
+{
+public:
+    /**
+        Create the queue able to contain at least the given number of
+        messages.
+
+        The capacity is rounded up to the next power of 2, use GetCapacity()
+        to get its actual value.
+     */
+    explicit wxBoundedMessageQueue(size_t capacity);
+
+    /**
+        Destroys all the messages still in the queue.
+     */
+    ~wxBoundedMessageQueue();
+
+    /**
+        Returns the maximal number of messages in the queue.
+     */
+    size_t GetCapacity() const;
+
+    /**
+        Remove all messages from the queue.
+     */
+    wxMessageQueueError Clear();
+
+    /**
+        Returns @true if the object had been initialized successfully, @false
+        if an error occurred.
+    */
+    bool IsOk() const;
+
+    /**
+        Add a message to this queue if there is space for it and wake up a
+        thread waiting for messages, if any.
+
+        This method never blocks and can be called from multiple threads in
+        parallel.
+
+        @return wxMSGQUEUE_NO_ERROR if the message was posted or
+            wxMSGQUEUE_FULL if the queue is full.
+    */
+    wxMessageQueueError Post(T const& msg);
+
+    /**
+        Post a message of move-only type.
+
+        The message is left unchanged if this function returns
+        wxMSGQUEUE_FULL.
+     */
+    wxMessageQueueError Post(T&& msg);
+
+    /**
+        Post a message, waiting for no more than @a timeout milliseconds for
+        the space in the queue.
+
+        If @a timeout is 0, this is the same as Post(). If it is negative,
+        this function waits for as long as necessary.
+
+        @return wxMSGQUEUE_NO_ERROR if the message was posted or
+            wxMSGQUEUE_FULL if the timeout expired.
+     */
+    wxMessageQueueError PostTimeout(long timeout, T const& msg);
+
+    /// @overload
+    wxMessageQueueError PostTimeout(long timeout, T&& msg);
+
+    /**
+        Post as many of the given messages as there is space for.
+
+        The messages are posted in order and the function stops at the first
+        one which doesn't fit into the queue.
+
+        @return The number of messages posted, which may be 0.
+     */
+    size_t PostMany(const T* msgs, size_t count);
+
+    /**
+        Block until a message becomes available in the queue.
+
+        The message is returned in @a msg.
+    */
+    wxMessageQueueError Receive(T& msg);
+
+    /**
+        Block until a message becomes available in the queue, but no more than
+        @a timeout milliseconds.
+
+        If no message is available after @a timeout milliseconds then returns
+        @b wxMSGQUEUE_TIMEOUT. If @a timeout is 0, this function returns
+        immediately.
+
+        The message is returned in @a msg.
+    */
+    wxMessageQueueError ReceiveTimeout(long timeout, T& msg);
+
+    /**
+        Block until at least one message becomes available and receive up to
+        @a maxCount messages.
+
+        The messages are stored in the @a msgs array and their number is
+        returned in @a count.
+     */
+    wxMessageQueueError ReceiveMany(T* msgs, size_t maxCount, size_t& count);
+
+    /**
+        Same as ReceiveMany() but waits for no more than @a timeout
+        milliseconds for the first message.
+
+        If no message is available after @a timeout milliseconds then returns
+        @b wxMSGQUEUE_TIMEOUT and sets @a count to 0.
+     */
+    wxMessageQueueError ReceiveManyTimeout(long timeout,
+                                           T* msgs,
+                                           size_t maxCount,
+                                           size_t& count);
+};
@@ -0,0 +1,222 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        threadpool.h
+// Purpose:     interface of wxThreadPool and wxTaskFuture
+// Author:      wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxTaskFuture
+
+    Represents the result of a task executed by wxThreadPool.
+
+    Objects of this class are returned by wxThreadPool::Run() and can be used
+    to check whether the task has completed, wait for it, retrieve its result
+    or cancel it if it hasn't started running yet.
+
+    They are cheap to copy and all copies refer to the same task.
+
+    @tparam T The type of the value returned by the task, may be @c void.
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxThreadPool
+
+    @since 3.3.3
+*/
+template <typename T>
+class wxTaskFuture
+{
+public:
+    /**
+        Default constructor creates an invalid object.
+
+        Use wxThreadPool::Run() to create valid objects of this class.
+     */
+    wxTaskFuture();
+
+    /**
+        Return @true if this object refers to a task.
+     */
+    bool IsOk() const;
+
+    /**
+        Return @true if the task has completed, either successfully or by
+        throwing an exception, or was cancelled.
+
+        This function doesn't block.
+     */
+    bool IsReady() const;
+
+    /**
+        Return @true if the task was cancelled before it started running.
+     */
+    bool IsCancelled() const;
+
+    /**
+        Cancel the task if it hasn't started running yet.
+
+        If the task is already running, it is not interrupted, but it can
+        check whether its cancellation was requested by calling
+        wxThreadPool::TestCancel() periodically and return early if it was.
+
+        @return @true if the task was cancelled and won't run, @false if it
+            is already running or done.
+     */
+    bool Cancel();
+
+    /**
+        Wait until the task is done.
+
+        The calling thread runs the other tasks queued in the same pool while
+        waiting instead of just blocking, so it is safe to wait for the tasks
+        from inside other tasks.
+     */
+    void Wait() const;
+
+    /**
+        Wait until the task is done and return its result.
+
+        The task must not have been cancelled.
+
+        If the task threw an exception, it is rethrown by this function.
+     */
+    T Get() const;
+
+    /**
+        Call the given function in the main thread once the task is done.
+
+        The function is called using wxApp::CallAfter(), so it will be only
+        executed when the main event loop runs. It is passed a future for the
+        task which can be used to retrieve its result without blocking.
+
+        Example:
+        @code
+        wxThreadPool::Get().Run([=]() { return LoadImage(path); })
+            .CallAfter([this](const wxTaskFuture<wxImage>& f)
+            {
+                m_bitmap->SetBitmap(f.Get());
+            });
+        @endcode
+
+        Note that this function can be only called once for each task.
+     */
+    void CallAfter(const std::function<void (const wxTaskFuture<T>&)>& func);
+};
+
+/**
+    @class wxThreadPool
+
+    Thread pool running small tasks in a fixed number of worker threads.
+
+    Each worker thread has its own queue of tasks: the tasks submitted from a
+    worker thread are added to its own queue, while the tasks submitted from
+    the other threads are added to a shared queue. The workers take the tasks
+    from their own queue first, then from the shared one and, if both of them
+    are empty, steal the tasks from the other workers queues. This keeps the
+    contention low even when the tasks are very short.
+
+    Most applications should use the global pool returned by Get() rather than
+    creating their own ones.
+
+    Example of running a task and waiting for its result:
+    @code
+    wxTaskFuture<int> f = wxThreadPool::Get().Run([]() { return Compute(); });
+    ... do something else in the meanwhile ...
+    int result = f.Get();
+    @endcode
+
+    And of processing an array in parallel:
+    @code
+    wxThreadPool::Get().ParallelFor(0, count, [&](int from, int to)
+        {
+            for ( int n = from; n < to; ++n )
+                Process(data[n]);
+        });
+    @endcode
+
+    This class is only available if @c wxUSE_THREADS is 1.
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxTaskFuture, wxThread
+
+    @since 3.3.3
+*/
+class wxThreadPool
+{
+public:
+    /**
+        Create a pool with the given number of worker threads.
+
+        @param numThreads Number of threads to use or 0 to use as many as
+            returned by wxThread::GetCPUCount().
+     */
+    explicit wxThreadPool(int numThreads = 0);
+
+    /**
+        Destructor waits until all the tasks submitted to the pool are done
+        and stops the worker threads.
+     */
+    ~wxThreadPool();
+
+    /**
+        Return the global pool shared by the whole application.
+
+        The pool is created on first use and destroyed when the library is
+        shut down.
+     */
+    static wxThreadPool& Get();
+
+    /**
+        Return the number of worker threads in this pool.
+     */
+    int GetThreadCount() const;
+
+    /**
+        Run the given function in one of the worker threads.
+
+        The function must not take any arguments and may return any copyable
+        value or nothing at all. If it throws an exception, it is rethrown by
+        wxTaskFuture::Get().
+
+        @return The future which can be used to wait for the task completion
+            and retrieve its result.
+     */
+    template <typename F>
+    wxTaskFuture<R> Run(F&& func);
+
+    /**
+        Call the given function for the consecutive subranges of the range
+        [@a from, @a to) in parallel.
+
+        The calling thread also takes part in the work and this function only
+        returns when the function was called for all the subranges. If the
+        function throws an exception, it is rethrown from here after all the
+        already started calls complete.
+
+        @param from The start of the range.
+        @param to The end of the range, not included in it.
+        @param func The function called with the start and end of each
+            subrange.
+        @param maxChunks The maximal number of subranges to use or 0 to choose
+            it automatically to balance the load between the threads. Use 1 to
+            process the entire range in the current thread.
+     */
+    void ParallelFor(int from,
+                     int to,
+                     const std::function<void (int, int)>& func,
+                     int maxChunks = 0);
+
+    /**
+        Return @true if the task executing in the current thread was
+        cancelled.
+
+        Long-running tasks can call this function periodically and return
+        early if it returns @true. It always returns @false when called from
+        outside of a task.
+     */
+    static bool TestCancel();
+};
@@ -139,6 +139,7 @@ enum
     ID_ZOOM_BILINEAR,
     ID_ZOOM_BICUBIC,
     ID_ZOOM_BOX_AVERAGE,
+    ID_ZOOM_LANCZOS,
     ID_PAINT_BG
 };
 
@@ -222,6 +223,7 @@ private:
         menu->AppendRadioItem(ID_ZOOM_BILINEAR, "Use rescale bilinear\tShift-Ctrl-L");
         menu->AppendRadioItem(ID_ZOOM_BICUBIC, "Use rescale bicubic\tShift-Ctrl-C");
         menu->AppendRadioItem(ID_ZOOM_BOX_AVERAGE, "Use rescale box average\tShift-Ctrl-B");
+        menu->AppendRadioItem(ID_ZOOM_LANCZOS, "Use rescale Lanczos\tShift-Ctrl-Z");
         menu->AppendSeparator();
         menu->Append(ID_ROTATE_LEFT, "Rotate &left\tCtrl-L");
         menu->Append(ID_ROTATE_RIGHT, "Rotate &right\tCtrl-R");
@@ -564,6 +566,10 @@ private:
                 m_resizeQuality = wxIMAGE_QUALITY_BOX_AVERAGE;
                 break;
 
+            case ID_ZOOM_LANCZOS:
+                m_resizeQuality = wxIMAGE_QUALITY_LANCZOS;
+                break;
+
             default:
                 wxFAIL_MSG("unknown use for zoom command");
                 return;
@@ -1100,6 +1106,7 @@ wxBEGIN_EVENT_TABLE(MyImageFrame, wxFrame)
     EVT_MENU(ID_ZOOM_BILINEAR, MyImageFrame::OnUseZoom)
     EVT_MENU(ID_ZOOM_BICUBIC, MyImageFrame::OnUseZoom)
     EVT_MENU(ID_ZOOM_BOX_AVERAGE, MyImageFrame::OnUseZoom)
+    EVT_MENU(ID_ZOOM_LANCZOS, MyImageFrame::OnUseZoom)
 wxEND_EVENT_TABLE()
 
 //-----------------------------------------------------------------------------
@@ -487,10 +487,27 @@ void wxAppConsoleBase::DelayPendingEventHandler(wxEvtHandler* toDelay)
     wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
 }
 
+void wxAppConsoleBase::TakeHandlersWithIncomingEvents()
+{
+    wxEvtHandler* handler = m_handlersWithIncomingEvents.exchange(nullptr);
+    if ( !handler )
+        return;
+
+    // the handlers were pushed in the reverse order, so insert all of them at
+    // the same position to get them back in the original order
+    const size_t pos = m_handlersWithPendingEvents.size();
+    for ( ; handler; handler = handler->m_nextHandlerWithPendingEvents )
+        m_handlersWithPendingEvents.Insert(handler, pos);
+}
+
 void wxAppConsoleBase::RemovePendingEventHandler(wxEvtHandler* toRemove)
 {
     wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
 
+    // the handler may have been added to the list of handlers with incoming
+    // events and not moved to m_handlersWithPendingEvents yet
+    TakeHandlersWithIncomingEvents();
+
     if (m_handlersWithPendingEvents.Index(toRemove) != wxNOT_FOUND)
     {
         m_handlersWithPendingEvents.Remove(toRemove);
@@ -511,21 +528,33 @@ void wxAppConsoleBase::RemovePendingEventHandler(wxEvtHandler* toRemove)
     }
     //else: it wasn't in this list at all, it's ok
 
+    // this must be done after removing the handler from the lists, see
+    // AppendPendingEventHandler()
+    toRemove->m_hasPendingEvents = false;
+
     wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
 }
 
 void wxAppConsoleBase::AppendPendingEventHandler(wxEvtHandler* toAppend)
 {
-    wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
-
-    if ( m_handlersWithPendingEvents.Index(toAppend) == wxNOT_FOUND )
-        m_handlersWithPendingEvents.Add(toAppend);
+    // the flag is set as long as the handler is in one of our lists, so we
+    // don't need to search for it and there is nothing to do if it's there
+    if ( toAppend->m_hasPendingEvents.exchange(true) )
+        return;
 
-    wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
+    wxEvtHandler* head = m_handlersWithIncomingEvents.load(std::memory_order_relaxed);
+    do
+    {
+        toAppend->m_nextHandlerWithPendingEvents = head;
+    }
+    while ( !m_handlersWithIncomingEvents.compare_exchange_weak(head, toAppend) );
 }
 
 bool wxAppConsoleBase::HasPendingEvents() const
 {
+    if ( m_handlersWithIncomingEvents.load() )
+        return true;
+
     wxENTER_CRIT_SECT(const_cast<wxAppConsoleBase*>(this)->m_handlersWithPendingEventsLocker);
 
     bool has = !m_handlersWithPendingEvents.IsEmpty();
@@ -555,9 +584,14 @@ void wxAppConsoleBase::ProcessPendingEvents()
                      "this helper list should be empty" );
 
         // iterate until the list becomes empty: the handlers remove themselves
-        // from it when they don't have any more pending events
-        while (!m_handlersWithPendingEvents.IsEmpty())
+        // from it when they don't have any more pending events, but new ones
+        // can be added to it by other threads while we're doing it
+        for ( ;; )
         {
+            TakeHandlersWithIncomingEvents();
+            if ( m_handlersWithPendingEvents.IsEmpty() )
+                break;
+
             // NOTE: we always call ProcessPendingEvents() on the first event handler
             //       with pending events because handlers auto-remove themselves
             //       from this list (see RemovePendingEventHandler) if they have no
@@ -596,8 +630,13 @@ void wxAppConsoleBase::DeletePendingEvents()
     wxCHECK_RET( m_handlersWithPendingDelayedEvents.IsEmpty(),
                  "this helper list should be empty" );
 
+    TakeHandlersWithIncomingEvents();
+
     for (unsigned int i=0; i<m_handlersWithPendingEvents.GetCount(); i++)
+    {
         m_handlersWithPendingEvents[i]->DeletePendingEvents();
+        m_handlersWithPendingEvents[i]->m_hasPendingEvents = false;
+    }
 
     m_handlersWithPendingEvents.Clear();
 
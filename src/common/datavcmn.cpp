@@ -142,6 +142,7 @@ bool wxDataViewModelNotifier::ItemsChanged( const wxDataViewItemArray &items )
 
 wxDataViewModel::wxDataViewModel()
 {
+    m_batchCount = 0;
 }
 
 wxDataViewModel::~wxDataViewModel()
@@ -313,10 +314,41 @@ void wxDataViewModel::Resort()
     }
 }
 
+void wxDataViewModel::BeginBatch()
+{
+    // only the outermost batch is forwarded to the notifiers
+    if ( m_batchCount++ )
+        return;
+
+    wxDataViewModelNotifiers::iterator iter;
+    for (iter = m_notifiers.begin(); iter != m_notifiers.end(); ++iter)
+    {
+        (*iter)->BeginBatch();
+    }
+}
+
+void wxDataViewModel::EndBatch()
+{
+    wxCHECK_RET( m_batchCount > 0, "EndBatch() without matching BeginBatch()" );
+
+    if ( --m_batchCount )
+        return;
+
+    wxDataViewModelNotifiers::iterator iter;
+    for (iter = m_notifiers.begin(); iter != m_notifiers.end(); ++iter)
+    {
+        (*iter)->EndBatch();
+    }
+}
+
 void wxDataViewModel::AddNotifier( wxDataViewModelNotifier *notifier )
 {
     m_notifiers.push_back( notifier );
     notifier->SetOwner( this );
+
+    // keep BeginBatch() and EndBatch() calls balanced for this notifier too
+    if ( m_batchCount )
+        notifier->BeginBatch();
 }
 
 void wxDataViewModel::RemoveNotifier( wxDataViewModelNotifier *notifier )
@@ -326,6 +358,11 @@ void wxDataViewModel::RemoveNotifier( wxDataViewModelNotifier *notifier )
     {
         if ( *iter == notifier )
         {
+            // don't leave the notifier inside a batch which will never end
+            // for it
+            if ( m_batchCount )
+                notifier->EndBatch();
+
             delete notifier;
             m_notifiers.erase(iter);
 
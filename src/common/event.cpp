@@ -47,6 +47,7 @@
 
 #if wxUSE_BASE
     #include <memory>
+    #include <unordered_map>
 #endif // wxUSE_BASE
 
 #if wxUSE_GUI
@@ -376,6 +377,7 @@ wxEvent::wxEvent(int theId, wxEventType commandType)
     m_propagatedFrom = nullptr;
     m_wasProcessed = false;
     m_willBeProcessedAgain = false;
+    m_isCoalescable = false;
 }
 
 wxEvent::wxEvent(const wxEvent& src)
@@ -392,6 +394,7 @@ wxEvent::wxEvent(const wxEvent& src)
     , m_isCommandEvent(src.m_isCommandEvent)
     , m_wasProcessed(false)
     , m_willBeProcessedAgain(false)
+    , m_isCoalescable(src.m_isCoalescable)
 {
 }
 
@@ -409,6 +412,7 @@ wxEvent& wxEvent::operator=(const wxEvent& src)
     m_propagatedFrom = nullptr;
     m_skipped = src.m_skipped;
     m_isCommandEvent = src.m_isCommandEvent;
+    m_isCoalescable = src.m_isCoalescable;
 
     // don't change m_wasProcessed
 
@@ -1188,13 +1192,131 @@ void wxEventHashTable::GrowEventTypeTable()
 // wxEvtHandler
 // ----------------------------------------------------------------------------
 
+// Don't bother indexing the dynamically bound event handlers if there are only
+// a few of them, searching them linearly is fast enough then.
+static const size_t DYNAMIC_EVENTS_INDEX_MIN_ENTRIES = 16;
+
+// The positions in m_entries of the handlers for each event type: those bound
+// to a single id are grouped by this id, while the ones bound to any id or to
+// a range of ids are kept together. All positions vectors are sorted.
+struct wxEvtHandler::DynamicEvents::Index
+{
+    struct ForType
+    {
+        std::unordered_map<int, wxVector<size_t>> byId;
+        wxVector<size_t> other;
+    };
+
+    explicit Index(const wxVector<wxDynamicEventTableEntry*>& entries)
+    {
+        for ( size_t n = 0; n < entries.size(); n++ )
+        {
+            if ( entries[n] )
+                Add(*entries[n], n);
+        }
+    }
+
+    void Add(const wxDynamicEventTableEntry& entry, size_t pos)
+    {
+        ForType& forType = byType[entry.m_eventType];
+        if ( entry.m_id != wxID_ANY && entry.m_lastId == wxID_ANY )
+            forType.byId[entry.m_id].push_back(pos);
+        else
+            forType.other.push_back(pos);
+    }
+
+    std::unordered_map<wxEventType, ForType> byType;
+};
+
+wxEvtHandler::DynamicEvents::~DynamicEvents()
+{
+    delete m_index;
+}
+
+void wxEvtHandler::DynamicEvents::PruneUnbound()
+{
+    if ( !m_numUnbound )
+        return;
+
+    // Removing the entries is linear in their number and requires rebuilding
+    // the index, so only do it once a sizeable part of them was unbound when
+    // there are many of them, to keep Unbind() amortized constant time.
+    if ( m_entries.size() >= DYNAMIC_EVENTS_INDEX_MIN_ENTRIES &&
+            m_numUnbound < m_entries.size() / 4 )
+        return;
+
+    size_t nNew = 0;
+    for ( size_t n = 0; n != m_entries.size(); n++ )
+    {
+        if ( m_entries[n] )
+            m_entries[nNew++] = m_entries[n];
+    }
+
+    wxASSERT( nNew + m_numUnbound == m_entries.size() );
+    m_entries.resize(nNew);
+    m_numUnbound = 0;
+
+    // The positions in the index are not valid any more, it will be rebuilt
+    // when it's needed again.
+    wxDELETE(m_index);
+}
+
+// A node of the singly-linked lists of the pending events.
+struct wxEvtHandler::PendingEventNode
+{
+    explicit PendingEventNode(wxEvent* event_) : event(event_), next(nullptr) { }
+
+    wxEvent* event;
+    PendingEventNode* next;
+};
+
+// The nodes of m_pendingEvents containing coalescable events, indexed by the
+// key identifying the events which can be coalesced together.
+struct wxEvtHandler::CoalescableEvents
+{
+    struct Key
+    {
+        explicit Key(const wxEvent& event)
+            : type(event.GetEventType()),
+              id(event.GetId()),
+              object(event.GetEventObject())
+        {
+        }
+
+        bool operator==(const Key& other) const
+        {
+            return type == other.type && id == other.id && object == other.object;
+        }
+
+        wxEventType type;
+        int id;
+        wxObject* object;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return std::hash<wxObject*>()(key.object) ^
+                    (static_cast<size_t>(key.type) * 31 + key.id);
+        }
+    };
+
+    std::unordered_map<Key, PendingEventNode*, KeyHash> nodes;
+};
+
 wxEvtHandler::wxEvtHandler()
 {
     m_nextHandler = nullptr;
     m_previousHandler = nullptr;
     m_enabled = true;
     m_dynamicEvents = nullptr;
-    m_pendingEvents = nullptr;
+    m_incomingEvents = nullptr;
+    m_pendingEvents =
+    m_pendingEventsLast = nullptr;
+    m_coalescableEvents = nullptr;
+    m_hasPendingEvents = false;
+    m_nextHandlerWithPendingEvents = nullptr;
 
     // no client data (yet)
     m_clientData = nullptr;
@@ -1236,6 +1358,7 @@ wxEvtHandler::~wxEvtHandler()
         wxTheApp->RemovePendingEventHandler(this);
 
     DeletePendingEvents();
+    delete m_coalescableEvents;
 
     // we only delete object data, not untyped
     if ( m_clientDataType == wxClientData_Object )
@@ -1332,37 +1455,142 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
         return;
     }
 
-    // 1) Add this event to our list of pending events
-    wxENTER_CRIT_SECT( m_pendingEventsLock );
-
-    if ( !m_pendingEvents )
-        m_pendingEvents = new wxList;
+    PendingEventNode* const node = new PendingEventNode(event);
 
-    m_pendingEvents->Append(event);
+    if ( event->IsCoalescable() )
+    {
+        // 1a) Coalescable events must be compared with the pending events, so
+        //     add them directly to the list of the pending events, which
+        //     requires locking it, unlike for the other events.
+        wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
+
+        // Take the events queued before this one into account.
+        TakeIncomingEvents();
+
+        // If the event was coalesced with an already pending one, there is
+        // nothing else to do, as this handler must be already in the list of
+        // the handlers with pending events.
+        if ( !AppendPendingEvent(node) )
+            return;
+    }
+    else
+    {
+        // 1b) Add this event to our list of incoming events: this is done
+        //     without locking, so that multiple threads can queue events
+        //     concurrently.
+        PendingEventNode* head = m_incomingEvents.load(std::memory_order_relaxed);
+        do
+        {
+            node->next = head;
+        }
+        while ( !m_incomingEvents.compare_exchange_weak(head, node) );
+    }
 
     // 2) Add this event handler to list of event handlers that
-    //    have pending events.
-
+    //    have pending events, if it's not there yet.
+    //
+    //    Notice that this must be done after adding the event, as
+    //    ProcessPendingEvents() checks for the incoming events after removing
+    //    the handler from this list, to preserve the invariant that a handler
+    //    is in the list if it has any pending events to process.
     wxTheApp->AppendPendingEventHandler(this);
 
-    // only release m_pendingEventsLock now because otherwise there is a race
-    // condition as described in the ticket #9093: we could process the event
-    // just added to m_pendingEvents in our ProcessPendingEvents() below before
-    // we had time to append this pointer to wxHandlersWithPendingEvents list; thus
-    // breaking the invariant that a handler should be in the list iff it has
-    // any pending events to process
-    wxLEAVE_CRIT_SECT( m_pendingEventsLock );
-
     // 3) Inform the system that new pending events are somewhere,
     //    and that these should be processed in idle time.
     wxWakeUpIdle();
 }
 
+void wxEvtHandler::LeavePendingEventHandlers()
+{
+    wxTheApp->RemovePendingEventHandler(this);
+
+    // more events could have been queued by another thread after we had
+    // checked for them and before we removed ourselves from the list, in which
+    // case QueueEvent() didn't add us to it as we were still there, so we need
+    // to do it ourselves
+    if ( m_incomingEvents.load() )
+        wxTheApp->AppendPendingEventHandler(this);
+}
+
+bool wxEvtHandler::TakeIncomingEvents()
+{
+    PendingEventNode* node = m_incomingEvents.exchange(nullptr);
+    if ( !node )
+        return false;
+
+    // the incoming events are in the reverse order, so build the list of the
+    // new events starting from the end
+    PendingEventNode* first = nullptr;
+    while ( node )
+    {
+        PendingEventNode* const next = node->next;
+        node->next = first;
+        first = node;
+        node = next;
+    }
+
+    while ( first )
+    {
+        PendingEventNode* const next = first->next;
+        AppendPendingEvent(first);
+        first = next;
+    }
+
+    return true;
+}
+
+bool wxEvtHandler::AppendPendingEvent(PendingEventNode* node)
+{
+    if ( node->event->IsCoalescable() )
+    {
+        if ( !m_coalescableEvents )
+            m_coalescableEvents = new CoalescableEvents;
+
+        PendingEventNode*&
+            pending = m_coalescableEvents->nodes[CoalescableEvents::Key(*node->event)];
+        if ( pending )
+        {
+            // Replace the older event with the new one, keeping its position
+            // in the queue, so that only the most recent one is processed.
+            delete pending->event;
+            pending->event = node->event;
+            delete node;
+
+            return false;
+        }
+
+        pending = node;
+    }
+
+    node->next = nullptr;
+
+    if ( m_pendingEventsLast )
+        m_pendingEventsLast->next = node;
+    else
+        m_pendingEvents = node;
+
+    m_pendingEventsLast = node;
+
+    return true;
+}
+
 void wxEvtHandler::DeletePendingEvents()
 {
-    if (m_pendingEvents)
-        m_pendingEvents->DeleteContents(true);
-    wxDELETE(m_pendingEvents);
+    TakeIncomingEvents();
+
+    for ( PendingEventNode* node = m_pendingEvents; node; )
+    {
+        PendingEventNode* const next = node->next;
+        delete node->event;
+        delete node;
+        node = next;
+    }
+
+    m_pendingEvents =
+    m_pendingEventsLast = nullptr;
+
+    if ( m_coalescableEvents )
+        m_coalescableEvents->nodes.clear();
 }
 
 void wxEvtHandler::ProcessPendingEvents()
@@ -1377,26 +1605,36 @@ void wxEvtHandler::ProcessPendingEvents()
 
     // we need to process only a single pending event in this call because
     // each call to ProcessEvent() could result in the destruction of this
-    // same event handler (see the comment at the end of this function)
+    // same event handler (see the comment at the end of this function), but
+    // we do move all the events queued since the last call to our list of
+    // pending events at once
 
     wxENTER_CRIT_SECT( m_pendingEventsLock );
 
-    // this method is only called by wxApp if this handler does have
-    // pending events
-    wxCHECK_RET( m_pendingEvents && !m_pendingEvents->IsEmpty(),
-                 "should have pending events if called" );
+    TakeIncomingEvents();
+
+    if ( !m_pendingEvents )
+    {
+        // this can happen if DeletePendingEvents() was called while we were
+        // in the list of handlers with pending events, just leave it
+        LeavePendingEventHandlers();
+
+        wxLEAVE_CRIT_SECT( m_pendingEventsLock );
 
-    wxList::compatibility_iterator node = m_pendingEvents->GetFirst();
-    wxEvent* pEvent = static_cast<wxEvent *>(node->GetData());
+        return;
+    }
+
+    PendingEventNode* prev = nullptr;
+    PendingEventNode* node = m_pendingEvents;
 
     // find the first event which can be processed now:
     wxEventLoopBase* evtLoop = wxEventLoopBase::GetActive();
     if (evtLoop && evtLoop->IsYielding())
     {
-        while (node && pEvent && !evtLoop->IsEventAllowedInsideYield(pEvent->GetEventCategory()))
+        while (node && !evtLoop->IsEventAllowedInsideYield(node->event->GetEventCategory()))
         {
-            node = node->GetNext();
-            pEvent = node ? static_cast<wxEvent *>(node->GetData()) : nullptr;
+            prev = node;
+            node = node->next;
         }
 
         if (!node)
@@ -1413,18 +1651,30 @@ void wxEvtHandler::ProcessPendingEvents()
         }
     }
 
-    std::unique_ptr<wxEvent> event(pEvent);
+    std::unique_ptr<wxEvent> event(node->event);
 
     // it's important we remove event from list before processing it, else a
     // nested event loop, for example from a modal dialog, might process the
     // same event again.
-    m_pendingEvents->Erase(node);
+    if ( prev )
+        prev->next = node->next;
+    else
+        m_pendingEvents = node->next;
+
+    if ( m_pendingEventsLast == node )
+        m_pendingEventsLast = prev;
 
-    if ( m_pendingEvents->IsEmpty() )
+    // a new event with the same key must be queued after this one now
+    if ( event->IsCoalescable() )
+        m_coalescableEvents->nodes.erase(CoalescableEvents::Key(*event));
+
+    delete node;
+
+    if ( !m_pendingEvents )
     {
         // if there are no more pending events left, we don't need to
         // stay in this list
-        wxTheApp->RemovePendingEventHandler(this);
+        LeavePendingEventHandlers();
     }
 
     wxLEAVE_CRIT_SECT( m_pendingEventsLock );
@@ -1790,6 +2040,9 @@ void wxEvtHandler::DoBind(int id,
     // than inserting the element at the front.
     m_dynamicEvents->m_entries.push_back(entry);
 
+    if ( m_dynamicEvents->m_index )
+        m_dynamicEvents->m_index->Add(*entry, m_dynamicEvents->m_entries.size() - 1);
+
     // Make sure we get to know when a sink is destroyed
     wxEvtHandler *eventSink = func->GetEvtHandler();
     if ( eventSink && eventSink != this )
@@ -1843,8 +2096,13 @@ wxEvtHandler::DoUnbind(int id,
             // vector, which is not guaranteed by our API, but here we can use
             // this implementation detail.
             m_dynamicEvents->m_entries[cookie] = nullptr;
+            m_dynamicEvents->m_numUnbound++;
 
             delete entry;
+
+            if ( !m_dynamicEvents->m_flag )
+                m_dynamicEvents->PruneUnbound();
+
             return true;
         }
     }
@@ -1899,65 +2157,101 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
     DynamicEvents& dynamicEvents = *m_dynamicEvents;
 
     wxRecursionGuard guard(dynamicEvents.m_flag);
-    bool needToPruneDeleted = false;
 
-    // We can't use Get{First,Next}DynamicEntry() here as they hide the deleted
-    // but not yet pruned entries from the caller, but here we do want to know
-    // about them, so iterate directly. Remember to do it in the reverse order
-    // to honour the order of handlers connection.
-    for ( size_t n = dynamicEvents.m_entries.size(); n; n-- )
+    // Try processing the event with the handler at the given position in
+    // m_entries and return true if it was processed.
+    //
+    // Notice that if it returns true, we must return immediately and skip
+    // pruning the unbound event entries below because this object itself
+    // could have been deleted by the event handler making m_dynamicEvents a
+    // dangling pointer which can't be accessed any longer in the code below.
+    //
+    // In practice, it hopefully shouldn't be a problem to wait until we get
+    // an event that we don't handle before pruning because this should happen
+    // soon enough and even if it doesn't the worst possible outcome is
+    // slightly increased memory consumption while not skipping pruning can
+    // result in hard to reproduce (because they require the disconnection and
+    // deletion happen at the same time which is not always the case) crashes.
+    const auto tryEntry = [&](size_t n)
     {
-        wxDynamicEventTableEntry* const entry = dynamicEvents.m_entries[n - 1];
+        wxDynamicEventTableEntry* const entry = dynamicEvents.m_entries[n];
 
         if ( !entry )
         {
             // This entry must have been unbound at some time in the past, so
-            // skip it now and really remove it from the vector below, once we
-            // finish iterating.
-            // N.B.:  If we are in a nested call, then we can't be done
-            // iterating during this call
-            needToPruneDeleted = !guard.IsInside();
-            continue;
+            // skip it now, it will be really removed from the vector later.
+            return false;
         }
 
-        if ( event.GetEventType() == entry->m_eventType )
+        if ( event.GetEventType() != entry->m_eventType )
+            return false;
+
+        wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
+        if ( !handler )
+           handler = this;
+
+        return ProcessEventIfMatchesId(*entry, handler, event);
+    };
+
+    if ( dynamicEvents.m_entries.size() < DYNAMIC_EVENTS_INDEX_MIN_ENTRIES )
+    {
+        // We can't use Get{First,Next}DynamicEntry() here as they hide the
+        // deleted but not yet pruned entries from the caller, but here we do
+        // want to know about them, so iterate directly. Remember to do it in
+        // the reverse order to honour the order of handlers connection.
+        for ( size_t n = dynamicEvents.m_entries.size(); n; n-- )
         {
-            wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
-            if ( !handler )
-               handler = this;
-            if ( ProcessEventIfMatchesId(*entry, handler, event) )
-            {
-                // It's important to skip pruning of the unbound event entries
-                // below because this object itself could have been deleted by
-                // the event handler making m_dynamicEvents a dangling pointer
-                // which can't be accessed any longer in the code below.
-                //
-                // In practice, it hopefully shouldn't be a problem to wait
-                // until we get an event that we don't handle before pruning
-                // because this should happen soon enough and even if it
-                // doesn't the worst possible outcome is slightly increased
-                // memory consumption while not skipping pruning can result in
-                // hard to reproduce (because they require the disconnection
-                // and deletion happen at the same time which is not always the
-                // case) crashes.
+            if ( tryEntry(n - 1) )
                 return true;
-            }
         }
     }
-
-    if ( needToPruneDeleted )
+    else
     {
-        size_t nNew = 0;
-        for ( size_t n = 0; n != dynamicEvents.m_entries.size(); n++ )
+        if ( !dynamicEvents.m_index )
+            dynamicEvents.m_index = new DynamicEvents::Index(dynamicEvents.m_entries);
+
+        // Only consider the handlers for this event type and, among those
+        // bound to a single id, only the ones bound to the event id.
+        //
+        // Notice that the references to the index elements remain valid even
+        // if the event handlers bind more handlers, as the index is only
+        // destroyed when pruning, which is never done in nested calls, and
+        // we only access its vectors by index as they could be reallocated.
+        const auto itType = dynamicEvents.m_index->byType.find(event.GetEventType());
+        if ( itType != dynamicEvents.m_index->byType.end() )
         {
-            if ( dynamicEvents.m_entries[n] )
-                dynamicEvents.m_entries[nNew++] = dynamicEvents.m_entries[n];
-        }
+            const DynamicEvents::Index::ForType& forType = itType->second;
+
+            const wxVector<size_t>* byId = nullptr;
+            const auto itId = forType.byId.find(event.GetId());
+            if ( itId != forType.byId.end() )
+                byId = &itId->second;
 
-        wxASSERT( nNew != dynamicEvents.m_entries.size() );
-        dynamicEvents.m_entries.resize(nNew);
+            const wxVector<size_t>& other = forType.other;
+
+            // Merge both lists in the reverse order of their positions to
+            // honour the order of handlers connection, as above.
+            size_t i = byId ? byId->size() : 0,
+                   j = other.size();
+            while ( i || j )
+            {
+                size_t n;
+                if ( !j || (i && (*byId)[i - 1] > other[j - 1]) )
+                    n = (*byId)[--i];
+                else
+                    n = other[--j];
+
+                if ( tryEntry(n) )
+                    return true;
+            }
+        }
     }
 
+    // N.B.: If we are in a nested call, then we can't be done iterating
+    // during this call.
+    if ( !guard.IsInside() )
+        dynamicEvents.PruneUnbound();
+
     return false;
 }
 
@@ -2037,8 +2331,12 @@ void wxEvtHandler::OnSinkDestroyed( wxEvtHandler *sink )
             // Just as in DoUnbind(), we use our knowledge of
             // GetNextDynamicEntry() implementation here.
             m_dynamicEvents->m_entries[cookie] = nullptr;
+            m_dynamicEvents->m_numUnbound++;
         }
     }
+
+    if ( !m_dynamicEvents->m_flag )
+        m_dynamicEvents->PruneUnbound();
 }
 
 #endif // wxUSE_BASE
@@ -28,6 +28,7 @@
 #include "wx/private/selectdispatcher.h"
 #ifdef __UNIX__
     #include "wx/unix/private/epolldispatcher.h"
+    #include "wx/unix/private/iouringdispatcher.h"
 #endif
 
 static
@@ -46,8 +47,12 @@ wxFDIODispatcher *wxFDIODispatcher::Get()
 {
     if ( !gs_dispatcher )
     {
+#ifdef wxHAS_IO_URING_DISPATCHER
+        gs_dispatcher = wxIoUringDispatcher::Create();
+        if ( !gs_dispatcher )
+#endif // wxHAS_IO_URING_DISPATCHER
 #if wxUSE_EPOLL_DISPATCHER
-        gs_dispatcher = wxEpollDispatcher::Create();
+            gs_dispatcher = wxEpollDispatcher::Create();
         if ( !gs_dispatcher )
 #endif // wxUSE_EPOLL_DISPATCHER
 #if wxUSE_SELECT_DISPATCHER
@@ -37,6 +37,7 @@
 #include  "wx/fileconf.h"
 #include  "wx/filefn.h"
 
+#include "wx/arrstr.h"
 #include "wx/base64.h"
 
 #include  "wx/stdpaths.h"
@@ -54,6 +55,12 @@
 
 #define FILECONF_TRACE_MASK wxT("fileconf")
 
+// the first line of the journal file, followed by the local file signature
+static const char* const JOURNAL_HEADER = "#wxFileConfig journal ";
+
+// don't merge the journal into the file before it becomes at least this big
+static const wxFileOffset JOURNAL_MIN_COMPACT_SIZE = 64*1024;
+
 // ----------------------------------------------------------------------------
 // global functions declarations
 // ----------------------------------------------------------------------------
@@ -69,6 +76,13 @@ static wxString FilterOutValue(const wxString& str);
 static wxString FilterInEntryName(const wxString& str);
 static wxString FilterOutEntryName(const wxString& str);
 
+// escape/unescape the journal record argument and prepend TAB separator to it
+static wxString JournalArg(const wxString& str);
+static wxString UnescapeJournalArg(const wxString& str);
+
+// return the size of the file or 0 if it doesn't exist
+static wxFileOffset GetFileSizeOrZero(const wxFileName& fn);
+
 // ============================================================================
 // private classes
 // ============================================================================
@@ -445,6 +459,11 @@ void wxFileConfig::Init()
     m_linesHead =
     m_linesTail = nullptr;
 
+    m_journalPending.clear();
+    m_journalSize =
+    m_localFileSize = 0;
+    m_mustCompactJournal = false;
+
     // It's not an error if (one of the) file(s) doesn't exist.
 
     // parse the global file
@@ -471,6 +490,8 @@ void wxFileConfig::Init()
         {
             Parse(fileLocal, true /* local */);
             SetRootPath();
+
+            m_localFileSize = GetFileSizeOrZero(m_fnLocalFile);
         }
         else
         {
@@ -489,6 +510,9 @@ void wxFileConfig::Init()
 
     m_isDirty = false;
     m_autosave = true;
+
+    // apply the changes saved in the journal, if any, to the local file
+    ReplayJournal();
 }
 
 // constructor supports creation of wxFileConfig objects of any type
@@ -644,7 +668,7 @@ void wxFileConfig::CleanUp()
 wxFileConfig::~wxFileConfig()
 {
     if ( m_autosave )
-        Flush();
+        DoFlush(true /* merge the journal into the file */);
 
     CleanUp();
 
@@ -662,9 +686,13 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
   for ( size_t n = 0; n < nLineCount; n++ )
   {
-    wxString strLine = buffer[n];
+    const wxString& strLine = buffer[n];
+#if wxUSE_UNICODE_WCHAR
+    const wxChar* const buf = strLine.wc_str();
+#else
     // FIXME-UTF8: rewrite using iterators
     wxWCharBuffer buf(strLine.c_str());
+#endif
     const wxChar *pStart;
     const wxChar *pEnd;
 
@@ -1082,6 +1110,14 @@ bool wxFileConfig::DoWriteString(const wxString& key, const wxString& szValue)
         // this will add a line for this group if it didn't have it before (or
         // do nothing for the root but it's ok as it always exists anyhow)
         (void)m_pCurrentGroup->GetGroupLine();
+
+        if ( IsJournaling() )
+        {
+            AddJournalRecord(wxS("set") +
+                             JournalArg(m_pCurrentGroup->GetFullName() +
+                                        wxCONFIG_PATH_SEPARATOR) +
+                             JournalArg(wxString()));
+        }
     }
     else
     {
@@ -1109,6 +1145,14 @@ bool wxFileConfig::DoWriteString(const wxString& key, const wxString& szValue)
         pEntry->SetValue(szValue);
 
         SetDirty();
+
+        if ( IsJournaling() )
+        {
+            AddJournalRecord(wxS("set") +
+                             JournalArg(m_pCurrentGroup->GetFullName() +
+                                        wxCONFIG_PATH_SEPARATOR + strName) +
+                             JournalArg(szValue));
+        }
     }
 
     return true;
@@ -1130,9 +1174,11 @@ bool wxFileConfig::DoWriteBinary(const wxString& key, const wxMemoryBuffer& buf)
 
 bool wxFileConfig::Flush(bool /* bCurrentOnly */)
 {
-  if ( !IsDirty() || m_fnLocalFile.GetFullPath().empty() )
-    return true;
+  return DoFlush(false /* don't merge the journal unless necessary */);
+}
 
+bool wxFileConfig::CreateLocalFileDir()
+{
   // Create the directory containing the file if it doesn't exist. Although we
   // don't always use XDG, it seems sensible to follow the XDG specification
   // and create it with permissions 700 if it doesn't exist.
@@ -1148,6 +1194,42 @@ bool wxFileConfig::Flush(bool /* bCurrentOnly */)
       }
   }
 
+  return true;
+}
+
+bool wxFileConfig::DoFlush(bool compact)
+{
+  if ( m_fnLocalFile.GetFullPath().empty() )
+    return true;
+
+  // even if there are no unsaved changes, the changes saved in the journal
+  // still need to be merged into the file when compacting
+  if ( !IsDirty() && !(compact && m_journalSize) )
+    return true;
+
+  if ( !CreateLocalFileDir() )
+    return false;
+
+  // in journal mode, just append the changes to the journal, unless it has
+  // become big enough to be worth merging into the file
+  if ( IsDirty() && IsJournaling() && !compact && !m_mustCompactJournal )
+  {
+      const wxFileOffset
+        journalSize = m_journalSize + (wxFileOffset)m_journalPending.length();
+      if ( journalSize < wxMax(m_localFileSize, JOURNAL_MIN_COMPACT_SIZE) )
+      {
+          if ( AppendToJournal() )
+          {
+              ResetDirty();
+              return true;
+          }
+
+          // try to save the changes by rewriting the whole file instead
+          wxLogTrace( FILECONF_TRACE_MASK,
+                      wxT("  Writing to journal failed, rewriting file") );
+      }
+  }
+
   // set the umask if needed
   wxCHANGE_UMASK(m_umask);
 
@@ -1180,6 +1262,11 @@ bool wxFileConfig::Flush(bool /* bCurrentOnly */)
       return false;
   }
 
+  // the file contains all the changes now, so the journal is not needed any
+  // more (and would be ignored even if we failed to remove it)
+  m_localFileSize = GetFileSizeOrZero(m_fnLocalFile);
+  RemoveJournal();
+
   ResetDirty();
 
   return true;
@@ -1211,6 +1298,205 @@ bool wxFileConfig::Save(wxOutputStream& os, const wxMBConv& conv)
 
 #endif // wxUSE_STREAMS
 
+// ----------------------------------------------------------------------------
+// journal
+// ----------------------------------------------------------------------------
+
+// The journal is a UTF-8 text file next to the local file. It starts with a
+// header line containing the signature of the local file it applies to, which
+// allows to detect the journal left over after the local file was rewritten,
+// and then contains one record per line. Each record consists of the
+// operation name and its arguments separated by TABs, with TABs, new lines
+// and backslashes in the arguments escaped with backslashes.
+
+wxFileName wxFileConfig::GetJournalFile() const
+{
+    wxFileName fn(m_fnLocalFile);
+    fn.SetFullName(fn.GetFullName() + wxS(".journal"));
+
+    return fn;
+}
+
+wxString wxFileConfig::GetLocalFileSignature() const
+{
+    if ( !m_fnLocalFile.FileExists() )
+        return wxS("none");
+
+    wxString signature = m_fnLocalFile.GetSize().ToString();
+#if wxUSE_DATETIME
+    signature << wxS(' ')
+              << m_fnLocalFile.GetModificationTime().GetValue().ToString();
+#endif // wxUSE_DATETIME
+
+    return signature;
+}
+
+void wxFileConfig::AddJournalRecord(const wxString& record)
+{
+    m_journalPending << record << wxS('\n');
+}
+
+bool wxFileConfig::AppendToJournal()
+{
+    wxCHANGE_UMASK(m_umask);
+
+    const wxString path = GetJournalFile().GetFullPath();
+
+    wxString text;
+    wxFile file;
+    if ( m_journalSize )
+    {
+        if ( !file.Open(path, wxFile::write_append) )
+            return false;
+    }
+    else // there is no journal for the current local file yet
+    {
+        // overwrite the stale journal, if any
+        if ( !file.Create(path, true /* overwrite */) )
+            return false;
+
+        text << JOURNAL_HEADER << GetLocalFileSignature() << wxS('\n');
+    }
+
+    text += m_journalPending;
+
+    const wxScopedCharBuffer buf = text.utf8_str();
+    if ( file.Write(buf.data(), buf.length()) != buf.length() || !file.Close() )
+    {
+        wxLogError(_("can't write configuration journal file '%s'."), path);
+
+        // we may have written an incomplete record, so don't append to this
+        // journal any more
+        m_mustCompactJournal = true;
+        return false;
+    }
+
+    m_journalSize += buf.length();
+    m_journalPending.clear();
+
+    return true;
+}
+
+void wxFileConfig::ReplayJournal()
+{
+    if ( !m_fnLocalFile.IsOk() )
+        return;
+
+    const wxString path = GetJournalFile().GetFullPath();
+    if ( !wxFileExists(path) )
+        return;
+
+    wxFile file(path);
+    const wxFileOffset len = file.IsOpened() ? file.Length() : wxInvalidOffset;
+    wxCharBuffer buf(len == wxInvalidOffset ? 0 : len);
+    if ( len == wxInvalidOffset || file.Read(buf.data(), len) != len )
+    {
+        wxLogWarning(_("can't read configuration journal file '%s'."), path);
+
+        // as above, don't save anything to avoid losing the changes in the
+        // journal we couldn't apply
+        wxLogWarning(_("Changes won't be saved to avoid overwriting the existing file \"%s\""),
+                     m_fnLocalFile.GetFullPath());
+        m_fnLocalFile.Clear();
+        return;
+    }
+
+    // ignore the last record if it is incomplete, as can happen if we crashed
+    // while writing it
+    const char* const start = buf.data();
+    const char* end = start + len;
+    while ( end != start && end[-1] != '\n' )
+        end--;
+
+    const bool isComplete = end == start + len;
+
+    const wxArrayString
+        records = wxSplit(wxString::FromUTF8(start, end - start), '\n', '\0');
+    if ( records.empty() ||
+            records[0] != wxString(JOURNAL_HEADER) + GetLocalFileSignature() )
+    {
+        // this journal was written for a different local file, e.g. because
+        // we crashed after rewriting the file but before removing it
+        wxLogTrace( FILECONF_TRACE_MASK,
+                    wxT("  Ignoring stale journal '%s'"),
+                    path );
+        return;
+    }
+
+    m_isReplayingJournal = true;
+
+    for ( size_t n = 1; n < records.size(); n++ )
+    {
+        if ( records[n].empty() )
+            continue;
+
+        wxArrayString args = wxSplit(records[n], '\t', '\0');
+        for ( auto& arg : args )
+            arg = UnescapeJournalArg(arg);
+
+        const wxString& op = args[0];
+        if ( op == wxS("set") && args.size() == 3 )
+        {
+            DoWriteString(args[1], args[2]);
+        }
+        else if ( op == wxS("delentry") && args.size() == 3 )
+        {
+            DeleteEntry(args[1], args[2] == wxS("1"));
+        }
+        else if ( op == wxS("delgroup") && args.size() == 2 )
+        {
+            DeleteGroup(args[1]);
+        }
+        else if ( op == wxS("renentry") && args.size() == 4 )
+        {
+            SetPath(args[1]);
+            RenameEntry(args[2], args[3]);
+            SetRootPath();
+        }
+        else if ( op == wxS("rengroup") && args.size() == 4 )
+        {
+            SetPath(args[1]);
+            RenameGroup(args[2], args[3]);
+            SetRootPath();
+        }
+        else
+        {
+            wxLogWarning(_("file '%s': invalid journal record at line %zu."),
+                         path, n + 1);
+        }
+    }
+
+    m_isReplayingJournal = false;
+
+    if ( isComplete && (GetStyle() & wxCONFIG_USE_JOURNAL) )
+    {
+        // we can keep appending to this journal
+        m_journalSize = len;
+        ResetDirty();
+    }
+    else
+    {
+        // the changes from the journal must be saved to the file on the next
+        // flush, which will also remove the journal
+        m_mustCompactJournal = true;
+        SetDirty();
+    }
+}
+
+void wxFileConfig::RemoveJournal()
+{
+    const wxString path = GetJournalFile().GetFullPath();
+    if ( wxFileExists(path) && !wxRemoveFile(path) )
+    {
+        wxLogSysError(_("can't delete configuration journal file '%s'"),
+                      path);
+    }
+
+    m_journalPending.clear();
+    m_journalSize = 0;
+    m_mustCompactJournal = false;
+}
+
 // ----------------------------------------------------------------------------
 // renaming groups/entries
 // ----------------------------------------------------------------------------
@@ -1240,6 +1526,15 @@ bool wxFileConfig::RenameEntry(const wxString& oldName,
     wxFileConfigEntry *newEntry = m_pCurrentGroup->AddEntry(newName);
     newEntry->SetValue(value);
 
+    if ( IsJournaling() )
+    {
+        AddJournalRecord(wxS("renentry") +
+                         JournalArg(m_pCurrentGroup->GetFullName() +
+                                    wxCONFIG_PATH_SEPARATOR) +
+                         JournalArg(oldName) +
+                         JournalArg(newName));
+    }
+
     return true;
 }
 
@@ -1259,6 +1554,15 @@ bool wxFileConfig::RenameGroup(const wxString& oldName,
 
     SetDirty();
 
+    if ( IsJournaling() )
+    {
+        AddJournalRecord(wxS("rengroup") +
+                         JournalArg(m_pCurrentGroup->GetFullName() +
+                                    wxCONFIG_PATH_SEPARATOR) +
+                         JournalArg(oldName) +
+                         JournalArg(newName));
+    }
+
     return true;
 }
 
@@ -1275,6 +1579,14 @@ bool wxFileConfig::DeleteEntry(const wxString& key, bool bGroupIfEmptyAlso)
 
   SetDirty();
 
+  if ( IsJournaling() )
+  {
+    AddJournalRecord(wxS("delentry") +
+                     JournalArg(m_pCurrentGroup->GetFullName() +
+                                wxCONFIG_PATH_SEPARATOR + path.Name()) +
+                     JournalArg(bGroupIfEmptyAlso ? wxS("1") : wxS("0")));
+  }
+
   if ( bGroupIfEmptyAlso && m_pCurrentGroup->IsEmpty() ) {
     if ( m_pCurrentGroup != m_pRootGroup ) {
       wxFileConfigGroup *pGroup = m_pCurrentGroup;
@@ -1294,6 +1606,13 @@ bool wxFileConfig::DeleteGroup(const wxString& key)
   if ( !m_pCurrentGroup->DeleteSubgroupByName(path.Name()) )
       return false;
 
+  if ( IsJournaling() )
+  {
+      AddJournalRecord(wxS("delgroup") +
+                       JournalArg(m_pCurrentGroup->GetFullName() +
+                                  wxCONFIG_PATH_SEPARATOR + path.Name()));
+  }
+
   path.UpdateIfDeleted();
 
   SetDirty();
@@ -1314,6 +1633,8 @@ bool wxFileConfig::DeleteAll()
                         m_fnLocalFile.GetFullPath());
           return false;
       }
+
+      RemoveJournal();
   }
 
   Init();
@@ -2255,4 +2576,87 @@ static wxString FilterOutEntryName(const wxString& str)
   return strResult;
 }
 
+// ----------------------------------------------------------------------------
+// journal helpers
+// ----------------------------------------------------------------------------
+
+static wxString JournalArg(const wxString& str)
+{
+    wxString strResult;
+    strResult.reserve(str.length() + 1);
+
+    strResult += wxS('\t');
+    for ( wxString::const_iterator i = str.begin(); i != str.end(); ++i )
+    {
+        switch ( (*i).GetValue() )
+        {
+            case wxT('\\'):
+                strResult += wxS("\\\\");
+                break;
+
+            case wxT('\t'):
+                strResult += wxS("\\t");
+                break;
+
+            case wxT('\n'):
+                strResult += wxS("\\n");
+                break;
+
+            case wxT('\r'):
+                strResult += wxS("\\r");
+                break;
+
+            default:
+                strResult += *i;
+        }
+    }
+
+    return strResult;
+}
+
+static wxString UnescapeJournalArg(const wxString& str)
+{
+    wxString strResult;
+    strResult.reserve(str.length());
+
+    for ( wxString::const_iterator i = str.begin(); i != str.end(); ++i )
+    {
+        if ( *i == wxT('\\') && i + 1 != str.end() )
+        {
+            switch ( (*++i).GetValue() )
+            {
+                case wxT('t'):
+                    strResult += wxS('\t');
+                    break;
+
+                case wxT('n'):
+                    strResult += wxS('\n');
+                    break;
+
+                case wxT('r'):
+                    strResult += wxS('\r');
+                    break;
+
+                default:
+                    strResult += *i;
+            }
+        }
+        else
+        {
+            strResult += *i;
+        }
+    }
+
+    return strResult;
+}
+
+static wxFileOffset GetFileSizeOrZero(const wxFileName& fn)
+{
+    if ( !fn.FileExists() )
+        return 0;
+
+    const wxULongLong size = fn.GetSize();
+    return size == wxInvalidSize ? 0 : static_cast<wxFileOffset>(size.GetValue());
+}
+
 #endif // wxUSE_CONFIG
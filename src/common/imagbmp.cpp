@@ -45,6 +45,7 @@
 #if wxUSE_ICO_CUR
 
 static bool CanReadICOOrCUR(wxInputStream *stream, wxUint16 resourceType);
+static bool CanReadICOOrCURHeader(const unsigned char* header, wxUint16 resourceType);
 
 #endif // wxUSE_ICO_CUR
 
@@ -1324,8 +1325,13 @@ bool wxBMPHandler::DoCanRead(wxInputStream& stream)
     if ( !stream.ReadAll(hdr, WXSIZEOF(hdr)) )     // it's ok to modify the stream position here
         return false;
 
+    return DoCanReadHeader(hdr);
+}
+
+bool wxBMPHandler::DoCanReadHeader(const unsigned char* header) const
+{
     // do we have the BMP file signature?
-    return hdr[0] == 'B' && hdr[1] == 'M';
+    return header[0] == 'B' && header[1] == 'M';
 }
 
 #endif // wxUSE_STREAMS
@@ -1793,6 +1799,11 @@ bool wxICOHandler::DoCanRead(wxInputStream& stream)
 
 }
 
+bool wxICOHandler::DoCanReadHeader(const unsigned char* header) const
+{
+    return CanReadICOOrCURHeader(header, 1 /*for identifying an icon*/);
+}
+
 #endif // wxUSE_STREAMS
 
 
@@ -1809,6 +1820,11 @@ bool wxCURHandler::DoCanRead(wxInputStream& stream)
     return CanReadICOOrCUR(&stream, 2 /*for identifying a cursor*/);
 }
 
+bool wxCURHandler::DoCanReadHeader(const unsigned char* header) const
+{
+    return CanReadICOOrCURHeader(header, 2 /*for identifying a cursor*/);
+}
+
 #endif // wxUSE_STREAMS
 
 //-----------------------------------------------------------------------------
@@ -1854,12 +1870,22 @@ static bool CanReadICOOrCUR(wxInputStream *stream, wxUint16 resourceType)
         return false;
     }
 
-    ICONDIR iconDir;
-    if ( !stream->ReadAll(&iconDir, sizeof(iconDir)) )
+    unsigned char header[sizeof(ICONDIR)];
+    if ( !stream->ReadAll(header, sizeof(header)) )
     {
         return false;
     }
 
+    return CanReadICOOrCURHeader(header, resourceType);
+}
+
+static bool CanReadICOOrCURHeader(const unsigned char* header, wxUint16 resourceType)
+{
+    wxCOMPILE_TIME_ASSERT( sizeof(ICONDIR) == 6, IconDirHeaderSize );
+
+    ICONDIR iconDir;
+    memcpy(&iconDir, header, sizeof(iconDir));
+
     return !iconDir.idReserved // reserved, must be 0
         && wxUINT16_SWAP_ON_BE(iconDir.idType) == resourceType // either 1 or 2
         && iconDir.idCount; // must contain at least one image
@@ -24,14 +24,31 @@
     #include "wx/colour.h"
 #endif
 
+#include "wx/mstream.h"
+#include "wx/thread.h"
+#include "wx/threadpool.h"
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
 
+#include "wx/private/imagerows.h"
+
 // For memcpy
 #include <string.h>
 
+#include <functional>
+#include <unordered_map>
 #include <unordered_set>
 
+// SSE2 and NEON are always available on the 64-bit x86 and ARM architectures,
+// so use them for some pixel operations there without any run-time checks.
+#if defined(__x86_64__) || defined(_M_X64)
+    #define wxIMAGE_USE_SSE2
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define wxIMAGE_USE_NEON
+    #include <arm_neon.h>
+#endif
+
 // make the code compile with either wxFile*Stream or wxFFile*Stream:
 #define HAS_FILE_STREAMS (wxUSE_STREAMS && (wxUSE_FILE || wxUSE_FFILE))
 
@@ -54,8 +71,207 @@ IMPLEMENT_VARIANT_OBJECT_EXPORTED_SHALLOWCMP(wxImage,WXDLLEXPORT)
 //-----------------------------------------------------------------------------
 
 wxList wxImage::sm_handlers;
+int wxImage::sm_maxThreads = 1;
 wxImage wxNullImage;
 
+//-----------------------------------------------------------------------------
+// wxImageHandlersIndex
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// This class allows to find the image handlers by their name, type, extension
+// or MIME type without iterating over all of them.
+//
+// It is rebuilt by wxImage functions modifying the list of handlers and also
+// when the number of handlers in the list changes, which can happen if the
+// list returned by wxImage::GetHandlers() is modified directly. Notice that
+// changing the properties of the handler after adding it is not supported.
+class wxImageHandlersIndex
+{
+public:
+    wxImageHandlersIndex() = default;
+
+    void Rebuild();
+
+    wxImageHandler* FindByName(const wxString& name)
+    {
+        Update();
+        return Find(m_byName, name);
+    }
+
+    wxImageHandler* FindByType(wxBitmapType type)
+    {
+        Update();
+        return Find(m_byType, type);
+    }
+
+    wxImageHandler* FindByExtension(const wxString& ext, wxBitmapType type);
+
+    wxImageHandler* FindByMime(const wxString& mimetype)
+    {
+        Update();
+        return Find(m_byMime, mimetype.Lower());
+    }
+
+    // Return all handlers in the order in which they're in the list.
+    const wxVector<wxImageHandler*>& GetAll()
+    {
+        Update();
+        return m_all;
+    }
+
+    // Return the maximal value returned by GetHeaderSize() of all handlers.
+    size_t GetMaxHeaderSize()
+    {
+        Update();
+        return m_maxHeaderSize;
+    }
+
+private:
+    template <typename Map, typename Key>
+    static wxImageHandler* Find(const Map& map, const Key& key)
+    {
+        const auto it = map.find(key);
+        return it != map.end() ? it->second : nullptr;
+    }
+
+    void Update()
+    {
+        if ( m_all.size() != wxImage::GetHandlers().GetCount() )
+            Rebuild();
+    }
+
+    wxVector<wxImageHandler*> m_all;
+
+    // These maps contain the first handler in the list with the given key,
+    // as the linear search used before did.
+    std::unordered_map<wxString, wxImageHandler*> m_byName;
+    std::unordered_map<int, wxImageHandler*> m_byType;
+    std::unordered_map<wxString, wxImageHandler*> m_byMime;
+
+    // Extensions are compared case-insensitively (at least the alternative
+    // ones), so this map uses lower case extensions as keys and contains all
+    // handlers using this extension, which need to be checked for the type.
+    std::unordered_map<wxString, wxVector<wxImageHandler*>> m_byExt;
+
+    size_t m_maxHeaderSize = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageHandlersIndex);
+};
+
+wxImageHandlersIndex& GetHandlersIndex()
+{
+    static wxImageHandlersIndex s_index;
+    return s_index;
+}
+
+void wxImageHandlersIndex::Rebuild()
+{
+    m_all.clear();
+    m_byName.clear();
+    m_byType.clear();
+    m_byMime.clear();
+    m_byExt.clear();
+    m_maxHeaderSize = 0;
+
+    const wxList& list = wxImage::GetHandlers();
+    for ( wxList::compatibility_iterator node = list.GetFirst();
+          node;
+          node = node->GetNext() )
+    {
+        wxImageHandler* const handler = (wxImageHandler*)node->GetData();
+        m_all.push_back(handler);
+
+        // Note that emplace() doesn't overwrite the existing elements.
+        m_byName.emplace(handler->GetName(), handler);
+        m_byType.emplace(handler->GetType(), handler);
+        m_byMime.emplace(handler->GetMimeType().Lower(), handler);
+
+        m_byExt[handler->GetExtension().Lower()].push_back(handler);
+        for ( const wxString& ext : handler->GetAltExtensions() )
+        {
+            wxVector<wxImageHandler*>& handlers = m_byExt[ext.Lower()];
+            if ( handlers.empty() || handlers.back() != handler )
+                handlers.push_back(handler);
+        }
+
+#if wxUSE_STREAMS
+        m_maxHeaderSize = wxMax(m_maxHeaderSize, handler->GetHeaderSize());
+#endif // wxUSE_STREAMS
+    }
+}
+
+wxImageHandler*
+wxImageHandlersIndex::FindByExtension(const wxString& ext, wxBitmapType type)
+{
+    Update();
+
+    const auto it = m_byExt.find(ext.Lower());
+    if ( it == m_byExt.end() )
+        return nullptr;
+
+    // Use the same checks as the linear search did: the main extension is
+    // compared case-sensitively, but the alternative ones are not.
+    for ( wxImageHandler* const handler : it->second )
+    {
+        if ( type != wxBITMAP_TYPE_ANY && handler->GetType() != type )
+            continue;
+
+        if ( handler->GetExtension() == ext ||
+                handler->GetAltExtensions().Index(ext, false) != wxNOT_FOUND )
+            return handler;
+    }
+
+    return nullptr;
+}
+
+#if wxUSE_STREAMS
+
+// The first bytes of the image stream, used to determine the image format
+// without reading the stream once for every handler.
+class wxImageStreamHeader
+{
+public:
+    // Read the header from the stream without changing its position: this
+    // works even for non-seekable streams by putting the data back into them.
+    explicit wxImageStreamHeader(wxInputStream& stream)
+        : m_data(GetHandlersIndex().GetMaxHeaderSize())
+    {
+        if ( m_data.empty() )
+            return;
+
+        const wxFileOffset pos = stream.IsSeekable() ? stream.TellI()
+                                                     : wxInvalidOffset;
+
+        stream.Read(&m_data[0], m_data.size());
+        m_data.resize(stream.LastRead());
+
+        if ( pos != wxInvalidOffset )
+            stream.SeekI(pos);
+        else if ( !m_data.empty() )
+            stream.Ungetch(&m_data[0], m_data.size());
+    }
+
+    // Check if the given handler can read the image from the stream, using
+    // just the header if possible.
+    bool CanBeReadBy(wxImageHandler& handler, wxInputStream& stream) const
+    {
+        const wxDetectedImageHeader
+            header(stream, m_data.empty() ? nullptr : &m_data[0], m_data.size());
+
+        return handler.CanRead(header);
+    }
+
+private:
+    wxVector<unsigned char> m_data;
+};
+
+#endif // wxUSE_STREAMS
+
+} // anonymous namespace
+
 //-----------------------------------------------------------------------------
 // wxImageRefData
 //-----------------------------------------------------------------------------
@@ -507,6 +723,10 @@ wxImage::Scale( int width, int height, wxImageResizeQuality quality ) const
             image = ResampleBox(width, height);
             break;
 
+        case wxIMAGE_QUALITY_LANCZOS:
+            image = ResampleLanczos(width, height);
+            break;
+
         case wxIMAGE_QUALITY_HIGH:
             image = width < old_width && height < old_height
                         ? ResampleBox(width, height)
@@ -608,6 +828,35 @@ wxImage wxImage::ResampleNearest(int width, int height) const
 namespace
 {
 
+// Calls the given function for consecutive ranges [from, to) of the lines from
+// 0 to count, possibly in several threads if allowed by wxImage::SetMaxThreads().
+//
+// The function must only write to the lines in the range it gets and the
+// results must not depend on the order in which the lines are processed.
+void ProcessLines(int count, int length, const std::function<void (int, int)>& func)
+{
+#if wxUSE_THREADS
+    // Don't use threads for processing less than this number of pixels, the
+    // overhead of using them would outweigh any gains.
+    static const long long MIN_PIXELS_PER_THREAD = 0x10000;
+
+    long long threads = wxImage::GetMaxThreads();
+    if ( !threads )
+        threads = wxThread::GetCPUCount();
+
+    threads = wxMin(threads, static_cast<long long>(count) * length / MIN_PIXELS_PER_THREAD);
+    if ( threads > 1 )
+    {
+        // Use as many chunks as threads, the calling thread processes one of
+        // them and the pool threads the others.
+        wxThreadPool::Get().ParallelFor(0, count, func, static_cast<int>(threads));
+        return;
+    }
+#endif // wxUSE_THREADS
+
+    func(0, count);
+}
+
 struct BoxPrecalc
 {
     int boxStart;
@@ -679,84 +928,90 @@ wxImage wxImage::ResampleBox(int width, int height) const
 
     const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = nullptr;
+    unsigned char* const dst_data_start = ret_image.GetData();
+    unsigned char* dst_alpha_start = nullptr;
 
-    wxCHECK_MSG( dst_data, ret_image, wxS("unable to create image") );
+    wxCHECK_MSG( dst_data_start, ret_image, wxS("unable to create image") );
 
     if ( src_alpha )
     {
         ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
+        dst_alpha_start = ret_image.GetAlpha();
     }
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
-
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
+    ProcessLines(height, width, [&](int yFrom, int yTo)
     {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
+        unsigned char* dst_data = dst_data_start + yFrom * width * 3;
+        unsigned char* dst_alpha = src_alpha ? dst_alpha_start + yFrom * width : nullptr;
 
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
-        {
-            // Source pixel in the X direction
-            const BoxPrecalc& hPrecalc = hPrecalcs[x];
+        int averaged_pixels, src_pixel_index;
+        double sum_r, sum_g, sum_b, sum_a;
 
-            // Box of pixels to average
-            averaged_pixels = (vPrecalc.boxEnd - vPrecalc.boxStart + 1)
-                                * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+        for ( int y = yFrom; y < yTo; y++ )        // Destination image - Y direction
+        {
+            // Source pixel in the Y direction
+            const BoxPrecalc& vPrecalc = vPrecalcs[y];
 
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+            for ( int x = 0; x < width; x++ )      // Destination image - X direction
             {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                // Source pixel in the X direction
+                const BoxPrecalc& hPrecalc = hPrecalcs[x];
+
+                // Box of pixels to average
+                averaged_pixels = (vPrecalc.boxEnd - vPrecalc.boxStart + 1)
+                                    * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
+                sum_r = sum_g = sum_b = sum_a = 0.0;
+
+                for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
                 {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
+                    for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                    {
+                        // Calculate the actual index in our source pixels
+                        src_pixel_index = j * M_IMGDATA->m_width + i;
+
+                        if (src_alpha)
+                        {
+                            sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
+                            sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
+                            sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
+                            sum_a += src_alpha[src_pixel_index];
+                        }
+                        else
+                        {
+                            sum_r += src_data[src_pixel_index * 3 + 0];
+                            sum_g += src_data[src_pixel_index * 3 + 1];
+                            sum_b += src_data[src_pixel_index * 3 + 2];
+                        }
+                    }
+                }
 
-                    if (src_alpha)
+                // Calculate the average from the sum and number of averaged pixels
+                if (src_alpha)
+                {
+                    if (sum_a != 0)
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
-                        sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
-                        sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
-                        sum_a += src_alpha[src_pixel_index];
+                        dst_data[0] = (unsigned char)(sum_r / sum_a);
+                        dst_data[1] = (unsigned char)(sum_g / sum_a);
+                        dst_data[2] = (unsigned char)(sum_b / sum_a);
                     }
                     else
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0];
-                        sum_g += src_data[src_pixel_index * 3 + 1];
-                        sum_b += src_data[src_pixel_index * 3 + 2];
+                        dst_data[0] = 0;
+                        dst_data[1] = 0;
+                        dst_data[2] = 0;
                     }
-                }
-            }
-
-            // Calculate the average from the sum and number of averaged pixels
-            if (src_alpha)
-            {
-                if (sum_a != 0)
-                {
-                    dst_data[0] = (unsigned char)(sum_r / sum_a);
-                    dst_data[1] = (unsigned char)(sum_g / sum_a);
-                    dst_data[2] = (unsigned char)(sum_b / sum_a);
+                    *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
                 }
                 else
                 {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
+                    dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
+                    dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
+                    dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
                 }
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
+                dst_data += 3;
             }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-                dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-                dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
-            }
-            dst_data += 3;
         }
-    }
+    });
 
     return ret_image;
 }
@@ -829,15 +1084,15 @@ wxImage wxImage::ResampleBilinear(int width, int height) const
     wxImage ret_image(width, height, false);
     const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = nullptr;
+    unsigned char* const dst_data_start = ret_image.GetData();
+    unsigned char* dst_alpha_start = nullptr;
 
-    wxCHECK_MSG( dst_data, ret_image, wxS("unable to create image") );
+    wxCHECK_MSG( dst_data_start, ret_image, wxS("unable to create image") );
 
     if ( src_alpha )
     {
         ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
+        dst_alpha_start = ret_image.GetAlpha();
     }
 
     wxVector<BilinearPrecalc> vPrecalcs(height);
@@ -845,61 +1100,67 @@ wxImage wxImage::ResampleBilinear(int width, int height) const
     ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
-
-    for ( int dsty = 0; dsty < height; dsty++ )
+    ProcessLines(height, width, [&](int yFrom, int yTo)
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
+        unsigned char* dst_data = dst_data_start + yFrom * width * 3;
+        unsigned char* dst_alpha = src_alpha ? dst_alpha_start + yFrom * width : nullptr;
 
+        // initialize alpha values to avoid g++ warnings about possibly
+        // uninitialized variables
+        double r1, g1, b1, a1 = 0;
+        double r2, g2, b2, a2 = 0;
 
-        for ( int dstx = 0; dstx < width; dstx++ )
+        for ( int dsty = yFrom; dsty < yTo; dsty++ )
         {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
-
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
-
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
-
-            // result lines
+            // We need to calculate the source pixel to interpolate from - Y-axis
+            const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
+            const int y_offset1 = vPrecalc.offset1;
+            const int y_offset2 = vPrecalc.offset2;
+            const double dy = vPrecalc.dd;
+            const double dy1 = vPrecalc.dd1;
 
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
 
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
+            for ( int dstx = 0; dstx < width; dstx++ )
+            {
+                // X-axis of pixel to interpolate from
+                const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
+
+                const int x_offset1 = hPrecalc.offset1;
+                const int x_offset2 = hPrecalc.offset2;
+                const double dx = hPrecalc.dd;
+                const double dx1 = hPrecalc.dd1;
+
+                int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
+                int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
+                int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
+                int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
+
+                // first line
+                r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
+                g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
+                b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
+                if ( src_alpha )
+                    a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
+
+                // second line
+                r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
+                g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
+                b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
+                if ( src_alpha )
+                    a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
+
+                // result lines
+
+                dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
+                dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
+                dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
+                dst_data += 3;
+
+                if ( src_alpha )
+                    *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
+            }
         }
-    }
+    });
 
     return ret_image;
 }
@@ -1012,15 +1273,15 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
 
     const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = nullptr;
+    unsigned char* const dst_data_start = ret_image.GetData();
+    unsigned char* dst_alpha_start = nullptr;
 
-    wxCHECK_MSG( dst_data, ret_image, wxS("unable to create image") );
+    wxCHECK_MSG( dst_data_start, ret_image, wxS("unable to create image") );
 
     if ( src_alpha )
     {
         ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
+        dst_alpha_start = ret_image.GetAlpha();
     }
 
     // Precalculate weights
@@ -1030,324 +1291,614 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+    ProcessLines(height, width, [&](int yFrom, int yTo)
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+        unsigned char* dst_data = dst_data_start + yFrom * width * 3;
+        unsigned char* dst_alpha = src_alpha ? dst_alpha_start + yFrom * width : nullptr;
 
-        for ( int dstx = 0; dstx < width; dstx++ )
+        for ( int dsty = yFrom; dsty < yTo; dsty++ )
         {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            // We need to calculate the source pixel to interpolate from - Y-axis
+            const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
+            for ( int dstx = 0; dstx < width; dstx++ )
             {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+                // X-axis of pixel to interpolate from
+                const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+
+                // Sums for each color channel
+                double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
+                // Here we actually determine the RGBA values for the destination pixel
+                for ( int k = -1; k <= 2; k++ )
                 {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
-
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
-
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
-
-                    // Create a sum of all values for each color channel
-                    // adjusted for the pixel's calculated weight
-                    if ( src_alpha )
-                    {
-                        const unsigned char a = src_alpha[src_pixel_index];
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
-                        sum_a += a * pixel_weight;
-                    }
-                    else
+                    // Y offset
+                    const int y_offset = vPrecalc.offset[k + 1];
+
+                    // Loop across the X axis
+                    for ( int i = -1; i <= 2; i++ )
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
+                        // X offset
+                        const int x_offset = hPrecalc.offset[i + 1];
+
+                        // Calculate the exact position where the source data
+                        // should be pulled from based on the x_offset and y_offset
+                        int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
+
+                        // Calculate the weight for the specified pixel according
+                        // to the bicubic b-spline kernel we're using for
+                        // interpolation
+                        const double
+                            pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
+
+                        // Create a sum of all values for each color channel
+                        // adjusted for the pixel's calculated weight
+                        if ( src_alpha )
+                        {
+                            const unsigned char a = src_alpha[src_pixel_index];
+                            sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
+                            sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
+                            sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
+                            sum_a += a * pixel_weight;
+                        }
+                        else
+                        {
+                            sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
+                            sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
+                            sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
+                        }
                     }
                 }
-            }
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            if ( src_alpha )
-            {
-                if (sum_a != 0)
+                // Put the data into the destination image.  The summed values are
+                // of double data type and are rounded here for accuracy
+                if ( src_alpha )
                 {
-                     dst_data[0] = (unsigned char)(sum_r / sum_a + 0.5);
-                     dst_data[1] = (unsigned char)(sum_g / sum_a + 0.5);
-                     dst_data[2] = (unsigned char)(sum_b / sum_a + 0.5);
+                    if (sum_a != 0)
+                    {
+                         dst_data[0] = (unsigned char)(sum_r / sum_a + 0.5);
+                         dst_data[1] = (unsigned char)(sum_g / sum_a + 0.5);
+                         dst_data[2] = (unsigned char)(sum_b / sum_a + 0.5);
+                    }
+                    else
+                    {
+                        dst_data[0] = 0;
+                        dst_data[1] = 0;
+                        dst_data[2] = 0;
+                    }
+                    *dst_alpha++ = (unsigned char)sum_a;
                 }
                 else
                 {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
+                    dst_data[0] = (unsigned char)(sum_r + 0.5);
+                    dst_data[1] = (unsigned char)(sum_g + 0.5);
+                    dst_data[2] = (unsigned char)(sum_b + 0.5);
                 }
-                *dst_alpha++ = (unsigned char)sum_a;
+                dst_data += 3;
             }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r + 0.5);
-                dst_data[1] = (unsigned char)(sum_g + 0.5);
-                dst_data[2] = (unsigned char)(sum_b + 0.5);
-            }
-            dst_data += 3;
         }
-    }
+    });
 
     return ret_image;
 }
 
-// Blur in the horizontal direction
-wxImage wxImage::BlurHorizontal(int blurRadius) const
+namespace
 {
-    wxImage ret_image(MakeEmptyClone());
 
-    wxCHECK( ret_image.IsOk(), ret_image );
+// Radius of the Lanczos kernel used by ResampleLanczos().
+const int LANCZOS_RADIUS = 3;
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
+// Number of bits used for the fractional part of the fixed point weights:
+// this must be small enough for the sum of the products of the weights with
+// the premultiplied colour values, which can be slightly greater than 255*255
+// after the first pass because of the negative lobes of the kernel, to fit in
+// int.
+const int LANCZOS_WEIGHT_BITS = 12;
 
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+double LanczosKernel(double x)
+{
+    if ( x == 0.0 )
+        return 1.0;
 
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
-        {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
+    if ( x <= -LANCZOS_RADIUS || x >= LANCZOS_RADIUS )
+        return 0.0;
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
+    const double px = M_PI * x;
+    return LANCZOS_RADIUS * sin(px) * sin(px / LANCZOS_RADIUS) / (px * px);
+}
 
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+struct LanczosPrecalc
+{
+    // The first source pixel used for this destination pixel.
+    int first;
 
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
-        {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
+    // The number of the source pixels used, each of them having the weight
+    // at the same index in LanczosWeights::weights.
+    int count;
+};
 
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
+// The weights of the source pixels for all destination pixels in one
+// direction.
+struct LanczosWeights
+{
+    LanczosWeights(int oldDim, int newDim);
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    const int* GetWeights(int dst) const { return &weights[dst * maxCount]; }
 
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    wxVector<LanczosPrecalc> precalcs;
 
-    return ret_image;
-}
+    // The weights for all destination pixels, maxCount per pixel.
+    wxVector<int> weights;
+    int maxCount;
+};
 
-// Blur in the vertical direction
-wxImage wxImage::BlurVertical(int blurRadius) const
+LanczosWeights::LanczosWeights(int oldDim, int newDim)
+    : precalcs(newDim)
 {
-    wxImage ret_image(MakeEmptyClone());
+    wxASSERT( oldDim > 0 && newDim > 0 );
 
-    wxCHECK( ret_image.IsOk(), ret_image );
+    // Map the centers of the new pixels to the old coordinates and, when
+    // shrinking, stretch the kernel to cover all the old pixels corresponding
+    // to the new one to avoid aliasing.
+    const double scale = static_cast<double>(oldDim) / newDim;
+    const double filterScale = wxMax(scale, 1.0);
+    const double support = LANCZOS_RADIUS * filterScale;
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
+    maxCount = wxMin(static_cast<int>(ceil(support)) * 2 + 1, oldDim);
+    weights.resize(newDim * maxCount, 0);
 
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+    wxVector<double> values(maxCount);
+    for ( int dst = 0; dst < newDim; dst++ )
+    {
+        const double center = (dst + 0.5) * scale;
 
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
+        LanczosPrecalc& precalc = precalcs[dst];
+        precalc.first = wxMax(static_cast<int>(center - support + 0.5), 0);
+        precalc.count = wxMin(static_cast<int>(center + support + 0.5), oldDim)
+                            - precalc.first;
+        if ( precalc.count > maxCount )
+            precalc.count = maxCount;
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+        double total = 0;
+        for ( int k = 0; k < precalc.count; k++ )
+        {
+            values[k] = LanczosKernel((precalc.first + k + 0.5 - center) / filterScale);
+            total += values[k];
         }
 
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
+        // Normalize the weights and convert them to fixed point, ensuring
+        // that their sum is exactly 1 by correcting the biggest one, so that
+        // the areas of uniform colour remain unchanged.
+        int* const w = &weights[dst * maxCount];
+        int sum = 0,
+            biggest = 0;
+        for ( int k = 0; k < precalc.count; k++ )
         {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+            w[k] = wxRound(values[k] / total * (1 << LANCZOS_WEIGHT_BITS));
+            sum += w[k];
 
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+            if ( w[k] > w[biggest] )
+                biggest = k;
         }
-    }
 
-    return ret_image;
+        w[biggest] += (1 << LANCZOS_WEIGHT_BITS) - sum;
+    }
 }
 
-// The new blur function
-wxImage wxImage::Blur(int blurRadius) const
+// Converts the weighted sum in fixed point to an integer value, which is not
+// clamped to any range, as doing it before un-premultiplying the colours
+// would change them.
+inline int LanczosResult(int sum)
 {
-    wxImage ret_image;
-    ret_image.Create(M_IMGDATA->m_width, M_IMGDATA->m_height, false);
-
-    // Blur the image in each direction
-    ret_image = BlurHorizontal(blurRadius);
-    ret_image = ret_image.BlurVertical(blurRadius);
+    return sum >> LANCZOS_WEIGHT_BITS;
+}
 
-    return ret_image;
+inline unsigned char LanczosClamp(int value)
+{
+    return static_cast<unsigned char>(value < 0 ? 0 : value > 255 ? 255 : value);
 }
 
-wxImage wxImage::Rotate90( bool clockwise ) const
+// Resamples a row of pixels with N interleaved channels each horizontally.
+template <int N>
+void LanczosFilterRow(const int* src, int* dst, const LanczosWeights& weights)
 {
-    wxImage image(MakeEmptyClone(Clone_SwapOrientation));
+    const int width = weights.precalcs.size();
+    for ( int x = 0; x < width; x++, dst += N )
+    {
+        const LanczosPrecalc& precalc = weights.precalcs[x];
+        const int* const w = weights.GetWeights(x);
+        const int* s = src + precalc.first * N;
 
-    wxCHECK( image.IsOk(), image );
+        int sum[N];
+        for ( int c = 0; c < N; c++ )
+            sum[c] = 1 << (LANCZOS_WEIGHT_BITS - 1);
 
-    long height = M_IMGDATA->m_height;
-    long width  = M_IMGDATA->m_width;
+        for ( int k = 0; k < precalc.count; k++, s += N )
+        {
+            for ( int c = 0; c < N; c++ )
+                sum[c] += s[c] * w[k];
+        }
 
-    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_X) )
-    {
-        int hot_x = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_X );
-        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y,
-                        clockwise ? hot_x : width - 1 - hot_x);
+        for ( int c = 0; c < N; c++ )
+            dst[c] = LanczosResult(sum[c]);
+    }
+}
+
+} // anonymous namespace
+
+// This is the Lanczos resampling algorithm using fixed point arithmetic.
+wxImage wxImage::ResampleLanczos(int width, int height) const
+{
+    wxCHECK_MSG( IsOk(), {}, "invalid image" );
+
+    // The image is resampled horizontally and then vertically, using the
+    // weights computed only once for all rows and columns, with all channels
+    // of each pixel stored together in the intermediate buffer.
+    //
+    // As with bicubic resampling, the colours are weighted by alpha, so that
+    // the colour of transparent pixels doesn't affect the result. To avoid
+    // losing precision, the colour values are multiplied by alpha and the
+    // alpha values by 255, which allows to use the same code for all the
+    // channels, and the intermediate values are not rounded to 8 bits.
+
+    wxImage ret_image;
+
+    ret_image.Create(width, height, false);
+
+    const unsigned char* src_data = M_IMGDATA->m_data;
+    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
+    unsigned char* const dst_data_start = ret_image.GetData();
+    unsigned char* dst_alpha_start = nullptr;
+
+    wxCHECK_MSG( dst_data_start, ret_image, wxS("unable to create image") );
+
+    if ( src_alpha )
+    {
+        ret_image.SetAlpha();
+        dst_alpha_start = ret_image.GetAlpha();
+    }
+
+    const int old_width = M_IMGDATA->m_width;
+    const int old_height = M_IMGDATA->m_height;
+
+    const LanczosWeights hWeights(old_width, width);
+    const LanczosWeights vWeights(old_height, height);
+
+    const int channels = src_alpha ? 4 : 3;
+    const size_t rowLen = static_cast<size_t>(width) * channels;
+
+    wxVector<int> tmp(rowLen * old_height);
+
+    ProcessLines(old_height, width, [&](int yFrom, int yTo)
+    {
+        wxVector<int> row(old_width * channels);
+
+        for ( int y = yFrom; y < yTo; y++ )
+        {
+            const unsigned char* src = src_data + y * old_width * 3;
+            int* const dst = &tmp[y * rowLen];
+
+            if ( src_alpha )
+            {
+                const unsigned char* alpha = src_alpha + y * old_width;
+                for ( int x = 0; x < old_width; x++, src += 3 )
+                {
+                    const int a = alpha[x];
+                    row[x*4 + 0] = src[0] * a;
+                    row[x*4 + 1] = src[1] * a;
+                    row[x*4 + 2] = src[2] * a;
+                    row[x*4 + 3] = a * 255;
+                }
+
+                LanczosFilterRow<4>(&row[0], dst, hWeights);
+            }
+            else
+            {
+                for ( int n = 0; n < old_width * 3; n++ )
+                    row[n] = src[n];
+
+                LanczosFilterRow<3>(&row[0], dst, hWeights);
+            }
+        }
+    });
+
+    ProcessLines(height, width, [&](int yFrom, int yTo)
+    {
+        wxVector<int> sums(rowLen);
+
+        for ( int y = yFrom; y < yTo; y++ )
+        {
+            // Accumulate the contributions of all the source rows one by one
+            // to access the memory sequentially.
+            const LanczosPrecalc& precalc = vWeights.precalcs[y];
+            const int* const w = vWeights.GetWeights(y);
+
+            for ( size_t n = 0; n < rowLen; n++ )
+                sums[n] = 1 << (LANCZOS_WEIGHT_BITS - 1);
+
+            for ( int k = 0; k < precalc.count; k++ )
+            {
+                const int* const src = &tmp[(precalc.first + k) * rowLen];
+                const int weight = w[k];
+                for ( size_t n = 0; n < rowLen; n++ )
+                    sums[n] += src[n] * weight;
+            }
+
+            unsigned char* dst_data = dst_data_start + y * width * 3;
+            if ( src_alpha )
+            {
+                unsigned char* const dst_alpha = dst_alpha_start + y * width;
+                for ( int x = 0; x < width; x++, dst_data += 3 )
+                {
+                    const int a = LanczosResult(sums[x*4 + 3]);
+                    if ( a <= 0 )
+                    {
+                        dst_data[0] =
+                        dst_data[1] =
+                        dst_data[2] =
+                        dst_alpha[x] = 0;
+                        continue;
+                    }
+
+                    dst_alpha[x] = LanczosClamp((a + 127) / 255);
+
+                    for ( int c = 0; c < 3; c++ )
+                    {
+                        const int v = wxMax(LanczosResult(sums[x*4 + c]), 0);
+                        dst_data[c] = LanczosClamp((v * 255 + a / 2) / a);
+                    }
+                }
+            }
+            else
+            {
+                for ( size_t n = 0; n < rowLen; n++ )
+                    dst_data[n] = LanczosClamp(LanczosResult(sums[n]));
+            }
+        }
+    });
+
+    return ret_image;
+}
+
+// Blur in the horizontal direction
+wxImage wxImage::BlurHorizontal(int blurRadius) const
+{
+    wxImage ret_image(MakeEmptyClone());
+
+    wxCHECK( ret_image.IsOk(), ret_image );
+
+    const unsigned char* src_data = M_IMGDATA->m_data;
+    unsigned char* dst_data = ret_image.GetData();
+    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
+    unsigned char* dst_alpha = ret_image.GetAlpha();
+
+    // number of pixels we average over
+    const int blurArea = blurRadius*2 + 1;
+
+    // Horizontal blurring algorithm - average all pixels in the specified blur
+    // radius in the X or horizontal direction
+    ProcessLines(M_IMGDATA->m_height, M_IMGDATA->m_width, [&](int yFrom, int yTo)
+    {
+        for ( int y = yFrom; y < yTo; y++ )
+        {
+            // Variables used in the blurring algorithm
+            long sum_r = 0,
+                 sum_g = 0,
+                 sum_b = 0,
+                 sum_a = 0;
+
+            long pixel_idx;
+            const unsigned char *src;
+            unsigned char *dst;
+
+            // Calculate the average of all pixels in the blur radius for the first
+            // pixel of the row
+            for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
+            {
+                // To deal with the pixels at the start of a row so it's not
+                // grabbing GOK values from memory at negative indices of the
+                // image's data or grabbing from the previous row
+                if ( kernel_x < 0 )
+                    pixel_idx = y * M_IMGDATA->m_width;
+                else
+                    pixel_idx = kernel_x + y * M_IMGDATA->m_width;
+
+                src = src_data + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( src_alpha )
+                    sum_a += src_alpha[pixel_idx];
+            }
+
+            dst = dst_data + y * M_IMGDATA->m_width*3;
+            dst[0] = (unsigned char)(sum_r / blurArea);
+            dst[1] = (unsigned char)(sum_g / blurArea);
+            dst[2] = (unsigned char)(sum_b / blurArea);
+            if ( src_alpha )
+                dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+
+            // Now average the values of the rest of the pixels by just moving the
+            // blur radius box along the row
+            for ( int x = 1; x < M_IMGDATA->m_width; x++ )
+            {
+                // Take care of edge pixels on the left edge by essentially
+                // duplicating the edge pixel
+                if ( x - blurRadius - 1 < 0 )
+                    pixel_idx = y * M_IMGDATA->m_width;
+                else
+                    pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
+
+                // Subtract the value of the pixel at the left side of the blur
+                // radius box
+                src = src_data + pixel_idx*3;
+                sum_r -= src[0];
+                sum_g -= src[1];
+                sum_b -= src[2];
+                if ( src_alpha )
+                    sum_a -= src_alpha[pixel_idx];
+
+                // Take care of edge pixels on the right edge
+                if ( x + blurRadius > M_IMGDATA->m_width - 1 )
+                    pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
+                else
+                    pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
+
+                // Add the value of the pixel being added to the end of our box
+                src = src_data + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( src_alpha )
+                    sum_a += src_alpha[pixel_idx];
+
+                // Save off the averaged data
+                dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
+                dst[0] = (unsigned char)(sum_r / blurArea);
+                dst[1] = (unsigned char)(sum_g / blurArea);
+                dst[2] = (unsigned char)(sum_b / blurArea);
+                if ( src_alpha )
+                    dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+            }
+        }
+    });
+
+    return ret_image;
+}
+
+// Blur in the vertical direction
+wxImage wxImage::BlurVertical(int blurRadius) const
+{
+    wxImage ret_image(MakeEmptyClone());
+
+    wxCHECK( ret_image.IsOk(), ret_image );
+
+    const unsigned char* src_data = M_IMGDATA->m_data;
+    unsigned char* dst_data = ret_image.GetData();
+    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
+    unsigned char* dst_alpha = ret_image.GetAlpha();
+
+    // number of pixels we average over
+    const int blurArea = blurRadius*2 + 1;
+
+    // Vertical blurring algorithm - same as horizontal but switched the
+    // opposite direction, so the image is split in vertical bands here
+    ProcessLines(M_IMGDATA->m_width, M_IMGDATA->m_height, [&](int xFrom, int xTo)
+    {
+        for ( int x = xFrom; x < xTo; x++ )
+        {
+            // Variables used in the blurring algorithm
+            long sum_r = 0,
+                 sum_g = 0,
+                 sum_b = 0,
+                 sum_a = 0;
+
+            long pixel_idx;
+            const unsigned char *src;
+            unsigned char *dst;
+
+            // Calculate the average of all pixels in our blur radius box for the
+            // first pixel of the column
+            for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
+            {
+                // To deal with the pixels at the start of a column so it's not
+                // grabbing GOK values from memory at negative indices of the
+                // image's data or grabbing from the previous column
+                if ( kernel_y < 0 )
+                    pixel_idx = x;
+                else
+                    pixel_idx = x + kernel_y * M_IMGDATA->m_width;
+
+                src = src_data + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( src_alpha )
+                    sum_a += src_alpha[pixel_idx];
+            }
+
+            dst = dst_data + x*3;
+            dst[0] = (unsigned char)(sum_r / blurArea);
+            dst[1] = (unsigned char)(sum_g / blurArea);
+            dst[2] = (unsigned char)(sum_b / blurArea);
+            if ( src_alpha )
+                dst_alpha[x] = (unsigned char)(sum_a / blurArea);
+
+            // Now average the values of the rest of the pixels by just moving the
+            // box along the column from top to bottom
+            for ( int y = 1; y < M_IMGDATA->m_height; y++ )
+            {
+                // Take care of pixels that would be beyond the top edge by
+                // duplicating the top edge pixel for the column
+                if ( y - blurRadius - 1 < 0 )
+                    pixel_idx = x;
+                else
+                    pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
+
+                // Subtract the value of the pixel at the top of our blur radius box
+                src = src_data + pixel_idx*3;
+                sum_r -= src[0];
+                sum_g -= src[1];
+                sum_b -= src[2];
+                if ( src_alpha )
+                    sum_a -= src_alpha[pixel_idx];
+
+                // Take care of the pixels that would be beyond the bottom edge of
+                // the image similar to the top edge
+                if ( y + blurRadius > M_IMGDATA->m_height - 1 )
+                    pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
+                else
+                    pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
+
+                // Add the value of the pixel being added to the end of our box
+                src = src_data + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( src_alpha )
+                    sum_a += src_alpha[pixel_idx];
+
+                // Save off the averaged data
+                dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
+                dst[0] = (unsigned char)(sum_r / blurArea);
+                dst[1] = (unsigned char)(sum_g / blurArea);
+                dst[2] = (unsigned char)(sum_b / blurArea);
+                if ( src_alpha )
+                    dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+            }
+        }
+    });
+
+    return ret_image;
+}
+
+// The new blur function
+wxImage wxImage::Blur(int blurRadius) const
+{
+    wxImage ret_image;
+    ret_image.Create(M_IMGDATA->m_width, M_IMGDATA->m_height, false);
+
+    // Blur the image in each direction
+    ret_image = BlurHorizontal(blurRadius);
+    ret_image = ret_image.BlurVertical(blurRadius);
+
+    return ret_image;
+}
+
+wxImage wxImage::Rotate90( bool clockwise ) const
+{
+    wxImage image(MakeEmptyClone(Clone_SwapOrientation));
+
+    wxCHECK( image.IsOk(), image );
+
+    long height = M_IMGDATA->m_height;
+    long width  = M_IMGDATA->m_width;
+
+    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_X) )
+    {
+        int hot_x = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_X );
+        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y,
+                        clockwise ? hot_x : width - 1 - hot_x);
     }
 
     if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y) )
@@ -1860,29 +2411,247 @@ wxImage::Paste(const wxImage & image, int x, int y,
     }
 }
 
-void wxImage::Replace( unsigned char r1, unsigned char g1, unsigned char b1,
-                       unsigned char r2, unsigned char g2, unsigned char b2 )
+// ----------------------------------------------------------------------------
+// Vectorized pixel operations
+// ----------------------------------------------------------------------------
+
+namespace
 {
-    wxCHECK_RET( IsOk(), wxT("invalid image") );
 
-    AllocExclusive();
+// Replaces all pixels of the colour (r1, g1, b1) among the given number of
+// RGB pixels with (r2, g2, b2).
+void ReplacePixels(unsigned char* data, size_t count,
+                   unsigned char r1, unsigned char g1, unsigned char b1,
+                   unsigned char r2, unsigned char g2, unsigned char b2)
+{
+    size_t n = 0;
 
-    unsigned char *data = GetData();
+#if defined(wxIMAGE_USE_SSE2)
+    // Compare 16 pixels, i.e. 3 vectors, at once with the colour repeated
+    // over 48 bytes and then find the pixels with all 3 components matching
+    // in the resulting bit mask: as matches are typically rare, it's not
+    // worth doing anything clever to replace them.
+    unsigned char pattern[48];
+    for ( int i = 0; i < 48; i += 3 )
+    {
+        pattern[i] = r1;
+        pattern[i + 1] = g1;
+        pattern[i + 2] = b1;
+    }
 
-    const int w = GetWidth();
-    const int h = GetHeight();
+    const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+    const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + 16));
+    const __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + 32));
 
-    for (int j = 0; j < h; j++)
-        for (int i = 0; i < w; i++)
+    for ( ; n + 16 <= count; n += 16, data += 48 )
+    {
+        const __m128i* const v = reinterpret_cast<const __m128i*>(data);
+
+        wxUint64 eq =
+            static_cast<wxUint64>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v), p0))) |
+            static_cast<wxUint64>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v + 1), p1))) << 16 |
+            static_cast<wxUint64>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v + 2), p2))) << 32;
+
+        // Keep only the bits corresponding to the first byte of each pixel.
+        eq &= (eq >> 1) & (eq >> 2) & wxULL(0x249249249249);
+
+        for ( unsigned char* p = data; eq; eq >>= 3, p += 3 )
+        {
+            if ( eq & 1 )
+            {
+                p[0] = r2;
+                p[1] = g2;
+                p[2] = b2;
+            }
+        }
+    }
+#elif defined(wxIMAGE_USE_NEON)
+    const uint8x16_t vr1 = vdupq_n_u8(r1),
+                     vg1 = vdupq_n_u8(g1),
+                     vb1 = vdupq_n_u8(b1),
+                     vr2 = vdupq_n_u8(r2),
+                     vg2 = vdupq_n_u8(g2),
+                     vb2 = vdupq_n_u8(b2);
+
+    for ( ; n + 16 <= count; n += 16, data += 48 )
+    {
+        uint8x16x3_t v = vld3q_u8(data);
+
+        const uint8x16_t eq = vandq_u8(vandq_u8(vceqq_u8(v.val[0], vr1),
+                                                vceqq_u8(v.val[1], vg1)),
+                                       vceqq_u8(v.val[2], vb1));
+        if ( vmaxvq_u8(eq) )
+        {
+            v.val[0] = vbslq_u8(eq, vr2, v.val[0]);
+            v.val[1] = vbslq_u8(eq, vg2, v.val[1]);
+            v.val[2] = vbslq_u8(eq, vb2, v.val[2]);
+            vst3q_u8(data, v);
+        }
+    }
+#endif // SIMD
+
+    for ( ; n < count; n++, data += 3 )
+    {
+        if ( data[0] == r1 && data[1] == g1 && data[2] == b1 )
+        {
+            data[0] = r2;
+            data[1] = g2;
+            data[2] = b2;
+        }
+    }
+}
+
+// Sets all pixels with alpha less than the threshold to the given colour.
+void SetTransparentPixels(unsigned char* data, const unsigned char* alpha,
+                          size_t count, unsigned char threshold,
+                          unsigned char r, unsigned char g, unsigned char b)
+{
+    size_t n = 0;
+
+#if defined(wxIMAGE_USE_SSE2)
+    const __m128i t = _mm_set1_epi8(static_cast<char>(threshold));
+
+    for ( ; n + 16 <= count; n += 16, data += 48, alpha += 16 )
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha));
+
+        // There is no unsigned comparison in SSE2, but max(a, t) == a if and
+        // only if a >= t, so the bits which are not set here are the ones
+        // corresponding to the pixels below the threshold.
+        unsigned below =
+            ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(a, t), a)) & 0xffff;
+
+        for ( unsigned char* p = data; below; below >>= 1, p += 3 )
         {
-            if ((data[0] == r1) && (data[1] == g1) && (data[2] == b1))
+            if ( below & 1 )
             {
-                data[0] = r2;
-                data[1] = g2;
-                data[2] = b2;
+                p[0] = r;
+                p[1] = g;
+                p[2] = b;
             }
-            data += 3;
         }
+    }
+#elif defined(wxIMAGE_USE_NEON)
+    const uint8x16_t t = vdupq_n_u8(threshold),
+                     vr = vdupq_n_u8(r),
+                     vg = vdupq_n_u8(g),
+                     vb = vdupq_n_u8(b);
+
+    for ( ; n + 16 <= count; n += 16, data += 48, alpha += 16 )
+    {
+        const uint8x16_t below = vcltq_u8(vld1q_u8(alpha), t);
+        if ( vmaxvq_u8(below) )
+        {
+            uint8x16x3_t v = vld3q_u8(data);
+            v.val[0] = vbslq_u8(below, vr, v.val[0]);
+            v.val[1] = vbslq_u8(below, vg, v.val[1]);
+            v.val[2] = vbslq_u8(below, vb, v.val[2]);
+            vst3q_u8(data, v);
+        }
+    }
+#endif // SIMD
+
+    for ( ; n < count; n++, data += 3, alpha++ )
+    {
+        if ( *alpha < threshold )
+        {
+            data[0] = r;
+            data[1] = g;
+            data[2] = b;
+        }
+    }
+}
+
+// Makes all pixels grey using the given weights, exactly as done by
+// wxColour::MakeGrey(), except for the pixels of the mask colour, if any.
+//
+// Returns false if the weights are not in the range supported by this
+// function, which must then not be used.
+bool MakeGreyPixels(unsigned char* data, size_t count,
+                    double weight_r, double weight_g, double weight_b,
+                    const unsigned char* mask)
+{
+    // Only non-negative values not greater than 1 are supported, which
+    // ensures that the luma is always in 0..765 range.
+    if ( weight_r < 0 || weight_r > 1 ||
+         weight_g < 0 || weight_g > 1 ||
+         weight_b < 0 || weight_b > 1 )
+        return false;
+
+    // Looking up the products of all possible component values with the
+    // weights is faster than converting the components to double and
+    // multiplying them and gives exactly the same results.
+    double lr[256], lg[256], lb[256];
+    for ( int i = 0; i < 256; i++ )
+    {
+        lr[i] = i * weight_r;
+        lg[i] = i * weight_g;
+        lb[i] = i * weight_b;
+    }
+
+    size_t n = 0;
+
+#if defined(wxIMAGE_USE_SSE2) && !defined(__FMA__)
+    // Notice that this can't be used if the compiler could have used FMA
+    // instructions in MakeGrey() as they could give slightly different
+    // results, which is why it isn't done for NEON neither.
+    const __m128d half = _mm_set1_pd(0.5);
+
+    for ( ; n + 2 <= count; n += 2, data += 6 )
+    {
+        const __m128d luma = _mm_add_pd(
+                                _mm_add_pd(_mm_set_pd(lr[data[3]], lr[data[0]]),
+                                           _mm_set_pd(lg[data[4]], lg[data[1]])),
+                                _mm_set_pd(lb[data[5]], lb[data[2]]));
+
+        // Round half away from zero, as wxRound() does, by truncating the
+        // (non-negative) value and incrementing it if the fractional part,
+        // which is computed exactly here, is at least one half.
+        const __m128i trunc = _mm_cvttpd_epi32(luma);
+        const __m128d frac = _mm_sub_pd(luma, _mm_cvtepi32_pd(trunc));
+        const __m128i up = _mm_shuffle_epi32(_mm_castpd_si128(_mm_cmpge_pd(frac, half)),
+                                             _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128i grey = _mm_sub_epi32(trunc, up);
+
+        unsigned char* p = data;
+        for ( int i = 0; i < 2; i++, p += 3 )
+        {
+            if ( mask && p[0] == mask[0] && p[1] == mask[1] && p[2] == mask[2] )
+                continue;
+
+            p[0] =
+            p[1] =
+            p[2] = static_cast<wxByte>(_mm_cvtsi128_si32(i ? _mm_srli_si128(grey, 4)
+                                                           : grey));
+        }
+    }
+#endif // SSE2
+
+    for ( ; n < count; n++, data += 3 )
+    {
+        if ( mask && data[0] == mask[0] && data[1] == mask[1] && data[2] == mask[2] )
+            continue;
+
+        const double luma = lr[data[0]] + lg[data[1]] + lb[data[2]];
+        data[0] =
+        data[1] =
+        data[2] = static_cast<wxByte>(wxRound(luma));
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+void wxImage::Replace( unsigned char r1, unsigned char g1, unsigned char b1,
+                       unsigned char r2, unsigned char g2, unsigned char b2 )
+{
+    wxCHECK_RET( IsOk(), wxT("invalid image") );
+
+    AllocExclusive();
+
+    ReplacePixels(GetData(), static_cast<size_t>(GetWidth()) * GetHeight(),
+                  r1, g1, b1, r2, g2, b2);
 }
 
 wxImage wxImage::ConvertToGreyscale() const
@@ -1893,6 +2662,25 @@ wxImage wxImage::ConvertToGreyscale() const
 wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double weight_b) const
 {
     wxImage image = *this;
+    if ( !image.IsOk() )
+        return image;
+
+    image.AllocExclusive();
+
+    unsigned char mask[3];
+    if ( image.HasMask() )
+    {
+        mask[0] = image.GetMaskRed();
+        mask[1] = image.GetMaskGreen();
+        mask[2] = image.GetMaskBlue();
+    }
+
+    if ( MakeGreyPixels(image.GetData(),
+                        static_cast<size_t>(image.GetWidth()) * image.GetHeight(),
+                        weight_r, weight_g, weight_b,
+                        image.HasMask() ? mask : nullptr) )
+        return image;
+
     image.ApplyToAllPixels([&image, weight_r, weight_g, weight_b](unsigned char *rgb)
     {
         if ( !image.HasMask() || rgb[0] != image.GetMaskRed() ||
@@ -2476,24 +3264,9 @@ bool wxImage::ConvertAlphaToMask(unsigned char mr,
     SetMask(true);
     SetMaskColour(mr, mg, mb);
 
-    unsigned char *imgdata = GetData();
-    unsigned char *alphadata = GetAlpha();
-
-    int w = GetWidth();
-    int h = GetHeight();
-
-    for (int y = 0; y < h; y++)
-    {
-        for (int x = 0; x < w; x++, imgdata += 3, alphadata++)
-        {
-            if (*alphadata < threshold)
-            {
-                imgdata[0] = mr;
-                imgdata[1] = mg;
-                imgdata[2] = mb;
-            }
-        }
-    }
+    SetTransparentPixels(GetData(), GetAlpha(),
+                         static_cast<size_t>(GetWidth()) * GetHeight(),
+                         threshold, mr, mg, mb);
 
     if ( !M_IMGDATA->m_staticAlpha )
         free(M_IMGDATA->m_alpha);
@@ -2603,6 +3376,20 @@ int wxImage::GetDefaultLoadFlags()
     return wxImageRefData::sm_defaultLoadFlags;
 }
 
+/* static */
+void wxImage::SetMaxThreads(int count)
+{
+    wxCHECK_RET( count >= 0, "invalid number of threads" );
+
+    sm_maxThreads = count;
+}
+
+/* static */
+int wxImage::GetMaxThreads()
+{
+    return sm_maxThreads;
+}
+
 void wxImage::SetLoadFlags(int flags)
 {
     AllocExclusive();
@@ -2832,12 +3619,11 @@ int wxImage::GetImageCount( const wxString& WXUNUSED_UNLESS_STREAMS(name),
 
 bool wxImage::CanRead( wxInputStream &stream )
 {
-    const wxList& list = GetHandlers();
+    const wxImageStreamHeader header(stream);
 
-    for ( wxList::compatibility_iterator node = list.GetFirst(); node; node = node->GetNext() )
+    for ( wxImageHandler* handler : GetHandlersIndex().GetAll() )
     {
-        wxImageHandler *handler=(wxImageHandler*)node->GetData();
-        if (handler->CanRead( stream ))
+        if ( header.CanBeReadBy(*handler, stream) )
             return true;
     }
 
@@ -2850,16 +3636,13 @@ int wxImage::GetImageCount( wxInputStream &stream, wxBitmapType type )
 
     if ( type == wxBITMAP_TYPE_ANY )
     {
-        const wxList& list = GetHandlers();
+        const wxImageStreamHeader header(stream);
 
-        for ( wxList::compatibility_iterator node = list.GetFirst();
-              node;
-              node = node->GetNext() )
+        for ( wxImageHandler* handlerToTry : GetHandlersIndex().GetAll() )
         {
-             handler = (wxImageHandler*)node->GetData();
-             if ( handler->CanRead(stream) )
+             if ( header.CanBeReadBy(*handlerToTry, stream) )
              {
-                 const int count = handler->GetImageCount(stream);
+                 const int count = handlerToTry->GetImageCount(stream);
                  if ( count >= 0 )
                      return count;
              }
@@ -2959,33 +3742,37 @@ bool wxImage::LoadFile( wxInputStream& stream, wxBitmapType type, int index )
 
     if ( type == wxBITMAP_TYPE_ANY )
     {
-        if ( !stream.IsSeekable() )
-        {
-            if ( verbose )
-            {
-                // The error message about image data format being unknown below
-                // would be misleading in this case as we are not even going to try
-                // any handlers because CanRead() never does anything for not
-                // seekable stream, so try to be more precise here.
-                wxLogError(_("Can't automatically determine the image format "
-                             "for non-seekable input."));
-            }
-            return false;
-        }
+        // Read the header only once instead of doing it for every handler.
+        const wxImageStreamHeader header(stream);
 
-        const wxList& list = GetHandlers();
-        for ( wxList::compatibility_iterator node = list.GetFirst();
-              node;
-              node = node->GetNext() )
+        for ( wxImageHandler* handlerToTry : GetHandlersIndex().GetAll() )
         {
-             handler = (wxImageHandler*)node->GetData();
-             if ( handler->CanRead(stream) && DoLoad(*handler, stream, index) )
+             if ( !header.CanBeReadBy(*handlerToTry, stream) )
+                 continue;
+
+             if ( DoLoad(*handlerToTry, stream, index) )
                  return true;
+
+             // We can't try the other handlers if we can't rewind the stream.
+             if ( !stream.IsSeekable() )
+                 return false;
         }
 
         if ( verbose )
         {
-            wxLogWarning( _("Unknown image data format.") );
+            if ( !stream.IsSeekable() )
+            {
+                // The error message about image data format being unknown
+                // would be misleading in this case as we couldn't try the
+                // handlers which need to read more than just the header, so
+                // try to be more precise here.
+                wxLogError(_("Can't automatically determine the image format "
+                             "for non-seekable input."));
+            }
+            else
+            {
+                wxLogWarning( _("Unknown image data format.") );
+            }
         }
 
         return false;
@@ -3096,6 +3883,7 @@ void wxImage::AddHandler( wxImageHandler *handler )
     if (FindHandler( handler->GetType() ) == nullptr)
     {
         sm_handlers.Append( handler );
+        GetHandlersIndex().Rebuild();
     }
     else
     {
@@ -3117,6 +3905,7 @@ void wxImage::InsertHandler( wxImageHandler *handler )
     if (FindHandler( handler->GetType() ) == nullptr)
     {
         sm_handlers.Insert( handler );
+        GetHandlersIndex().Rebuild();
     }
     else
     {
@@ -3133,6 +3922,7 @@ bool wxImage::RemoveHandler( const wxString& name )
     if (handler)
     {
         sm_handlers.DeleteObject(handler);
+        GetHandlersIndex().Rebuild();
         delete handler;
         return true;
     }
@@ -3142,57 +3932,22 @@ bool wxImage::RemoveHandler( const wxString& name )
 
 wxImageHandler *wxImage::FindHandler( const wxString& name )
 {
-    wxList::compatibility_iterator node = sm_handlers.GetFirst();
-    while (node)
-    {
-        wxImageHandler *handler = (wxImageHandler*)node->GetData();
-        if (handler->GetName().Cmp(name) == 0) return handler;
-
-        node = node->GetNext();
-    }
-    return nullptr;
+    return GetHandlersIndex().FindByName(name);
 }
 
 wxImageHandler *wxImage::FindHandler( const wxString& extension, wxBitmapType bitmapType )
 {
-    wxList::compatibility_iterator node = sm_handlers.GetFirst();
-    while (node)
-    {
-        wxImageHandler *handler = (wxImageHandler*)node->GetData();
-        if ((bitmapType == wxBITMAP_TYPE_ANY) || (handler->GetType() == bitmapType))
-        {
-            if (handler->GetExtension() == extension)
-                return handler;
-            if (handler->GetAltExtensions().Index(extension, false) != wxNOT_FOUND)
-                return handler;
-        }
-        node = node->GetNext();
-    }
-    return nullptr;
+    return GetHandlersIndex().FindByExtension(extension, bitmapType);
 }
 
 wxImageHandler *wxImage::FindHandler(wxBitmapType bitmapType )
 {
-    wxList::compatibility_iterator node = sm_handlers.GetFirst();
-    while (node)
-    {
-        wxImageHandler *handler = (wxImageHandler *)node->GetData();
-        if (handler->GetType() == bitmapType) return handler;
-        node = node->GetNext();
-    }
-    return nullptr;
+    return GetHandlersIndex().FindByType(bitmapType);
 }
 
 wxImageHandler *wxImage::FindHandlerMime( const wxString& mimetype )
 {
-    wxList::compatibility_iterator node = sm_handlers.GetFirst();
-    while (node)
-    {
-        wxImageHandler *handler = (wxImageHandler *)node->GetData();
-        if (handler->GetMimeType().IsSameAs(mimetype, false)) return handler;
-        node = node->GetNext();
-    }
-    return nullptr;
+    return GetHandlersIndex().FindByMime(mimetype);
 }
 
 void wxImage::InitStandardHandlers()
@@ -3214,6 +3969,7 @@ void wxImage::CleanUpHandlers()
     }
 
     sm_handlers.Clear();
+    GetHandlersIndex().Rebuild();
 }
 
 wxString wxImage::GetImageExtWildcard()
@@ -3344,43 +4100,278 @@ wxImage::RGBValue wxImage::HSVtoRGB(const HSVValue& hsv)
                 blue = hsv.value;
                 break;
 
-            case 4:
-                red = hsv.value * (1.0 - hsv.saturation * (1.0 - f));
-                green = p;
-                blue = hsv.value;
-                break;
+            case 4:
+                red = hsv.value * (1.0 - hsv.saturation * (1.0 - f));
+                green = p;
+                blue = hsv.value;
+                break;
+
+            default:    // case 5:
+                red = hsv.value;
+                green = p;
+                blue = hsv.value * (1.0 - hsv.saturation * f);
+                break;
+        }
+    }
+
+    return RGBValue((unsigned char)wxRound(red * 255.0),
+                    (unsigned char)wxRound(green * 255.0),
+                    (unsigned char)wxRound(blue * 255.0));
+}
+
+static void DoRotateHue(unsigned char *rgb, double angle)
+{
+    wxImage::RGBValue rgbValue(rgb[0], rgb[1], rgb[2]);
+    wxImage::HSVValue hsvValue = wxImage::RGBtoHSV(rgbValue);
+
+    hsvValue.hue = hsvValue.hue + angle;
+
+    if (hsvValue.hue > 1.0)
+        hsvValue.hue = hsvValue.hue - 1.0;
+    else if (hsvValue.hue < 0.0)
+        hsvValue.hue = hsvValue.hue + 1.0;
+
+    rgbValue = wxImage::HSVtoRGB(hsvValue);
+    rgb[0] = rgbValue.red;
+    rgb[1] = rgbValue.green;
+    rgb[2] = rgbValue.blue;
+}
+
+static void DoChangeSaturation(unsigned char *rgb, double factor)
+{
+    wxImage::RGBValue rgbValue(rgb[0], rgb[1], rgb[2]);
+    wxImage::HSVValue hsvValue = wxImage::RGBtoHSV(rgbValue);
+
+    hsvValue.saturation += hsvValue.saturation * factor;
+
+    if (hsvValue.saturation > 1.0)
+        hsvValue.saturation = 1.0;
+    else if (hsvValue.saturation < 0.0)
+        hsvValue.saturation = 0.0;
+
+    rgbValue = wxImage::HSVtoRGB(hsvValue);
+    rgb[0] = rgbValue.red;
+    rgb[1] = rgbValue.green;
+    rgb[2] = rgbValue.blue;
+}
+
+static void DoChangeBrightness(unsigned char *rgb, double factor)
+{
+    wxImage::RGBValue rgbValue(rgb[0], rgb[1], rgb[2]);
+    wxImage::HSVValue hsvValue = wxImage::RGBtoHSV(rgbValue);
+
+    hsvValue.value += hsvValue.value * factor;
+
+    if (hsvValue.value > 1.0)
+        hsvValue.value = 1.0;
+    else if (hsvValue.value < 0.0)
+        hsvValue.value = 0.0;
+
+    rgbValue = wxImage::HSVtoRGB(hsvValue);
+    rgb[0] = rgbValue.red;
+    rgb[1] = rgbValue.green;
+    rgb[2] = rgbValue.blue;
+}
+
+namespace
+{
+
+#if defined(wxIMAGE_USE_SSE2) && !defined(__FMA__)
+
+// Returns the elements of a where the mask is set and those of b elsewhere.
+inline __m128d SelectPD(__m128d mask, __m128d a, __m128d b)
+{
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+// Returns 1 if x is greater than 1, 0 if it is less than 0 and x otherwise.
+inline __m128d ClampToUnitPD(__m128d x)
+{
+    const __m128d zero = _mm_setzero_pd(),
+                  one = _mm_set1_pd(1.0);
+
+    return SelectPD(_mm_cmpgt_pd(x, one), one,
+                    SelectPD(_mm_cmplt_pd(x, zero), zero, x));
+}
+
+enum HSVComponent
+{
+    HSV_Hue,
+    HSV_Saturation,
+    HSV_Value
+};
+
+// Does the same thing as DoRotateHue(), DoChangeSaturation() or
+// DoChangeBrightness(), depending on the component, for two pixels at once.
+//
+// The colour components are passed as doubles in 0..255 range and all the
+// computations are done in the same order as in RGBtoHSV() and HSVtoRGB(), in
+// order to get exactly the same results. Notice that this is not the case if
+// the compiler could use FMA instructions for the latter, so this code is not
+// used then, and also not used with NEON for the same reason.
+void ChangeHSVComponentOf2Pixels(__m128d& r, __m128d& g, __m128d& b,
+                                 HSVComponent component, double amount)
+{
+    const __m128d zero = _mm_setzero_pd(),
+                  one = _mm_set1_pd(1.0),
+                  six = _mm_set1_pd(6.0),
+                  c255 = _mm_set1_pd(255.0);
+
+    // This part corresponds to RGBtoHSV(). The divisions by zero for grey
+    // pixels are harmless, as their results are not used.
+    const __m128d red = _mm_div_pd(r, c255),
+                  green = _mm_div_pd(g, c255),
+                  blue = _mm_div_pd(b, c255);
+
+    const __m128d minimumRGB = _mm_min_pd(blue, _mm_min_pd(green, red));
+
+    const __m128d greenIsMax = _mm_cmpgt_pd(green, red);
+    const __m128d redOrGreen = SelectPD(greenIsMax, green, red);
+    const __m128d blueIsMax = _mm_cmpgt_pd(blue, redOrGreen);
+    const __m128d maximumRGB = SelectPD(blueIsMax, blue, redOrGreen);
+
+    const __m128d deltaRGB = _mm_sub_pd(maximumRGB, minimumRGB);
+    const __m128d isGrey = _mm_cmpeq_pd(deltaRGB, zero);
+
+    // Select the operands before dividing to avoid doing it 3 times, this
+    // still gives the same result for the selected channel. Adding 0 to the
+    // quotient for the red channel doesn't change it either.
+    const __m128d hueDiff = SelectPD(blueIsMax, _mm_sub_pd(red, green),
+                                     SelectPD(greenIsMax,
+                                              _mm_sub_pd(blue, red),
+                                              _mm_sub_pd(green, blue)));
+    const __m128d hueBase = SelectPD(blueIsMax, _mm_set1_pd(4.0),
+                                     _mm_and_pd(greenIsMax, _mm_set1_pd(2.0)));
+
+    __m128d hue = _mm_add_pd(hueBase, _mm_div_pd(hueDiff, deltaRGB));
+    hue = _mm_div_pd(hue, six);
+    hue = SelectPD(_mm_cmplt_pd(hue, zero), _mm_add_pd(hue, one), hue);
+    hue = _mm_andnot_pd(isGrey, hue);
+
+    __m128d saturation = _mm_andnot_pd(isGrey, _mm_div_pd(deltaRGB, maximumRGB));
+    __m128d value = maximumRGB;
+
+    const __m128d amountPD = _mm_set1_pd(amount);
+    switch ( component )
+    {
+        case HSV_Hue:
+            hue = _mm_add_pd(hue, amountPD);
+            hue = SelectPD(_mm_cmpgt_pd(hue, one), _mm_sub_pd(hue, one),
+                           SelectPD(_mm_cmplt_pd(hue, zero),
+                                    _mm_add_pd(hue, one),
+                                    hue));
+            break;
+
+        case HSV_Saturation:
+            saturation = ClampToUnitPD(_mm_add_pd(saturation,
+                                                  _mm_mul_pd(saturation, amountPD)));
+            break;
 
-            default:    // case 5:
-                red = hsv.value;
-                green = p;
-                blue = hsv.value * (1.0 - hsv.saturation * f);
-                break;
-        }
+        case HSV_Value:
+            value = ClampToUnitPD(_mm_add_pd(value, _mm_mul_pd(value, amountPD)));
+            break;
     }
 
-    return RGBValue((unsigned char)wxRound(red * 255.0),
-                    (unsigned char)wxRound(green * 255.0),
-                    (unsigned char)wxRound(blue * 255.0));
+    // And this one to HSVtoRGB(). The hue is never negative here, so
+    // truncating it is the same as taking its floor.
+    const __m128d hue6 = _mm_mul_pd(hue, six);
+    const __m128d sector = _mm_cvtepi32_pd(_mm_cvttpd_epi32(hue6));
+    const __m128d f = _mm_sub_pd(hue6, sector);
+
+    const __m128d p = _mm_mul_pd(value, _mm_sub_pd(one, saturation));
+    const __m128d q = _mm_mul_pd(value,
+                                 _mm_sub_pd(one, _mm_mul_pd(saturation, f)));
+    const __m128d t = _mm_mul_pd(value,
+                                 _mm_sub_pd(one,
+                                            _mm_mul_pd(saturation,
+                                                       _mm_sub_pd(one, f))));
+
+    const __m128d s0 = _mm_cmpeq_pd(sector, zero),
+                  s1 = _mm_cmpeq_pd(sector, one),
+                  s2 = _mm_cmpeq_pd(sector, _mm_set1_pd(2.0)),
+                  s3 = _mm_cmpeq_pd(sector, _mm_set1_pd(3.0)),
+                  s4 = _mm_cmpeq_pd(sector, _mm_set1_pd(4.0));
+
+    const __m128d isGreyNow = _mm_cmpeq_pd(saturation, zero);
+
+    __m128d* const components[] = { &r, &g, &b };
+    const __m128d results[] =
+    {
+        SelectPD(s0, value, SelectPD(s1, q, SelectPD(s2, p, SelectPD(s3, p,
+            SelectPD(s4, t, value))))),
+        SelectPD(s0, t, SelectPD(s1, value, SelectPD(s2, value, SelectPD(s3, q,
+            p)))),
+        SelectPD(s0, p, SelectPD(s1, p, SelectPD(s2, t, SelectPD(s3, value,
+            SelectPD(s4, value, q))))),
+    };
+
+    for ( int n = 0; n < 3; n++ )
+    {
+        // Round half away from zero, as wxRound() does, see MakeGreyPixels().
+        const __m128d x = _mm_mul_pd(SelectPD(isGreyNow, value, results[n]),
+                                     c255);
+        const __m128d trunc = _mm_cvtepi32_pd(_mm_cvttpd_epi32(x));
+        const __m128d up = _mm_cmpge_pd(_mm_sub_pd(x, trunc), _mm_set1_pd(0.5));
+
+        *components[n] = _mm_add_pd(trunc, _mm_and_pd(up, one));
+    }
 }
 
-static void DoRotateHue(unsigned char *rgb, double angle)
+#endif // SSE2 without FMA
+
+// Changes the hue, saturation and brightness of the given pixels, doing
+// exactly the same thing as calling DoRotateHue(), DoChangeSaturation() and
+// DoChangeBrightness() for each of them for the non-zero parameters.
+void ChangeHSVOfPixels(unsigned char* const* pixels, size_t count,
+                       double angleH, double factorS, double factorV)
 {
-    wxImage::RGBValue rgbValue(rgb[0], rgb[1], rgb[2]);
-    wxImage::HSVValue hsvValue = wxImage::RGBtoHSV(rgbValue);
+    size_t n = 0;
 
-    hsvValue.hue = hsvValue.hue + angle;
+#if defined(wxIMAGE_USE_SSE2) && !defined(__FMA__)
+    for ( ; n + 2 <= count; n += 2 )
+    {
+        unsigned char* const p0 = pixels[n];
+        unsigned char* const p1 = pixels[n + 1];
 
-    if (hsvValue.hue > 1.0)
-        hsvValue.hue = hsvValue.hue - 1.0;
-    else if (hsvValue.hue < 0.0)
-        hsvValue.hue = hsvValue.hue + 1.0;
+        __m128d r = _mm_set_pd(p1[0], p0[0]),
+                g = _mm_set_pd(p1[1], p0[1]),
+                b = _mm_set_pd(p1[2], p0[2]);
 
-    rgbValue = wxImage::HSVtoRGB(hsvValue);
-    rgb[0] = rgbValue.red;
-    rgb[1] = rgbValue.green;
-    rgb[2] = rgbValue.blue;
+        if ( !wxIsNullDouble(angleH) )
+            ChangeHSVComponentOf2Pixels(r, g, b, HSV_Hue, angleH);
+
+        if ( !wxIsNullDouble(factorS) )
+            ChangeHSVComponentOf2Pixels(r, g, b, HSV_Saturation, factorS);
+
+        if ( !wxIsNullDouble(factorV) )
+            ChangeHSVComponentOf2Pixels(r, g, b, HSV_Value, factorV);
+
+        p0[0] = static_cast<unsigned char>(_mm_cvtsd_f64(r));
+        p0[1] = static_cast<unsigned char>(_mm_cvtsd_f64(g));
+        p0[2] = static_cast<unsigned char>(_mm_cvtsd_f64(b));
+        p1[0] = static_cast<unsigned char>(_mm_cvtsd_f64(_mm_unpackhi_pd(r, r)));
+        p1[1] = static_cast<unsigned char>(_mm_cvtsd_f64(_mm_unpackhi_pd(g, g)));
+        p1[2] = static_cast<unsigned char>(_mm_cvtsd_f64(_mm_unpackhi_pd(b, b)));
+    }
+#endif // SSE2 without FMA
+
+    for ( ; n < count; n++ )
+    {
+        unsigned char* const rgb = pixels[n];
+
+        if ( !wxIsNullDouble(angleH) )
+            DoRotateHue(rgb, angleH);
+
+        if ( !wxIsNullDouble(factorS) )
+            DoChangeSaturation(rgb, factorS);
+
+        if ( !wxIsNullDouble(factorV) )
+            DoChangeBrightness(rgb, factorV);
+    }
 }
 
+} // anonymous namespace
+
 // Rotates the hue of each pixel in the image by angle, which is a double in the
 // range [-1.0..+1.0], where -1.0 corresponds to -360 degrees and +1.0 corresponds
 // to +360 degrees.
@@ -3390,30 +4381,12 @@ void wxImage::RotateHue(double angle)
         return;
 
     wxASSERT(angle >= -1.0 && angle <= 1.0);
-    ApplyToAllPixels([angle](unsigned char *rgb)
+    ApplyToPixelBatches([angle](unsigned char* const* pixels, size_t count)
     {
-        DoRotateHue(rgb, angle);
+        ChangeHSVOfPixels(pixels, count, angle, 0.0, 0.0);
     });
 }
 
-static void DoChangeSaturation(unsigned char *rgb, double factor)
-{
-    wxImage::RGBValue rgbValue(rgb[0], rgb[1], rgb[2]);
-    wxImage::HSVValue hsvValue = wxImage::RGBtoHSV(rgbValue);
-
-    hsvValue.saturation += hsvValue.saturation * factor;
-
-    if (hsvValue.saturation > 1.0)
-        hsvValue.saturation = 1.0;
-    else if (hsvValue.saturation < 0.0)
-        hsvValue.saturation = 0.0;
-
-    rgbValue = wxImage::HSVtoRGB(hsvValue);
-    rgb[0] = rgbValue.red;
-    rgb[1] = rgbValue.green;
-    rgb[2] = rgbValue.blue;
-}
-
 // Changes the saturation of each pixel in the image. factor is a double in the
 // range [-1.0..+1.0], where -1.0 corresponds to -100 percent and +1.0 corresponds
 // to +100 percent.
@@ -3423,30 +4396,12 @@ void wxImage::ChangeSaturation(double factor)
         return;
 
     wxASSERT(factor >= -1.0 && factor <= 1.0);
-    ApplyToAllPixels([factor](unsigned char *rgb)
+    ApplyToPixelBatches([factor](unsigned char* const* pixels, size_t count)
     {
-        DoChangeSaturation(rgb, factor);
+        ChangeHSVOfPixels(pixels, count, 0.0, factor, 0.0);
     });
 }
 
-static void DoChangeBrightness(unsigned char *rgb, double factor)
-{
-    wxImage::RGBValue rgbValue(rgb[0], rgb[1], rgb[2]);
-    wxImage::HSVValue hsvValue = wxImage::RGBtoHSV(rgbValue);
-
-    hsvValue.value += hsvValue.value * factor;
-
-    if (hsvValue.value > 1.0)
-        hsvValue.value = 1.0;
-    else if (hsvValue.value < 0.0)
-        hsvValue.value = 0.0;
-
-    rgbValue = wxImage::HSVtoRGB(hsvValue);
-    rgb[0] = rgbValue.red;
-    rgb[1] = rgbValue.green;
-    rgb[2] = rgbValue.blue;
-}
-
 // Changes the brightness (value) of each pixel in the image. factor is a double
 // in the range [-1.0..+1.0], where -1.0 corresponds to -100 percent and +1.0
 // corresponds to +100 percent.
@@ -3456,9 +4411,9 @@ void wxImage::ChangeBrightness(double factor)
         return;
 
     wxASSERT(factor >= -1.0 && factor <= 1.0);
-    ApplyToAllPixels([factor](unsigned char *rgb)
+    ApplyToPixelBatches([factor](unsigned char* const* pixels, size_t count)
     {
-        DoChangeBrightness(rgb, factor);
+        ChangeHSVOfPixels(pixels, count, 0.0, 0.0, factor);
     });
 }
 
@@ -3475,16 +4430,10 @@ void wxImage::ChangeHSV(double angleH, double factorS, double factorV)
 
     wxASSERT(angleH >= -1.0 && angleH <= 1.0 && factorS >= -1.0 &&
              factorS <= 1.0 && factorV >= -1.0 && factorV <= 1.0);
-    ApplyToAllPixels([angleH, factorS, factorV](unsigned char *rgb)
+    ApplyToPixelBatches([angleH, factorS, factorV](unsigned char* const* pixels,
+                                                   size_t count)
     {
-        if ( !wxIsNullDouble(angleH) )
-            DoRotateHue(rgb, angleH);
-
-        if ( !wxIsNullDouble(factorS) )
-            DoChangeSaturation(rgb, factorS);
-
-        if ( !wxIsNullDouble(factorV) )
-            DoChangeBrightness(rgb, factorV);
+        ChangeHSVOfPixels(pixels, count, angleH, factorS, factorV);
     });
 }
 
@@ -3514,14 +4463,104 @@ bool wxImageHandler::CanRead( const wxString& name )
     return CanRead(stream);
 }
 
+bool wxImageHandler::CanReadHeader(const void* header, size_t len) const
+{
+    wxCHECK_MSG( header, false, wxT("null header pointer") );
+
+    const size_t headerSize = GetHeaderSize();
+    wxCHECK_MSG( headerSize, false,
+                 wxT("this handler can't check the image header") );
+
+    // The image is too short to be in our format.
+    if ( len < headerSize )
+        return false;
+
+    return DoCanReadHeader(static_cast<const unsigned char*>(header));
+}
+
+bool wxImageHandler::DoCanReadDetected(const wxDetectedImageHeader& header)
+{
+    // If this handler can recognize its images by their header, let
+    // DoCanRead() read it from memory: this avoids seeking back in the stream
+    // and also works for the non-seekable streams.
+    if ( GetHeaderSize() && header.GetLength() )
+    {
+        wxMemoryInputStream stream(header.GetData(), header.GetLength());
+
+        // But if DoCanRead() is overridden in a derived class and needs more
+        // data than the header contains, we still have to use the stream.
+        const bool canRead = DoCanRead(stream);
+        if ( canRead || !stream.Eof() )
+            return canRead;
+    }
+
+    return CanRead(header.GetStream());
+}
+
 bool wxImageHandler::CallDoCanRead(wxInputStream& stream)
 {
     return wxInputStreamPeeker(stream)
             .CallIfCanSeek(&wxImageHandler::DoCanRead, this);
 }
 
+bool wxImageHandler::LoadRows(wxImageRowSink& sink,
+                              wxInputStream& stream,
+                              int scale,
+                              bool verbose,
+                              int index)
+{
+    wxCHECK_MSG( scale > 0 && (scale & (scale - 1)) == 0, false,
+                 "scale must be a power of 2" );
+
+    return DoLoadRows(sink, stream, scale, verbose, index);
+}
+
+bool wxImageHandler::DoLoadRows(wxImageRowSink& sink,
+                                wxInputStream& stream,
+                                int scale,
+                                bool verbose,
+                                int index)
+{
+    wxImage image;
+    if ( !LoadFile(&image, stream, verbose, index) )
+        return false;
+
+    wxImageRowReducer reducer(sink, scale);
+
+    const int width = image.GetWidth(),
+              height = image.GetHeight();
+    if ( !reducer.Start(width, height, image.HasAlpha()) )
+        return false;
+
+    const unsigned char* const data = image.GetData();
+    const unsigned char* const alpha = image.GetAlpha();
+    for ( int y = 0; y < height; y++ )
+    {
+        if ( !reducer.ProcessRow(y, data + 3 * static_cast<size_t>(y) * width,
+                                 alpha ? alpha + static_cast<size_t>(y) * width
+                                       : nullptr) )
+            return false;
+    }
+
+    return true;
+}
+
 #endif // wxUSE_STREAMS
 
+/* static */
+int wxImageHandler::GetScaleForMaxSize(unsigned width, unsigned height,
+                                       unsigned maxWidth, unsigned maxHeight)
+{
+    int scale = 1;
+    while ( (maxWidth && width / scale > maxWidth) ||
+                (maxHeight && height / scale > maxHeight) )
+    {
+        scale *= 2;
+    }
+
+    return scale;
+}
+
 /* static */
 wxImageResolution
 wxImageHandler::GetResolutionFromOptions(const wxImage& image, int *x, int *y)
@@ -3558,6 +4597,135 @@ wxImageHandler::GetResolutionFromOptions(const wxImage& image, int *x, int *y)
     return (wxImageResolution)resUnit;
 }
 
+// ----------------------------------------------------------------------------
+// helpers for loading images row by row
+// ----------------------------------------------------------------------------
+
+bool wxImageRowReducer::Start(int width, int height, bool hasAlpha)
+{
+    if ( width <= 0 || height <= 0 )
+        return false;
+
+    m_blockWidth = wxMin(m_scale, width);
+    m_blockHeight = wxMin(m_scale, height);
+    m_width = width / m_blockWidth;
+    m_height = height / m_blockHeight;
+    m_hasAlpha = hasAlpha;
+
+    if ( m_scale > 1 )
+    {
+        m_sums.assign(3 * m_width, 0);
+        m_data.resize(3 * m_width);
+        if ( hasAlpha )
+        {
+            m_sumsAlpha.assign(m_width, 0);
+            m_alpha.resize(m_width);
+        }
+    }
+
+    return m_sink.Start(m_width, m_height, hasAlpha);
+}
+
+bool wxImageRowReducer::ProcessRow(int y,
+                                   const unsigned char* data,
+                                   const unsigned char* alpha)
+{
+    if ( m_scale == 1 )
+        return m_sink.ProcessRow(y, data, alpha);
+
+    // Ignore the extra rows at the bottom.
+    const int yDst = y / m_blockHeight;
+    if ( yDst >= m_height )
+        return true;
+
+    for ( int x = 0; x < m_width; x++ )
+    {
+        wxUint64* const sums = &m_sums[3 * x];
+        for ( int n = 0; n < m_blockWidth; n++, data += 3 )
+        {
+            if ( m_hasAlpha )
+            {
+                const unsigned a = *alpha++;
+                sums[0] += data[0] * a;
+                sums[1] += data[1] * a;
+                sums[2] += data[2] * a;
+                m_sumsAlpha[x] += a;
+            }
+            else
+            {
+                sums[0] += data[0];
+                sums[1] += data[1];
+                sums[2] += data[2];
+            }
+        }
+    }
+
+    if ( (y + 1) % m_blockHeight )
+        return true;
+
+    // This was the last row of the block, compute the averages.
+    const wxUint64 count = static_cast<wxUint64>(m_blockWidth) * m_blockHeight;
+    for ( int x = 0; x < m_width; x++ )
+    {
+        wxUint64* const sums = &m_sums[3 * x];
+        unsigned char* const dst = &m_data[3 * x];
+
+        if ( m_hasAlpha )
+        {
+            const wxUint64 sumAlpha = m_sumsAlpha[x];
+            for ( int c = 0; c < 3; c++ )
+            {
+                dst[c] = sumAlpha ? static_cast<unsigned char>((sums[c] + sumAlpha / 2) / sumAlpha)
+                                  : 0;
+            }
+
+            m_alpha[x] = static_cast<unsigned char>((sumAlpha + count / 2) / count);
+            m_sumsAlpha[x] = 0;
+        }
+        else
+        {
+            for ( int c = 0; c < 3; c++ )
+                dst[c] = static_cast<unsigned char>((sums[c] + count / 2) / count);
+        }
+
+        sums[0] =
+        sums[1] =
+        sums[2] = 0;
+    }
+
+    return m_sink.ProcessRow(yDst, &m_data[0], m_hasAlpha ? &m_alpha[0] : nullptr);
+}
+
+bool wxImageRowWriter::Start(int width, int height, bool hasAlpha)
+{
+    if ( !m_image.Create(width, height, false) )
+        return false;
+
+    if ( hasAlpha )
+        m_image.SetAlpha();
+
+    return true;
+}
+
+bool wxImageRowWriter::ProcessRow(int y,
+                                  const unsigned char* data,
+                                  const unsigned char* alpha)
+{
+    const size_t width = m_image.GetWidth();
+    memcpy(m_image.GetData() + 3 * width * y, data, 3 * width);
+
+    if ( m_image.HasAlpha() )
+    {
+        unsigned char* const dst = m_image.GetAlpha() + width * y;
+        if ( alpha )
+            memcpy(dst, alpha, width);
+        else
+            memset(dst, wxIMAGE_ALPHA_OPAQUE, width);
+    }
+
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // image histogram stuff
 // ----------------------------------------------------------------------------
@@ -3949,15 +5117,173 @@ wxImage wxImage::Rotate(double angle,
 // Helper function used internally by wxImage class only.
 template <typename F>
 void wxImage::ApplyToAllPixels(const F& func)
+{
+    ApplyToPixelBatches([&func](unsigned char* const* pixels, size_t count)
+    {
+        for ( size_t n = 0; n < count; n++ )
+            func(pixels[n]);
+    });
+}
+
+// Helper function used internally by wxImage class only.
+template <typename F>
+void wxImage::ApplyToPixelBatches(const F& func)
 {
     AllocExclusive();
 
     const size_t size = GetWidth() * GetHeight();
     unsigned char *data = GetData();
 
-    for ( size_t i = 0; i < size; i++, data += 3 )
+    static const size_t BATCH_SIZE = 64;
+    unsigned char* pixels[BATCH_SIZE];
+
+    // Process the given number of pixels starting from data without using
+    // the cache below.
+    const auto processDirectly = [&func, &data, &pixels](size_t count)
+    {
+        while ( count )
+        {
+            const size_t batch = wxMin(count, BATCH_SIZE);
+            for ( size_t n = 0; n < batch; n++, data += 3 )
+                pixels[n] = data;
+
+            func(pixels, batch);
+
+            count -= batch;
+        }
+    };
+
+    // The functors used here are relatively expensive, e.g. they convert each
+    // pixel to HSV and back, while real images typically contain many pixels
+    // of the same colour, so remember the results for the recently seen
+    // colours in a small direct-mapped cache, except for tiny images for which
+    // it is not worth it.
+    static const int CACHE_BITS = 12;
+    if ( size < (1u << CACHE_BITS) )
+    {
+        processDirectly(size);
+        return;
+    }
+
+    struct CacheEntry
+    {
+        // The colour of the pixel with the extra bit set to distinguish it
+        // from the unused entries, which are 0.
+        wxUint32 key;
+
+        // The colour after applying the functor to it or, if it hasn't been
+        // computed yet, the index of the pending pixel with the PENDING bit.
+        wxUint32 value;
+    };
+
+    static const wxUint32 PENDING = 0x80000000;
+
+    wxVector<CacheEntry> cache(1u << CACHE_BITS, CacheEntry());
+
+    // The pixels not found in the cache are collected in a batch, together
+    // with the cache entries to update with their new colours, and the
+    // pixels of the same colours as them, which are just copied when the
+    // batch is processed.
+    CacheEntry* entries[BATCH_SIZE];
+    size_t numPending = 0;
+
+    struct Duplicate
+    {
+        unsigned char* data;
+        size_t index;
+    };
+
+    static const size_t MAX_DUPLICATES = 4*BATCH_SIZE;
+    Duplicate duplicates[MAX_DUPLICATES];
+    size_t numDuplicates = 0;
+
+    const auto processPending = [&]()
     {
-        func(data);
+        func(pixels, numPending);
+
+        for ( size_t n = 0; n < numDuplicates; n++ )
+        {
+            const unsigned char* const p = pixels[duplicates[n].index];
+            unsigned char* const dup = duplicates[n].data;
+
+            dup[0] = p[0];
+            dup[1] = p[1];
+            dup[2] = p[2];
+        }
+
+        for ( size_t n = 0; n < numPending; n++ )
+        {
+            // The entry could have been reused for another pending pixel.
+            if ( entries[n]->value != (PENDING | n) )
+                continue;
+
+            const unsigned char* const p = pixels[n];
+            entries[n]->value = (p[0] << 16) | (p[1] << 8) | p[2];
+        }
+
+        numPending = 0;
+        numDuplicates = 0;
+    };
+
+    // For images with many different colours most lookups fail and using the
+    // cache only makes things slower, so check how often it is useful for
+    // each block of pixels and don't use it for the next blocks if it isn't.
+    static const size_t BLOCK_SIZE = 1u << 14;
+    static const int BLOCKS_TO_SKIP = 16;
+
+    int blocksToSkip = 0;
+    for ( size_t start = 0; start < size; start += BLOCK_SIZE )
+    {
+        const size_t count = wxMin(BLOCK_SIZE, size - start);
+
+        if ( blocksToSkip )
+        {
+            blocksToSkip--;
+            processDirectly(count);
+            continue;
+        }
+
+        size_t numMisses = 0;
+        for ( size_t i = 0; i < count; i++, data += 3 )
+        {
+            const wxUint32 colour = (data[0] << 16) | (data[1] << 8) | data[2];
+            CacheEntry& entry = cache[(colour * 2654435761u) >> (32 - CACHE_BITS)];
+            if ( entry.key == (colour | 0x1000000) )
+            {
+                if ( entry.value & PENDING )
+                {
+                    const Duplicate dup = { data, entry.value & ~PENDING };
+                    duplicates[numDuplicates] = dup;
+                    if ( ++numDuplicates == MAX_DUPLICATES )
+                        processPending();
+                }
+                else
+                {
+                    data[0] = static_cast<unsigned char>(entry.value >> 16);
+                    data[1] = static_cast<unsigned char>(entry.value >> 8);
+                    data[2] = static_cast<unsigned char>(entry.value);
+                }
+
+                continue;
+            }
+
+            numMisses++;
+
+            entry.key = colour | 0x1000000;
+            entry.value = PENDING | numPending;
+
+            pixels[numPending] = data;
+            entries[numPending] = &entry;
+
+            if ( ++numPending == BATCH_SIZE )
+                processPending();
+        }
+
+        if ( numPending )
+            processPending();
+
+        if ( numMisses > count / 2 )
+            blocksToSkip = BLOCKS_TO_SKIP;
     }
 }
 
@@ -167,6 +167,11 @@ bool wxGIFHandler::DoCanRead( wxInputStream& stream )
          // it's ok to modify the stream position here
 }
 
+bool wxGIFHandler::DoCanReadHeader(const unsigned char* header) const
+{
+    return memcmp(header, "GIF", 3) == 0;
+}
+
 int wxGIFHandler::DoGetImageCount( wxInputStream& stream )
 {
     wxGIFDecoder decod;
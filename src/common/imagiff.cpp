@@ -781,6 +781,11 @@ bool wxIFFHandler::DoCanRead(wxInputStream& stream)
          // it's ok to modify the stream position here
 }
 
+bool wxIFFHandler::DoCanReadHeader(const unsigned char* header) const
+{
+    return (memcmp(header, "FORM", 4) == 0) && (memcmp(header+8, "ILBM", 4) == 0);
+}
+
 #endif // wxUSE_STREAMS
 
 #endif // wxUSE_IFF
@@ -40,6 +40,8 @@
 #include "wx/filefn.h"
 #include "wx/wfstream.h"
 
+#include "wx/private/imagerows.h"
+
 // For memcpy
 #include <string.h>
 // For JPEG library error handling
@@ -230,18 +232,27 @@ static inline void wx_cmyk_to_rgb(unsigned char* rgb, const unsigned char* cmyk)
     #pragma warning(disable:4611)
 #endif /* VC++ */
 
-bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int WXUNUSED(index) )
+// Decode the JPEG image passing its rows to the given sink and, if image is
+// not null, set its options corresponding to the image metadata.
+//
+// If scale is greater than 1, libjpeg is asked to reduce the image size by
+// this factor while decoding it, which is much faster than doing it later,
+// but it may not support reducing it by as much as requested. If reducer is
+// non-null, it is then used to reduce the image by the remaining factor,
+// otherwise the rows are passed to the sink directly. Alternatively, the
+// maximal image size may be specified instead of the scale.
+static bool
+wx_jpeg_load(wxInputStream& stream,
+             bool verbose,
+             int scale,
+             unsigned maxWidth,
+             unsigned maxHeight,
+             wxImageRowSink& sink,
+             wxImageRowReducer* reducer,
+             wxImage* image)
 {
-    wxCHECK_MSG( image, false, "null image pointer" );
-
     struct jpeg_decompress_struct cinfo;
     wx_error_mgr jerr;
-    unsigned char *ptr;
-
-    // save this before calling Destroy()
-    const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
-                   maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
-    image->Destroy();
 
     cinfo.err = jpeg_std_error( &jerr );
     jerr.error_exit = wx_error_exit;
@@ -260,7 +271,6 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
       }
       (cinfo.src->term_source)(&cinfo);
       jpeg_destroy_decompress(&cinfo);
-      if (image->IsOk()) image->Destroy();
       return false;
     }
 
@@ -283,39 +293,61 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     // scale the picture to fit in the specified max size if necessary
     if ( maxWidth > 0 || maxHeight > 0 )
     {
-        unsigned& scale = cinfo.scale_denom;
-        while ( (maxWidth && (cinfo.image_width / scale > maxWidth)) ||
-                    (maxHeight && (cinfo.image_height / scale > maxHeight)) )
+        unsigned& denom = cinfo.scale_denom;
+        while ( (maxWidth && (cinfo.image_width / denom > maxWidth)) ||
+                    (maxHeight && (cinfo.image_height / denom > maxHeight)) )
         {
-            scale *= 2;
+            denom *= 2;
         }
     }
+    else
+    {
+        cinfo.scale_denom = scale;
+    }
 
     jpeg_start_decompress( &cinfo );
 
-    image->Create( cinfo.output_width, cinfo.output_height );
-    if (!image->IsOk()) {
-        jpeg_finish_decompress( &cinfo );
+    wxImageRowSink* rowSink = &sink;
+    if ( reducer )
+    {
+        // Check by how much the image was actually reduced by libjpeg.
+        const int dctScale = (cinfo.image_width + cinfo.output_width / 2)
+                                / cinfo.output_width;
+
+        int extraScale = 1;
+        while ( dctScale * extraScale * 2 <= scale )
+            extraScale *= 2;
+
+        reducer->SetScale(extraScale);
+        rowSink = reducer;
+    }
+
+    if ( !rowSink->Start(cinfo.output_width, cinfo.output_height, false) )
+    {
+        jpeg_abort_decompress( &cinfo );
+        (cinfo.src->term_source)(&cinfo);
         jpeg_destroy_decompress( &cinfo );
         return false;
     }
-    image->SetMask( false );
-    ptr = image->GetData();
 
     unsigned stride = cinfo.output_width * bytesPerPixel;
     JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
                             ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, 1 );
 
+    // the buffer for the row converted to RGB, only needed for CMYK images
+    JSAMPARRAY rgbbuf = cinfo.out_color_space == JCS_RGB
+                            ? tempbuf
+                            : (*cinfo.mem->alloc_sarray)
+                                ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                                 cinfo.output_width * 3, 1 );
+
     while ( cinfo.output_scanline < cinfo.output_height )
     {
+        const int y = cinfo.output_scanline;
         jpeg_read_scanlines( &cinfo, tempbuf, 1 );
-        if (cinfo.out_color_space == JCS_RGB)
-        {
-            memcpy( ptr, tempbuf[0], stride );
-            ptr += stride;
-        }
-        else // CMYK
+        if (cinfo.out_color_space != JCS_RGB)
         {
+            unsigned char* ptr = (unsigned char*) rgbbuf[0];
             const unsigned char* inptr = (const unsigned char*) tempbuf[0];
             for (size_t i = 0; i < cinfo.output_width; i++)
             {
@@ -324,24 +356,35 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
                 inptr += 4;
             }
         }
+
+        if ( !rowSink->ProcessRow(y, (const unsigned char*) rgbbuf[0], nullptr) )
+        {
+            jpeg_abort_decompress( &cinfo );
+            (cinfo.src->term_source)(&cinfo);
+            jpeg_destroy_decompress( &cinfo );
+            return false;
+        }
     }
 
-    // set up resolution if available: it's part of optional JFIF APP0 chunk
-    if ( cinfo.saw_JFIF_marker )
+    if ( image )
     {
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX, cinfo.X_density);
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY, cinfo.Y_density);
+        // set up resolution if available: it's part of optional JFIF APP0 chunk
+        if ( cinfo.saw_JFIF_marker )
+        {
+            image->SetOption(wxIMAGE_OPTION_RESOLUTIONX, cinfo.X_density);
+            image->SetOption(wxIMAGE_OPTION_RESOLUTIONY, cinfo.Y_density);
 
-        // we use the same values for this option as libjpeg so we don't need
-        // any conversion here
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, cinfo.density_unit);
-    }
+            // we use the same values for this option as libjpeg so we don't need
+            // any conversion here
+            image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, cinfo.density_unit);
+        }
 
-    if ( cinfo.image_width != cinfo.output_width || cinfo.image_height != cinfo.output_height )
-    {
-        // save the original image size
-        image->SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, cinfo.image_width);
-        image->SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, cinfo.image_height);
+        if ( cinfo.image_width != cinfo.output_width || cinfo.image_height != cinfo.output_height )
+        {
+            // save the original image size
+            image->SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, cinfo.image_width);
+            image->SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, cinfo.image_height);
+        }
     }
 
     jpeg_finish_decompress( &cinfo );
@@ -349,6 +392,33 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     return true;
 }
 
+bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int WXUNUSED(index) )
+{
+    wxCHECK_MSG( image, false, "null image pointer" );
+
+    // save this before calling Destroy()
+    const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
+                   maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+    image->Destroy();
+
+    wxImageRowWriter writer(*image);
+    if ( !wx_jpeg_load(stream, verbose, 1, maxWidth, maxHeight,
+                       writer, nullptr, image) )
+    {
+        if (image->IsOk()) image->Destroy();
+        return false;
+    }
+
+    return true;
+}
+
+bool wxJPEGHandler::DoLoadRows( wxImageRowSink& sink, wxInputStream& stream,
+                                int scale, bool verbose, int WXUNUSED(index) )
+{
+    wxImageRowReducer reducer(sink);
+    return wx_jpeg_load(stream, verbose, scale, 0, 0, sink, &reducer, nullptr);
+}
+
 typedef struct {
     struct jpeg_destination_mgr pub;
 
@@ -497,7 +567,12 @@ bool wxJPEGHandler::DoCanRead( wxInputStream& stream )
     if ( !stream.Read(hdr, WXSIZEOF(hdr)) )     // it's ok to modify the stream position here
         return false;
 
-    return hdr[0] == 0xFF && hdr[1] == 0xD8;
+    return DoCanReadHeader(hdr);
+}
+
+bool wxJPEGHandler::DoCanReadHeader( const unsigned char* header ) const
+{
+    return header[0] == 0xFF && header[1] == 0xD8;
 }
 
 #endif   // wxUSE_STREAMS
@@ -489,8 +489,13 @@ bool wxPCXHandler::DoCanRead( wxInputStream& stream )
     if ( !stream )
         return false;
 
+    return DoCanReadHeader(&c);
+}
+
+bool wxPCXHandler::DoCanReadHeader( const unsigned char* header ) const
+{
     // not very safe, but this is all we can get from PCX header :-(
-    return c == 10;
+    return header[0] == 10;
 }
 
 #endif // wxUSE_STREAMS
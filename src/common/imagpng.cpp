@@ -37,6 +37,8 @@
 
 #include <unordered_map>
 
+#include "wx/private/imagerows.h"
+
 #define wxIMAGE_OPTION_PNG_DESCRIPTION_KEY "Description"
 
 // ----------------------------------------------------------------------------
@@ -109,6 +111,7 @@ struct wxPNGImageData
     {
         lines = nullptr;
         m_buf = nullptr;
+        m_rowBuf = nullptr;
         info_ptr = (png_infop) nullptr;
         png_ptr = (png_structp) nullptr;
         ok = false;
@@ -144,6 +147,7 @@ struct wxPNGImageData
     ~wxPNGImageData()
     {
         free(m_buf);
+        free(m_rowBuf);
         free( lines );
 
         if ( png_ptr )
@@ -157,8 +161,24 @@ struct wxPNGImageData
 
     void DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo);
 
+    // Load the image row by row passing the rows to the given reducer, which
+    // is set up to reduce the image by the given scale or to fit it into the
+    // given maximal size, if it's non-zero, and set the image options if the
+    // image is non-null.
+    void DoLoadPNGRows(wxImageRowReducer& reducer,
+                       wxPNGInfoStruct& wxinfo,
+                       int scale,
+                       unsigned maxWidth,
+                       unsigned maxHeight,
+                       wxImage* image);
+
+    // Read the rest of the file after the image data and set the image
+    // options from the metadata found in it.
+    void FinishLoading(wxImage* image, int color_type);
+
     unsigned char** lines;
     unsigned char* m_buf;
+    unsigned char* m_rowBuf;
     png_infop info_ptr;
     png_structp png_ptr;
     bool ok;
@@ -242,7 +262,12 @@ bool wxPNGHandler::DoCanRead( wxInputStream& stream )
     if ( !stream.Read(hdr, WXSIZEOF(hdr)) )     // it's ok to modify the stream position here
         return false;
 
-    return memcmp(hdr, "\211PNG", WXSIZEOF(hdr)) == 0;
+    return DoCanReadHeader(hdr);
+}
+
+bool wxPNGHandler::DoCanReadHeader( const unsigned char* header ) const
+{
+    return memcmp(header, "\211PNG", 4) == 0;
 }
 
 // convert data from RGB to wxImage format
@@ -345,6 +370,24 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
 
     png_read_image( png_ptr, lines );
 
+    FinishLoading(image, color_type);
+
+    // loaded successfully, now init wxImage with this data
+    if (needCopy)
+        CopyDataFromPNG(image, lines, width, height);
+
+    // This will indicate to the caller that loading succeeded.
+    ok = true;
+}
+
+void wxPNGImageData::FinishLoading(wxImage* image, int color_type)
+{
+    if ( !image )
+    {
+        png_read_end( png_ptr, info_ptr );
+        return;
+    }
+
     // load "Description" text chunk
     png_textp text_ptr;
     const int num_comments = png_get_text( png_ptr, info_ptr, &text_ptr, nullptr );
@@ -445,11 +488,123 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
 
         image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, res);
     }
+}
 
+void
+wxPNGImageData::DoLoadPNGRows(wxImageRowReducer& reducer,
+                              wxPNGInfoStruct& wxinfo,
+                              int scale,
+                              unsigned maxWidth,
+                              unsigned maxHeight,
+                              wxImage* image)
+{
+    png_uint_32 width, height = 0;
+    int bit_depth, color_type, interlace_type;
 
-    // loaded successfully, now init wxImage with this data
-    if (needCopy)
-        CopyDataFromPNG(image, lines, width, height);
+    png_ptr = png_create_read_struct
+                          (
+                            PNG_LIBPNG_VER_STRING,
+                            nullptr,
+                            wx_PNG_error,
+                            wx_PNG_warning
+                          );
+    if (!png_ptr)
+        return;
+
+    png_set_read_fn( png_ptr, &wxinfo, wx_PNG_stream_reader);
+
+    info_ptr = png_create_info_struct( png_ptr );
+    if (!info_ptr)
+        return;
+
+    if (setjmp(wxinfo.jmpbuf))
+        return;
+
+    png_read_info( png_ptr, info_ptr );
+    png_get_IHDR( png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
+                  &interlace_type, nullptr, nullptr );
+
+    png_set_expand(png_ptr);
+    png_set_gray_to_rgb(png_ptr);
+    png_set_strip_16( png_ptr );
+    png_set_packing( png_ptr );
+    png_set_interlace_handling( png_ptr );
+    png_read_update_info( png_ptr, info_ptr );
+
+    const bool hasAlpha =
+        (color_type & PNG_COLOR_MASK_ALPHA) ||
+        png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
+
+    if ( maxWidth || maxHeight )
+        scale = wxPNGHandler::GetScaleForMaxSize(width, height, maxWidth, maxHeight);
+    reducer.SetScale(scale);
+
+    if ( !reducer.Start(width, height, hasAlpha) )
+        return;
+
+    // Interlaced images can't be decoded row by row, so we have to load all
+    // of them into memory in this case, otherwise we need just a single row.
+    const bool interlaced = interlace_type != PNG_INTERLACE_NONE;
+    if ( interlaced )
+    {
+        if ( !Alloc(width, height, nullptr) )
+            return;
+
+        png_read_image( png_ptr, lines );
+    }
+
+    // Allocate the buffer for the RGBA row and for its RGB and alpha parts.
+    m_rowBuf = static_cast<unsigned char*>(malloc(width * 8));
+    if ( !m_rowBuf )
+        return;
+
+    unsigned char* const rowRGB = m_rowBuf + 4 * width;
+    unsigned char* const rowAlpha = rowRGB + 3 * width;
+
+    // as in CopyDataFromPNG(), the image only has alpha if it is not opaque
+    bool opaque = true;
+
+    for ( png_uint_32 y = 0; y < height; y++ )
+    {
+        unsigned char* row = m_rowBuf;
+        if ( interlaced )
+            row = lines[y];
+        else
+            png_read_row( png_ptr, row, nullptr );
+
+        const unsigned char* rowData = row;
+        if ( hasAlpha )
+        {
+            const unsigned char* src = row;
+            for ( png_uint_32 x = 0; x < width; x++, src += 4 )
+            {
+                rowRGB[3*x] = src[0];
+                rowRGB[3*x + 1] = src[1];
+                rowRGB[3*x + 2] = src[2];
+                rowAlpha[x] = src[3];
+
+                if ( !IsOpaque(src[3]) )
+                    opaque = false;
+            }
+
+            rowData = rowRGB;
+        }
+
+        if ( !reducer.ProcessRow(y, rowData, hasAlpha ? rowAlpha : nullptr) )
+            return;
+    }
+
+    FinishLoading(image, color_type);
+
+    if ( image && opaque && image->HasAlpha() )
+        image->ClearAlpha();
+
+    if ( image && scale > 1 )
+    {
+        // save the original image size
+        image->SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, width);
+        image->SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, height);
+    }
 
     // This will indicate to the caller that loading succeeded.
     ok = true;
@@ -465,8 +620,25 @@ wxPNGHandler::LoadFile(wxImage *image,
     wxinfo.verbose = verbose;
     wxinfo.stream.in = &stream;
 
+    // save this before DoLoadPNGXXX() call Destroy()
+    const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
+                   maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+
     wxPNGImageData data;
-    data.DoLoadPNGFile(image, wxinfo);
+    if ( maxWidth || maxHeight )
+    {
+        // Reduce the image while loading it instead of loading the entire
+        // image into memory only to scale it down later.
+        image->Destroy();
+
+        wxImageRowWriter writer(*image);
+        wxImageRowReducer reducer(writer);
+        data.DoLoadPNGRows(reducer, wxinfo, 1, maxWidth, maxHeight, image);
+    }
+    else
+    {
+        data.DoLoadPNGFile(image, wxinfo);
+    }
 
     if ( !data.ok )
     {
@@ -486,6 +658,30 @@ wxPNGHandler::LoadFile(wxImage *image,
     return true;
 }
 
+bool
+wxPNGHandler::DoLoadRows(wxImageRowSink& sink,
+                         wxInputStream& stream,
+                         int scale,
+                         bool verbose,
+                         int WXUNUSED(index))
+{
+    wxPNGInfoStruct wxinfo;
+    wxinfo.verbose = verbose;
+    wxinfo.stream.in = &stream;
+
+    wxImageRowReducer reducer(sink);
+
+    wxPNGImageData data;
+    data.DoLoadPNGRows(reducer, wxinfo, scale, 0, 0, nullptr);
+
+    if ( !data.ok && verbose )
+    {
+        wxLogError(_("Couldn't load a PNG image - file is corrupted or not enough memory."));
+    }
+
+    return data.ok;
+}
+
 // ----------------------------------------------------------------------------
 // SaveFile() palette helpers
 // ----------------------------------------------------------------------------
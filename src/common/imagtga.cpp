@@ -928,7 +928,14 @@ bool wxTGAHandler::DoCanRead(wxInputStream& stream)
     // read the fixed-size TGA headers
     unsigned char hdr[HDR_SIZE];
     stream.Read(hdr, HDR_SIZE);     // it's ok to modify the stream position here
+    if ( stream.LastRead() != HDR_SIZE )
+        return false;
+
+    return DoCanReadHeader(hdr);
+}
 
+bool wxTGAHandler::DoCanReadHeader(const unsigned char* hdr) const
+{
     // Check whether we can read the file or not.
 
     short colorType = hdr[HDR_COLORTYPE];
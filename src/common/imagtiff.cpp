@@ -40,6 +40,8 @@ extern "C"
 #include "wx/filefn.h"
 #include "wx/wfstream.h"
 
+#include "wx/private/imagerows.h"
+
 #ifndef TIFFLINKAGEMODE
     #define TIFFLINKAGEMODE LINKAGEMODE
 #endif
@@ -288,11 +290,224 @@ TIFFwxOpen(wxOutputStream &stream, const char* name, const char* mode)
     return tif;
 }
 
+// ----------------------------------------------------------------------------
+// reading helpers
+// ----------------------------------------------------------------------------
+
+static bool wxTIFFHasAlpha(TIFF* tif)
+{
+    wxUint16 samplesPerPixel = 0;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+
+    wxUint16 extraSamples;
+    wxUint16* samplesInfo;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_EXTRASAMPLES,
+                          &extraSamples, &samplesInfo);
+
+    wxUint16 photometric;
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric))
+    {
+        photometric = PHOTOMETRIC_MINISWHITE;
+    }
+
+    return (extraSamples >= 1
+        && ((samplesInfo[0] == EXTRASAMPLE_UNSPECIFIED)
+            || samplesInfo[0] == EXTRASAMPLE_ASSOCALPHA
+            || samplesInfo[0] == EXTRASAMPLE_UNASSALPHA))
+        || (extraSamples == 0 && samplesPerPixel == 4
+            && photometric == PHOTOMETRIC_RGB);
+}
+
+// Check if the current directory can be decoded by wxTIFFLoadRows(): this is
+// not the case for the images which need special handling in LoadFile() nor
+// for the images using non default orientation, as libtiff only flips them
+// inside the band of rows being decoded.
+static bool wxTIFFCanLoadRows(TIFF* tif)
+{
+    char msg[1024] = "";
+    if ( !TIFFRGBAImageOK(tif, msg) )
+        return false;
+
+    wxUint16 samplesPerPixel = 0;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+    if ( samplesPerPixel == 2 )
+        return false;
+
+    wxUint16 orientation = ORIENTATION_TOPLEFT;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION, &orientation);
+
+    return orientation == ORIENTATION_TOPLEFT;
+}
+
+// Decode the image in bands of rows corresponding to its strips or tiles,
+// using memory only for a single band, and pass the rows to the sink.
+static bool wxTIFFLoadRows(TIFF* tif, wxImageRowSink& sink)
+{
+    char msg[1024] = "";
+    TIFFRGBAImage img;
+    if ( !TIFFRGBAImageBegin(&img, tif, 0, msg) )
+        return false;
+
+    img.req_orientation = ORIENTATION_TOPLEFT;
+
+    const wxUint32 w = img.width,
+                   h = img.height;
+
+    wxUint32 band = 0;
+    if ( TIFFIsTiled(tif) )
+        (void) TIFFGetField(tif, TIFFTAG_TILELENGTH, &band);
+    else
+        (void) TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &band);
+
+    if ( !band || band > h )
+        band = h;
+
+    const bool hasAlpha = wxTIFFHasAlpha(tif);
+
+    wxUint32* const raster = (wxUint32*)_TIFFmalloc(
+        (tmsize_t)w * band * sizeof(wxUint32) + (tmsize_t)w * 4);
+
+    bool ok = raster && sink.Start(w, h, hasAlpha);
+    if ( ok )
+    {
+        unsigned char* const rowRGB = (unsigned char*)(raster + (size_t)w * band);
+        unsigned char* const rowAlpha = rowRGB + 3 * w;
+
+        for ( wxUint32 y = 0; ok && y < h; y += band )
+        {
+            const wxUint32 rows = wxMin(band, h - y);
+
+            img.row_offset = y;
+            img.col_offset = 0;
+            if ( !TIFFRGBAImageGet(&img, raster, w, rows) )
+            {
+                ok = false;
+                break;
+            }
+
+            const wxUint32* src = raster;
+            for ( wxUint32 i = 0; i < rows; i++ )
+            {
+                unsigned char* ptr = rowRGB;
+                for ( wxUint32 j = 0; j < w; j++, src++ )
+                {
+                    *(ptr++) = (unsigned char)TIFFGetR(*src);
+                    *(ptr++) = (unsigned char)TIFFGetG(*src);
+                    *(ptr++) = (unsigned char)TIFFGetB(*src);
+                    if ( hasAlpha )
+                        rowAlpha[j] = (unsigned char)TIFFGetA(*src);
+                }
+
+                if ( !sink.ProcessRow(y + i, rowRGB,
+                                      hasAlpha ? rowAlpha : nullptr) )
+                {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if ( raster )
+        _TIFFfree(raster);
+
+    TIFFRGBAImageEnd(&img);
+
+    return ok;
+}
+
+// Copy some baseline TIFF tags and the resolution to the image options.
+static void
+wxTIFFSetImageOptions(wxImage* image,
+                      TIFF* tif,
+                      wxUint16 photometric,
+                      wxUint16 samplesPerPixel,
+                      wxUint16 bitsPerSample)
+{
+    image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
+
+    wxUint16 compression;
+    /*
+    Copy some baseline TIFF tags which helps when re-saving a TIFF
+    to be similar to the original image.
+    */
+    if (samplesPerPixel)
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, samplesPerPixel);
+    }
+
+    if (bitsPerSample)
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_BITSPERSAMPLE, bitsPerSample);
+    }
+
+    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression) )
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, compression);
+    }
+
+    // Set the resolution unit.
+    wxImageResolution resUnit = wxIMAGE_RESOLUTION_NONE;
+    wxUint16 tiffRes;
+    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &tiffRes) )
+    {
+        switch (tiffRes)
+        {
+            default:
+                wxLogWarning(_("Unknown TIFF resolution unit %d ignored"),
+                    tiffRes);
+                wxFALLTHROUGH;
+
+            case RESUNIT_NONE:
+                resUnit = wxIMAGE_RESOLUTION_NONE;
+                break;
+
+            case RESUNIT_INCH:
+                resUnit = wxIMAGE_RESOLUTION_INCHES;
+                break;
+
+            case RESUNIT_CENTIMETER:
+                resUnit = wxIMAGE_RESOLUTION_CM;
+                break;
+        }
+    }
+
+    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, resUnit);
+
+    /*
+    Set the image resolution if it's available. Resolution tag is not
+    dependent on RESOLUTIONUNIT != RESUNIT_NONE (according to TIFF spec).
+    */
+    float resX, resY;
+
+    if ( TIFFGetField(tif, TIFFTAG_XRESOLUTION, &resX) )
+    {
+        /*
+        Use a string value to not lose precision.
+        rounding to int as cm and then converting to inch may
+        result in whole integer rounding error, eg. 201 instead of 200 dpi.
+        If an app wants an int, GetOptionInt will convert and round down.
+        */
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
+            wxString::FromCDouble((double) resX));
+    }
+
+    if ( TIFFGetField(tif, TIFFTAG_YRESOLUTION, &resY) )
+    {
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
+            wxString::FromCDouble((double) resY));
+    }
+}
+
 bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index )
 {
     if (index == -1)
         index = 0;
 
+    // save this before calling Destroy()
+    const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
+                   maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+
     image->Destroy();
 
     TIFF *tif = TIFFwxOpen( stream, "image", "r" );
@@ -341,12 +556,38 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     {
         photometric = PHOTOMETRIC_MINISWHITE;
     }
-    const bool hasAlpha = (extraSamples >= 1
-        && ((samplesInfo[0] == EXTRASAMPLE_UNSPECIFIED)
-            || samplesInfo[0] == EXTRASAMPLE_ASSOCALPHA
-            || samplesInfo[0] == EXTRASAMPLE_UNASSALPHA))
-        || (extraSamples == 0 && samplesPerPixel == 4
-            && photometric == PHOTOMETRIC_RGB);
+    const bool hasAlpha = wxTIFFHasAlpha(tif);
+
+    // If the image needs to be reduced, do it while decoding it instead of
+    // loading the entire image into memory first, if possible.
+    const int scale = GetScaleForMaxSize(w, h, maxWidth, maxHeight);
+    if ( scale > 1 && wxTIFFCanLoadRows(tif) )
+    {
+        wxImageRowWriter writer(*image);
+        wxImageRowReducer reducer(writer, scale);
+        if ( !wxTIFFLoadRows(tif, reducer) )
+        {
+            if (verbose)
+            {
+                wxLogError( _("TIFF: Error reading image.") );
+            }
+
+            image->Destroy();
+            TIFFClose( tif );
+
+            return false;
+        }
+
+        // save the original image size
+        image->SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, w);
+        image->SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, h);
+
+        wxTIFFSetImageOptions(image, tif, photometric, samplesPerPixel, bitsPerSample);
+
+        TIFFClose( tif );
+
+        return true;
+    }
 
     // guard against integer overflow during multiplication which could result
     // in allocating a too small buffer and then overflowing it
@@ -499,85 +740,55 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     }
 
 
-    image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
+    wxTIFFSetImageOptions(image, tif, photometric, samplesPerPixel, bitsPerSample);
 
-    wxUint16 compression;
-    /*
-    Copy some baseline TIFF tags which helps when re-saving a TIFF
-    to be similar to the original image.
-    */
-    if (samplesPerPixel)
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, samplesPerPixel);
-    }
-
-    if (bitsPerSample)
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_BITSPERSAMPLE, bitsPerSample);
-    }
+    _TIFFfree( raster );
 
-    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression) )
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, compression);
-    }
+    TIFFClose( tif );
 
-    // Set the resolution unit.
-    wxImageResolution resUnit = wxIMAGE_RESOLUTION_NONE;
-    wxUint16 tiffRes;
-    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &tiffRes) )
-    {
-        switch (tiffRes)
-        {
-            default:
-                wxLogWarning(_("Unknown TIFF resolution unit %d ignored"),
-                    tiffRes);
-                wxFALLTHROUGH;
+    return true;
+}
 
-            case RESUNIT_NONE:
-                resUnit = wxIMAGE_RESOLUTION_NONE;
-                break;
+bool wxTIFFHandler::DoLoadRows( wxImageRowSink& sink, wxInputStream& stream,
+                                int scale, bool verbose, int index )
+{
+    if (index == -1)
+        index = 0;
 
-            case RESUNIT_INCH:
-                resUnit = wxIMAGE_RESOLUTION_INCHES;
-                break;
+    const wxFileOffset pos = stream.TellI();
 
-            case RESUNIT_CENTIMETER:
-                resUnit = wxIMAGE_RESOLUTION_CM;
-                break;
+    TIFF *tif = TIFFwxOpen( stream, "image", "r" );
+    if (!tif)
+    {
+        if (verbose)
+        {
+            wxLogError( _("TIFF: Error loading image.") );
         }
+
+        return false;
     }
 
-    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, resUnit);
+    if ( !TIFFSetDirectory( tif, (tdir_t)index ) || !wxTIFFCanLoadRows(tif) )
+    {
+        // Let LoadFile() deal with this image, including giving the errors.
+        TIFFClose( tif );
 
-    /*
-    Set the image resolution if it's available. Resolution tag is not
-    dependent on RESOLUTIONUNIT != RESUNIT_NONE (according to TIFF spec).
-    */
-    float resX, resY;
+        if ( stream.SeekI(pos) == wxInvalidOffset )
+            return false;
 
-    if ( TIFFGetField(tif, TIFFTAG_XRESOLUTION, &resX) )
-    {
-        /*
-        Use a string value to not lose precision.
-        rounding to int as cm and then converting to inch may
-        result in whole integer rounding error, eg. 201 instead of 200 dpi.
-        If an app wants an int, GetOptionInt will convert and round down.
-        */
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
-            wxString::FromCDouble((double) resX));
+        return wxImageHandler::DoLoadRows(sink, stream, scale, verbose, index);
     }
 
-    if ( TIFFGetField(tif, TIFFTAG_YRESOLUTION, &resY) )
+    wxImageRowReducer reducer(sink, scale);
+    const bool ok = wxTIFFLoadRows(tif, reducer);
+    if ( !ok && verbose )
     {
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
-            wxString::FromCDouble((double) resY));
+        wxLogError( _("TIFF: Error reading image.") );
     }
 
-    _TIFFfree( raster );
-
     TIFFClose( tif );
 
-    return true;
+    return ok;
 }
 
 int wxTIFFHandler::DoGetImageCount( wxInputStream& stream )
@@ -894,8 +1105,13 @@ bool wxTIFFHandler::DoCanRead( wxInputStream& stream )
     if ( !stream.Read(&hdr[0], WXSIZEOF(hdr)) )     // it's ok to modify the stream position here
         return false;
 
-    return (hdr[0] == 'I' && hdr[1] == 'I') ||
-           (hdr[0] == 'M' && hdr[1] == 'M');
+    return DoCanReadHeader(hdr);
+}
+
+bool wxTIFFHandler::DoCanReadHeader( const unsigned char* header ) const
+{
+    return (header[0] == 'I' && header[1] == 'I') ||
+           (header[0] == 'M' && header[1] == 'M');
 }
 
 #endif  // wxUSE_STREAMS
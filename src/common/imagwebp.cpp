@@ -317,13 +317,18 @@ int wxWEBPHandler::DoGetImageCount(wxInputStream& stream)
 
 bool wxWEBPHandler::DoCanRead(wxInputStream& stream)
 {
-    // check header according to https://developers.google.com/speed/webp/docs/riff_container
     const int buffer_size = 12;
-    char buffer[buffer_size];
+    unsigned char buffer[buffer_size];
     stream.Read(buffer, buffer_size);
     if (stream.LastRead() != buffer_size)
         return false;
-    return memcmp(buffer, "RIFF", 4) == 0 && memcmp(buffer + 8, "WEBP", 4) == 0;
+    return DoCanReadHeader(buffer);
+}
+
+bool wxWEBPHandler::DoCanReadHeader(const unsigned char* header) const
+{
+    // check header according to https://developers.google.com/speed/webp/docs/riff_container
+    return memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "WEBP", 4) == 0;
 }
 
 #endif // wxUSE_STREAMS
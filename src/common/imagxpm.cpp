@@ -256,6 +256,11 @@ bool wxXPMHandler::DoCanRead(wxInputStream& stream)
          // it's ok to modify the stream position here
 }
 
+bool wxXPMHandler::DoCanReadHeader( const unsigned char* header ) const
+{
+    return memcmp(header, "/* XPM */", 9) == 0;
+}
+
 #endif  // wxUSE_STREAMS
 
 #endif // wxUSE_XPM
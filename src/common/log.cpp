@@ -38,6 +38,7 @@
 #include "wx/textfile.h"
 #include "wx/thread.h"
 #include "wx/crt.h"
+#include "wx/msgqueue.h"
 #include "wx/vector.h"
 
 #include "wx/private/log.h"
@@ -49,6 +50,8 @@
 
 #include <stdlib.h>
 
+#include <atomic>
+
 #if defined(__WINDOWS__)
     // This header includes <windows.h> and declares wxMSWFormatMessage().
     #include "wx/msw/private.h"
@@ -151,17 +154,144 @@ struct PreviousLogInfo
 PreviousLogInfo gs_prevLog;
 
 
-// map containing all components for which log level was explicitly set
+// Holds a value which can be read from any thread without locking: instead of
+// modifying the value, a new one is published. The old values can't be freed
+// immediately as they could still be used by the other threads, so they are
+// kept until a later Publish() call sees that no thread is reading them.
 //
-// NB: all accesses to it must be protected by GetLevelsCS() critical section
-using ComponentLevelsMap = std::unordered_map<wxString, wxLogLevel>;
+// This is only suitable for the values which change rarely, such as the log
+// filtering settings below.
+template <typename T>
+class LogSettingsSnapshot
+{
+public:
+    LogSettingsSnapshot() { Publish(new T); }
+
+    ~LogSettingsSnapshot()
+    {
+        FreeRetired();
+        delete m_current.load();
+    }
+
+    // Object which must exist while the value returned by its Get() is used,
+    // to prevent Publish() from freeing this value in the meanwhile.
+    class Reader
+    {
+    public:
+        explicit Reader(LogSettingsSnapshot& snapshot)
+            : m_snapshot(snapshot)
+        {
+            m_snapshot.m_numReaders++;
+        }
+
+        ~Reader()
+        {
+            m_snapshot.m_numReaders--;
+        }
+
+        const T& Get() const { return *m_snapshot.m_current.load(); }
+
+    private:
+        LogSettingsSnapshot& m_snapshot;
+
+        wxDECLARE_NO_COPY_CLASS(Reader);
+    };
+
+    // Check if the current value is empty without using Reader, which is
+    // more expensive: this is used to avoid doing it in the common case.
+    bool IsEmpty() const { return m_isEmpty.load(std::memory_order_relaxed); }
+
+    // The calls to the functions below must be serialized by the caller.
+
+    // Return the current value, which can't be freed while it is being used
+    // as only Publish() could do it.
+    const T& GetCurrent() const { return *m_current.load(); }
+
+    // Make the given value current, the snapshot takes ownership of it.
+    void Publish(T* value)
+    {
+        m_isEmpty.store(value->empty(), std::memory_order_relaxed);
 
-inline ComponentLevelsMap& GetComponentLevels()
+        T* const old = m_current.exchange(value);
+        if ( old )
+            m_retired.push_back(old);
+
+        // Any reader created after this check will use the new value, so the
+        // old ones can be freed if there are no readers right now.
+        if ( !m_numReaders )
+            FreeRetired();
+    }
+
+private:
+    void FreeRetired()
+    {
+        for ( size_t n = 0; n < m_retired.size(); n++ )
+            delete m_retired[n];
+
+        m_retired.clear();
+    }
+
+    // All operations on these atomics use sequentially consistent ordering,
+    // which is required for the reasoning in Publish() to be correct.
+    std::atomic<T*> m_current{nullptr};
+    std::atomic<int> m_numReaders{0};
+
+    std::atomic<bool> m_isEmpty{true};
+
+    // the old values which could still be used by the readers
+    wxVector<T*> m_retired;
+
+    wxDECLARE_NO_COPY_CLASS(LogSettingsSnapshot);
+};
+
+// map containing all components for which log level was explicitly set
+using ComponentLevels = std::unordered_map<wxString, wxLogLevel>;
+
+// NB: all changes to it must be protected by GetLevelsCS() critical section
+inline LogSettingsSnapshot<ComponentLevels>& GetComponentLevels()
 {
-    static ComponentLevelsMap s_componentLevels;
+    static LogSettingsSnapshot<ComponentLevels> s_componentLevels;
     return s_componentLevels;
 }
 
+// The range of the levels in GetComponentLevels(), updated together with it.
+//
+// It is stored separately from the snapshot to allow checking whether a
+// message is enabled without looking up its component, and so without
+// creating a Reader, which modifies the shared readers counter.
+struct ComponentLevelsRange
+{
+    std::atomic<wxLogLevel> minLevel{wxLOG_Max};
+    std::atomic<wxLogLevel> maxLevel{0};
+};
+
+inline ComponentLevelsRange& GetComponentLevelsRange()
+{
+    static ComponentLevelsRange s_componentLevelsRange;
+    return s_componentLevelsRange;
+}
+
+wxLogLevel
+LookupComponentLevel(const ComponentLevels& levels, const wxString& componentOrig)
+{
+    if ( levels.empty() )
+        return wxLog::GetLogLevel();
+
+    // Make a copy before modifying it in the loop.
+    wxString component = componentOrig;
+
+    while ( !component.empty() )
+    {
+        const auto it = levels.find(component);
+        if ( it != levels.end() )
+            return it->second;
+
+        component = component.BeforeLast('/');
+    }
+
+    return wxLog::GetLogLevel();
+}
+
 } // anonymous namespace
 
 // ============================================================================
@@ -371,7 +501,15 @@ wxLog::OnLog(wxLogLevel level,
         logger = wxPerThreadLogger;
         if ( !logger )
         {
-            if ( ms_pLogger )
+            wxLog* const active = ms_pLogger;
+            if ( active && active->IsThreadSafe() )
+            {
+                // there is no need to buffer the messages for this logger,
+                // but notice that repetition counting is only done for the
+                // messages logged from the main thread
+                active->DoLogRecord(level, msg, info);
+            }
+            else if ( active )
             {
                 // buffer the messages until they can be shown from the main
                 // thread
@@ -588,29 +726,63 @@ void wxLog::SetComponentLevel(const wxString& component, wxLogLevel level)
     {
         wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
 
-        GetComponentLevels()[component] = level;
+        auto& snapshot = GetComponentLevels();
+
+        ComponentLevels* const levels = new ComponentLevels(snapshot.GetCurrent());
+        (*levels)[component] = level;
+
+        wxLogLevel minLevel = wxLOG_Max,
+                   maxLevel = 0;
+        for ( const auto& it : *levels )
+        {
+            minLevel = wxMin(minLevel, it.second);
+            maxLevel = wxMax(maxLevel, it.second);
+        }
+
+        ComponentLevelsRange& range = GetComponentLevelsRange();
+        range.minLevel.store(minLevel, std::memory_order_relaxed);
+        range.maxLevel.store(maxLevel, std::memory_order_relaxed);
+
+        snapshot.Publish(levels);
     }
 }
 
 /* static */
-wxLogLevel wxLog::GetComponentLevel(const wxString& componentOrig)
+wxLogLevel wxLog::GetComponentLevel(const wxString& component)
 {
-    wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
+    auto& snapshot = GetComponentLevels();
+    if ( snapshot.IsEmpty() )
+        return GetLogLevel();
 
-    // Make a copy before modifying it in the loop.
-    wxString component = componentOrig;
+    const LogSettingsSnapshot<ComponentLevels>::Reader reader(snapshot);
+    return LookupComponentLevel(reader.Get(), component);
+}
 
-    const auto& componentLevels = GetComponentLevels();
-    while ( !component.empty() )
-    {
-        const auto it = componentLevels.find(component);
-        if ( it != componentLevels.end() )
-            return it->second;
+/* static */
+bool wxLog::IsLevelEnabled(wxLogLevel level, const char* component)
+{
+    if ( !IsEnabled() )
+        return false;
 
-        component = component.BeforeLast('/');
-    }
+    auto& snapshot = GetComponentLevels();
+    const wxLogLevel globalLevel = GetLogLevel();
+
+    // avoid creating the component string if its level doesn't matter
+    if ( snapshot.IsEmpty() || !component || !*component )
+        return level <= globalLevel;
 
-    return GetLogLevel();
+    // and also avoid looking it up if the result doesn't depend on it
+    const ComponentLevelsRange& range = GetComponentLevelsRange();
+    if ( level > globalLevel &&
+            level > range.maxLevel.load(std::memory_order_relaxed) )
+        return false;
+
+    if ( level <= globalLevel &&
+            level <= range.minLevel.load(std::memory_order_relaxed) )
+        return true;
+
+    const LogSettingsSnapshot<ComponentLevels>::Reader reader(snapshot);
+    return level <= LookupComponentLevel(reader.Get(), wxASCII_STR(component));
 }
 
 // ----------------------------------------------------------------------------
@@ -635,6 +807,21 @@ wxArrayString& TraceMasks()
     return s_traceMasks;
 }
 
+// copy of TraceMasks() used by IsAllowedTraceMask() without locking, it must
+// be updated by PublishTraceMasks() whenever TraceMasks() changes
+LogSettingsSnapshot<wxArrayString>& TraceMasksSnapshot()
+{
+    static LogSettingsSnapshot<wxArrayString> s_traceMasksSnapshot;
+
+    return s_traceMasksSnapshot;
+}
+
+// must be called with GetTraceMaskCS() locked
+void PublishTraceMasks()
+{
+    TraceMasksSnapshot().Publish(new wxArrayString(TraceMasks()));
+}
+
 } // anonymous namespace
 
 /* static */ const wxArrayString& wxLog::GetTraceMasks()
@@ -651,6 +838,8 @@ void wxLog::AddTraceMask(const wxString& str)
     wxCRIT_SECT_LOCKER(lock, GetTraceMaskCS());
 
     TraceMasks().push_back(str);
+
+    PublishTraceMasks();
 }
 
 void wxLog::RemoveTraceMask(const wxString& str)
@@ -659,21 +848,33 @@ void wxLog::RemoveTraceMask(const wxString& str)
 
     int index = TraceMasks().Index(str);
     if ( index != wxNOT_FOUND )
+    {
         TraceMasks().RemoveAt((size_t)index);
+
+        PublishTraceMasks();
+    }
 }
 
 void wxLog::ClearTraceMasks()
 {
     wxCRIT_SECT_LOCKER(lock, GetTraceMaskCS());
 
-    TraceMasks().Clear();
+    if ( !TraceMasks().empty() )
+    {
+        TraceMasks().Clear();
+
+        PublishTraceMasks();
+    }
 }
 
 /*static*/ bool wxLog::IsAllowedTraceMask(const wxString& mask)
 {
-    wxCRIT_SECT_LOCKER(lock, GetTraceMaskCS());
+    auto& snapshot = TraceMasksSnapshot();
+    if ( snapshot.IsEmpty() )
+        return false;
 
-    const wxArrayString& masks = GetTraceMasks();
+    const LogSettingsSnapshot<wxArrayString>::Reader reader(snapshot);
+    const wxArrayString& masks = reader.Get();
     for ( wxArrayString::const_iterator it = masks.begin(),
                                         en = masks.end();
           it != en;
@@ -985,6 +1186,174 @@ wxLogInterposerTemp::wxLogInterposerTemp()
     #pragma warning(default:4355)
 #endif // VC++
 
+#if wxUSE_THREADS
+
+// ----------------------------------------------------------------------------
+// wxLogAsync
+// ----------------------------------------------------------------------------
+
+// Thread passing the queued log records to the real log target.
+class wxLogAsyncThread : public wxThread
+{
+public:
+    wxLogAsyncThread(wxLog *target, size_t capacity)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_target(target),
+          m_queue(capacity)
+    {
+    }
+
+    // queue the record for logging, taking ownership of it
+    void Log(wxLogRecord *record)
+    {
+        Message message;
+        message.record = record;
+        m_queue.PostTimeout(-1, message);
+    }
+
+    // wait until all the records queued before are logged and flush the
+    // target
+    void Drain()
+    {
+        DrainRequest request;
+
+        Message message;
+        message.drain = &request;
+        m_queue.PostTimeout(-1, message);
+
+        wxMutexLocker lock(request.mutex);
+        while ( !request.done )
+            request.condition.Wait();
+    }
+
+    // ask the thread to exit after logging all the queued records
+    void Stop()
+    {
+        m_queue.PostTimeout(-1, Message());
+    }
+
+protected:
+    virtual ExitCode Entry() override
+    {
+        Message messages[64];
+        for ( ;; )
+        {
+            size_t count;
+            if ( m_queue.ReceiveMany(messages, WXSIZEOF(messages), count)
+                    != wxMSGQUEUE_NO_ERROR )
+                break;
+
+            for ( size_t n = 0; n < count; n++ )
+            {
+                const Message& message = messages[n];
+                if ( message.record )
+                {
+                    const wxLogRecord& rec = *message.record;
+                    m_target->LogRecord(rec.level, rec.msg, rec.info);
+
+                    delete message.record;
+                }
+                else if ( message.drain )
+                {
+                    m_target->Flush();
+
+                    DrainRequest& request = *message.drain;
+
+                    wxMutexLocker lock(request.mutex);
+                    request.done = true;
+                    request.condition.Signal();
+                }
+                else // stop request, which is always the last message
+                {
+                    m_target->Flush();
+
+                    return nullptr;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    // used by Drain() to wait until the thread processes its request
+    struct DrainRequest
+    {
+        DrainRequest() : condition(mutex) { }
+
+        wxMutex mutex;
+        wxCondition condition;
+        bool done = false;
+    };
+
+    // either a record to log, a drain request or, if both are null, a request
+    // to stop the thread
+    struct Message
+    {
+        wxLogRecord *record = nullptr;
+        DrainRequest *drain = nullptr;
+    };
+
+    wxLog *const m_target;
+
+    wxBoundedMessageQueue<Message> m_queue;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsyncThread);
+};
+
+wxLogAsync::wxLogAsync(wxLog *target, size_t capacity)
+    : m_target(target)
+{
+    wxASSERT_MSG( target, "log target can't be null" );
+
+    m_thread = new wxLogAsyncThread(target, capacity);
+    if ( m_thread->Run() != wxTHREAD_NO_ERROR )
+    {
+        // just log synchronously, only from the main thread, if we can't
+        // use the background thread
+        delete m_thread;
+        m_thread = nullptr;
+    }
+}
+
+wxLogAsync::~wxLogAsync()
+{
+    if ( m_thread )
+    {
+        m_thread->Stop();
+        m_thread->Wait();
+
+        delete m_thread;
+    }
+
+    delete m_target;
+}
+
+void wxLogAsync::Drain()
+{
+    if ( m_thread )
+        m_thread->Drain();
+    else
+        m_target->Flush();
+}
+
+void wxLogAsync::DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info)
+{
+    if ( m_thread )
+        m_thread->Log(new wxLogRecord(level, msg, info));
+    else
+        m_target->LogRecord(level, msg, info);
+}
+
+bool wxLogAsync::IsThreadSafe() const
+{
+    return m_thread != nullptr;
+}
+
+#endif // wxUSE_THREADS
+
 // ============================================================================
 // Global functions/variables
 // ============================================================================
@@ -49,6 +49,17 @@
 
 #include <unordered_map>
 
+// SSE2 and NEON are always available on the 64-bit x86 and ARM architectures,
+// so use them for handling runs of ASCII characters in UTF-8 conversions there
+// without any run-time checks.
+#if defined(__x86_64__) || defined(_M_X64)
+    #define wxSTRCONV_USE_SSE2
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define wxSTRCONV_USE_NEON
+    #include <arm_neon.h>
+#endif
+
 #define TRACE_STRCONV wxT("strconv")
 
 // WC_UTF16 is defined only if sizeof(wchar_t) == 2, otherwise it's supposed to
@@ -385,9 +396,73 @@ size_t wxMBConv::WC2MB(char *outBuff, const wchar_t *inBuff, size_t outLen) cons
     return rc;
 }
 
+// Converting from UTF-8 never produces more wide characters than there are
+// bytes in the input and converting to it never produces more than 3 bytes
+// per UTF-16 code unit or 4 bytes per UTF-32 character, so for UTF-8 we
+// allocate the buffer big enough for the worst case and convert in a single
+// pass instead of computing the exact size of the output first. The excess
+// memory, if any, is given back once the real size is known.
+//
+// Both functions return the length of the output, including the trailing NUL
+// if the input was NUL-terminated, or wxCONV_FAILED.
+static size_t
+ConvertFromUTF8InOnePass(const wxMBConv& conv, wxWCharBuffer& wbuf,
+                         const char *src, size_t srcLen)
+{
+    const size_t maxLen = srcLen == wxNO_LEN ? strlen(src) + 1 : srcLen;
+
+    wbuf = wxWCharBuffer(maxLen);
+    const size_t dstLen = conv.ToWChar(wbuf.data(), maxLen, src, srcLen);
+    if ( dstLen == wxCONV_FAILED )
+        wbuf.reset();
+    else if ( dstLen < maxLen && !wbuf.extend(dstLen) )
+        wbuf.shrink(dstLen);
+
+    return dstLen;
+}
+
+static size_t
+ConvertToUTF8InOnePass(const wxMBConv& conv, wxCharBuffer& buf,
+                       const wchar_t *src, size_t srcLen)
+{
+#ifdef WC_UTF16
+    static const size_t maxBytesPerChar = 3;
+#else
+    static const size_t maxBytesPerChar = 4;
+#endif
+
+    const size_t maxLen = (srcLen == wxNO_LEN ? wxWcslen(src) + 1 : srcLen)
+                            * maxBytesPerChar;
+
+    buf = wxCharBuffer(maxLen);
+    const size_t dstLen = conv.FromWChar(buf.data(), maxLen, src, srcLen);
+    if ( dstLen == wxCONV_FAILED )
+        buf.reset();
+    else if ( dstLen < maxLen && !buf.extend(dstLen) )
+        buf.shrink(dstLen);
+
+    return dstLen;
+}
+
 wxWCharBuffer
 wxMBConv::cMB2WC(const char *inBuff, size_t inLen, size_t *outLen) const
 {
+    if ( IsUTF8() )
+    {
+        wxWCharBuffer wbuf;
+        const size_t dstLen = ConvertFromUTF8InOnePass(*this, wbuf,
+                                                       inBuff, inLen);
+        if ( outLen )
+        {
+            if ( dstLen == wxCONV_FAILED )
+                *outLen = 0;
+            else
+                *outLen = inLen == wxNO_LEN ? dstLen - 1 : dstLen;
+        }
+
+        return wbuf;
+    }
+
     const size_t dstLen = ToWChar(nullptr, 0, inBuff, inLen);
     if ( dstLen != wxCONV_FAILED )
     {
@@ -423,6 +498,22 @@ wxMBConv::cMB2WC(const char *inBuff, size_t inLen, size_t *outLen) const
 wxCharBuffer
 wxMBConv::cWC2MB(const wchar_t *inBuff, size_t inLen, size_t *outLen) const
 {
+    if ( IsUTF8() )
+    {
+        wxCharBuffer buf;
+        const size_t dstLen = ConvertToUTF8InOnePass(*this, buf,
+                                                     inBuff, inLen);
+        if ( outLen )
+        {
+            if ( dstLen == wxCONV_FAILED )
+                *outLen = 0;
+            else
+                *outLen = inLen == wxNO_LEN ? dstLen - 1 : dstLen;
+        }
+
+        return buf;
+    }
+
     size_t dstLen = FromWChar(nullptr, 0, inBuff, inLen);
     if ( dstLen != wxCONV_FAILED )
     {
@@ -469,6 +560,17 @@ wxWCharBuffer wxMBConv::DoConvertMB2WC(const char* buf, size_t srcLen) const
     // come from wxScopedCharBuffer.
     if ( srcLen && buf )
     {
+        if ( IsUTF8() )
+        {
+            wxWCharBuffer wbuf;
+            const size_t dstLen = ConvertFromUTF8InOnePass(*this, wbuf,
+                                                           buf, srcLen);
+            if ( dstLen != wxCONV_FAILED && srcLen == wxNO_LEN )
+                wbuf.shrink(dstLen - 1);
+
+            return wbuf;
+        }
+
         const size_t dstLen = ToWChar(nullptr, 0, buf, srcLen);
         if ( dstLen != wxCONV_FAILED )
         {
@@ -494,6 +596,17 @@ wxCharBuffer wxMBConv::DoConvertWC2MB(const wchar_t* wbuf, size_t srcLen) const
 {
     if ( srcLen && wbuf )
     {
+        if ( IsUTF8() )
+        {
+            wxCharBuffer buf;
+            const size_t dstLen = ConvertToUTF8InOnePass(*this, buf,
+                                                         wbuf, srcLen);
+            if ( dstLen != wxCONV_FAILED && srcLen == wxNO_LEN )
+                buf.shrink(dstLen - 1);
+
+            return buf;
+        }
+
         const size_t dstLen = FromWChar(nullptr, 0, wbuf, srcLen);
         if ( dstLen != wxCONV_FAILED )
         {
@@ -943,6 +1056,208 @@ extern const unsigned char tableUtf8Lengths[256] = {
                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0   // F5..FF
 };
 
+// ----------------------------------------------------------------------------
+// Helpers for converting runs of ASCII characters in bulk
+// ----------------------------------------------------------------------------
+
+// Return the number of ASCII characters at the start of the given buffer.
+static size_t CountLeadingASCII(const char *src, size_t len)
+{
+    const char *p = src;
+    const char * const end = src + len;
+
+#if defined(wxSTRCONV_USE_SSE2)
+    for ( ; end - p >= 16; p += 16 )
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if ( _mm_movemask_epi8(v) )
+            break;
+    }
+#elif defined(wxSTRCONV_USE_NEON)
+    for ( ; end - p >= 16; p += 16 )
+    {
+        if ( vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p))) & 0x80 )
+            break;
+    }
+#else // !SIMD
+    // Check 8 bytes at once, using memcpy() to avoid unaligned reads.
+    for ( ; end - p >= 8; p += 8 )
+    {
+        wxUint64 word;
+        memcpy(&word, p, sizeof(word));
+        if ( word & wxULL(0x8080808080808080) )
+            break;
+    }
+#endif // SIMD
+
+    // Find the exact position of the first non-ASCII character, if any.
+    while ( p != end && !(static_cast<unsigned char>(*p) & 0x80) )
+        p++;
+
+    return p - src;
+}
+
+// Copy the ASCII characters at the start of the given buffer to the output,
+// which may be null to just count them, and return their number.
+static size_t ConvertLeadingASCII(wchar_t *dst, const char *src, size_t len)
+{
+    if ( !dst )
+        return CountLeadingASCII(src, len);
+
+    const char *p = src;
+    const char * const end = src + len;
+
+#if defined(wxSTRCONV_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; end - p >= 16; p += 16, dst += 16 )
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if ( _mm_movemask_epi8(v) )
+            break;
+
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+        __m128i * const out = reinterpret_cast<__m128i*>(dst);
+#ifdef WC_UTF16
+        _mm_storeu_si128(out, lo);
+        _mm_storeu_si128(out + 1, hi);
+#else // !WC_UTF16
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+#endif // WC_UTF16/!WC_UTF16
+    }
+#elif defined(wxSTRCONV_USE_NEON)
+    for ( ; end - p >= 16; p += 16, dst += 16 )
+    {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        if ( vmaxvq_u8(v) & 0x80 )
+            break;
+
+        const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        const uint16x8_t hi = vmovl_high_u8(v);
+
+#ifdef WC_UTF16
+        uint16_t * const out = reinterpret_cast<uint16_t*>(dst);
+        vst1q_u16(out, lo);
+        vst1q_u16(out + 8, hi);
+#else // !WC_UTF16
+        uint32_t * const out = reinterpret_cast<uint32_t*>(dst);
+        vst1q_u32(out, vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32(out + 4, vmovl_high_u16(lo));
+        vst1q_u32(out + 8, vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32(out + 12, vmovl_high_u16(hi));
+#endif // WC_UTF16/!WC_UTF16
+    }
+#else // !SIMD
+    for ( ; end - p >= 8; p += 8, dst += 8 )
+    {
+        wxUint64 word;
+        memcpy(&word, p, sizeof(word));
+        if ( word & wxULL(0x8080808080808080) )
+            break;
+
+        for ( int n = 0; n < 8; n++ )
+            dst[n] = static_cast<unsigned char>(p[n]);
+    }
+#endif // SIMD
+
+    for ( ; p != end && !(static_cast<unsigned char>(*p) & 0x80); p++ )
+        *dst++ = static_cast<unsigned char>(*p);
+
+    return p - src;
+}
+
+// Copy the ASCII characters at the start of the given wide buffer to the
+// output, which may be null to just count them, and return their number.
+static size_t ConvertLeadingASCII(char *dst, const wchar_t *src, size_t len)
+{
+    const wchar_t *p = src;
+    const wchar_t * const end = src + len;
+
+#if defined(wxSTRCONV_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; end - p >= 16; p += 16 )
+    {
+        const __m128i * const in = reinterpret_cast<const __m128i*>(p);
+        __m128i packed;
+
+#ifdef WC_UTF16
+        const __m128i a = _mm_loadu_si128(in);
+        const __m128i b = _mm_loadu_si128(in + 1);
+
+        const __m128i nonASCII = _mm_and_si128(_mm_or_si128(a, b),
+                                               _mm_set1_epi16(~0x7F));
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi16(nonASCII, zero)) != 0xFFFF )
+            break;
+
+        packed = _mm_packus_epi16(a, b);
+#else // !WC_UTF16
+        const __m128i a = _mm_loadu_si128(in);
+        const __m128i b = _mm_loadu_si128(in + 1);
+        const __m128i c = _mm_loadu_si128(in + 2);
+        const __m128i d = _mm_loadu_si128(in + 3);
+
+        const __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        const __m128i nonASCII = _mm_and_si128(all, _mm_set1_epi32(~0x7F));
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi32(nonASCII, zero)) != 0xFFFF )
+            break;
+
+        // All values are less than 0x80, so saturation never happens here.
+        packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+#endif // WC_UTF16/!WC_UTF16
+
+        if ( dst )
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), packed);
+            dst += 16;
+        }
+    }
+#elif defined(wxSTRCONV_USE_NEON)
+    for ( ; end - p >= 16; p += 16 )
+    {
+        uint8x16_t packed;
+
+#ifdef WC_UTF16
+        const uint16_t * const in = reinterpret_cast<const uint16_t*>(p);
+        const uint16x8_t a = vld1q_u16(in);
+        const uint16x8_t b = vld1q_u16(in + 8);
+        if ( vmaxvq_u16(vorrq_u16(a, b)) > 0x7F )
+            break;
+
+        packed = vcombine_u8(vmovn_u16(a), vmovn_u16(b));
+#else // !WC_UTF16
+        const uint32_t * const in = reinterpret_cast<const uint32_t*>(p);
+        const uint32x4_t a = vld1q_u32(in);
+        const uint32x4_t b = vld1q_u32(in + 4);
+        const uint32x4_t c = vld1q_u32(in + 8);
+        const uint32x4_t d = vld1q_u32(in + 12);
+        if ( vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) > 0x7F )
+            break;
+
+        packed = vcombine_u8(vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))),
+                             vmovn_u16(vcombine_u16(vmovn_u32(c), vmovn_u32(d))));
+#endif // WC_UTF16/!WC_UTF16
+
+        if ( dst )
+        {
+            vst1q_u8(reinterpret_cast<uint8_t*>(dst), packed);
+            dst += 16;
+        }
+    }
+#endif // SIMD
+
+    for ( ; p != end && static_cast<wxUint32>(*p) < 0x80; p++ )
+    {
+        if ( dst )
+            *dst++ = static_cast<char>(*p);
+    }
+
+    return p - src;
+}
+
 size_t
 wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
                             const char *src, size_t srcLen) const
@@ -953,7 +1268,7 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
     if ( srcLen == wxNO_LEN )
         srcLen = strlen(src) + 1;
 
-    for ( const char *p = src; ; p++ )
+    for ( const char *p = src; ; )
     {
         if ( (srcLen == wxNO_LEN ? !*p : !srcLen) )
         {
@@ -975,6 +1290,30 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
             return written;
         }
 
+        // Runs of ASCII characters are by far the most common case, so handle
+        // them in bulk instead of one by one.
+        if ( !(static_cast<unsigned char>(*p) & 0x80) )
+        {
+            size_t len = srcLen;
+            if ( out && dstLen < len )
+                len = dstLen;
+
+            len = ConvertLeadingASCII(out, p, len);
+            if ( len )
+            {
+                if ( out )
+                {
+                    out += len;
+                    dstLen -= len;
+                }
+
+                p += len;
+                srcLen -= len;
+                written += len;
+                continue;
+            }
+        }
+
         if ( out && !dstLen-- )
             break;
 
@@ -1053,6 +1392,7 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
             out++;
 
         written++;
+        p++;
     }
 
     return wxCONV_FAILED;
@@ -1065,10 +1405,11 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
     char *out = dstLen ? dst : nullptr;
     size_t written = 0;
 
-    const wchar_t* const end = srcLen == wxNO_LEN ? nullptr : src + srcLen;
+    const wchar_t* const end = src + (srcLen == wxNO_LEN ? wxWcslen(src)
+                                                         : srcLen);
     for ( const wchar_t *wp = src; ; )
     {
-        if ( end ? wp == end : !*wp )
+        if ( wp == end )
         {
             // all done successfully, just add the trailing NUL if we are not
             // using explicit length
@@ -1088,6 +1429,28 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
             return written;
         }
 
+        // As in ToWChar(), handle runs of ASCII characters in bulk.
+        if ( static_cast<wxUint32>(*wp) < 0x80 )
+        {
+            size_t len = end - wp;
+            if ( out && dstLen < len )
+                len = dstLen;
+
+            len = ConvertLeadingASCII(out, wp, len);
+            if ( len )
+            {
+                if ( out )
+                {
+                    out += len;
+                    dstLen -= len;
+                }
+
+                wp += len;
+                written += len;
+                continue;
+            }
+        }
+
         wxUint32 code;
 #ifdef WC_UTF16
         code = *wp++;
@@ -1095,7 +1458,7 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
         if ( IsSurrogate(code) )
         {
             // Check that we have the second part of the surrogate pair.
-            if ( end ? wp == end : !*wp )
+            if ( wp == end )
                 return wxCONV_FAILED;
 
             code = EncodeSurrogate(code, *wp++);
@@ -466,21 +466,13 @@ const wchar_t *wxString::AsWChar(const wxMBConv& conv) const
     if ( lenWC == wxCONV_FAILED )
         return nullptr;
 
-    // keep the same buffer if the string size didn't change: this is not only
-    // an optimization but also ensure that code which modifies string
-    // character by character (without changing its length) can continue to use
-    // the pointer returned by a previous wc_str() call even after changing the
+    // Extend() keeps the same buffer if it's big enough: this is not only an
+    // optimization but also ensure that code which modifies string character
+    // by character (without changing its length) can continue to use the
+    // pointer returned by a previous wc_str() call even after changing the
     // string
-
-    // TODO-UTF8: we could check for ">" instead of "!=" here as this would
-    //            allow to save on buffer reallocations but at the cost of
-    //            consuming (even) more memory, we should benchmark this to
-    //            determine if it's worth doing
-    if ( !m_convertedToWChar.m_str || lenWC != m_convertedToWChar.m_len )
-    {
-        if ( !const_cast<wxString *>(this)->m_convertedToWChar.Extend(lenWC) )
-            return nullptr;
-    }
+    if ( !const_cast<wxString *>(this)->m_convertedToWChar.Extend(lenWC) )
+        return nullptr;
 
     // finally do convert
     m_convertedToWChar.m_str[lenWC] = L'\0';
@@ -511,22 +503,53 @@ const char *wxString::AsChar(const wxMBConv& conv) const
     const size_t lenWC = m_impl.length();
 #endif // wxUSE_UNICODE_UTF8/wxUSE_UNICODE_WCHAR
 
+    ConvertedBuffer<char>& convertedToChar =
+        const_cast<wxString *>(this)->m_convertedToChar;
+
+    if ( conv.IsUTF8() )
+    {
+        // UTF-8 never needs more than 3 bytes per UTF-16 code unit or 4 bytes
+        // per UTF-32 character, so short strings can be converted in a single
+        // pass into a stack buffer big enough for the worst case, instead of
+        // computing the length of the output first, and then copied into a
+        // buffer of the exact size. The longer ones are converted in two
+        // passes below to avoid keeping a buffer much bigger than needed.
+#if SIZEOF_WCHAR_T == 2
+        const size_t maxLenMB = 3*lenWC;
+#else
+        const size_t maxLenMB = 4*lenWC;
+#endif
+
+        char buf[512];
+        if ( maxLenMB <= WXSIZEOF(buf) )
+        {
+            const size_t lenMB = conv.FromWChar(buf, maxLenMB, strWC, lenWC);
+            if ( lenMB == wxCONV_FAILED )
+                return nullptr;
+
+            if ( !convertedToChar.Extend(lenMB) )
+                return nullptr;
+
+            memcpy(convertedToChar.m_str, buf, lenMB);
+            convertedToChar.m_str[lenMB] = '\0';
+
+            return convertedToChar.m_str;
+        }
+    }
+
     const size_t lenMB = conv.FromWChar(nullptr, 0, strWC, lenWC);
     if ( lenMB == wxCONV_FAILED )
         return nullptr;
 
-    if ( !m_convertedToChar.m_str || lenMB != m_convertedToChar.m_len )
-    {
-        if ( !const_cast<wxString *>(this)->m_convertedToChar.Extend(lenMB) )
-            return nullptr;
-    }
+    if ( !convertedToChar.Extend(lenMB) )
+        return nullptr;
 
-    m_convertedToChar.m_str[lenMB] = '\0';
-    if ( conv.FromWChar(m_convertedToChar.m_str, lenMB,
+    convertedToChar.m_str[lenMB] = '\0';
+    if ( conv.FromWChar(convertedToChar.m_str, lenMB,
                         strWC, lenWC) == wxCONV_FAILED )
         return nullptr;
 
-    return m_convertedToChar.m_str;
+    return convertedToChar.m_str;
 }
 
 // ---------------------------------------------------------------------------
@@ -0,0 +1,571 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/threadpool.cpp
+// Purpose:     wxThreadPool implementation
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#if wxUSE_THREADS
+
+#include "wx/threadpool.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+    #include "wx/module.h"
+    #include "wx/utils.h"
+#endif // WX_PRECOMP
+
+#include <deque>
+
+namespace
+{
+
+using wxThreadPoolTaskPtr = std::shared_ptr<wxThreadPoolTaskBase>;
+
+// the worker object corresponding to the current thread, if any
+thread_local wxThreadPoolWorker* gs_currentWorker = nullptr;
+
+// the task being executed in the current thread, if any
+thread_local wxThreadPoolTaskBase* gs_currentTask = nullptr;
+
+// the global pool returned by wxThreadPool::Get()
+std::atomic<wxThreadPool*> gs_globalPool{nullptr};
+wxCriticalSection gs_globalPoolCS;
+
+// values of wxThreadPoolTaskBase::m_continuationState
+enum
+{
+    Continuation_None,
+    Continuation_Finished,
+    Continuation_Set
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxThreadPool::TaskQueue: double-ended queue of tasks
+// ----------------------------------------------------------------------------
+
+// Each worker takes the tasks from the back of its own queue, which is better
+// for cache locality as the most recently added tasks are executed first, but
+// the other threads steal the tasks from the front of it, which minimizes the
+// contention between them and the owner.
+class wxThreadPool::TaskQueue
+{
+public:
+    TaskQueue() = default;
+
+    void PushBack(const wxThreadPoolTaskPtr& task)
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        m_tasks.push_back(task);
+    }
+
+    bool PopBack(wxThreadPoolTaskPtr& task)
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( m_tasks.empty() )
+            return false;
+
+        task = std::move(m_tasks.back());
+        m_tasks.pop_back();
+
+        return true;
+    }
+
+    bool PopFront(wxThreadPoolTaskPtr& task)
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( m_tasks.empty() )
+            return false;
+
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+
+        return true;
+    }
+
+private:
+    wxCriticalSection m_cs;
+    std::deque<wxThreadPoolTaskPtr> m_tasks;
+
+    wxDECLARE_NO_COPY_CLASS(TaskQueue);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolWorker: worker thread of wxThreadPool
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolWorker : public wxThread
+{
+public:
+    explicit wxThreadPoolWorker(wxThreadPool& pool)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_pool(pool)
+    {
+    }
+
+    wxThreadPool& GetPool() const { return m_pool; }
+
+    // the tasks submitted by the tasks running in this thread
+    wxThreadPool::TaskQueue m_queue;
+
+protected:
+    virtual ExitCode Entry() override
+    {
+        m_pool.WorkerLoop(this);
+
+        return nullptr;
+    }
+
+private:
+    wxThreadPool& m_pool;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolWorker);
+};
+
+// ============================================================================
+// wxThreadPoolTaskBase implementation
+// ============================================================================
+
+void wxThreadPoolTaskBase::Execute()
+{
+    int expected = State_Pending;
+    if ( !m_state.compare_exchange_strong(expected, State_Running) )
+    {
+        // the task was cancelled
+        return;
+    }
+
+    wxThreadPoolTaskBase* const outerTask = gs_currentTask;
+    gs_currentTask = this;
+
+#if wxUSE_EXCEPTIONS
+    try
+    {
+        DoRun();
+    }
+    catch ( ... )
+    {
+        m_exception = std::current_exception();
+    }
+#else // !wxUSE_EXCEPTIONS
+    DoRun();
+#endif // wxUSE_EXCEPTIONS/!wxUSE_EXCEPTIONS
+
+    gs_currentTask = outerTask;
+
+    m_state = State_Done;
+
+    Finish();
+}
+
+bool wxThreadPoolTaskBase::Cancel()
+{
+    m_cancelRequested = true;
+
+    return CancelIfPending();
+}
+
+bool wxThreadPoolTaskBase::CancelIfPending()
+{
+    int expected = State_Pending;
+    if ( !m_state.compare_exchange_strong(expected, State_Cancelled) )
+        return false;
+
+    Finish();
+
+    return true;
+}
+
+void wxThreadPoolTaskBase::Finish()
+{
+    // call the continuation if it had been already set, otherwise it will be
+    // called by SetContinuation() itself
+    if ( m_continuationState.exchange(Continuation_Finished) == Continuation_Set )
+    {
+        m_continuation();
+        m_continuation = nullptr;
+    }
+
+    if ( m_pool )
+        m_pool->OnTaskDone();
+}
+
+void wxThreadPoolTaskBase::SetContinuation(const std::function<void ()>& func)
+{
+    wxCHECK_RET( m_continuationState != Continuation_Set,
+                 "task continuation can only be set once" );
+
+    m_continuation = func;
+
+    if ( m_continuationState.exchange(Continuation_Set) == Continuation_Finished )
+    {
+        m_continuation();
+        m_continuation = nullptr;
+    }
+}
+
+void wxThreadPoolTaskBase::Wait()
+{
+    if ( IsDone() )
+        return;
+
+    wxCHECK_RET( m_pool, "task must be submitted to a pool" );
+
+    m_pool->WaitFor(*this);
+}
+
+void wxThreadPoolTaskBase::RethrowIfFailed() const
+{
+#if wxUSE_EXCEPTIONS
+    if ( m_exception )
+        std::rethrow_exception(m_exception);
+#endif // wxUSE_EXCEPTIONS
+}
+
+// ============================================================================
+// wxThreadPool implementation
+// ============================================================================
+
+wxThreadPool::wxThreadPool(int numThreads)
+    : m_workAvailable(m_mutex),
+      m_taskDone(m_mutex)
+{
+    if ( numThreads <= 0 )
+    {
+        numThreads = wxThread::GetCPUCount();
+        if ( numThreads <= 0 )
+            numThreads = 1;
+    }
+
+    m_sharedQueue = new TaskQueue;
+
+    // the workers can't do anything before we release the mutex, so we don't
+    // need to worry about them accessing m_workers while we're filling it
+    wxMutexLocker lock(m_mutex);
+
+    m_workers.reserve(numThreads);
+    for ( int n = 0; n < numThreads; n++ )
+    {
+        wxThreadPoolWorker* const worker = new wxThreadPoolWorker(*this);
+        if ( worker->Run() != wxTHREAD_NO_ERROR )
+        {
+            // just use as many threads as we managed to create
+            delete worker;
+            break;
+        }
+
+        m_workers.push_back(worker);
+    }
+}
+
+wxThreadPool::~wxThreadPool()
+{
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_stopping = true;
+        m_workAvailable.Broadcast();
+    }
+
+    // the workers only exit once all the queued tasks are done
+    for ( size_t n = 0; n < m_workers.size(); n++ )
+    {
+        m_workers[n]->Wait();
+        delete m_workers[n];
+    }
+
+    delete m_sharedQueue;
+}
+
+/* static */
+wxThreadPool& wxThreadPool::Get()
+{
+    wxThreadPool* pool = gs_globalPool;
+    if ( !pool )
+    {
+        wxCriticalSectionLocker lock(gs_globalPoolCS);
+
+        pool = gs_globalPool;
+        if ( !pool )
+        {
+            pool = new wxThreadPool;
+            gs_globalPool = pool;
+        }
+    }
+
+    return *pool;
+}
+
+void wxThreadPool::Submit(const std::shared_ptr<wxThreadPoolTaskBase>& task)
+{
+    task->m_pool = this;
+
+    if ( m_workers.empty() )
+    {
+        // we couldn't create any threads, so just run it synchronously
+        task->Execute();
+        return;
+    }
+
+    wxThreadPoolWorker* const worker = gs_currentWorker;
+    if ( worker && &worker->GetPool() == this )
+        worker->m_queue.PushBack(task);
+    else
+        m_sharedQueue->PushBack(task);
+
+    m_numQueued++;
+
+    // notice that m_numQueued must be incremented before checking the number
+    // of idle threads: as the threads increment the latter before checking
+    // the former, either they see the new task or we see them as idle
+    if ( m_numIdle > 0 || m_numWaiting > 0 )
+    {
+        wxMutexLocker lock(m_mutex);
+
+        if ( m_numIdle > 0 )
+            m_workAvailable.Signal();
+
+        // the threads waiting for some task can run this one meanwhile
+        if ( m_numWaiting > 0 )
+            m_taskDone.Broadcast();
+    }
+}
+
+bool wxThreadPool::RunQueuedTask(wxThreadPoolWorker* worker)
+{
+    if ( !m_numQueued )
+        return false;
+
+    wxThreadPoolTaskPtr task;
+    if ( !(worker && worker->m_queue.PopBack(task)) &&
+            !m_sharedQueue->PopFront(task) )
+    {
+        // try stealing a task from the other workers, starting with different
+        // workers in different threads to avoid all of them contending for
+        // the same queue
+        const size_t count = m_workers.size();
+        const size_t start = m_nextVictim++;
+
+        bool found = false;
+        for ( size_t n = 0; n < count && !found; n++ )
+        {
+            wxThreadPoolWorker* const victim = m_workers[(start + n) % count];
+            if ( victim != worker )
+                found = victim->m_queue.PopFront(task);
+        }
+
+        if ( !found )
+            return false;
+    }
+
+    m_numQueued--;
+
+    task->Execute();
+
+    return true;
+}
+
+void wxThreadPool::WorkerLoop(wxThreadPoolWorker* worker)
+{
+    // wait until the ctor finishes creating the workers
+    {
+        wxMutexLocker lock(m_mutex);
+    }
+
+    gs_currentWorker = worker;
+
+    for ( ;; )
+    {
+        if ( RunQueuedTask(worker) )
+            continue;
+
+        wxMutexLocker lock(m_mutex);
+
+        m_numIdle++;
+        while ( !m_numQueued && !m_stopping )
+            m_workAvailable.Wait();
+        m_numIdle--;
+
+        if ( m_stopping && !m_numQueued )
+            break;
+    }
+
+    gs_currentWorker = nullptr;
+}
+
+void wxThreadPool::WaitFor(wxThreadPoolTaskBase& task)
+{
+    wxThreadPoolWorker* worker = gs_currentWorker;
+    if ( worker && &worker->GetPool() != this )
+        worker = nullptr;
+
+    while ( !task.IsDone() )
+    {
+        // run the other tasks while waiting, this is not only more efficient
+        // but also avoids deadlocks if all workers wait for some tasks
+        if ( RunQueuedTask(worker) )
+            continue;
+
+        wxMutexLocker lock(m_mutex);
+
+        m_numWaiting++;
+        while ( !task.IsDone() && !m_numQueued )
+            m_taskDone.Wait();
+        m_numWaiting--;
+    }
+}
+
+void wxThreadPool::OnTaskDone()
+{
+    // see the comment in Submit() about the order of operations
+    if ( m_numWaiting > 0 )
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_taskDone.Broadcast();
+    }
+}
+
+void wxThreadPool::ParallelFor(int from,
+                               int to,
+                               const std::function<void (int, int)>& func,
+                               int maxChunks)
+{
+    const int count = to - from;
+    if ( count <= 0 )
+        return;
+
+    // by default use a few chunks per thread to balance the load if some of
+    // them take longer than the others
+    const int numThreads = GetThreadCount() + 1;
+    int numChunks = 4*numThreads;
+    if ( maxChunks > 0 && numChunks > maxChunks )
+        numChunks = maxChunks;
+    if ( numChunks > count )
+        numChunks = count;
+
+    if ( numChunks <= 1 || numThreads == 1 )
+    {
+        func(from, to);
+        return;
+    }
+
+    // the chunks are processed by the calling thread and the helper tasks in
+    // the order in which they take them
+    std::atomic<int> nextChunk{0};
+    const auto processChunks = [&]()
+    {
+        for ( ;; )
+        {
+            const int n = nextChunk++;
+            if ( n >= numChunks )
+                break;
+
+            func(from + static_cast<int>(static_cast<wxLongLong_t>(count)*n/numChunks),
+                 from + static_cast<int>(static_cast<wxLongLong_t>(count)*(n + 1)/numChunks));
+        }
+    };
+
+    wxVector<wxTaskFuture<void>> helpers;
+    const int numHelpers = wxMin(numChunks - 1, numThreads - 1);
+    helpers.reserve(numHelpers);
+    for ( int n = 0; n < numHelpers; n++ )
+        helpers.push_back(Run(processChunks));
+
+    // the helpers which haven't started yet are not needed any more once we
+    // return from processChunks(), but the others must finish before we can
+    // return as they use our local variables -- and they must not be asked to
+    // cancel, as this would be visible to func() via TestCancel()
+    const auto waitForHelpers = [&helpers]()
+    {
+        for ( size_t n = 0; n < helpers.size(); n++ )
+        {
+            if ( !helpers[n].m_task->CancelIfPending() )
+                helpers[n].Wait();
+        }
+    };
+
+#if wxUSE_EXCEPTIONS
+    try
+    {
+        processChunks();
+    }
+    catch ( ... )
+    {
+        nextChunk = numChunks;
+        waitForHelpers();
+        throw;
+    }
+#else // !wxUSE_EXCEPTIONS
+    processChunks();
+#endif // wxUSE_EXCEPTIONS/!wxUSE_EXCEPTIONS
+
+    waitForHelpers();
+
+    // propagate the exceptions thrown in the helpers, if any
+    for ( size_t n = 0; n < helpers.size(); n++ )
+    {
+        if ( !helpers[n].IsCancelled() )
+            helpers[n].Get();
+    }
+}
+
+/* static */
+bool wxThreadPool::TestCancel()
+{
+    return gs_currentTask && gs_currentTask->m_cancelRequested;
+}
+
+/* static */
+void wxThreadPool::CallInMainThread(const std::function<void ()>& func)
+{
+    wxCHECK_RET( wxTheApp, "can't call function in main thread without wxApp" );
+
+    wxTheApp->CallAfter(func);
+}
+
+// ============================================================================
+// wxThreadPoolModule: destroys the global pool
+// ============================================================================
+
+class wxThreadPoolModule : public wxModule
+{
+public:
+    wxThreadPoolModule()
+    {
+        // the pool threads must be stopped before the threads support is
+        // cleaned up
+        AddDependency("wxThreadModule");
+    }
+
+    virtual bool OnInit() override { return true; }
+    virtual void OnExit() override
+    {
+        delete gs_globalPool.exchange(nullptr);
+    }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxThreadPoolModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxThreadPoolModule, wxModule);
+
+#endif // wxUSE_THREADS
@@ -54,6 +54,10 @@
 #include "wx/private/markupparser.h"
 #endif // wxUSE_ACCESSIBILITY
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
 //-----------------------------------------------------------------------------
 // classes
 //-----------------------------------------------------------------------------
@@ -72,11 +76,11 @@ static const int PADDING_RIGHTLEFT = 3;
 namespace
 {
 
-// Flags for Walker() function defined below.
+// Flags for wxDataViewMainWindow::GetRowByItem().
 enum WalkFlags
 {
-    Walk_All,               // Visit all items.
-    Walk_ExpandedOnly       // Visit only expanded items.
+    Walk_All,               // Consider all items.
+    Walk_ExpandedOnly       // Consider only items inside expanded nodes.
 };
 
 // The column is either the index of the column to be used for sorting or one
@@ -539,6 +543,22 @@ public:
         m_branchData->RemoveChild(index);
     }
 
+    // returns the position of the child node containing the given row, which
+    // is relative to this node, i.e. 0 corresponds to its first child, in the
+    // children list and also the row of this child
+    unsigned FindChildByRow(int row, int& childRow) const
+    {
+        wxCHECK_MSG( m_branchData != nullptr, 0, "leaf node doesn't have children" );
+        return m_branchData->FindChildByRow(row, childRow);
+    }
+
+    // returns the row of the child with the given index relative to this node
+    int GetChildRow(unsigned index) const
+    {
+        wxCHECK_MSG( m_branchData != nullptr, 0, "leaf node doesn't have children" );
+        return m_branchData->GetChildRow(index);
+    }
+
     // returns position of child node for given item in children list or wxNOT_FOUND
     int FindChildByItem(const wxDataViewItem& item) const
     {
@@ -575,6 +595,19 @@ public:
         return m_branchData && m_branchData->open;
     }
 
+    // Returns true if this node is shown in the control, i.e. if all of its
+    // parents are expanded.
+    bool IsShown() const
+    {
+        for ( const wxDataViewTreeNode* node = m_parent; node; node = node->m_parent )
+        {
+            if ( !node->IsOpen() )
+                return false;
+        }
+
+        return true;
+    }
+
     void ToggleOpen(wxDataViewMainWindow* window)
     {
         // We do not allow the (invisible) root node to be collapsed because
@@ -621,6 +654,9 @@ public:
 
         if ( !has )
         {
+            if ( m_branchData && m_branchData->subTreeCount )
+                m_parent->m_branchData->InvalidateChildRowsAfter(this);
+
             wxDELETE(m_branchData);
         }
         else if ( m_branchData == nullptr )
@@ -645,11 +681,23 @@ public:
         wxASSERT( m_branchData->subTreeCount >= 0 );
 
         if( m_parent )
+        {
+            // Notice that this must be done even if the parent is closed, as
+            // its children rows are still used when it is walked through.
+            m_parent->m_branchData->InvalidateChildRowsAfter(this);
+
             m_parent->ChangeSubTreeCount(num);
+        }
     }
 
     void Resort(wxDataViewMainWindow* window);
 
+    // Replaces all the children of this branch node with the given nodes and
+    // sorts them if necessary. The old children which are not reused must be
+    // deleted by the caller.
+    void ResetChildren(wxDataViewMainWindow* window,
+                       const wxDataViewTreeNodes& children);
+
     // Should be called after changing the item value to update its position in
     // the control if necessary.
     void PutInSortOrder(wxDataViewMainWindow* window)
@@ -678,18 +726,92 @@ private:
     {
         BranchNodeData()
             : open(false),
-              subTreeCount(0)
+              subTreeCount(0),
+              validChildRowsEnd(0)
         {
         }
 
         void InsertChild(wxDataViewTreeNode* node, unsigned index)
         {
             children.insert(children.begin() + index, node);
+            InvalidateChildRows(index);
         }
 
         void RemoveChild(unsigned index)
         {
             children.erase(children.begin() + index);
+            InvalidateChildRows(index);
+        }
+
+        // Must be called when the number of rows taken by the child with the
+        // given index or the order of the children changes.
+        void InvalidateChildRows(unsigned index)
+        {
+            if ( index < validChildRowsEnd )
+                validChildRowsEnd = index;
+        }
+
+        // Same as above, but for the given child node: as this requires
+        // finding it, it only searches among the children whose rows are
+        // still valid.
+        void InvalidateChildRowsAfter(const wxDataViewTreeNode* node)
+        {
+            for ( unsigned n = validChildRowsEnd; n > 0; n-- )
+            {
+                if ( children[n - 1] == node )
+                {
+                    validChildRowsEnd = n - 1;
+                    break;
+                }
+            }
+        }
+
+        unsigned FindChildByRow(int row, int& childRow) const
+        {
+            // If all children are leaves or closed, there is no need to
+            // compute anything.
+            if ( (int)children.size() == subTreeCount )
+            {
+                childRow = row;
+                return row;
+            }
+
+            UpdateChildRowsEnd();
+
+            const unsigned index = std::upper_bound(childRowsEnd.begin(),
+                                                    childRowsEnd.end(),
+                                                    row) - childRowsEnd.begin();
+            childRow = index ? childRowsEnd[index - 1] : 0;
+            return index;
+        }
+
+        int GetChildRow(unsigned index) const
+        {
+            if ( !index )
+                return 0;
+
+            UpdateChildRowsEnd();
+
+            return childRowsEnd[index - 1];
+        }
+
+        // Recompute the part of childRowsEnd which is not valid any more.
+        void UpdateChildRowsEnd() const
+        {
+            const unsigned count = children.size();
+            if ( validChildRowsEnd == count && childRowsEnd.size() == count )
+                return;
+
+            childRowsEnd.resize(count);
+
+            int rows = validChildRowsEnd ? childRowsEnd[validChildRowsEnd - 1] : 0;
+            for ( unsigned n = validChildRowsEnd; n < count; n++ )
+            {
+                rows += 1 + children[n]->GetSubTreeCount();
+                childRowsEnd[n] = rows;
+            }
+
+            validChildRowsEnd = count;
         }
 
         // Child nodes. Note that this may be empty even if m_hasChildren in
@@ -707,6 +829,14 @@ private:
         // 0 for leaves and is the number of rows the subtree occupies for
         // branch nodes.
         int                  subTreeCount;
+
+        // Number of rows taken by the children up to and including the one
+        // with the given index, i.e. including the rows of their expanded
+        // subtrees, which allows to find the child containing the given row
+        // using binary search. It is computed on demand and only the first
+        // validChildRowsEnd elements of it are up to date.
+        mutable wxVector<int> childRowsEnd;
+        mutable unsigned     validChildRowsEnd;
     };
 
     BranchNodeData *m_branchData;
@@ -740,8 +870,20 @@ public:
     }
     bool ValueChanged( const wxDataViewItem &item, unsigned int model_column );
     bool Cleared();
+    void BeginBatch() { m_inBatch = true; }
+    void EndBatch();
+
+    // Forget the changes accumulated during the current batch, if any, and
+    // stop batching: used when the model is changed during a batch.
+    void CancelBatch();
     void Resort()
     {
+        if ( m_inBatch )
+        {
+            m_batchResort = true;
+            return;
+        }
+
         ClearRowHeightCache();
 
         if (!IsVirtualList())
@@ -1027,6 +1169,13 @@ private:
     // Helper of public Expand(), must be called with a valid node.
     void DoExpand(wxDataViewTreeNode* node, unsigned int row, bool expandChildren);
 
+    // Helpers of EndBatch(): update the children of the given node and all
+    // its descendants which were changed during the batch and apply the
+    // structural or value changes.
+    void SyncChildren(wxDataViewTreeNode* node);
+    void ApplyBatchedTreeChanges();
+    void ApplyBatchedValueChanges(bool refresh);
+
 private:
     wxDataViewCtrl             *m_owner;
     int                         m_lineHeight;
@@ -1075,6 +1224,22 @@ private:
     // Id m_editorCtrl is non-null, pointer to the associated renderer.
     wxDataViewRenderer* m_editorRenderer;
 
+    // True between the model BeginBatch() and EndBatch() calls.
+    bool                        m_inBatch;
+
+    // Changes accumulated during the current batch: the items whose children
+    // were added or deleted, the deleted items themselves, whether Resort()
+    // was called and the changed items with the view column changed for each
+    // of them (or wxNOT_FOUND if all of them were).
+    //
+    // The deleted items are remembered because the model may reuse their IDs
+    // for the items added later during the same batch, and the nodes of the
+    // deleted items must not be reused for these new items.
+    std::unordered_set<void*>   m_batchParents;
+    std::unordered_set<void*>   m_batchDeleted;
+    bool                        m_batchResort;
+    std::unordered_map<void*, int> m_batchChanged;
+
 private:
     wxDECLARE_DYNAMIC_CLASS(wxDataViewMainWindow);
     wxDECLARE_EVENT_TABLE();
@@ -1102,6 +1267,10 @@ public:
         { return m_mainWindow->Cleared(); }
     virtual void Resort() override
         { m_mainWindow->Resort(); }
+    virtual void BeginBatch() override
+        { m_mainWindow->BeginBatch(); }
+    virtual void EndBatch() override
+        { m_mainWindow->EndBatch(); }
 
     wxDataViewMainWindow    *m_mainWindow;
 };
@@ -1959,6 +2128,7 @@ void wxDataViewTreeNode::Resort(wxDataViewMainWindow* window)
             std::sort(m_branchData->children.begin(),
                       m_branchData->children.end(),
                       wxGenericTreeModelNodeCmp(window, sortOrder));
+            m_branchData->InvalidateChildRows(0);
 
             m_branchData->sortOrder = sortOrder;
         }
@@ -1974,6 +2144,31 @@ void wxDataViewTreeNode::Resort(wxDataViewMainWindow* window)
 }
 
 
+void wxDataViewTreeNode::ResetChildren(wxDataViewMainWindow* window,
+                                       const wxDataViewTreeNodes& children)
+{
+    wxCHECK_RET( m_branchData != nullptr, "leaf node doesn't have children" );
+
+    int sum = 0;
+    for ( wxDataViewTreeNodes::const_iterator i = children.begin();
+          i != children.end();
+          ++i )
+    {
+        sum += 1 + (*i)->GetSubTreeCount();
+    }
+
+    m_branchData->children = children;
+    m_branchData->InvalidateChildRows(0);
+
+    // The new children are not sorted, so resort them if the node is open and
+    // just forget the old sort order otherwise.
+    m_branchData->sortOrder = SortOrder();
+
+    ChangeSubTreeCount(sum - m_branchData->subTreeCount);
+    Resort(window);
+}
+
+
 void
 wxDataViewTreeNode::PutChildInSortOrder(wxDataViewMainWindow* window,
                                         wxDataViewTreeNode* childNode)
@@ -2145,6 +2340,9 @@ wxDataViewMainWindow::wxDataViewMainWindow( wxDataViewCtrl *parent, wxWindowID i
     m_count = -1;
     m_underMouse = nullptr;
 
+    m_inBatch = false;
+    m_batchResort = false;
+
     UpdateDisplay();
 }
 
@@ -3052,76 +3250,26 @@ void wxDataViewHeaderWindow::FinishEditing()
     win->FinishEditing();
 }
 
-//-----------------------------------------------------------------------------
-// Helper class for do operation on the tree node
-//-----------------------------------------------------------------------------
-
-namespace
-{
-
-class DoJob
-{
-public:
-    DoJob() { }
-    virtual ~DoJob() { }
-
-    // The return value control how the tree-walker tranverse the tree
-    enum
-    {
-        DONE,          // Job done, stop traversing and return
-        SKIP_SUBTREE,  // Ignore the current node's subtree and continue
-        CONTINUE       // Job not done, continue
-    };
-
-    virtual int operator() ( wxDataViewTreeNode * node ) = 0;
-};
-
-bool
-Walker(wxDataViewTreeNode * node, DoJob & func, WalkFlags flags = Walk_All)
+bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxDataViewItem & item)
 {
-    wxCHECK_MSG( node, false, "can't walk null node" );
-
-    switch( func( node ) )
+    // Adding rows to a virtual list is cheap, so only defer it for the trees.
+    if ( m_inBatch && !IsVirtualList() )
     {
-        case DoJob::DONE:
-            return true;
-        case DoJob::SKIP_SUBTREE:
-            return false;
-        case DoJob::CONTINUE:
-            break;
-    }
-
-    if ( node->HasChildren() && (flags != Walk_ExpandedOnly || node->IsOpen()) )
-    {
-        const wxDataViewTreeNodes& nodes = node->GetChildNodes();
-
-        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
-              i != nodes.end();
-              ++i )
-        {
-            if ( Walker(*i, func, flags) )
-                return true;
-        }
+        m_batchParents.insert(parent.GetID());
+        return true;
     }
 
-    return false;
-}
-
-} // anonymous namespace
-
-bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxDataViewItem & item)
-{
     if (IsVirtualList())
     {
         wxDataViewVirtualListModel *list_model =
             (wxDataViewVirtualListModel*) GetModel();
         m_count = list_model->GetCount();
+
+        if ( m_rowHeightCache )
+            m_rowHeightCache->InsertRows(GetRowByItem(item), 1);
     }
     else
     {
-        // specific position (row) is unclear, so clear whole height cache
-        ClearRowHeightCache();
-
         const FindNodeResult findResult = FindNode(parent);
         wxDataViewTreeNode *parentNode = findResult.m_node;
 
@@ -3213,6 +3361,10 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
             parentNode->InsertChild(this, itemNode, 0);
         }
 
+        // Shift the heights of all the rows after the new one, if it's shown.
+        if ( m_rowHeightCache && itemNode->IsShown() )
+            m_rowHeightCache->InsertRows(GetRowByItem(item), 1);
+
         InvalidateCount();
     }
 
@@ -3227,12 +3379,22 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
 bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
                                        const wxDataViewItem& item)
 {
+    if ( m_inBatch && !IsVirtualList() )
+    {
+        m_batchParents.insert(parent.GetID());
+        m_batchDeleted.insert(item.GetID());
+        return true;
+    }
+
     if (IsVirtualList())
     {
         wxDataViewVirtualListModel *list_model =
             (wxDataViewVirtualListModel*) GetModel();
         m_count = list_model->GetCount();
 
+        if ( m_rowHeightCache )
+            m_rowHeightCache->DeleteRows(GetRowByItem(item), 1);
+
         m_selection.OnItemDelete(GetRowByItem(item));
     }
     else // general case
@@ -3284,8 +3446,8 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             return true;
         }
 
-        if ( m_rowHeightCache )
-            m_rowHeightCache->Remove(GetRowByItem(parent) + itemPosInNode);
+        // Remember whether the item occupied any rows before deleting it.
+        const bool itemShown = itemNode->IsShown();
 
         // Delete the item from wxDataViewTreeNode representation:
         const int itemsDeleted = 1 + itemNode->GetSubTreeCount();
@@ -3312,8 +3474,9 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             }
         }
 
-        // Update selection by removing 'item' and its entire children tree from the selection.
-        if ( !m_selection.IsEmpty() )
+        // Update selection by removing 'item' and its entire children tree from
+        // the selection and forget the heights of all the removed rows.
+        if ( !m_selection.IsEmpty() || (m_rowHeightCache && itemShown) )
         {
             // we can't call GetRowByItem() on 'item', as it's already deleted, so compute it from
             // the parent ('parentNode') and position in its list of children
@@ -3333,7 +3496,11 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
                           1;
             }
 
-            m_selection.OnItemsDeleted(itemRow, itemsDeleted);
+            if ( !m_selection.IsEmpty() )
+                m_selection.OnItemsDeleted(itemRow, itemsDeleted);
+
+            if ( m_rowHeightCache && itemShown )
+                m_rowHeightCache->DeleteRows(itemRow, itemsDeleted);
         }
     }
 
@@ -3349,11 +3516,19 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
 
 bool wxDataViewMainWindow::DoItemChanged(const wxDataViewItem & item, int view_column)
 {
-    if ( !IsVirtualList() )
+    if ( m_inBatch )
     {
-        if ( m_rowHeightCache )
-            m_rowHeightCache->Remove(GetRowByItem(item));
+        // Remember the changed column, unless several different ones change.
+        std::pair<std::unordered_map<void*, int>::iterator, bool>
+            res = m_batchChanged.insert(std::make_pair(item.GetID(), view_column));
+        if ( !res.second && res.first->second != view_column )
+            res.first->second = wxNOT_FOUND;
 
+        return true;
+    }
+
+    if ( !IsVirtualList() )
+    {
         // Move this node to its new correct place after it was updated.
         //
         // In principle, we could skip the call to PutInSortOrder() if the modified
@@ -3367,7 +3542,34 @@ bool wxDataViewMainWindow::DoItemChanged(const wxDataViewItem & item, int view_c
         if ( !findResult.m_subtreeRealized )
             return true;
         wxCHECK_MSG( node, false, "invalid item" );
-        node->PutInSortOrder(this);
+
+        if ( m_rowHeightCache && node->IsShown() )
+        {
+            // The height of the item may have changed and, if it was moved to
+            // keep the sort order, all its rows are somewhere else now.
+            const int oldRow = GetRowByItem(item);
+            node->PutInSortOrder(this);
+            const int newRow = GetRowByItem(item);
+
+            if ( newRow == oldRow )
+            {
+                m_rowHeightCache->Invalidate(oldRow);
+            }
+            else
+            {
+                const unsigned int rows = 1 + node->GetSubTreeCount();
+                m_rowHeightCache->DeleteRows(oldRow, rows);
+                m_rowHeightCache->InsertRows(newRow, rows);
+            }
+        }
+        else
+        {
+            node->PutInSortOrder(this);
+        }
+    }
+    else if ( m_rowHeightCache )
+    {
+        m_rowHeightCache->Invalidate(GetRowByItem(item));
     }
 
     wxDataViewColumn* column;
@@ -3403,6 +3605,12 @@ bool wxDataViewMainWindow::ValueChanged( const wxDataViewItem & item, unsigned i
 
 bool wxDataViewMainWindow::Cleared()
 {
+    // Everything is going to be rebuilt anyhow, so forget the pending changes.
+    m_batchParents.clear();
+    m_batchDeleted.clear();
+    m_batchResort = false;
+    m_batchChanged.clear();
+
     DestroyTree();
     m_selection.Clear();
     m_currentRow = (unsigned)-1;
@@ -3424,6 +3632,333 @@ bool wxDataViewMainWindow::Cleared()
     return true;
 }
 
+// Calls the given functor for all the realized nodes under the given one with
+// their rows, or -1 for the nodes which are not shown, in the rows order.
+template <typename F>
+static void
+WalkRealizedNodes(wxDataViewTreeNode* node, bool shown, unsigned int& row, F& func)
+{
+    const wxDataViewTreeNodes& children = node->GetChildNodes();
+    for ( wxDataViewTreeNodes::const_iterator i = children.begin();
+          i != children.end();
+          ++i )
+    {
+        wxDataViewTreeNode* const child = *i;
+        func(child, shown ? row : (unsigned int)-1);
+
+        if ( shown )
+            row++;
+
+        if ( child->HasChildren() )
+            WalkRealizedNodes(child, shown && child->IsOpen(), row, func);
+    }
+}
+
+void wxDataViewMainWindow::EndBatch()
+{
+    m_inBatch = false;
+
+    bool refreshed = false;
+    if ( IsVirtualList() )
+    {
+        // Virtual list models sort their items themselves, so there is no
+        // tree to update, but the whole window still needs to be redrawn.
+        if ( m_batchResort )
+        {
+            ClearRowHeightCache();
+            UpdateDisplay();
+            refreshed = true;
+        }
+    }
+    else if ( !m_batchParents.empty() || m_batchResort )
+    {
+        ApplyBatchedTreeChanges();
+        refreshed = true;
+    }
+
+    if ( !m_batchChanged.empty() )
+        ApplyBatchedValueChanges(!refreshed);
+
+    CancelBatch();
+}
+
+void wxDataViewMainWindow::CancelBatch()
+{
+    m_inBatch = false;
+
+    m_batchParents.clear();
+    m_batchDeleted.clear();
+    m_batchResort = false;
+    m_batchChanged.clear();
+}
+
+void wxDataViewMainWindow::SyncChildren(wxDataViewTreeNode* node)
+{
+    if ( m_batchParents.count(node->GetItem().GetID()) )
+    {
+        wxDataViewModel* const model = GetModel();
+        const wxDataViewItem& item = node->GetItem();
+
+        if ( !node->HasChildren() )
+        {
+            // Nodes will be initialized in Expand(), as in ItemAdded().
+            node->SetHasChildren(model->IsContainer(item));
+            return;
+        }
+
+        // Nothing to do if the children were never realized neither.
+        if ( !node->IsOpen() && node->GetChildNodes().empty() )
+            return;
+
+        // Build the new list of children reusing the existing nodes, which
+        // keeps their own children and expanded state, but only for the items
+        // which were not deleted: if there is an item with the same ID now,
+        // it's a different item which just happens to reuse this ID.
+        std::unordered_map<void*, wxDataViewTreeNode*> oldNodes;
+        wxDataViewTreeNodes deletedNodes;
+        const wxDataViewTreeNodes& oldChildren = node->GetChildNodes();
+        for ( wxDataViewTreeNodes::const_iterator i = oldChildren.begin();
+              i != oldChildren.end();
+              ++i )
+        {
+            void* const id = (*i)->GetItem().GetID();
+            if ( m_batchDeleted.count(id) )
+                deletedNodes.push_back(*i);
+            else
+                oldNodes[id] = *i;
+        }
+
+        wxDataViewItemArray items;
+        const unsigned int count = model->GetChildren(item, items);
+
+        wxDataViewTreeNodes children;
+        children.reserve(count);
+        for ( unsigned int n = 0; n < count; n++ )
+        {
+            std::unordered_map<void*, wxDataViewTreeNode*>::iterator
+                it = oldNodes.find(items[n].GetID());
+            if ( it != oldNodes.end() )
+            {
+                children.push_back(it->second);
+                oldNodes.erase(it);
+            }
+            else
+            {
+                wxDataViewTreeNode* const child = new wxDataViewTreeNode(node, items[n]);
+                child->SetHasChildren(model->IsContainer(items[n]));
+                children.push_back(child);
+            }
+        }
+
+        node->ResetChildren(this, children);
+
+        for ( std::unordered_map<void*, wxDataViewTreeNode*>::iterator
+                it = oldNodes.begin();
+              it != oldNodes.end();
+              ++it )
+        {
+            delete it->second;
+        }
+
+        for ( size_t n = 0; n < deletedNodes.size(); n++ )
+            delete deletedNodes[n];
+
+        // As in ItemDeleted(), the node may have become a leaf.
+        if ( children.empty() )
+        {
+            const bool isContainer = model->IsContainer(item);
+            node->SetHasChildren(isContainer);
+            if ( isContainer && node->IsOpen() )
+                node->ToggleOpen(this);
+
+            return;
+        }
+    }
+
+    if ( !node->HasChildren() )
+        return;
+
+    const wxDataViewTreeNodes& children = node->GetChildNodes();
+    for ( wxDataViewTreeNodes::const_iterator i = children.begin();
+          i != children.end();
+          ++i )
+    {
+        if ( (*i)->HasChildren() )
+            SyncChildren(*i);
+    }
+}
+
+void wxDataViewMainWindow::ApplyBatchedTreeChanges()
+{
+    // Remember the selected and current items as their rows may change,
+    // except for the deleted ones, even if their IDs are used again now.
+    std::unordered_set<void*> selected;
+    wxSelectionStore::IterationState cookie;
+    for ( unsigned int row = m_selection.GetFirstSelectedItem(cookie);
+          row != wxSelectionStore::NO_SELECTION;
+          row = m_selection.GetNextSelectedItem(cookie) )
+    {
+        void* const id = GetItemByRow(row).GetID();
+        if ( !m_batchDeleted.count(id) )
+            selected.insert(id);
+    }
+
+    const bool hadCurrentRow = HasCurrentRow();
+    const unsigned int oldCurrentRow = m_currentRow;
+    void* currentID = hadCurrentRow ? GetItemByRow(m_currentRow).GetID()
+                                    : nullptr;
+    if ( m_batchDeleted.count(currentID) )
+        currentID = nullptr;
+
+    // Update all the modified nodes in a single pass over the tree: this
+    // visits all the realized nodes, but is still much faster than handling
+    // each change separately.
+    SyncChildren(m_root);
+
+    if ( m_batchResort )
+        m_root->Resort(this);
+
+    InvalidateCount();
+    ClearRowHeightCache();
+
+    // Restore the selection and the current row by looking for their items
+    // among the nodes shown now.
+    m_selection.Clear();
+    m_currentRow = (unsigned int)-1;
+
+    const unsigned int count = GetRowCount();
+    m_selection.SetItemCount(count);
+    if ( !selected.empty() || currentID )
+    {
+        auto restore = [&](wxDataViewTreeNode* node, unsigned int row)
+        {
+            if ( row == (unsigned int)-1 )
+                return;
+
+            void* const id = node->GetItem().GetID();
+            if ( selected.count(id) )
+                m_selection.SelectItem(row);
+            if ( id == currentID )
+                m_currentRow = row;
+        };
+
+        unsigned int row = 0;
+        WalkRealizedNodes(m_root, true, row, restore);
+    }
+
+    // As in ItemDeleted(), keep the current row if its item was deleted.
+    if ( hadCurrentRow && !HasCurrentRow() && count )
+        m_currentRow = wxMin(oldCurrentRow, count - 1);
+
+    GetOwner()->InvalidateColBestWidths();
+    UpdateDisplay();
+}
+
+void wxDataViewMainWindow::ApplyBatchedValueChanges(bool refresh)
+{
+    wxVector<wxDataViewTreeNode*> nodes;
+    wxVector<unsigned int> rows;
+    wxVector<wxDataViewItem> items;
+
+    if ( IsVirtualList() )
+    {
+        for ( std::unordered_map<void*, int>::const_iterator
+                it = m_batchChanged.begin();
+              it != m_batchChanged.end();
+              ++it )
+        {
+            const wxDataViewItem item(it->first);
+            rows.push_back(GetRowByItem(item));
+            items.push_back(item);
+        }
+    }
+    else
+    {
+        // Only the items realized in the tree matter, as in DoItemChanged(),
+        // and, unlike with FindNode(), the items deleted during the batch are
+        // not a problem when looking for them like this.
+        auto find = [&](wxDataViewTreeNode* node, unsigned int row)
+        {
+            if ( m_batchChanged.count(node->GetItem().GetID()) )
+            {
+                nodes.push_back(node);
+                rows.push_back(row);
+                items.push_back(node->GetItem());
+            }
+        };
+
+        unsigned int row = 0;
+        WalkRealizedNodes(m_root, true, row, find);
+    }
+
+    // Move the nodes to their new places if the control is sorted, in which
+    // case the whole window needs to be refreshed.
+    bool moved = false;
+    if ( !nodes.empty() && !GetSortOrder().IsNone() )
+    {
+        for ( unsigned int n = 0; n < nodes.size(); n++ )
+            nodes[n]->PutInSortOrder(this);
+
+        moved = true;
+    }
+
+    // Forget the heights of the changed rows and find the range of the rows
+    // to refresh.
+    unsigned int rowFrom = (unsigned int)-1,
+                 rowTo = 0;
+    for ( unsigned int n = 0; n < rows.size(); n++ )
+    {
+        const unsigned int row = rows[n];
+        if ( row == (unsigned int)-1 )
+            continue;
+
+        if ( m_rowHeightCache && !moved )
+            m_rowHeightCache->Invalidate(row);
+
+        rowFrom = wxMin(rowFrom, row);
+        rowTo = wxMax(rowTo, row);
+    }
+
+    if ( moved )
+    {
+        ClearRowHeightCache();
+        UpdateDisplay();
+    }
+    else if ( refresh && rowFrom <= rowTo )
+    {
+        // Don't bother refreshing the rows which are not visible anyhow.
+        rowFrom = wxMax(rowFrom, GetFirstVisibleRow());
+        rowTo = wxMin(rowTo, GetLastVisibleRow());
+        if ( rowFrom <= rowTo )
+            RefreshRows(rowFrom, rowTo);
+    }
+
+    bool allColumnsChanged = false;
+    for ( unsigned int n = 0; n < items.size(); n++ )
+    {
+        const int view_column = m_batchChanged[items[n].GetID()];
+
+        wxDataViewColumn* column;
+        if ( view_column == wxNOT_FOUND )
+        {
+            column = nullptr;
+            allColumnsChanged = true;
+        }
+        else
+        {
+            column = m_owner->GetColumn(view_column);
+            if ( !allColumnsChanged )
+                GetOwner()->InvalidateColBestWidth(view_column);
+        }
+
+        wxDataViewEvent le(wxEVT_DATAVIEW_ITEM_VALUE_CHANGED, m_owner, column, items[n]);
+        m_owner->ProcessWindowEvent(le);
+    }
+
+    if ( allColumnsChanged )
+        GetOwner()->InvalidateColBestWidths();
+}
+
 void wxDataViewMainWindow::UpdateDisplay()
 {
     m_dirty = true;
@@ -3751,24 +4286,21 @@ int wxDataViewMainWindow::GetLineStart( unsigned int row ) const
         return row * m_lineHeight;
 
     int start = 0;
-    if ( m_rowHeightCache->GetLineStart(row, start) )
-        return start;
-
-    unsigned int r;
-    for (r = 0; r < row; r++)
+    while ( !m_rowHeightCache->GetLineStart(row, start) )
     {
-        int height = 0;
-        if ( !m_rowHeightCache->GetLineHeight(r, height) )
+        // some row height before this one is not in cache -> get the first
+        // missing one from the renderer...
+        const unsigned int r = m_rowHeightCache->GetFirstUnknown();
+        wxDataViewItem item = GetItemByRow(r);
+        if ( !item )
         {
-            // row height not in cache -> get it from the renderer...
-            wxDataViewItem item = GetItemByRow(r);
-            if (!item)
-                break;
-
-            height = QueryAndCacheLineHeight(r, item);
+            // ... unless there are no more rows, in which case the start of
+            // the given row is the end of the last existing one.
+            m_rowHeightCache->GetLineStart(r, start);
+            break;
         }
 
-        start += height;
+        QueryAndCacheLineHeight(r, item);
     }
 
     return start;
@@ -3781,48 +4313,26 @@ int wxDataViewMainWindow::GetLineAt( unsigned int y ) const
         return y / m_lineHeight;
 
     unsigned int row = 0;
-    if ( m_rowHeightCache->GetLineAt(y, row) )
-        return row;
-
-    // OnPaint asks GetLineAt for the very last y position and this is always
-    // below the last item (--> an invalid item). To prevent iterating over all
-    // items, check if y is below the last row.
-    // Because this is done very often (for each repaint) its worth to handle
-    // this special case separately.
-    int height = 0;
-    int start = 0;
-    unsigned int rowCount = GetRowCount();
-    if (rowCount == 0 ||
-        (m_rowHeightCache->GetLineInfo(rowCount - 1, start, height) &&
-         y >= static_cast<unsigned int>(start + height)))
-    {
-        return rowCount;
-    }
-
-    // sum all item heights until y is reached
-    unsigned int yy = 0;
-    for (;;)
+    while ( !m_rowHeightCache->GetLineAt(y, row) )
     {
-        height = 0;
-        if ( !m_rowHeightCache->GetLineHeight(row, height) )
+        // Either y is below the last row or the height of some row before the
+        // one containing it is not in cache: get the first missing one from
+        // the renderer, checking that it's not beyond the last row.
+        //
+        // Notice that OnPaint asks GetLineAt for the very last y position and
+        // this is always below the last item, but this is cheap to check as
+        // the cache already knows that it has no missing rows at all then.
+        const unsigned int r = m_rowHeightCache->GetFirstUnknown();
+        wxDataViewItem item = GetItemByRow(r);
+        if ( !item )
         {
-            // row height not in cache -> get it from the renderer...
-            wxDataViewItem item = GetItemByRow(row);
-            if ( !item )
-            {
-                wxASSERT(row >= GetRowCount());
-                break;
-            }
-
-            height = QueryAndCacheLineHeight(row, item);
+            wxASSERT(r >= GetRowCount());
+            return GetRowCount();
         }
 
-        yy += height;
-        if (y < yy)
-            break;
-
-        row++;
+        QueryAndCacheLineHeight(r, item);
     }
+
     return row;
 }
 
@@ -3872,73 +4382,34 @@ int wxDataViewMainWindow::QueryAndCacheLineHeight(unsigned int row, wxDataViewIt
 }
 
 
-namespace
+wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) const
 {
+    wxASSERT( !IsVirtualList() );
 
-class RowToTreeNodeJob: public DoJob
-{
-public:
-    // Note that we initialize m_current to -1 because the first node passed to
-    // our operator() will be the root node, which doesn't appear in the window
-    // and so doesn't count as a real row.
-    explicit RowToTreeNodeJob(int row)
-        : m_row(row), m_current(-1), m_ret(nullptr)
-    {
-    }
+    // Checking for this also ensures that the row is always inside the subtree
+    // of the current node in the loop below.
+    if ( row >= static_cast<unsigned>(m_root->GetSubTreeCount()) )
+        return nullptr;
 
-    virtual int operator() ( wxDataViewTreeNode * node ) override
+    // Descend the tree choosing the child containing the row at each level:
+    // thanks to the rows counts stored in the nodes this only takes
+    // logarithmic time in the number of children.
+    //
+    // Note that the row here is relative to the first child of the node, as
+    // the root node itself doesn't appear in the window.
+    int rowInNode = static_cast<int>(row);
+    for ( wxDataViewTreeNode* node = m_root; ; )
     {
-        if( m_current == m_row)
-        {
-            m_ret = node;
-            return DoJob::DONE;
-        }
-
-        if( node->GetSubTreeCount() + m_current < m_row )
-        {
-            m_current += node->GetSubTreeCount() + 1;
-            return  DoJob::SKIP_SUBTREE;
-        }
-        else
-        {
-            // If the current node has only leaf children, we can find the
-            // desired node directly. This can speed up finding the node
-            // in some cases, and will have a very good effect for list views.
-            if ( node->HasChildren() &&
-                 (int)node->GetChildNodes().size() == node->GetSubTreeCount() )
-            {
-                const int index = m_row - m_current - 1;
-                m_ret = node->GetChildNodes()[index];
-                return DoJob::DONE;
-            }
+        int childRow;
+        const unsigned index = node->FindChildByRow(rowInNode, childRow);
 
-            m_current++;
+        wxDataViewTreeNode* const child = node->GetChildNodes()[index];
+        if ( rowInNode == childRow )
+            return child;
 
-            return DoJob::CONTINUE;
-        }
+        rowInNode -= childRow + 1;
+        node = child;
     }
-
-    wxDataViewTreeNode * GetResult() const
-        { return m_ret; }
-
-private:
-    const int m_row;
-    int m_current;
-    wxDataViewTreeNode* m_ret;
-};
-
-} // anonymous namespace
-  //
-wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) const
-{
-    wxASSERT( !IsVirtualList() );
-
-    if ( row == (unsigned)-1 )
-        return nullptr;
-
-    RowToTreeNodeJob job(static_cast<int>(row));
-    Walker( m_root , job );
-    return job.GetResult();
 }
 
 wxDataViewItem wxDataViewMainWindow::GetItemByRow(unsigned int row) const
@@ -4030,13 +4501,6 @@ wxDataViewMainWindow::DoExpand(wxDataViewTreeNode* node,
             return;
         }
 
-        if ( m_rowHeightCache )
-        {
-            // Expand makes new rows visible thus we invalidates all following
-            // rows in the height cache
-            m_rowHeightCache->Remove(row);
-        }
-
         node->ToggleOpen(this);
 
         // build the children of current node
@@ -4050,6 +4514,8 @@ wxDataViewMainWindow::DoExpand(wxDataViewTreeNode* node,
         // Shift all stored indices after this row by the number of newly added
         // rows.
         m_selection.OnItemsInserted(row + 1, countNewRows);
+        if ( m_rowHeightCache )
+            m_rowHeightCache->InsertRows(row + 1, countNewRows);
         if ( HasCurrentRow() && m_currentRow > row )
             ChangeCurrentRow(m_currentRow + countNewRows);
 
@@ -4100,13 +4566,6 @@ void wxDataViewMainWindow::Collapse(unsigned int row)
     if (!node->HasChildren())
         return;
 
-    if ( m_rowHeightCache )
-    {
-        // Collapse hides rows thus we invalidates all following
-        // rows in the height cache
-        m_rowHeightCache->Remove(row);
-    }
-
     if (node->IsOpen())
     {
         if ( !SendExpanderEvent(wxEVT_DATAVIEW_ITEM_COLLAPSING,node->GetItem()) )
@@ -4130,6 +4589,9 @@ void wxDataViewMainWindow::Collapse(unsigned int row)
 
         node->ToggleOpen(this);
 
+        if ( m_rowHeightCache )
+            m_rowHeightCache->DeleteRows(row + 1, countDeletedRows);
+
         // Adjust the current row if necessary.
         if ( HasCurrentRow() && m_currentRow > row )
         {
@@ -4338,60 +4800,6 @@ int wxDataViewMainWindow::RecalculateCount() const
     }
 }
 
-namespace
-{
-
-class ItemToRowJob : public DoJob
-{
-public:
-    // As with RowToTreeNodeJob above, we initialize m_current to -1 because
-    // the first node passed to our operator() is the root node which is not
-    // visible on screen and so we should return 0 for its first child node and
-    // not for the root itself.
-    ItemToRowJob(const wxDataViewItem& item, wxVector<wxDataViewItem>::reverse_iterator iter)
-        : m_item(item), m_iter(iter), m_current(-1)
-    {
-    }
-
-    // Maybe binary search will help to speed up this process
-    virtual int operator() ( wxDataViewTreeNode * node) override
-    {
-        if( node->GetItem() == m_item )
-        {
-            return DoJob::DONE;
-        }
-
-        // Is this node the next (grand)parent of the item we're looking for?
-        if( node->GetItem() == *m_iter )
-        {
-            // Search for the next (grand)parent now and skip this item itself.
-            ++m_iter;
-            ++m_current;
-            return DoJob::CONTINUE;
-        }
-        else
-        {
-            // Skip this node and all its currently visible children.
-            m_current += node->GetSubTreeCount() + 1;
-            return DoJob::SKIP_SUBTREE;
-        }
-
-    }
-
-    int GetResult() const
-        { return m_current; }
-
-private:
-    const wxDataViewItem m_item;
-    wxVector<wxDataViewItem>::reverse_iterator m_iter;
-
-    // The row corresponding to the last node seen in our operator().
-    int m_current;
-
-};
-
-} // anonymous namespace
-
 int
 wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item,
                                    WalkFlags flags) const
@@ -4418,16 +4826,32 @@ wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item,
             it = model->GetParent(it);
         }
 
-        // add an 'invalid' item to represent our 'invisible' root node
-        parentChain.push_back(wxDataViewItem());
-
         // the parent chain was created by adding the deepest parent first.
-        // so if we want to start at the root node, we have to iterate backwards through the vector
-        ItemToRowJob job( item, parentChain.rbegin() );
-        if ( !Walker( m_root, job, flags ) )
-            return -1;
+        // so if we want to start at the root node, we have to iterate backwards
+        // through the vector, descending into the corresponding child at each
+        // level and adding the number of rows before it to the result, which
+        // starts at -1 because the root node itself doesn't count as a row.
+        int row = -1;
+        const wxDataViewTreeNode* node = m_root;
+        for ( wxVector<wxDataViewItem>::reverse_iterator parentIt = parentChain.rbegin();
+              parentIt != parentChain.rend();
+              ++parentIt )
+        {
+            if ( !node->HasChildren() )
+                return -1;
 
-        return job.GetResult();
+            if ( flags == Walk_ExpandedOnly && !node->IsOpen() )
+                return -1;
+
+            const int index = node->FindChildByItem(*parentIt);
+            if ( index == wxNOT_FOUND )
+                return -1;
+
+            row += node->GetChildRow(index) + 1;
+            node = node->GetChildNodes()[index];
+        }
+
+        return row;
     }
 }
 
@@ -5613,7 +6037,11 @@ wxEND_EVENT_TABLE()
 wxDataViewCtrl::~wxDataViewCtrl()
 {
     if (m_notifier)
+    {
+        // There is no need to apply the pending changes, if any, now.
+        m_clientArea->CancelBatch();
         GetModel()->RemoveNotifier( m_notifier );
+    }
 
     DoClearColumns();
 
@@ -5889,6 +6317,11 @@ bool wxDataViewCtrl::Enable(bool enable)
 
 bool wxDataViewCtrl::AssociateModel( wxDataViewModel *model )
 {
+    // The tree is rebuilt below anyhow, so forget about the changes made
+    // during the current batch of the old model, if any. And if the new model
+    // is in a batch, AddNotifier() starts a new one for us.
+    m_clientArea->CancelBatch();
+
     if (wxDataViewModel* const oldModel = GetModel())
     {
         // Remove the notifier from the model before calling the base class
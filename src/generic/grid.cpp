@@ -26,6 +26,7 @@
 #ifndef WX_PRECOMP
     #include "wx/utils.h"
     #include "wx/dcclient.h"
+    #include "wx/dcmemory.h"
     #include "wx/settings.h"
     #include "wx/log.h"
     #include "wx/textctrl.h"
@@ -46,6 +47,7 @@
 #include "wx/renderer.h"
 #include "wx/headerctrl.h"
 #include "wx/scopeguard.h"
+#include "wx/threadpool.h"
 
 #if wxUSE_CLIPBOARD
     #include "wx/clipbrd.h"
@@ -61,6 +63,8 @@ const char wxGridNameStr[] = "grid";
 // Required for wxIs... functions
 #include <ctype.h>
 
+#include <typeinfo>
+
 // ----------------------------------------------------------------------------
 // globals
 // ----------------------------------------------------------------------------
@@ -626,6 +630,31 @@ wxGridCellAttr *wxGridCellAttr::Clone() const
     return attr;
 }
 
+bool wxGridCellAttr::IsSameAs(const wxGridCellAttr& other) const
+{
+    // We can't compare the client data, so consider the attributes using it
+    // to be always different.
+    if ( HasClientDataContainer() || other.HasClientDataContainer() )
+        return false;
+
+    return m_colText == other.m_colText &&
+           m_colBack == other.m_colBack &&
+           m_font == other.m_font &&
+           m_hAlign == other.m_hAlign &&
+           m_vAlign == other.m_vAlign &&
+           m_sizeRows == other.m_sizeRows &&
+           m_sizeCols == other.m_sizeCols &&
+           m_fitMode.IsSpecified() == other.m_fitMode.IsSpecified() &&
+           m_fitMode.IsClip() == other.m_fitMode.IsClip() &&
+           m_fitMode.IsOverflow() == other.m_fitMode.IsOverflow() &&
+           m_fitMode.GetEllipsizeMode() == other.m_fitMode.GetEllipsizeMode() &&
+           m_renderer == other.m_renderer &&
+           m_editor == other.m_editor &&
+           m_defGridAttr == other.m_defGridAttr &&
+           m_isReadOnly == other.m_isReadOnly &&
+           m_attrkind == other.m_attrkind;
+}
+
 void wxGridCellAttr::MergeWith(wxGridCellAttr *mergefrom)
 {
     if ( !HasTextColour() && mergefrom->HasTextColour() )
@@ -933,6 +962,475 @@ wxGridCellEditor* wxGridCellAttr::GetEditor(const wxGrid* grid, int row, int col
     return editor;
 }
 
+// ----------------------------------------------------------------------------
+// wxGridDamage
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+bool CompareCellCoords(const wxGridCellCoords& c1, const wxGridCellCoords& c2)
+{
+    return c1.GetRow() < c2.GetRow() ||
+            (c1.GetRow() == c2.GetRow() && c1.GetCol() < c2.GetCol());
+}
+
+} // anonymous namespace
+
+void wxGridDamage::AddCell(int row, int col)
+{
+    m_cells.push_back(wxGridCellCoords(row, col));
+
+    // Don't let the vector grow indefinitely if the same cells are changed
+    // over and over again.
+    if ( m_cells.size() >= m_compactAt )
+    {
+        Compact();
+
+        m_compactAt = wxMax(2*m_cells.size(), 1024);
+    }
+}
+
+void wxGridDamage::Compact()
+{
+    std::sort(m_cells.begin(), m_cells.end(), CompareCellCoords);
+    m_cells.erase(std::unique(m_cells.begin(), m_cells.end()), m_cells.end());
+}
+
+void wxGridDamage::Clear()
+{
+    m_cells.clear();
+    m_compactAt = 0;
+}
+
+wxVector<wxGridBlockCoords> wxGridDamage::TakeBlocks(const wxGrid& grid)
+{
+    const int numRows = grid.GetNumberRows();
+    const int numCols = grid.GetNumberCols();
+
+    // Convert the cells to positions, using -1 for the column of full rows,
+    // and sort them to have all the cells of the same row together.
+    wxVector<wxGridCellCoords> cells;
+    cells.reserve(m_cells.size());
+    for ( const auto& cell : m_cells )
+    {
+        const int row = cell.GetRow();
+        const int col = cell.GetCol();
+        if ( row >= numRows || col >= numCols )
+            continue;
+
+        cells.push_back(wxGridCellCoords(grid.GetRowPos(row),
+                                         col == -1 ? -1 : grid.GetColPos(col)));
+    }
+
+    Clear();
+
+    std::sort(cells.begin(), cells.end(), CompareCellCoords);
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+    wxVector<wxGridBlockCoords> blocks;
+
+    // Indices of the blocks ending in the previous row, which can be extended
+    // to the current one, sorted by their left column, and the same thing for
+    // the current row.
+    wxVector<size_t> prevBlocks,
+                     currBlocks;
+    int prevRow = -1;
+
+    const size_t count = cells.size();
+    for ( size_t n = 0; n < count; )
+    {
+        const int row = cells[n].GetRow();
+        const bool adjacent = prevRow != -1 && row == prevRow + 1;
+
+        currBlocks.clear();
+        size_t prev = 0;
+
+        while ( n < count && cells[n].GetRow() == row )
+        {
+            // Find the run of adjacent columns starting at this cell, the
+            // full row is always a single run.
+            int left = cells[n].GetCol(),
+                right = left;
+            if ( left == -1 )
+            {
+                left = 0;
+                right = numCols - 1;
+
+                while ( n < count && cells[n].GetRow() == row )
+                    n++;
+            }
+            else
+            {
+                for ( n++; n < count && cells[n].GetRow() == row; n++ )
+                {
+                    if ( cells[n].GetCol() != right + 1 )
+                        break;
+
+                    right++;
+                }
+            }
+
+            // Extend the block with the same columns from the previous row, if
+            // any, or start a new one.
+            if ( adjacent )
+            {
+                while ( prev < prevBlocks.size() &&
+                            blocks[prevBlocks[prev]].GetLeftCol() < left )
+                    prev++;
+            }
+
+            if ( adjacent && prev < prevBlocks.size() &&
+                    blocks[prevBlocks[prev]].GetLeftCol() == left &&
+                        blocks[prevBlocks[prev]].GetRightCol() == right )
+            {
+                blocks[prevBlocks[prev]].SetBottomRow(row);
+                currBlocks.push_back(prevBlocks[prev]);
+                prev++;
+            }
+            else
+            {
+                currBlocks.push_back(blocks.size());
+                blocks.push_back(wxGridBlockCoords(row, left, row, right));
+            }
+        }
+
+        prevBlocks.swap(currBlocks);
+        prevRow = row;
+    }
+
+    return blocks;
+}
+
+// ----------------------------------------------------------------------------
+// wxGridLineOffsets
+// ----------------------------------------------------------------------------
+
+void wxGridLineOffsets::Clear()
+{
+    m_sizes.clear();
+    m_tree.clear();
+    m_topBit = 0;
+}
+
+void wxGridLineOffsets::Assign(wxVector<int>&& sizes)
+{
+    m_sizes = std::move(sizes);
+
+    Rebuild(0);
+}
+
+void wxGridLineOffsets::Rebuild(int from)
+{
+    const int count = GetCount();
+
+    m_tree.resize(count + 1);
+
+    for ( int n = from + 1; n <= count; n++ )
+        m_tree[n] = m_sizes[n - 1];
+
+    // The entries up to "from" only depend on the sizes of the lines before
+    // it and so are still valid, but the ones covering the lines before it in
+    // the ranges of the entries after it must be added to them. These entries
+    // are exactly those used for computing the offset of the line at "from".
+    for ( int n = from; n > 0; n -= n & -n )
+    {
+        const int parent = n + (n & -n);
+        if ( parent <= count )
+            m_tree[parent] += m_tree[n];
+    }
+
+    for ( int n = from + 1; n <= count; n++ )
+    {
+        const int parent = n + (n & -n);
+        if ( parent <= count )
+            m_tree[parent] += m_tree[n];
+    }
+
+    m_topBit = 0;
+    if ( count )
+    {
+        m_topBit = 1;
+        while ( m_topBit*2 <= count )
+            m_topBit *= 2;
+    }
+}
+
+void wxGridLineOffsets::SetSize(int pos, int size)
+{
+    const int diff = size - m_sizes[pos];
+    if ( !diff )
+        return;
+
+    m_sizes[pos] = size;
+
+    const int count = GetCount();
+    for ( int n = pos + 1; n <= count; n += n & -n )
+        m_tree[n] += diff;
+}
+
+int wxGridLineOffsets::GetStart(int pos) const
+{
+    int start = 0;
+    for ( int n = pos; n > 0; n -= n & -n )
+        start += m_tree[n];
+
+    return start;
+}
+
+int wxGridLineOffsets::FindPos(int offset) const
+{
+    if ( offset < 0 )
+        return wxNOT_FOUND;
+
+    // Find the number of the lines ending at or before the given offset by
+    // descending the implicit tree, the line after them contains the offset.
+    const int count = GetCount();
+    int pos = 0;
+    for ( int bit = m_topBit; bit; bit /= 2 )
+    {
+        const int next = pos + bit;
+        if ( next <= count && m_tree[next] <= offset )
+        {
+            pos = next;
+            offset -= m_tree[next];
+        }
+    }
+
+    return pos < count ? pos : wxNOT_FOUND;
+}
+
+void wxGridLineOffsets::Insert(int pos, int count, int size)
+{
+    m_sizes.insert(m_sizes.begin() + pos, count, size);
+
+    Rebuild(pos);
+}
+
+void wxGridLineOffsets::Remove(int pos, int count)
+{
+    m_sizes.erase(m_sizes.begin() + pos, m_sizes.begin() + pos + count);
+
+    Rebuild(pos);
+}
+
+// ----------------------------------------------------------------------------
+// wxGridTextMeasurer
+// ----------------------------------------------------------------------------
+
+wxGridTextMeasurer::wxGridTextMeasurer(wxReadOnlyDC& dc, const wxFont& font)
+    : m_font(font)
+{
+    dc.SetFont(font);
+
+    // Use the same string as wxTextMeasure for the height of the empty lines.
+    m_lineHeight = dc.GetTextExtent(wxS("W")).y;
+
+    for ( int ch = 0; ch < static_cast<int>(WXSIZEOF(m_widths)); ch++ )
+    {
+        // Don't try to measure the control characters, they may be shown
+        // differently depending on the platform.
+        if ( ch < 0x20 || (ch >= 0x7f && ch < 0xa0) )
+            m_widths[ch] = -1;
+        else
+            m_widths[ch] = dc.GetTextExtent(wxString(wxUniChar(ch))).x;
+    }
+}
+
+int
+wxGridTextMeasurer::GetExtent(const wxString& text,
+                              wxGridDirection direction) const
+{
+    int lines = 1;
+    int width = 0,
+        widthMax = 0;
+    for ( wxString::const_iterator it = text.begin(); it != text.end(); ++it )
+    {
+        const wxUniChar ch = *it;
+        if ( ch == wxS('\n') )
+        {
+            lines++;
+            width = 0;
+            continue;
+        }
+
+        const wxUint32 code = ch.GetValue();
+        if ( code >= WXSIZEOF(m_widths) || m_widths[code] == -1 )
+            return -1;
+
+        width += m_widths[code];
+        if ( width > widthMax )
+            widthMax = width;
+    }
+
+    return direction == wxGRID_COLUMN ? widthMax : lines * m_lineHeight;
+}
+
+namespace
+{
+
+// Return the maximal extent of the given texts which can be measured using
+// the given measurer and append the indices of the other ones to unsupported.
+int
+MeasureTexts(const wxGridTextMeasurer& measurer,
+             wxGridDirection direction,
+             const wxVector<wxString>& texts,
+             size_t begin,
+             size_t end,
+             wxVector<size_t>& unsupported)
+{
+    int extentMax = 0;
+    for ( size_t n = begin; n < end; n++ )
+    {
+        const int extent = measurer.GetExtent(texts[n], direction);
+        if ( extent == -1 )
+            unsupported.push_back(n);
+        else if ( extent > extentMax )
+            extentMax = extent;
+    }
+
+    return extentMax;
+}
+
+// Collects the texts of the cells measured in wxGRID_AUTOSIZE_PARALLEL mode
+// and measures them in batches, using several threads if possible.
+class wxGridParallelMeasurer
+{
+public:
+    wxGridParallelMeasurer(wxReadOnlyDC& dc, wxGridDirection direction)
+        : m_dc(dc),
+          m_direction(direction)
+    {
+    }
+
+    // Add the text to be measured using the given font.
+    void Add(const wxFont& font, const wxString& text)
+    {
+        Batch& batch = GetBatch(font);
+        batch.texts.push_back(text);
+        if ( batch.texts.size() == BATCH_SIZE )
+            Measure(batch);
+    }
+
+    // Measure all the remaining texts and return the maximal extent of all
+    // the texts added to this object.
+    int Finish()
+    {
+        for ( size_t n = 0; n < m_batches.size(); n++ )
+            Measure(m_batches[n]);
+
+        return m_extentMax;
+    }
+
+private:
+    // The number of texts to accumulate before measuring them: this limits
+    // the memory used for storing them.
+    static const size_t BATCH_SIZE = 65536;
+
+    // The minimal number of texts to measure in each thread, as measuring
+    // them is very fast and there is no point in using another thread to
+    // measure just a few of them.
+    static const size_t MIN_TEXTS_PER_THREAD = 4096;
+
+    struct Batch
+    {
+        std::unique_ptr<wxGridTextMeasurer> measurer;
+        wxVector<wxString> texts;
+    };
+
+    Batch& GetBatch(const wxFont& font)
+    {
+        // Typically all cells use the same font, so check the last used one
+        // first.
+        if ( m_last < m_batches.size() &&
+                m_batches[m_last].measurer->GetFont() == font )
+            return m_batches[m_last];
+
+        for ( m_last = 0; m_last < m_batches.size(); m_last++ )
+        {
+            if ( m_batches[m_last].measurer->GetFont() == font )
+                return m_batches[m_last];
+        }
+
+        m_batches.push_back(Batch());
+        m_batches.back().measurer.reset(new wxGridTextMeasurer(m_dc, font));
+        return m_batches.back();
+    }
+
+    void Measure(Batch& batch)
+    {
+        const wxVector<wxString>& texts = batch.texts;
+        const size_t count = texts.size();
+        if ( !count )
+            return;
+
+        int extentMax = 0;
+        wxVector<size_t> unsupported;
+
+#if wxUSE_THREADS
+        // Measure the texts in the threads of the global pool, in as many
+        // parts as allowed by their number.
+        wxCriticalSection critsect;
+        wxThreadPool::Get().ParallelFor
+        (
+            0, static_cast<int>(count),
+            [&](int begin, int end)
+            {
+                wxVector<size_t> unsupportedPart;
+                const int extent = MeasureTexts(*batch.measurer, m_direction,
+                                                texts, begin, end,
+                                                unsupportedPart);
+
+                wxCriticalSectionLocker lock(critsect);
+
+                if ( extent > extentMax )
+                    extentMax = extent;
+
+                unsupported.insert(unsupported.end(),
+                                   unsupportedPart.begin(),
+                                   unsupportedPart.end());
+            },
+            wxMax(static_cast<int>(count / MIN_TEXTS_PER_THREAD), 1)
+        );
+#else // !wxUSE_THREADS
+        extentMax = MeasureTexts(*batch.measurer, m_direction, texts,
+                                 0, count, unsupported);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+        // Measure the texts which couldn't be measured without using the DC.
+        if ( !unsupported.empty() )
+        {
+            m_dc.SetFont(batch.measurer->GetFont());
+            for ( size_t n = 0; n < unsupported.size(); n++ )
+            {
+                const wxSize
+                    size = m_dc.GetMultiLineTextExtent(texts[unsupported[n]]);
+                const int
+                    extent = m_direction == wxGRID_COLUMN ? size.x : size.y;
+                if ( extent > extentMax )
+                    extentMax = extent;
+            }
+        }
+
+        if ( extentMax > m_extentMax )
+            m_extentMax = extentMax;
+
+        batch.texts.clear();
+    }
+
+    wxReadOnlyDC& m_dc;
+    const wxGridDirection m_direction;
+
+    wxVector<Batch> m_batches;
+    size_t m_last = 0;
+
+    int m_extentMax = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridParallelMeasurer);
+};
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------
 // wxGridCellAttrData
 // ----------------------------------------------------------------------------
@@ -956,60 +1454,231 @@ void KeyToCoords(wxGridCoordsToAttrMap::key_type key, int *pRow, int *pCol)
     *pCol = key & wxUINT32_MAX;
 }
 
+// Return true if the two different attributes can be replaced by just one of
+// them: this is only the case if they are equal and nobody else holds a
+// reference to them, so that neither of them can be modified later.
+bool CanShareAttrs(const wxGridCellAttr* attr1, const wxGridCellAttr* attr2)
+{
+    return attr1->GetRefCount() == 1 && attr2->GetRefCount() == 1 &&
+                !attr1->HasSize() && attr1->IsSameAs(*attr2);
+}
+
 } // anonymous namespace
 
 wxGridCellAttrData::~wxGridCellAttrData()
 {
-    for ( wxGridCoordsToAttrMap::iterator it = m_attrs.begin();
-          it != m_attrs.end();
-          ++it )
+    for ( Runs& runs : m_cols )
+    {
+        for ( Runs::const_iterator it = runs.begin(); it != runs.end(); ++it )
+            it->second.attr->DecRef();
+    }
+}
+
+/* static */
+wxGridCellAttrData::Runs::iterator
+wxGridCellAttrData::FindRun(Runs& runs, int row)
+{
+    Runs::iterator it = runs.upper_bound(row);
+    if ( it != runs.begin() )
+    {
+        Runs::iterator prev = std::prev(it);
+        if ( prev->second.last >= row )
+            return prev;
+    }
+
+    return it;
+}
+
+/* static */
+wxGridCellAttrData::Runs::const_iterator
+wxGridCellAttrData::FindRun(const Runs& runs, int row)
+{
+    return FindRun(const_cast<Runs&>(runs), row);
+}
+
+/* static */
+void wxGridCellAttrData::MergeWithNext(Runs& runs, Runs::iterator it)
+{
+    const Runs::iterator next = std::next(it);
+    if ( next == runs.end() || next->first != it->second.last + 1 )
+        return;
+
+    Run& run = it->second;
+    const Run& nextRun = next->second;
+
+    if ( nextRun.attr == run.attr )
+        run.merged = run.merged || nextRun.merged;
+    else if ( CanShareAttrs(run.attr, nextRun.attr) )
+        run.merged = true;
+    else
+        return;
+
+    run.last = nextRun.last;
+    nextRun.attr->DecRef();
+
+    runs.erase(next);
+}
+
+/* static */
+wxGridCellAttr* wxGridCellAttrData::GetAttrForSplit(const Run& run)
+{
+    // Cells of merged runs don't need to share the same attribute object and
+    // using a copy of it allows merging both parts with other runs later.
+    if ( run.merged )
+        return run.attr->Clone();
+
+    run.attr->IncRef();
+    return run.attr;
+}
+
+/* static */
+void wxGridCellAttrData::EraseRow(Runs& runs, int row)
+{
+    const Runs::iterator it = FindRun(runs, row);
+    if ( it == runs.end() || it->first > row )
+        return;
+
+    Run& run = it->second;
+    if ( it->first == run.last )
     {
-        it->second->DecRef();
+        run.attr->DecRef();
+        runs.erase(it);
     }
+    else if ( row == it->first )
+    {
+        // The first row is the key, so the run has to be reinserted.
+        const Run rest = run;
+        runs.insert(runs.erase(it), std::make_pair(row + 1, rest));
+    }
+    else if ( row == run.last )
+    {
+        run.last--;
+    }
+    else // split the run in two
+    {
+        Run after = run;
+        after.attr = GetAttrForSplit(run);
+
+        run.last = row - 1;
 
-    m_attrs.clear();
+        runs.insert(std::next(it), std::make_pair(row + 1, after));
+    }
 }
 
 void wxGridCellAttrData::SetAttr(wxGridCellAttr *attr, int row, int col)
 {
-    wxGridCoordsToAttrMap::iterator it = FindIndex(row, col);
-    if ( it == m_attrs.end() )
+    // Negative coordinates are not supported.
+    if ( row < 0 || col < 0 )
     {
         if ( attr )
-        {
-            // add the attribute
-            m_attrs[CoordsToKey(row, col)] = attr;
-        }
-        //else: nothing to do
+            attr->DecRef();
+        return;
     }
-    else // we already have an attribute for this cell
+
+    if ( static_cast<size_t>(col) >= m_cols.size() )
     {
-        // See note near DecRef() in wxGridRowOrColAttrData::SetAttr for why
-        // this also works when old and new attribute are the same.
-        it->second->DecRef();
+        if ( !attr )
+            return;
 
-        // Change or remove the attribute.
-        if ( attr )
-            it->second = attr;
-        else
-            m_attrs.erase(it);
+        m_cols.resize(col + 1);
+    }
+
+    Runs& runs = m_cols[col];
+
+    Runs::iterator it = FindRun(runs, row);
+    if ( it != runs.end() && it->first <= row && it->second.attr == attr )
+    {
+        // We already have a reference to this attribute, so just release the
+        // one which was passed to us.
+        attr->DecRef();
+        return;
+    }
+
+    EraseRow(runs, row);
+
+    if ( !attr )
+        return;
+
+    const Run run = { row, attr, false };
+    it = runs.insert(FindRun(runs, row), std::make_pair(row, run));
+
+    // Merge the new run with the adjacent ones, if possible. Also try merging
+    // the adjacent runs with their own neighbours: their attributes could have
+    // been modified after being set, as wxGrid::SetCellBackgroundColour() and
+    // similar functions do, so they may have become equal only now.
+    const Runs::iterator next = std::next(it);
+    if ( next != runs.end() )
+        MergeWithNext(runs, next);
+
+    MergeWithNext(runs, it);
+
+    if ( it != runs.begin() )
+    {
+        const Runs::iterator prev = std::prev(it);
+
+        // Note that this may invalidate "it" and is the last use of it.
+        MergeWithNext(runs, prev);
+
+        if ( prev != runs.begin() )
+            MergeWithNext(runs, std::prev(prev));
     }
 }
 
 wxGridCellAttr *wxGridCellAttrData::GetAttr(int row, int col) const
 {
-    wxGridCellAttr *attr = nullptr;
+    if ( row < 0 || col < 0 || static_cast<size_t>(col) >= m_cols.size() )
+        return nullptr;
+
+    const Runs& runs = m_cols[col];
+
+    const Runs::const_iterator it = FindRun(runs, row);
+    if ( it == runs.end() || it->first > row )
+        return nullptr;
+
+    wxGridCellAttr* const attr = it->second.attr;
+    attr->IncRef();
+
+    return attr;
+}
+
+wxGridCellAttr *wxGridCellAttrData::GetOwnAttr(int row, int col)
+{
+    if ( row < 0 || col < 0 || static_cast<size_t>(col) >= m_cols.size() )
+        return nullptr;
+
+    Runs& runs = m_cols[col];
 
-    wxGridCoordsToAttrMap::iterator it = FindIndex(row, col);
-    if ( it != m_attrs.end() )
+    const Runs::iterator it = FindRun(runs, row);
+    if ( it == runs.end() || it->first > row )
+        return nullptr;
+
+    wxGridCellAttr* attr = it->second.attr;
+    if ( it->second.merged && it->first != it->second.last )
     {
-        attr = it->second;
-        attr->IncRef();
+        // The other cells of this run only use the same attribute because it
+        // was equal to theirs, so give this cell its own copy of it.
+        attr = attr->Clone();
+
+        EraseRow(runs, row);
+
+        const Run run = { row, attr, false };
+        runs.insert(FindRun(runs, row), std::make_pair(row, run));
     }
 
+    attr->IncRef();
+
     return attr;
 }
 
+size_t wxGridCellAttrData::GetRunsCount() const
+{
+    size_t count = 0;
+    for ( const Runs& runs : m_cols )
+        count += runs.size();
+
+    return count;
+}
+
 namespace
 {
 
@@ -1195,20 +1864,177 @@ void UpdateCellAttrRowsOrCols(wxGridCoordsToAttrMap& attrs, int editPos,
 
 } // anonymous namespace
 
-void wxGridCellAttrData::UpdateAttrRows( size_t pos, int numRows )
-{
-    UpdateCellAttrRowsOrCols(m_attrs, static_cast<int>(pos), numRows, 0);
+void wxGridCellAttrData::ExtractSpanAttrs(wxGridCoordsToAttrMap& attrs)
+{
+    const size_t numCols = m_cols.size();
+    for ( size_t col = 0; col < numCols; col++ )
+    {
+        Runs& runs = m_cols[col];
+
+        for ( Runs::iterator it = runs.begin(); it != runs.end(); )
+        {
+            wxGridCellAttr* const attr = it->second.attr;
+            if ( !attr->HasSize() )
+            {
+                ++it;
+                continue;
+            }
+
+            for ( int row = it->first; row <= it->second.last; row++ )
+            {
+                attr->IncRef();
+                attrs[CoordsToKey(row, static_cast<int>(col))] = attr;
+            }
+
+            attr->DecRef();
+
+            it = runs.erase(it);
+        }
+    }
+}
+
+void wxGridCellAttrData::RestoreSpanAttrs(const wxGridCoordsToAttrMap& attrs)
+{
+    for ( wxGridCoordsToAttrMap::const_iterator it = attrs.begin();
+          it != attrs.end();
+          ++it )
+    {
+        int row, col;
+        KeyToCoords(it->first, &row, &col);
+
+        SetAttr(it->second, row, col);
+    }
+}
+
+void wxGridCellAttrData::UpdateAttrRows( size_t pos, int numRows )
+{
+    wxGridCoordsToAttrMap spanAttrs;
+    ExtractSpanAttrs(spanAttrs);
+
+    const int editPos = static_cast<int>(pos);
+
+    for ( Runs& runs : m_cols )
+    {
+        Runs::iterator it = FindRun(runs, editPos);
+        if ( it == runs.end() )
+            continue;
+
+        // The runs after the edit position are moved, and so have to be
+        // reinserted with their new first rows, into this map.
+        Runs moved;
+
+        if ( numRows > 0 )
+        {
+            // Split the run containing the insertion position, if any.
+            if ( it->first < editPos )
+            {
+                Run after = it->second;
+                after.attr = GetAttrForSplit(after);
+
+                it->second.last = editPos - 1;
+
+                moved.insert(moved.end(), std::make_pair(editPos, after));
+                ++it;
+            }
+
+            for ( Runs::iterator i = it; i != runs.end(); ++i )
+                moved.insert(moved.end(), *i);
+
+            runs.erase(it, runs.end());
+
+            for ( Runs::iterator i = moved.begin(); i != moved.end(); ++i )
+            {
+                Run run = i->second;
+                run.last += numRows;
+                runs.insert(runs.end(), std::make_pair(i->first + numRows, run));
+            }
+        }
+        else // deleting rows
+        {
+            const int editEnd = editPos - numRows;
+
+            // Remove the deleted rows from the runs.
+            for ( Runs::iterator i = it; i != runs.end(); ++i )
+            {
+                int first = i->first;
+                Run run = i->second;
+
+                if ( first >= editEnd )
+                {
+                    first += numRows;
+                    run.last += numRows;
+                }
+                else // the run intersects the deleted range
+                {
+                    if ( first >= editPos && run.last < editEnd )
+                    {
+                        run.attr->DecRef();
+                        continue;
+                    }
+
+                    if ( first > editPos )
+                        first = editPos;
+                    run.last = run.last < editEnd ? editPos - 1
+                                                  : run.last + numRows;
+                }
+
+                moved.insert(moved.end(), std::make_pair(first, run));
+            }
+
+            runs.erase(it, runs.end());
+            runs.insert(moved.begin(), moved.end());
+
+            // Merge the runs which became adjacent, if possible.
+            if ( editPos > 0 )
+            {
+                it = FindRun(runs, editPos - 1);
+                if ( it != runs.end() && it->first < editPos )
+                    MergeWithNext(runs, it);
+            }
+        }
+    }
+
+    if ( !spanAttrs.empty() )
+    {
+        UpdateCellAttrRowsOrCols(spanAttrs, editPos, numRows, 0);
+        RestoreSpanAttrs(spanAttrs);
+    }
 }
 
 void wxGridCellAttrData::UpdateAttrCols( size_t pos, int numCols )
 {
-    UpdateCellAttrRowsOrCols(m_attrs, static_cast<int>(pos), 0, numCols);
-}
+    wxGridCoordsToAttrMap spanAttrs;
+    ExtractSpanAttrs(spanAttrs);
 
-wxGridCoordsToAttrMap::iterator
-wxGridCellAttrData::FindIndex(int row, int col) const
-{
-    return m_attrs.find(CoordsToKey(row, col));
+    if ( pos < m_cols.size() )
+    {
+        if ( numCols > 0 )
+        {
+            m_cols.insert(m_cols.begin() + pos, numCols, Runs());
+        }
+        else // deleting columns
+        {
+            const size_t end = wxMin(pos - numCols, m_cols.size());
+            for ( size_t col = pos; col < end; col++ )
+            {
+                const Runs& runs = m_cols[col];
+                for ( Runs::const_iterator it = runs.begin();
+                      it != runs.end();
+                      ++it )
+                {
+                    it->second.attr->DecRef();
+                }
+            }
+
+            m_cols.erase(m_cols.begin() + pos, m_cols.begin() + end);
+        }
+    }
+
+    if ( !spanAttrs.empty() )
+    {
+        UpdateCellAttrRowsOrCols(spanAttrs, static_cast<int>(pos), 0, numCols);
+        RestoreSpanAttrs(spanAttrs);
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -1394,7 +2220,10 @@ wxGridCellAttr *wxGridCellAttrProvider::GetAttr(int row, int col,
                 break;
 
             case (wxGridCellAttr::Cell):
-                attr = m_data->m_cellAttrs.GetAttr(row, col);
+                // The cell attribute is requested in order to modify it, so
+                // make sure it isn't shared with the other cells having equal
+                // attributes.
+                attr = m_data->m_cellAttrs.GetOwnAttr(row, col);
                 break;
 
             case (wxGridCellAttr::Col):
@@ -2397,10 +3226,65 @@ wxEND_EVENT_TABLE()
 
 void wxGridWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
 {
+    if ( m_owner->IsUsingBackBuffer() )
+    {
+        wxPaintDC dc( this );
+        PaintUsingBackBuffer( dc );
+        return;
+    }
+
     wxAutoBufferedPaintDC dc( this );
     m_owner->PrepareDCFor( dc, this );
-    wxRegion reg = GetUpdateRegion();
+    DrawContents( dc, GetUpdateRegion() );
+}
+
+void wxGridWindow::PaintUsingBackBuffer( wxDC& dc )
+{
+    const wxSize size = GetClientSize();
+    if ( size.x <= 0 || size.y <= 0 )
+        return;
+
+    const double scale = dc.GetContentScaleFactor();
+    if ( !m_backBuffer.IsOk() ||
+            m_backBuffer.GetLogicalSize() != size ||
+                m_backBuffer.GetScaleFactor() != scale )
+    {
+        m_backBuffer.CreateWithLogicalSize(size, scale);
+        InvalidateBackBuffer();
+    }
+
+    wxMemoryDC mdc( m_backBuffer );
+    m_owner->PrepareDCFor( mdc, this );
 
+    // Nothing drawn before can be reused if the window was scrolled.
+    const wxPoint origin = mdc.GetDeviceOrigin();
+    if ( origin != m_backBufferOrigin )
+    {
+        m_backBufferOrigin = origin;
+        InvalidateBackBuffer();
+    }
+
+    if ( !m_backBufferDirty.IsEmpty() )
+    {
+        mdc.SetDeviceClippingRegion( m_backBufferDirty );
+        DrawContents( mdc, m_backBufferDirty );
+        mdc.DestroyClippingRegion();
+
+        m_backBufferDirty.Clear();
+    }
+
+    // Copy just the part of the buffer which needs to be repainted, which may
+    // be bigger than the part redrawn above if the window was just exposed.
+    mdc.SetDeviceOrigin( 0, 0 );
+    for ( wxRegionIterator iter(GetUpdateRegion()); iter; ++iter )
+    {
+        const wxRect r = iter.GetRect();
+        dc.Blit( r.GetPosition(), r.GetSize(), &mdc, r.GetPosition() );
+    }
+}
+
+void wxGridWindow::DrawContents( wxDC& dc, const wxRegion& reg )
+{
     wxGridCellCoordsVector dirtyCells = m_owner->CalcCellsExposed( reg , this );
     m_owner->DrawGridCellArea( dc, dirtyCells );
 
@@ -2757,6 +3641,28 @@ void wxGridWindow::ScrollWindow( int dx, int dy, const wxRect *rect )
     m_owner->ScrollWindow(dx, dy, rect);
 }
 
+void wxGridWindow::Refresh( bool eraseBackground, const wxRect *rect )
+{
+    InvalidateBackBuffer( rect );
+
+    wxGridSubwindow::Refresh( eraseBackground, rect );
+}
+
+void wxGridWindow::InvalidateBackBuffer( const wxRect *rect )
+{
+    if ( !m_backBuffer.IsOk() )
+        return;
+
+    const wxRect rectAll( m_backBuffer.GetLogicalSize() );
+    m_backBufferDirty.Union( rect ? *rect * rectAll : rectAll );
+}
+
+void wxGridWindow::FreeBackBuffer()
+{
+    m_backBuffer = wxBitmap();
+    m_backBufferDirty.Clear();
+}
+
 void wxGrid::ScrollWindow( int dx, int dy, const wxRect *rect )
 {
     if ( UsesOverlaySelection() && IsSelection() )
@@ -2914,6 +3820,10 @@ wxGrid::~wxGrid()
 
     delete m_typeRegistry;
     delete m_selection;
+    delete m_damage;
+
+    delete m_rowOffsets;
+    delete m_colOffsets;
 
     delete m_setFixedRows;
     delete m_setFixedCols;
@@ -3121,9 +4031,9 @@ wxGrid::SetTable(wxGridTableBase *table,
 
         // kill row and column size arrays
         m_colWidths.Empty();
-        m_colRights.Empty();
+        m_colOffsets->Clear();
         m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        m_rowOffsets->Clear();
     }
 
     if (table)
@@ -3273,6 +4183,15 @@ void wxGrid::Init()
 
     m_batchCount = 0;
 
+    m_rowOffsets = new wxGridLineOffsets;
+    m_colOffsets = new wxGridLineOffsets;
+
+    m_damage = nullptr;
+    m_deferredRefreshPending = false;
+    m_useBackBuffer = false;
+
+    m_autoSizeMode = wxGRID_AUTOSIZE_ALL;
+
     m_extraWidth =
     m_extraHeight = 0;
 
@@ -3299,35 +4218,39 @@ void wxGrid::Init()
 void wxGrid::InitRowHeights()
 {
     m_rowHeights.Empty();
-    m_rowBottoms.Empty();
-
     m_rowHeights.Alloc( m_numRows );
-    m_rowBottoms.Alloc( m_numRows );
-
     m_rowHeights.Add( m_defaultRowHeight, m_numRows );
 
-    for ( int i = 0; i < m_numRows; i++ )
-    {
-        int rowBottom = ( GetRowPos( i ) + 1 ) * m_defaultRowHeight;
-        m_rowBottoms.Add( rowBottom );
-    }
+    m_rowOffsets->Assign(wxVector<int>(m_numRows, m_defaultRowHeight));
 }
 
 void wxGrid::InitColWidths()
 {
     m_colWidths.Empty();
-    m_colRights.Empty();
-
     m_colWidths.Alloc( m_numCols );
-    m_colRights.Alloc( m_numCols );
-
     m_colWidths.Add( m_defaultColWidth, m_numCols );
 
-    for ( int i = 0; i < m_numCols; i++ )
-    {
-        int colRight = ( GetColPos( i ) + 1 ) * m_defaultColWidth;
-        m_colRights.Add( colRight );
-    }
+    m_colOffsets->Assign(wxVector<int>(m_numCols, m_defaultColWidth));
+}
+
+void wxGrid::UpdateRowOffsets()
+{
+    wxVector<int> heights;
+    heights.reserve(m_numRows);
+    for ( int rowPos = 0; rowPos < m_numRows; rowPos++ )
+        heights.push_back(GetRowHeight(GetRowAt(rowPos)));
+
+    m_rowOffsets->Assign(std::move(heights));
+}
+
+void wxGrid::UpdateColOffsets()
+{
+    wxVector<int> widths;
+    widths.reserve(m_numCols);
+    for ( int colPos = 0; colPos < m_numCols; colPos++ )
+        widths.push_back(GetColWidth(GetColAt(colPos)));
+
+    m_colOffsets->Assign(std::move(widths));
 }
 
 int wxGrid::GetColWidth(int col) const
@@ -3341,16 +4264,16 @@ int wxGrid::GetColWidth(int col) const
 
 int wxGrid::GetColLeft(int col) const
 {
-    if ( m_colRights.IsEmpty() )
+    if ( m_colOffsets->IsEmpty() )
         return GetColPos( col ) * m_defaultColWidth;
 
-    return m_colRights[col] - GetColWidth(col);
+    return m_colOffsets->GetStart(GetColPos(col));
 }
 
 int wxGrid::GetColRight(int col) const
 {
-    return m_colRights.IsEmpty() ? (GetColPos( col ) + 1) * m_defaultColWidth
-                                 : m_colRights[col];
+    return m_colOffsets->IsEmpty() ? (GetColPos( col ) + 1) * m_defaultColWidth
+                                   : m_colOffsets->GetEnd(GetColPos(col));
 }
 
 int wxGrid::GetRowHeight(int row) const
@@ -3365,16 +4288,16 @@ int wxGrid::GetRowHeight(int row) const
 
 int wxGrid::GetRowTop(int row) const
 {
-    if ( m_rowBottoms.IsEmpty() )
+    if ( m_rowOffsets->IsEmpty() )
         return GetRowPos( row ) * m_defaultRowHeight;
 
-    return m_rowBottoms[row] - GetRowHeight(row);
+    return m_rowOffsets->GetStart(GetRowPos(row));
 }
 
 int wxGrid::GetRowBottom(int row) const
 {
-    return m_rowBottoms.IsEmpty() ? (GetRowPos( row ) + 1) * m_defaultRowHeight
-                                  : m_rowBottoms[row];
+    return m_rowOffsets->IsEmpty() ? (GetRowPos( row ) + 1) * m_defaultRowHeight
+                                   : m_rowOffsets->GetEnd(GetRowPos(row));
 }
 
 void wxGrid::CalcDimensions()
@@ -3545,20 +4468,7 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.Insert( m_defaultRowHeight, pos, numRows );
-                m_rowBottoms.Insert( 0, pos, numRows );
-
-                int bottom = 0;
-                if ( pos > 0 )
-                    bottom = m_rowBottoms[GetRowAt( pos - 1 )];
-
-                int rowPos;
-                for ( rowPos = pos; rowPos < m_numRows; rowPos++ )
-                {
-                    i = GetRowAt( rowPos );
-
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
+                m_rowOffsets->Insert( pos, numRows, m_defaultRowHeight );
             }
 
             UpdateCurrentCellOnRedim();
@@ -3599,20 +4509,7 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.Add( m_defaultRowHeight, numRows );
-                m_rowBottoms.Add( 0, numRows );
-
-                int bottom = 0;
-                if ( oldNumRows > 0 )
-                    bottom = m_rowBottoms[oldNumRows - 1];
-
-                int rowPos;
-                for ( rowPos = oldNumRows; rowPos < m_numRows; rowPos++ )
-                {
-                    i = GetRowAt( rowPos );
-
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
+                m_rowOffsets->Insert( oldNumRows, numRows, m_defaultRowHeight );
             }
 
             UpdateCurrentCellOnRedim();
@@ -3652,17 +4549,14 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.RemoveAt( pos, numRows );
-                m_rowBottoms.RemoveAt( pos, numRows );
 
-                int h = 0;
-                int rowPos;
-                for ( rowPos = 0; rowPos < m_numRows; rowPos++ )
-                {
-                    i = GetRowAt( rowPos );
-
-                    h += GetRowHeight(i);
-                    m_rowBottoms[i] = h;
-                }
+                // The positions and indices of the rows are the same unless
+                // they were reordered, in which case we need to recompute all
+                // the offsets.
+                if ( m_rowAt.IsEmpty() )
+                    m_rowOffsets->Remove( pos, numRows );
+                else
+                    UpdateRowOffsets();
             }
 
             UpdateCurrentCellOnRedim();
@@ -3724,20 +4618,7 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.Insert( m_defaultColWidth, pos, numCols );
-                m_colRights.Insert( 0, pos, numCols );
-
-                int right = 0;
-                if ( pos > 0 )
-                    right = m_colRights[GetColAt( pos - 1 )];
-
-                int colPos;
-                for ( colPos = pos; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    right += GetColWidth(i);
-                    m_colRights[i] = right;
-                }
+                m_colOffsets->Insert( pos, numCols, m_defaultColWidth );
             }
 
             // See comment for wxGRIDTABLE_NOTIFY_COLS_APPENDED case explaining
@@ -3783,20 +4664,7 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.Add( m_defaultColWidth, numCols );
-                m_colRights.Add( 0, numCols );
-
-                int right = 0;
-                if ( oldNumCols > 0 )
-                    right = m_colRights[GetColAt( oldNumCols - 1 )];
-
-                int colPos;
-                for ( colPos = oldNumCols; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    right += GetColWidth(i);
-                    m_colRights[i] = right;
-                }
+                m_colOffsets->Insert( oldNumCols, numCols, m_defaultColWidth );
             }
 
             // Notice that this must be called after updating m_colWidths above
@@ -3842,17 +4710,13 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.RemoveAt( pos, numCols );
-                m_colRights.RemoveAt( pos, numCols );
-
-                int w = 0;
-                int colPos;
-                for ( colPos = 0; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
 
-                    w += GetColWidth(i);
-                    m_colRights[i] = w;
-                }
+                // As for the rows, recompute all the offsets if the columns
+                // were reordered.
+                if ( m_colAt.IsEmpty() )
+                    m_colOffsets->Remove( pos, numCols );
+                else
+                    UpdateColOffsets();
             }
 
             // See comment for wxGRIDTABLE_NOTIFY_COLS_APPENDED case explaining
@@ -5467,24 +6331,11 @@ void wxGrid::DoEndMoveRow(int pos)
 
 void wxGrid::RefreshAfterRowPosChange()
 {
-    // recalculate the row bottoms as the row positions have changed,
+    // recalculate the row offsets as the row positions have changed,
     // unless we calculate them dynamically because all rows heights are the
     // same and it's easy to do
     if ( !m_rowHeights.empty() )
-    {
-        int rowBottom = 0;
-        for ( int rowPos = 0; rowPos < m_numRows; rowPos++ )
-        {
-            int rowID = GetRowAt( rowPos );
-
-            // Ignore the currently hidden rows.
-            const int height = m_rowHeights[rowID];
-            if ( height > 0 )
-                rowBottom += height;
-
-            m_rowBottoms[rowID] = rowBottom;
-        }
-    }
+        UpdateRowOffsets();
 
     // and make the changes visible
     RefreshArea(wxGA_Cells | wxGA_RowLabels);
@@ -5568,24 +6419,11 @@ void wxGrid::DoEndMoveCol(int pos)
 
 void wxGrid::RefreshAfterColPosChange()
 {
-    // recalculate the column rights as the column positions have changed,
+    // recalculate the column offsets as the column positions have changed,
     // unless we calculate them dynamically because all columns widths are the
     // same and it's easy to do
     if ( !m_colWidths.empty() )
-    {
-        int colRight = 0;
-        for ( int colPos = 0; colPos < m_numCols; colPos++ )
-        {
-            int colID = GetColAt( colPos );
-
-            // Ignore the currently hidden columns.
-            const int width = m_colWidths[colID];
-            if ( width > 0 )
-                colRight += width;
-
-            m_colRights[colID] = colRight;
-        }
-    }
+        UpdateColOffsets();
 
     int areas = wxGA_Cells;
 
@@ -5998,6 +6836,36 @@ void wxGrid::Refresh(bool eraseb, const wxRect* rect)
     {
         wxScrolledCanvas::Refresh(eraseb, rect);
 
+        // Refreshing the grid itself doesn't call Refresh() of the grid
+        // windows, so we need to update their back buffers ourselves.
+        if ( m_useBackBuffer )
+        {
+            wxGridWindow* const gridWindows[] =
+            {
+                m_gridWin,
+                m_frozenColGridWin,
+                m_frozenRowGridWin,
+                m_frozenCornerGridWin
+            };
+
+            for ( wxGridWindow* gridWindow : gridWindows )
+            {
+                if ( !gridWindow )
+                    continue;
+
+                if ( rect )
+                {
+                    wxRect r(*rect);
+                    r.Offset(-gridWindow->GetPosition());
+                    gridWindow->InvalidateBackBuffer(&r);
+                }
+                else
+                {
+                    gridWindow->InvalidateBackBuffer();
+                }
+            }
+        }
+
         // Notice that this function expects the rectangle to be relative
         // to the wxGrid window itself, i.e. the origin (0, 0) at the top
         // left corner of the window. and will correctly refresh the sub-
@@ -6220,23 +7088,12 @@ void wxGrid::OnDPIChanged(wxDPIChangedEvent& event)
     // inside InitPixelFields() above).
     if ( !m_rowHeights.empty() )
     {
-        int total = 0;
+        // Note that even hidden rows heights must be scaled to ensure that
+        // they appear in the expected size if they are shown again.
         for ( unsigned i = 0; i < m_rowHeights.size(); ++i )
-        {
-            int height = m_rowHeights[i];
-
-            // Note that even hidden rows heights must be scaled to ensure that
-            // they appear in the expected size if they are shown again.
-            height = event.ScaleY(height);
-
-            m_rowHeights[i] = height;
+            m_rowHeights[i] = event.ScaleY(m_rowHeights[i]);
 
-            // But don't count hidden rows for the total height.
-            if ( height > 0 )
-                total += height;
-
-            m_rowBottoms[i] = total;
-        }
+        UpdateRowOffsets();
     }
 
     // Similarly for columns, except that here we need to update the native
@@ -6246,23 +7103,15 @@ void wxGrid::OnDPIChanged(wxDPIChangedEvent& event)
         colHeader = m_useNativeHeader ? GetGridColHeader() : nullptr;
     if ( !m_colWidths.empty() )
     {
-        int total = 0;
         for ( unsigned i = 0; i < m_colWidths.size(); ++i )
         {
-            int width = m_colWidths[i];
-
-            width = event.ScaleX(width);
-
-            m_colWidths[i] = width;
-
-            if ( width > 0 )
-                total += width;
-
-            m_colRights[i] = total;
+            m_colWidths[i] = event.ScaleX(m_colWidths[i]);
 
             if ( colHeader )
                 colHeader->UpdateColumn(i);
         }
+
+        UpdateColOffsets();
     }
     else if ( colHeader )
     {
@@ -7891,6 +8740,10 @@ void wxGrid::EndBatch()
             CalcDimensions();
             InvalidateOverlaySelection();
             Refresh();
+
+            // Everything was just refreshed anyhow.
+            if ( m_damage )
+                m_damage->Clear();
         }
     }
 }
@@ -7905,6 +8758,97 @@ void wxGrid::ForceRefresh()
     EndBatch();
 }
 
+void wxGrid::EnableDeferredRefresh(bool enable)
+{
+    if ( enable == IsDeferredRefreshEnabled() )
+        return;
+
+    if ( enable )
+    {
+        m_damage = new wxGridDamage;
+    }
+    else
+    {
+        // Don't lose the cells collected so far.
+        FlushDeferredRefresh();
+
+        wxDELETE(m_damage);
+    }
+}
+
+void wxGrid::FlushDeferredRefresh()
+{
+    m_deferredRefreshPending = false;
+
+    if ( !m_damage || m_damage->IsEmpty() )
+        return;
+
+    if ( !ShouldRefresh() )
+    {
+        // The grid will be entirely refreshed when it's shown or at the end
+        // of the batch anyhow.
+        m_damage->Clear();
+        return;
+    }
+
+    // Find the positions of the rows and columns shown in the main grid
+    // window: there is no need to refresh the cells outside of this range,
+    // unless they're frozen, as they are not visible.
+    int cw, ch;
+    m_gridWin->GetClientSize(&cw, &ch);
+
+    const wxPoint offset = GetGridWindowOffset(m_gridWin);
+    int left, top, right, bottom;
+    CalcGridWindowUnscrolledPosition(offset.x, offset.y,
+                                     &left, &top, m_gridWin);
+    CalcGridWindowUnscrolledPosition(offset.x + cw - 1, offset.y + ch - 1,
+                                     &right, &bottom, m_gridWin);
+
+    const int topPos = YToPos(top, m_gridWin);
+    const int bottomPos = YToPos(bottom, m_gridWin);
+    const int leftPos = XToPos(left, m_gridWin);
+    const int rightPos = XToPos(right, m_gridWin);
+
+    for ( const auto& block : m_damage->TakeBlocks(*this) )
+    {
+        if ( block.GetTopRow() >= m_numFrozenRows &&
+                (block.GetBottomRow() < topPos || block.GetTopRow() > bottomPos) )
+            continue;
+
+        if ( block.GetLeftCol() >= m_numFrozenCols &&
+                (block.GetRightCol() < leftPos || block.GetLeftCol() > rightPos) )
+            continue;
+
+        RefreshBlock(GetRowAt(block.GetTopRow()), GetColAt(block.GetLeftCol()),
+                     GetRowAt(block.GetBottomRow()), GetColAt(block.GetRightCol()));
+    }
+}
+
+void wxGrid::UseBackBuffer(bool use)
+{
+    if ( use == m_useBackBuffer )
+        return;
+
+    m_useBackBuffer = use;
+
+    // Nothing else to do if the grid hasn't been created yet.
+    if ( !m_gridWin )
+        return;
+
+    if ( !use )
+    {
+        m_gridWin->FreeBackBuffer();
+        if ( m_frozenColGridWin )
+            m_frozenColGridWin->FreeBackBuffer();
+        if ( m_frozenRowGridWin )
+            m_frozenRowGridWin->FreeBackBuffer();
+        if ( m_frozenCornerGridWin )
+            m_frozenCornerGridWin->FreeBackBuffer();
+    }
+
+    Refresh(false);
+}
+
 void wxGrid::DoEnable(bool enable)
 {
     wxScrolledCanvas::DoEnable(enable);
@@ -8344,9 +9288,8 @@ wxGridCellCoords wxGrid::XYToCell(int x, int y, wxGridWindow *gridWindow) const
 }
 
 // compute row or column from some (unscrolled) coordinate value, using either
-// m_defaultRowHeight/m_defaultColWidth or binary search on array of
-// m_rowBottoms/m_colRights to do it quickly in O(log n) time.
-// NOTE: This may not work correctly for reordered columns.
+// m_defaultRowHeight/m_defaultColWidth or m_rowOffsets/m_colOffsets to do it
+// quickly in O(log n) time.
 int wxGrid::PosToLinePos(int coord,
                          bool clipToMinMax,
                          const wxGridOperations& oper,
@@ -8365,8 +9308,8 @@ int wxGrid::PosToLinePos(int coord,
 
     // check for the simplest case: if we have no explicit line sizes
     // configured, then we already know the line this position falls in
-    const wxArrayInt& lineEnds = oper.GetLineEnds(this);
-    if ( lineEnds.empty() )
+    const wxGridLineOffsets& offsets = oper.GetLineOffsets(this);
+    if ( offsets.IsEmpty() )
     {
         if ( maxPos < (numLines + minPos) )
             return maxPos;
@@ -8374,45 +9317,22 @@ int wxGrid::PosToLinePos(int coord,
         return clipToMinMax ? numLines + minPos - 1 : -1;
     }
 
-    // binary search is quite efficient and we can't really make any assumptions
-    // on where to start here since row and columns could be of size 0 if they are
-    // hidden. While this could be made more efficient, some profiling will be
-    // necessary to determine if it really is a performance bottleneck
+    if ( numLines <= 0 )
+        return wxNOT_FOUND;
+
     maxPos = numLines + minPos - 1;
 
-    // check if the position is beyond the last column
-    const int lineAtMaxPos = oper.GetLineAt(this, maxPos);
-    if ( coord >= lineEnds[lineAtMaxPos] )
+    // check if the position is beyond the last line of this window
+    if ( coord >= offsets.GetEnd(maxPos) )
         return clipToMinMax ? maxPos : wxNOT_FOUND;
 
     // or before the first one
-    const int lineAt0 = oper.GetLineAt(this, minPos);
-    if ( coord < oper.GetLineStartPos(this, lineAt0) )
+    if ( coord < offsets.GetStart(minPos) )
         return clipToMinMax ? minPos : wxNOT_FOUND;
-    else if ( coord < lineEnds[lineAt0] )
-        return minPos;
-
-    // finally do perform the binary search
-    while ( minPos < maxPos )
-    {
-        wxCHECK_MSG( lineEnds[oper.GetLineAt(this, minPos)] <= coord &&
-                        coord < lineEnds[oper.GetLineAt(this, maxPos)],
-                     -1,
-                     "wxGrid: internal error in PosToLinePos()" );
-
-        if ( coord >= lineEnds[oper.GetLineAt(this, maxPos - 1)] )
-            return maxPos;
-        else
-            maxPos--;
-
-        const int median = minPos + (maxPos - minPos + 1) / 2;
-        if ( coord < lineEnds[oper.GetLineAt(this, median)] )
-            maxPos = median;
-        else
-            minPos = median;
-    }
 
-    return maxPos;
+    // hidden lines have zero size, so the line containing the given position
+    // is the first one ending after it
+    return offsets.FindPos(coord);
 }
 
 int
@@ -10034,6 +10954,10 @@ wxGridCellAttr *wxGrid::GetOrCreateCellAttr(int row, int col) const
         m_table->SetAttr(attr, row, col);
     }
 
+    // The table may have returned a new copy of the attribute shared with
+    // other cells, so don't keep using the old one for this cell.
+    const_cast<wxGrid *>(this)->RefreshAttr(row, col);
+
     return attr;
 }
 
@@ -10370,7 +11294,7 @@ void wxGrid::SetDefaultRowSize( int height, bool resizeExistingRows )
         // arrays (which also allows us to take advantage of
         // some speed optimisations)
         m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        m_rowOffsets->Clear();
         CalcDimensions();
     }
 }
@@ -10471,11 +11395,7 @@ void wxGrid::DoSetRowSize( int row, int height )
     if ( !diff )
         return;
 
-
-    for ( int rowPos = GetRowPos(row); rowPos < m_numRows; rowPos++ )
-    {
-        m_rowBottoms[GetRowAt(rowPos)] += diff;
-    }
+    m_rowOffsets->SetSize(GetRowPos(row), GetRowHeight(row));
 
     InvalidateBestSize();
 
@@ -10539,7 +11459,7 @@ void wxGrid::SetDefaultColSize( int width, bool resizeExistingCols )
         // arrays (which also allows us to take advantage of
         // some speed optimisations)
         m_colWidths.Empty();
-        m_colRights.Empty();
+        m_colOffsets->Clear();
 
         CalcDimensions();
     }
@@ -10620,10 +11540,7 @@ void wxGrid::DoSetColSize( int col, int width )
     }
     //else: will be refreshed when the header is redrawn
 
-    for ( int colPos = GetColPos(col); colPos < m_numCols; colPos++ )
-    {
-        m_colRights[GetColAt(colPos)] += diff;
-    }
+    m_colOffsets->SetSize(GetColPos(col), GetColWidth(col));
 
     InvalidateBestSize();
 
@@ -10800,10 +11717,24 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
     wxGridCellAttrPtr attr;
     wxGridCellRendererPtr renderer;
 
+    // In the sampling mode, only measure the cells in the selected lines.
+    const bool sampled = (m_autoSizeMode & wxGRID_AUTOSIZE_SAMPLE) != 0;
+    wxVector<int> sample;
+    if ( sampled )
+        sample = GetAutoSizeSampleLines(direction);
+
+    // In the parallel mode, the texts of the cells using the standard string
+    // renderer are collected and measured later by this object.
+    const bool parallel = (m_autoSizeMode & wxGRID_AUTOSIZE_PARALLEL) != 0;
+    wxGridParallelMeasurer parallelMeasurer(dc, direction);
+
     wxCoord extent, extentMax = 0;
-    int max = column ? m_numRows : m_numCols;
-    for ( int rowOrCol = 0; rowOrCol < max; rowOrCol++ )
+    int max = sampled ? static_cast<int>(sample.size())
+                      : column ? m_numRows : m_numCols;
+    for ( int n = 0; n < max; n++ )
     {
+        const int rowOrCol = sampled ? sample[n] : n;
+
         if ( column )
         {
             if ( !IsRowShown(rowOrCol) )
@@ -10861,6 +11792,13 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
 
         if ( renderer )
         {
+            if ( parallel && span == CellSpan_None &&
+                    typeid(*renderer) == typeid(wxGridCellStringRenderer) )
+            {
+                parallelMeasurer.Add(attr->GetFont(), GetCellValue(row, col));
+                continue;
+            }
+
             extent = column
                         ? renderer->GetBestWidth(*this, *attr, dc, row, col,
                                                  GetRowHeight(row))
@@ -10884,6 +11822,10 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
         }
     }
 
+    extent = parallelMeasurer.Finish();
+    if ( extent > extentMax )
+        extentMax = extent;
+
     // now also compare with the column label extent
     wxCoord extentLabel;
     dc.SetFont( GetLabelFont() );
@@ -11005,6 +11947,86 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
     }
 }
 
+wxVector<int> wxGrid::GetAutoSizeSampleLines(wxGridDirection direction) const
+{
+    // Notice that to auto-size a column we need to measure the cells in
+    // (some of) its rows and vice versa.
+    const bool column = direction == wxGRID_COLUMN;
+    const int count = column ? m_numRows : m_numCols;
+
+    // Collect the positions of the lines to measure first.
+    wxVector<int> positions;
+
+    const int head = wxMin(wxMax(m_autoSizeSample.m_head, 0), count);
+    for ( int pos = 0; pos < head; pos++ )
+        positions.push_back(pos);
+
+    const int tail = wxMax(head, count - wxMax(m_autoSizeSample.m_tail, 0));
+    for ( int pos = tail; pos < count; pos++ )
+        positions.push_back(pos);
+
+    // Choose a line in each of the intervals of (almost) the same size in
+    // between the head and the tail, using a simple pseudo-random generator
+    // with a fixed seed to make the results reproducible.
+    const int middle = tail - head;
+    const int random = wxMin(m_autoSizeSample.m_random, middle);
+    wxUint32 seed = 1;
+    for ( int n = 0; n < random; n++ )
+    {
+        const int start = head + static_cast<int>(wxInt64(middle)*n/random);
+        const int end = head + static_cast<int>(wxInt64(middle)*(n + 1)/random);
+
+        seed = seed*1103515245 + 12345;
+        positions.push_back(start + (seed >> 16) % (end - start));
+    }
+
+    if ( m_autoSizeSample.m_visible && count )
+    {
+        const int frozen = column ? m_numFrozenRows : m_numFrozenCols;
+        for ( int pos = 0; pos < frozen; pos++ )
+            positions.push_back(pos);
+
+        int x, y;
+        CalcGridWindowUnscrolledPosition(0, 0, &x, &y, m_gridWin);
+
+        int w, h;
+        m_gridWin->GetClientSize(&w, &h);
+
+        int first, last;
+        if ( column )
+        {
+            const wxGridRowOperations oper;
+            first = PosToLinePos(y, true, oper, m_gridWin);
+            last = PosToLinePos(y + h, true, oper, m_gridWin);
+        }
+        else
+        {
+            const wxGridColumnOperations oper;
+            first = PosToLinePos(x, true, oper, m_gridWin);
+            last = PosToLinePos(x + w, true, oper, m_gridWin);
+        }
+
+        if ( first != wxNOT_FOUND && last != wxNOT_FOUND )
+        {
+            for ( int pos = first; pos <= last; pos++ )
+                positions.push_back(pos);
+        }
+    }
+
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()),
+                    positions.end());
+
+    // And return the indices of the lines at these positions.
+    for ( size_t n = 0; n < positions.size(); n++ )
+    {
+        positions[n] = column ? GetRowAt(positions[n])
+                              : GetColAt(positions[n]);
+    }
+
+    return positions;
+}
+
 wxCoord wxGrid::CalcColOrRowLabelAreaMinSize(wxGridDirection direction)
 {
     // calculate size for the rows or columns?
@@ -11125,8 +12147,7 @@ wxSize wxGrid::DoGetBestSize() const
     }
     else
     {
-        for ( int col = 0; col < m_numCols; col++ )
-            size.x += GetColWidth(col);
+        size.x += m_colOffsets->GetStart(m_numCols);
     }
 
     if ( m_rowHeights.empty() )
@@ -11135,8 +12156,7 @@ wxSize wxGrid::DoGetBestSize() const
     }
     else
     {
-        for ( int row = 0; row < m_numRows; row++ )
-            size.y += GetRowHeight(row);
+        size.y += m_rowOffsets->GetStart(m_numRows);
     }
 
     return size + GetWindowBorderSize();
@@ -11167,7 +12187,24 @@ void wxGrid::SetCellValue( int row, int col, const wxString& s )
     if ( m_table )
     {
         m_table->SetValue( row, col, s );
-        if ( ShouldRefresh() )
+        if ( m_damage )
+        {
+            if ( ShouldRefresh() )
+            {
+                // As below, refresh the entire row if the cell can overflow.
+                if ( GetCellOverflow(row, col) )
+                    m_damage->AddRow(row);
+                else
+                    m_damage->AddCell(row, col);
+
+                if ( !m_deferredRefreshPending )
+                {
+                    m_deferredRefreshPending = true;
+                    CallAfter(&wxGrid::FlushDeferredRefresh);
+                }
+            }
+        }
+        else if ( ShouldRefresh() )
         {
             wxRect rect( CellToRect( row, col ) );
             CalcScrolledPosition(0, rect.y, nullptr, &rect.y);
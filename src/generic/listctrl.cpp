@@ -91,6 +91,70 @@ static const int HEADER_IMAGE_MARGIN_IN_REPORT_MODE = 2;
 // space after a checkbox
 static const int MARGIN_AROUND_CHECKBOX = 5;
 
+// ----------------------------------------------------------------------------
+// helpers for sorting the items by column
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// The key used for sorting the items by the contents of one of their columns,
+// computed once per item rather than once per comparison.
+class wxListSortKey
+{
+public:
+    wxListSortKey(const wxString& text, int flags)
+    {
+        m_number = 0;
+        m_isNumber = (flags & wxLIST_SORT_NUMERIC) && text.ToDouble(&m_number);
+        if ( !m_isNumber )
+            m_text = flags & wxLIST_SORT_NOCASE ? text.Lower() : text;
+    }
+
+    // Non-numeric values come before all numbers and are compared as text.
+    bool operator<(const wxListSortKey& other) const
+    {
+        if ( m_isNumber != other.m_isNumber )
+            return !m_isNumber;
+
+        return m_isNumber ? m_number < other.m_number : m_text < other.m_text;
+    }
+
+private:
+    wxString m_text;
+    double m_number;
+    bool m_isNumber;
+};
+
+// Comparator taking wxLIST_SORT_DESCENDING into account.
+class wxListSortKeyComparator
+{
+public:
+    explicit wxListSortKeyComparator(int flags)
+        : m_descending((flags & wxLIST_SORT_DESCENDING) != 0)
+    {
+    }
+
+    bool operator()(const wxListSortKey& key1, const wxListSortKey& key2) const
+    {
+        return m_descending ? key2 < key1 : key1 < key2;
+    }
+
+private:
+    const bool m_descending;
+};
+
+wxListSortKey GetLineSortKey(const wxListLineData& line, int col, int flags)
+{
+    // The line may not have a value for this column, see DeleteColumn().
+    if ( static_cast<size_t>(col) >= line.m_items.size() )
+        return wxListSortKey(wxString(), flags);
+
+    return wxListSortKey(line.m_items[col].GetText(), flags);
+}
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------
 // wxListItemData
 // ----------------------------------------------------------------------------
@@ -1556,6 +1620,9 @@ void wxListMainWindow::Init()
 
     m_hasCheckBoxes = false;
     m_extendRulesAndAlternateColour = false;
+
+    m_sortColumn = wxNOT_FOUND;
+    m_sortFlags = wxLIST_SORT_TEXT;
 }
 
 wxListMainWindow::wxListMainWindow()
@@ -3553,6 +3620,17 @@ void wxListMainWindow::SetItem( wxListItem &item )
                 widthInfo.bNeedsUpdate = true;
             }
         }
+
+        // move the item to its new place if its sort key changed
+        if ( item.m_col == m_sortColumn && (item.m_mask & wxLIST_MASK_TEXT) )
+        {
+            const size_t pos = MoveToSortedPosition((size_t)id);
+            if ( pos != (size_t)id )
+            {
+                RefreshLines(wxMin(pos, (size_t)id), wxMax(pos, (size_t)id));
+                return;
+            }
+        }
     }
 
     // update the item on screen unless we're going to update everything soon
@@ -4344,6 +4422,11 @@ void wxListMainWindow::DeleteColumn( int col )
     m_dirty = true;
     m_columns.erase( m_columns.begin() + col );
 
+    if ( col == m_sortColumn )
+        m_sortColumn = wxNOT_FOUND;
+    else if ( col < m_sortColumn )
+        m_sortColumn--;
+
     if ( !IsVirtual() )
     {
         // update all the items
@@ -4598,6 +4681,13 @@ void wxListMainWindow::InsertItem( wxListItem &item )
         }
     }
 
+    if ( m_sortColumn != wxNOT_FOUND )
+    {
+        // ignore the requested position to keep the items sorted
+        id = FindSortedPosition(line);
+        item.m_itemId = id;
+    }
+
     m_lines.insert( m_lines.begin() + id, std::move(line) );
 
     m_dirty = true;
@@ -4613,6 +4703,117 @@ void wxListMainWindow::InsertItem( wxListItem &item )
     RefreshLines(id, GetItemCount() - 1);
 }
 
+void wxListMainWindow::AppendItems( const wxVector<wxArrayString>& rows )
+{
+    wxCHECK_RET( !IsVirtual(), wxT("can't be used with virtual control") );
+
+    if ( rows.empty() )
+        return;
+
+    m_dirty = true;
+
+    if ( InReportView() )
+    {
+        ResetVisibleLinesRange();
+
+        // don't measure all the new items now, the maximal columns widths
+        // will be recomputed if and when they're needed
+        for ( auto& widthInfo : m_aColWidths )
+            widthInfo.bNeedsUpdate = true;
+    }
+
+    std::vector<wxListLineData> lines;
+    lines.reserve(rows.size());
+    for ( const auto& row : rows )
+    {
+        wxListLineData line(this);
+
+        const size_t count = wxMin(row.size(), line.m_items.size());
+        for ( size_t col = 0; col < count; col++ )
+            line.m_items[col].SetText(row[col]);
+
+        lines.push_back(std::move(line));
+    }
+
+    // the indices of the new items in ascending order
+    std::vector<size_t> positions;
+    positions.reserve(lines.size());
+
+    const size_t countOld = m_lines.size();
+    if ( m_sortColumn == wxNOT_FOUND )
+    {
+        m_lines.insert(m_lines.end(),
+                       std::make_move_iterator(lines.begin()),
+                       std::make_move_iterator(lines.end()));
+
+        for ( size_t n = countOld; n < m_lines.size(); n++ )
+            positions.push_back(n);
+    }
+    else
+    {
+        // sort the new lines among themselves and then merge them with the
+        // existing ones, which is much faster than inserting them one by one
+        const wxListSortKeyComparator compare(m_sortFlags);
+
+        std::vector<wxListSortKey> keysNew;
+        keysNew.reserve(lines.size());
+        for ( const auto& line : lines )
+            keysNew.push_back(GetLineSortKey(line, m_sortColumn, m_sortFlags));
+
+        std::vector<size_t> order(lines.size());
+        for ( size_t n = 0; n < order.size(); n++ )
+            order[n] = n;
+
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t n1, size_t n2)
+                         {
+                            return compare(keysNew[n1], keysNew[n2]);
+                         });
+
+        std::vector<wxListLineData> merged;
+        merged.reserve(countOld + lines.size());
+
+        size_t current = (size_t)-1;
+        size_t old = 0;
+        for ( const size_t n : order )
+        {
+            // new items are inserted after the existing items with the same
+            // key, as InsertItem() does
+            for ( ; old < countOld; old++ )
+            {
+                const wxListSortKey
+                    key = GetLineSortKey(m_lines[old], m_sortColumn, m_sortFlags);
+                if ( compare(keysNew[n], key) )
+                    break;
+
+                if ( old == m_current )
+                    current = merged.size();
+                merged.push_back(std::move(m_lines[old]));
+            }
+
+            positions.push_back(merged.size());
+            merged.push_back(std::move(lines[n]));
+        }
+
+        for ( ; old < countOld; old++ )
+        {
+            if ( old == m_current )
+                current = merged.size();
+            merged.push_back(std::move(m_lines[old]));
+        }
+
+        m_lines.swap(merged);
+
+        if ( HasCurrent() )
+            m_current = current;
+    }
+
+    // notice that we don't refresh anything here, all the items will be
+    // repainted once the control is laid out when it becomes idle
+    for ( const size_t n : positions )
+        SendNotify(n, wxEVT_LIST_INSERT_ITEM);
+}
+
 long wxListMainWindow::InsertColumn( long col, const wxListItem &item )
 {
     long idx = -1;
@@ -4627,6 +4828,9 @@ long wxListMainWindow::InsertColumn( long col, const wxListItem &item )
         wxColWidthInfo colWidthInfo(0, IsVirtual());
 
         bool insert = (col >= 0) && ((size_t)col < m_columns.size());
+        if ( insert && col <= m_sortColumn )
+            m_sortColumn++;
+
         if ( insert )
         {
             m_columns.insert( m_columns.begin() + col, column );
@@ -4710,6 +4914,9 @@ struct wxListLineComparator
 
 void wxListMainWindow::SortItems( wxListCtrlCompare fn, wxIntPtr data )
 {
+    // the items are not sorted by column any longer
+    m_sortColumn = wxNOT_FOUND;
+
     // selections won't make sense any more after sorting the items so reset
     // them
     HighlightAll(false);
@@ -4720,6 +4927,89 @@ void wxListMainWindow::SortItems( wxListCtrlCompare fn, wxIntPtr data )
     m_dirty = true;
 }
 
+void wxListMainWindow::SortItemsByColumn( int col, int flags )
+{
+    m_sortColumn = col;
+    m_sortFlags = flags;
+
+    if ( col == wxNOT_FOUND )
+        return;
+
+    HighlightAll(false);
+    ResetCurrent();
+
+    // compute the keys only once instead of doing it for each comparison and
+    // sort the indices of the lines to avoid moving them around repeatedly
+    const size_t count = m_lines.size();
+
+    std::vector<wxListSortKey> keys;
+    keys.reserve(count);
+    for ( const auto& line : m_lines )
+        keys.push_back(GetLineSortKey(line, col, flags));
+
+    std::vector<size_t> order(count);
+    for ( size_t n = 0; n < count; n++ )
+        order[n] = n;
+
+    const wxListSortKeyComparator compare(flags);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t n1, size_t n2)
+                     {
+                        return compare(keys[n1], keys[n2]);
+                     });
+
+    std::vector<wxListLineData> lines;
+    lines.reserve(count);
+    for ( const size_t n : order )
+        lines.push_back(std::move(m_lines[n]));
+
+    m_lines.swap(lines);
+
+    m_dirty = true;
+}
+
+size_t wxListMainWindow::MoveToSortedPosition(size_t n)
+{
+    wxListLineData line(std::move(m_lines[n]));
+    m_lines.erase(m_lines.begin() + n);
+
+    const size_t pos = FindSortedPosition(line);
+    m_lines.insert(m_lines.begin() + pos, std::move(line));
+
+    // the current item must remain the same even if its index changes
+    if ( HasCurrent() )
+    {
+        if ( m_current == n )
+            m_current = pos;
+        else if ( n < m_current && m_current <= pos )
+            m_current--;
+        else if ( pos <= m_current && m_current < n )
+            m_current++;
+    }
+
+    return pos;
+}
+
+size_t wxListMainWindow::FindSortedPosition(const wxListLineData& line) const
+{
+    const wxListSortKey key = GetLineSortKey(line, m_sortColumn, m_sortFlags);
+    const wxListSortKeyComparator compare(m_sortFlags);
+
+    // insert the new item after all the existing items with the same key
+    const auto it = std::upper_bound
+                    (
+                        m_lines.begin(), m_lines.end(), key,
+                        [&](const wxListSortKey& k, const wxListLineData& other)
+                        {
+                            return compare(k, GetLineSortKey(other,
+                                                             m_sortColumn,
+                                                             m_sortFlags));
+                        }
+                    );
+
+    return it - m_lines.begin();
+}
+
 // ----------------------------------------------------------------------------
 // scrolling
 // ----------------------------------------------------------------------------
@@ -5530,6 +5820,11 @@ long wxGenericListCtrl::InsertItem( wxListItem& info )
     return info.m_itemId;
 }
 
+void wxGenericListCtrl::AppendItems( const wxVector<wxArrayString>& rows )
+{
+    m_mainWin->AppendItems( rows );
+}
+
 long wxGenericListCtrl::InsertItem( long index, const wxString &label )
 {
     wxListItem info;
@@ -5595,6 +5890,20 @@ bool wxGenericListCtrl::SortItems( wxListCtrlCompare fn, wxIntPtr data )
     return true;
 }
 
+bool wxGenericListCtrl::SortItemsByColumn( int col, int flags )
+{
+    wxCHECK_MSG( !IsVirtual(), false, wxT("can't sort virtual control") );
+
+    // column 0 always exists, even if there are no columns outside of report
+    // mode
+    wxCHECK_MSG( col == wxNOT_FOUND ||
+                    (col >= 0 && (col == 0 || col < GetColumnCount())),
+                 false, wxT("invalid column index") );
+
+    m_mainWin->SortItemsByColumn( col, flags );
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // event handlers
 // ----------------------------------------------------------------------------
@@ -28,287 +28,430 @@
 // ============================================================================
 
 // ----------------------------------------------------------------------------
-// RowRanges
+// HeightCache
 // ----------------------------------------------------------------------------
 
-void RowRanges::Add(unsigned int row)
+HeightCache::HeightCache()
+    : m_nodes(1),
+      m_root(Nil),
+      m_seed(2463534242u)
 {
-    size_t count = m_ranges.size();
-    size_t rngIdx = 0;
-    for (rngIdx = 0; rngIdx < count; ++rngIdx)
-    {
-        RowRange &rng = m_ranges[rngIdx];
-
-        if (row >= rng.from && rng.to > row)
-        {
-            // index already in range
-            return;
-        }
+}
 
-        if (row == rng.from - 1)
-        {
-            // extend range at the beginning (to the left)
-            rng.from = row;
-            // no cleanup necessary
-            return;
-        }
-        if (row == rng.to)
-        {
-            // extend range at the end (set to row+1 because 'to' is not
-            // including)
-            rng.to = row + 1;
-            CleanUp(rngIdx);
-            return;
-        }
+HeightCache::~HeightCache()
+{
+}
 
-        if (rng.from > row + 1)
-        {
-            // this range is already behind row index, so break here and insert
-            // a new range before
-            break;
-        }
+unsigned int HeightCache::NewNode(int height, unsigned int count)
+{
+    // Use xorshift for the priorities: we don't need good randomness here,
+    // just something looking random enough to keep the tree balanced.
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Node node;
+    node.height = height;
+    node.count = count;
+    node.priority = m_seed;
+    node.left =
+    node.right = Nil;
+
+    unsigned int t;
+    if ( m_free.empty() )
+    {
+        t = static_cast<unsigned int>(m_nodes.size());
+        m_nodes.push_back(node);
+    }
+    else
+    {
+        t = m_free.back();
+        m_free.pop_back();
+        m_nodes[t] = node;
     }
 
-    RowRange newRange;
-    newRange.from = row;
-    newRange.to = row + 1;
-    m_ranges.insert(m_ranges.begin() + rngIdx, newRange);
+    Update(t);
+
+    return t;
 }
 
-void RowRanges::Remove(unsigned int row)
+void HeightCache::FreeTree(unsigned int t)
 {
-    size_t count = m_ranges.size();
-    size_t rngIdx = 0;
-    while (rngIdx < count)
-    {
-        RowRange &rng = m_ranges[rngIdx];
-        if (rng.from >= row)
-        {
-            // this range starts behind row index, so remove it
-            m_ranges.erase(m_ranges.begin() + rngIdx);
-            count--;
-            continue;
-        }
-        if (rng.to > row)
-        {
-            // this ranges includes row, so cut off at row index to exclude row
-            rng.to = row;
-        }
+    if ( t == Nil )
+        return;
 
-        rngIdx += 1;
-    }
+    FreeTree(m_nodes[t].left);
+    FreeTree(m_nodes[t].right);
+
+    m_free.push_back(t);
 }
 
+void HeightCache::Update(unsigned int t)
+{
+    Node& node = m_nodes[t];
+    const Node& left = m_nodes[node.left];
+    const Node& right = m_nodes[node.right];
+
+    node.rows = left.rows + node.count + right.rows;
+    node.unknown = left.unknown + (node.height ? 0 : node.count) + right.unknown;
+    node.sum = left.sum + node.height*static_cast<int>(node.count) + right.sum;
+}
 
-void RowRanges::CleanUp(unsigned int idx)
+void
+HeightCache::Split(unsigned int t, unsigned int k, unsigned int& l, unsigned int& r)
 {
-    size_t count = m_ranges.size();
+    if ( t == Nil )
+    {
+        l =
+        r = Nil;
+        return;
+    }
 
-    wxCHECK_RET( idx < count, "Wrong index" );
+    // Note that we can't keep references to the nodes here as m_nodes may be
+    // reallocated when splitting a run below.
+    const unsigned int leftRows = m_nodes[m_nodes[t].left].rows;
+    const unsigned int count = m_nodes[t].count;
 
-    size_t rngIdx = 0;
-    if (idx > 0)
+    if ( k <= leftRows )
     {
-        // start one RowRange before
-        rngIdx = idx - 1;
+        unsigned int leftPart, rightPart;
+        Split(m_nodes[t].left, k, leftPart, rightPart);
+
+        m_nodes[t].left = rightPart;
+        Update(t);
+
+        l = leftPart;
+        r = t;
     }
+    else if ( k >= leftRows + count )
+    {
+        unsigned int leftPart, rightPart;
+        Split(m_nodes[t].right, k - leftRows - count, leftPart, rightPart);
 
-    RowRange *prevRng = &m_ranges[rngIdx];
-    rngIdx++;
-    while (rngIdx <= idx + 1 && rngIdx < count)
+        m_nodes[t].right = leftPart;
+        Update(t);
+
+        l = t;
+        r = rightPart;
+    }
+    else // The split position is inside this run.
     {
-        RowRange &rng = m_ranges[rngIdx];
+        const unsigned int tail = leftRows + count - k;
+        const unsigned int tailNode = NewNode(m_nodes[t].height, tail);
 
-        if (prevRng->to == rng.from)
-        {
-            // this range starts where the previous range began, so remove this
-            // and set the to-value of the previous range to the to-value of
-            // this range
-            prevRng->to = rng.to;
-            m_ranges.erase(m_ranges.begin() + rngIdx);
-            count--;
-            continue;
-        }
+        const unsigned int right = m_nodes[t].right;
+        m_nodes[t].count -= tail;
+        m_nodes[t].right = Nil;
+        Update(t);
 
-        prevRng = &rng;
-        rngIdx += 1;
+        l = t;
+        r = Merge(tailNode, right);
     }
 }
 
-bool RowRanges::Has(unsigned int row) const
+unsigned int HeightCache::Merge(unsigned int l, unsigned int r)
 {
-    size_t count = m_ranges.size();
-    for (size_t rngIdx = 0; rngIdx < count; rngIdx++)
+    if ( l == Nil )
+        return r;
+    if ( r == Nil )
+        return l;
+
+    if ( m_nodes[l].priority > m_nodes[r].priority )
     {
-        const RowRange &rng = m_ranges[rngIdx];
-        if (rng.from <= row && row < rng.to)
-        {
-            return true;
-        }
+        const unsigned int right = Merge(m_nodes[l].right, r);
+        m_nodes[l].right = right;
+        Update(l);
+        return l;
     }
-    return false;
+    else
+    {
+        const unsigned int left = Merge(l, m_nodes[r].left);
+        m_nodes[r].left = left;
+        Update(r);
+        return r;
+    }
+}
+
+void HeightCache::GrowLast(unsigned int t, unsigned int count)
+{
+    if ( m_nodes[t].right != Nil )
+        GrowLast(m_nodes[t].right, count);
+    else
+        m_nodes[t].count += count;
+
+    Update(t);
 }
 
-unsigned int RowRanges::CountAll() const
+unsigned int HeightCache::Join(unsigned int l, unsigned int r)
 {
-    unsigned int ctr = 0;
-    size_t count = m_ranges.size();
-    for (size_t rngIdx = 0; rngIdx < count; rngIdx++)
+    if ( l == Nil )
+        return r;
+    if ( r == Nil )
+        return l;
+
+    unsigned int last = l;
+    while ( m_nodes[last].right != Nil )
+        last = m_nodes[last].right;
+
+    unsigned int first = r;
+    while ( m_nodes[first].left != Nil )
+        first = m_nodes[first].left;
+
+    if ( m_nodes[last].height != m_nodes[first].height )
+        return Merge(l, r);
+
+    // Both runs have the same height, so fold the first run of the right
+    // tree into the last run of the left one to keep the number of runs, and
+    // hence the depth of the tree, minimal.
+    const unsigned int count = m_nodes[first].count;
+
+    unsigned int head, rest;
+    Split(r, count, head, rest);
+    FreeTree(head);
+
+    GrowLast(l, count);
+
+    return Merge(l, rest);
+}
+
+void HeightCache::DoSet(unsigned int row, int height)
+{
+    if ( row >= GetRowCount() )
     {
-        const RowRange &rng = m_ranges[rngIdx];
-        ctr += rng.to - rng.from;
+        // Rows after the end are unknown anyway.
+        if ( !height )
+            return;
+
+        // Extend the cache with unknown rows up to and including this one.
+        m_root = Join(m_root, NewNode(0, row + 1 - GetRowCount()));
     }
-    return ctr;
+
+    unsigned int before, rest;
+    Split(m_root, row, before, rest);
+
+    unsigned int node, after;
+    Split(rest, 1, node, after);
+
+    m_nodes[node].height = height;
+    Update(node);
+
+    m_root = Join(Join(before, node), after);
 }
 
-unsigned int RowRanges::CountTo(unsigned int row) const
+bool HeightCache::GetLineStart(unsigned int row, int &start) const
 {
-    unsigned int ctr = 0;
-    size_t count = m_ranges.size();
-    for (size_t rngIdx = 0; rngIdx < count; rngIdx++)
+    if ( row > GetRowCount() )
+        return false;
+
+    int y = 0;
+    unsigned int k = row;
+    unsigned int t = m_root;
+    while ( t != Nil )
     {
-        const RowRange &rng = m_ranges[rngIdx];
-        if (rng.from > row)
-        {
-            break;
-        }
-        else if (rng.to < row)
+        const Node& node = m_nodes[t];
+        const Node& left = m_nodes[node.left];
+
+        if ( k < left.rows )
         {
-            ctr += rng.to - rng.from;
+            t = node.left;
+            continue;
         }
-        else
+
+        // All rows of the left subtree are before the given one.
+        if ( left.unknown )
+            return false;
+
+        y += left.sum;
+        k -= left.rows;
+
+        if ( k < node.count )
         {
-            ctr += row - rng.from;
+            // Only the first k rows of this run are before the given one.
+            if ( k && !node.height )
+                return false;
+
+            y += node.height*static_cast<int>(k);
             break;
         }
+
+        if ( !node.height )
+            return false;
+
+        y += node.height*static_cast<int>(node.count);
+        k -= node.count;
+        t = node.right;
     }
-    return ctr;
-}
 
-// ----------------------------------------------------------------------------
-// HeightCache
-// ----------------------------------------------------------------------------
+    start = y;
+    return true;
+}
 
-bool HeightCache::GetLineInfo(unsigned int row, int &start, int &height)
+bool HeightCache::GetLineHeight(unsigned int row, int &height) const
 {
-    int y = 0;
-    bool found = false;
+    if ( row >= GetRowCount() )
+        return false;
 
-    for ( const auto& kv : m_heightToRowRange )
+    unsigned int k = row;
+    unsigned int t = m_root;
+    for ( ;; )
     {
-        int rowHeight = kv.first;
-        const RowRanges& rowRanges = kv.second;
-        if (rowRanges.Has(row))
+        const Node& node = m_nodes[t];
+        const unsigned int leftRows = m_nodes[node.left].rows;
+
+        if ( k < leftRows )
         {
-            height = rowHeight;
-            found = true;
+            t = node.left;
+        }
+        else if ( k < leftRows + node.count )
+        {
+            if ( !node.height )
+                return false;
+
+            height = node.height;
+            return true;
+        }
+        else
+        {
+            k -= leftRows + node.count;
+            t = node.right;
         }
-        y += rowHeight * (rowRanges.CountTo(row));
-    }
-    if (found)
-    {
-        start = y;
     }
-    return found;
 }
 
-bool HeightCache::GetLineStart(unsigned int row, int &start)
+bool HeightCache::GetLineInfo(unsigned int row, int &start, int &height) const
 {
-    int height = 0;
-    return GetLineInfo(row, start, height);
+    int h;
+    if ( !GetLineHeight(row, h) || !GetLineStart(row, start) )
+        return false;
+
+    height = h;
+    return true;
 }
 
-bool HeightCache::GetLineHeight(unsigned int row, int &height)
+bool HeightCache::GetLineAt(int y, unsigned int &row) const
 {
-    for ( const auto& kv : m_heightToRowRange )
+    if ( y < 0 )
+        return false;
+
+    unsigned int rowsBefore = 0;
+    unsigned int t = m_root;
+    while ( t != Nil )
     {
-        int rowHeight = kv.first;
-        const RowRanges& rowRanges = kv.second;
-        if (rowRanges.Has(row))
+        const Node& node = m_nodes[t];
+        const Node& left = m_nodes[node.left];
+
+        if ( y < left.sum )
+        {
+            t = node.left;
+            continue;
+        }
+
+        // The row we're looking for is after all the rows of the left subtree,
+        // but we can't find it if we don't know the heights of all of them.
+        if ( left.unknown || !node.height )
+            return false;
+
+        y -= left.sum;
+        rowsBefore += left.rows;
+
+        const int runHeight = node.height*static_cast<int>(node.count);
+        if ( y < runHeight )
         {
-            height = rowHeight;
+            row = rowsBefore + y / node.height;
             return true;
         }
+
+        y -= runHeight;
+        rowsBefore += node.count;
+        t = node.right;
     }
+
+    // Given y point is after the last row.
     return false;
 }
 
-bool HeightCache::GetLineAt(int y, unsigned int &row)
+unsigned int HeightCache::GetFirstUnknown() const
 {
-    unsigned int total = 0;
+    if ( !m_nodes[m_root].unknown )
+        return GetRowCount();
 
-    for ( const auto& kv : m_heightToRowRange )
+    unsigned int rowsBefore = 0;
+    unsigned int t = m_root;
+    for ( ;; )
     {
-        const RowRanges& rowRanges = kv.second;
-        total += rowRanges.CountAll();
-    }
-
-    if (total == 0)
-    {
-        return false;
-    }
+        const Node& node = m_nodes[t];
+        const Node& left = m_nodes[node.left];
 
-    int lo = 0;
-    int hi = total;
-    int start, height;
-    while (lo < hi)
-    {
-        int mid = (lo + hi) / 2;
-        if (GetLineInfo(mid, start, height))
+        if ( left.unknown )
         {
-            if (start + height <= y)
-            {
-                lo = mid + 1;
-            }
-            else
-            {
-                hi = mid;
-            }
-        }
-        else
-        {
-            // should never happen, except the HeightCache has gaps which is an
-            // invalid state
-            return false;
-        }
-    }
-    if (GetLineInfo(lo, start, height))
-    {
-        if (y < start)
-        {
-            // given y point is before the first row
-            return false;
+            t = node.left;
+            continue;
         }
-        row = lo;
-        return true;
-    }
-    else
-    {
-        // given y point is after the last row
-        return false;
+
+        rowsBefore += left.rows;
+        if ( !node.height )
+            return rowsBefore;
+
+        rowsBefore += node.count;
+        t = node.right;
     }
 }
 
 void HeightCache::Put(unsigned int row, int height)
 {
-    m_heightToRowRange[height].Add(row);
+    wxCHECK_RET( height > 0, "invalid row height" );
+
+    DoSet(row, height);
+}
+
+void HeightCache::Invalidate(unsigned int row)
+{
+    DoSet(row, 0);
 }
 
 void HeightCache::Remove(unsigned int row)
 {
-    for ( auto& kv : m_heightToRowRange )
-    {
-        RowRanges& rowRanges = kv.second;
-        rowRanges.Remove(row);
-    }
+    if ( row >= GetRowCount() )
+        return;
+
+    unsigned int before, after;
+    Split(m_root, row, before, after);
+    FreeTree(after);
+
+    m_root = before;
 }
 
-void HeightCache::Clear()
+void HeightCache::InsertRows(unsigned int row, unsigned int count)
 {
-    m_heightToRowRange.clear();
+    // Nothing to do if the rows are inserted after the last known one, as all
+    // rows there are unknown anyhow.
+    if ( !count || row >= GetRowCount() )
+        return;
+
+    unsigned int before, after;
+    Split(m_root, row, before, after);
+
+    m_root = Join(Join(before, NewNode(0, count)), after);
 }
 
-HeightCache::~HeightCache()
+void HeightCache::DeleteRows(unsigned int row, unsigned int count)
+{
+    if ( !count || row >= GetRowCount() )
+        return;
+
+    unsigned int before, rest;
+    Split(m_root, row, before, rest);
+
+    unsigned int deleted, after;
+    Split(rest, count, deleted, after);
+    FreeTree(deleted);
+
+    m_root = Join(before, after);
+}
+
+void HeightCache::Clear()
 {
-    Clear();
+    m_nodes.resize(1);
+    m_free.clear();
+    m_root = Nil;
 }
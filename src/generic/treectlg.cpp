@@ -199,6 +199,32 @@ public:
     void SetX(int x) { m_x = x; }
     void SetY(int y) { m_y = y; }
 
+    // layout data computed and cached by wxGenericTreeCtrl: the offset of
+    // this item from the top of its parent children, the total height of
+    // this item and all its visible descendants (or -1 if unknown) and the
+    // number of the first children whose offsets are known
+    int GetOffset() const { return m_offset; }
+    void SetOffset(int offset) { m_offset = offset; }
+
+    int GetSubtreeHeight() const { return m_subtreeHeight; }
+    void SetSubtreeHeight(int height) { m_subtreeHeight = height; }
+
+    size_t GetValidOffsets() const { return m_validOffsets; }
+    void SetValidOffsets(size_t count)
+        { m_validOffsets = static_cast<unsigned int>(count); }
+
+    // forget the layout data if it was computed for another generation of
+    // the layout, see wxGenericTreeCtrl::InvalidateLayout()
+    void SyncLayout(unsigned int generation)
+    {
+        if ( m_layoutGen != generation )
+        {
+            m_layoutGen = generation;
+            m_subtreeHeight = -1;
+            m_validOffsets = 0;
+        }
+    }
+
     int GetHeight() const { return m_height; }
     int GetWidth() const { return m_width; }
 
@@ -254,8 +280,6 @@ public:
         { DoCalculateSize(control, dc); }
     void CalculateSize(wxGenericTreeCtrl *control);
 
-    void GetSize( int &x, int &y, const wxGenericTreeCtrl* );
-
     void ResetSize() { m_width = 0; }
     void ResetTextSize() { m_width = 0; m_widthText = -1; }
     void RecursiveResetSize();
@@ -343,6 +367,11 @@ private:
     int                 m_width;        // width of this item
     int                 m_height;       // height of this item
 
+    int                 m_offset;         // see GetOffset() &c above
+    int                 m_subtreeHeight;
+    unsigned int        m_validOffsets;
+    unsigned int        m_layoutGen;
+
     // use bitfields to save size
     unsigned int        m_isCollapsed :1;
     unsigned int        m_hasHilight  :1; // same as focused
@@ -635,6 +664,11 @@ wxGenericTreeItem::wxGenericTreeItem(wxGenericTreeItem *parent,
     m_state = wxTREE_ITEMSTATE_NONE;
     m_x = m_y = 0;
 
+    m_offset = 0;
+    m_subtreeHeight = -1;
+    m_validOffsets = 0;
+    m_layoutGen = 0;
+
     m_isCollapsed = true;
     m_hasHilight = false;
     m_hasPlus = false;
@@ -696,31 +730,15 @@ size_t wxGenericTreeItem::GetChildrenCount(bool recursively) const
     return total;
 }
 
-void wxGenericTreeItem::GetSize( int &x, int &y,
-                                 const wxGenericTreeCtrl *theButton )
-{
-    int bottomY=m_y+theButton->GetLineHeight(this);
-    if ( y < bottomY )
-        y = bottomY;
-    int width = m_x +  m_width;
-    if ( x < width )
-        x = width;
-
-    if (IsExpanded())
-    {
-        size_t count = m_children.size();
-        for ( size_t n = 0; n < count; ++n )
-        {
-            m_children[n]->GetSize( x, y, theButton );
-        }
-    }
-}
-
 wxGenericTreeItem *wxGenericTreeItem::HitTest(const wxPoint& point,
                                               const wxGenericTreeCtrl *theCtrl,
                                               int &flags,
                                               int level)
 {
+    // the positions of the other items are set by their parents below
+    if ( level == 0 )
+        theCtrl->CalculateItemPosition(this);
+
     // for a hidden root node, don't evaluate it, but do evaluate children
     if ( !(level == 0 && theCtrl->HasFlag(wxTR_HIDE_ROOT)) )
     {
@@ -807,19 +825,18 @@ wxGenericTreeItem *wxGenericTreeItem::HitTest(const wxPoint& point,
             return nullptr;
     }
 
-    // evaluate children
-    size_t count = m_children.size();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        wxGenericTreeItem *res = m_children[n]->HitTest( point,
-                                                         theCtrl,
-                                                         flags,
-                                                         level + 1 );
-        if ( res != nullptr )
-            return res;
-    }
+    // evaluate the only child which can contain this point
+    if ( m_children.empty() )
+        return nullptr;
 
-    return nullptr;
+    const int y = m_y + theCtrl->GetItemOwnHeight(this);
+    const size_t n = theCtrl->FindChildAt(this, point.y - y);
+
+    wxGenericTreeItem * const child = m_children[n];
+    theCtrl->SetItemPosition(child, level + 1,
+                             y + theCtrl->GetChildOffset(this, n));
+
+    return child->HitTest(point, theCtrl, flags, level + 1);
 }
 
 int wxGenericTreeItem::GetCurrentImage() const
@@ -988,6 +1005,12 @@ void wxGenericTreeCtrl::Init()
     m_dndEffectItem = nullptr;
 
     m_lastOnSame = false;
+
+    m_layoutGen = 1;
+    m_layoutLineHeight = m_lineHeight;
+    m_layoutWidth = 0;
+    m_layoutWidthChanged = false;
+    m_layoutWidthStale = false;
 }
 
 bool wxGenericTreeCtrl::Create(wxWindow *parent,
@@ -1092,6 +1115,7 @@ unsigned int wxGenericTreeCtrl::GetCount() const
 void wxGenericTreeCtrl::SetIndent(unsigned int indent)
 {
     m_indent = indent;
+    InvalidateLayout();
     m_dirty = true;
 }
 
@@ -1119,6 +1143,7 @@ void wxGenericTreeCtrl::SetWindowStyleFlag(long styles)
     // want to update the inherited styles, but right now
     // none of the parents has updatable styles
     m_windowStyle = styles;
+    InvalidateLayout();
     m_dirty = true;
 }
 
@@ -1188,7 +1213,7 @@ wxGenericTreeCtrl::SetItemText(const wxTreeItemId& item, const wxString& text)
 
     wxGenericTreeItem *pItem = GetItemPtr(item);
     pItem->SetText(text);
-    pItem->CalculateSize(this);
+    RecalculateItemSize(pItem);
     RefreshLine(pItem);
 }
 
@@ -1200,7 +1225,7 @@ void wxGenericTreeCtrl::SetItemImage(const wxTreeItemId& item,
 
     wxGenericTreeItem *pItem = GetItemPtr(item);
     pItem->SetImage(image, which);
-    pItem->CalculateSize(this);
+    RecalculateItemSize(pItem);
     RefreshLine(pItem);
 }
 
@@ -1221,7 +1246,7 @@ void wxGenericTreeCtrl::DoSetItemState(const wxTreeItemId& item, int state)
 
     wxGenericTreeItem *pItem = GetItemPtr(item);
     pItem->SetState(state);
-    pItem->CalculateSize(this);
+    RecalculateItemSize(pItem);
     RefreshLine(pItem);
 }
 
@@ -1246,7 +1271,7 @@ void wxGenericTreeCtrl::SetItemBold(const wxTreeItemId& item, bool bold)
 
         // recalculate the item size as bold and non bold fonts have different
         // widths
-        pItem->CalculateSize(this);
+        RecalculateItemSize(pItem);
         RefreshLine(pItem);
     }
 }
@@ -1298,7 +1323,7 @@ wxGenericTreeCtrl::SetItemFont(const wxTreeItemId& item, const wxFont& font)
     wxGenericTreeItem *pItem = GetItemPtr(item);
     pItem->Attr().SetFont(font);
     pItem->ResetTextSize();
-    pItem->CalculateSize(this);
+    RecalculateItemSize(pItem);
     RefreshLine(pItem);
 }
 
@@ -1316,6 +1341,8 @@ bool wxGenericTreeCtrl::SetFont( const wxFont &font )
     if (m_anchor)
         m_anchor->RecursiveResetTextSize();
 
+    InvalidateLayout();
+
     return true;
 }
 
@@ -1671,8 +1698,10 @@ wxTreeItemId wxGenericTreeCtrl::DoInsertItem(const wxTreeItemId& parentId,
         data->m_pItem = item;
     }
 
-    parent->Insert( item, previous == (size_t)-1 ? parent->GetChildren().size()
-                                                 : previous );
+    const size_t index = previous == (size_t)-1 ? parent->GetChildren().size()
+                                                : previous;
+    parent->Insert( item, index );
+    InvalidateItemLayout( parent, index );
 
     InvalidateBestSize();
     return item;
@@ -1689,6 +1718,7 @@ wxTreeItemId wxGenericTreeCtrl::AddRoot(const wxString& text,
 
     m_anchor = new wxGenericTreeItem(nullptr, text,
                                    image, selImage, data);
+    InvalidateLayout();
     if ( data != nullptr )
     {
         data->m_pItem = m_anchor;
@@ -1782,6 +1812,8 @@ void wxGenericTreeCtrl::DeleteChildren(const wxTreeItemId& itemId)
     wxGenericTreeItem *item = GetItemPtr(itemId);
     ChildrenClosing(item);
     item->DeleteChildren(this);
+    InvalidateItemLayout(item, 0);
+    InvalidateLayoutWidth();
     InvalidateBestSize();
 }
 
@@ -1847,6 +1879,7 @@ void wxGenericTreeCtrl::Delete(const wxTreeItemId& itemId)
         if ( index != wxNOT_FOUND )
         {
             siblings.erase(siblings.begin() + index);
+            InvalidateItemLayout(parent, index);
         }
     }
     else // deleting the root
@@ -1864,6 +1897,7 @@ void wxGenericTreeCtrl::Delete(const wxTreeItemId& itemId)
 
     delete item;
 
+    InvalidateLayoutWidth();
     InvalidateBestSize();
 }
 
@@ -1898,6 +1932,7 @@ void wxGenericTreeCtrl::Expand(const wxTreeItemId& itemId)
     }
 
     item->Expand();
+    InvalidateItemLayout(item);
     if ( !IsFrozen() )
     {
         CalculatePositions();
@@ -1940,6 +1975,8 @@ void wxGenericTreeCtrl::Collapse(const wxTreeItemId& itemId)
 
     ChildrenClosing(item);
     item->Collapse();
+    InvalidateItemLayout(item);
+    InvalidateLayoutWidth();
 
 #if 0  // TODO why should items be collapsed recursively?
     wxGenericTreeItems& children = item->GetChildren();
@@ -2130,6 +2167,8 @@ wxGenericTreeCtrl::SelectItemRange(wxGenericTreeItem *item1,
 
     // item2 is not necessary after item1
     // choice first' and 'last' between item1 and item2
+    CalculateItemPosition(item1);
+    CalculateItemPosition(item2);
     wxGenericTreeItem *first= (item1->GetY()<item2->GetY()) ? item1 : item2;
     wxGenericTreeItem *last = (item1->GetY()<item2->GetY()) ? item2 : item1;
 
@@ -2333,6 +2372,7 @@ void wxGenericTreeCtrl::ScrollTo(const wxTreeItemId &item)
     }
 
     wxGenericTreeItem *gitem = GetItemPtr(item);
+    CalculateItemPosition(gitem);
 
     int itemY = gitem->GetY();
 
@@ -2380,6 +2420,8 @@ void wxGenericTreeCtrl::SortChildren(const wxTreeItemId& itemId)
                   {
                       return OnCompareItems(a, b) < 0;
                   });
+
+        InvalidateItemLayout(item, 0);
     }
     //else: don't make the tree dirty as nothing changed
 }
@@ -2451,6 +2493,8 @@ void wxGenericTreeCtrl::UpdateAfterImageListChange()
     // Don't do this if we're in the process of deleting the tree control.
     if (HasImages())
         CalculateLineHeight();
+
+    InvalidateLayout();
 }
 
 void wxGenericTreeCtrl::SetImageList(wxImageList *imageList)
@@ -2493,10 +2537,24 @@ void wxGenericTreeCtrl::AssignButtonsImageList(wxImageList *imageList)
 
 void wxGenericTreeCtrl::AdjustMyScrollbars()
 {
+    m_layoutWidthChanged = false;
+
     if (m_anchor)
     {
-        int x = 0, y = 0;
-        m_anchor->GetSize( x, y, this );
+        CheckLayoutLineHeight();
+
+        if ( m_layoutWidthStale )
+        {
+            m_layoutWidthStale = false;
+            m_layoutWidth = GetMeasuredSubtreeWidth(m_anchor, 0);
+        }
+
+        // the height of all the items is known, but the width is only known
+        // for the items which had been already laid out (notice that using
+        // the same DC is much faster if the items need to be measured)
+        wxInfoDC dc(this);
+        int x = m_layoutWidth,
+            y = 2 + GetSubtreeHeight(m_anchor, &dc);
         y += PIXELS_PER_UNIT+2; // one more scrollbar unit + 2 pixels
         x += PIXELS_PER_UNIT+2; // one more scrollbar unit + 2 pixels
         int x_pos = GetScrollPos( wxHORIZONTAL );
@@ -2507,6 +2565,9 @@ void wxGenericTreeCtrl::AdjustMyScrollbars()
     }
     else
     {
+        m_layoutWidthStale = false;
+        m_layoutWidth = 0;
+
         SetScrollbars( 0, 0, 0, 0 );
     }
 }
@@ -2514,11 +2575,292 @@ void wxGenericTreeCtrl::AdjustMyScrollbars()
 int wxGenericTreeCtrl::GetLineHeight(wxGenericTreeItem *item) const
 {
     if (GetWindowStyleFlag() & wxTR_HAS_VARIABLE_ROW_HEIGHT)
+    {
+        // the items are only measured when they're needed
+        item->CalculateSize(wxConstCast(this, wxGenericTreeCtrl));
         return item->GetHeight();
+    }
     else
         return m_lineHeight;
 }
 
+void wxGenericTreeCtrl::InvalidateLayout()
+{
+    // the data computed for the previous generations is ignored, so this
+    // invalidates the layout of all items at once (0 is never used as it's
+    // the generation of the items which had never been laid out)
+    if ( !++m_layoutGen )
+        m_layoutGen = 1;
+
+    m_layoutLineHeight = m_lineHeight;
+    m_layoutWidth = 0;
+}
+
+void wxGenericTreeCtrl::InvalidateItemLayout(wxGenericTreeItem *item,
+                                             size_t firstChild)
+{
+    item->SyncLayout(m_layoutGen);
+    if ( firstChild < item->GetValidOffsets() )
+        item->SetValidOffsets(firstChild);
+
+    // the heights of the item and all its ancestors and the offsets of their
+    // next siblings change too, but if the height of an item is already
+    // unknown, it must be also the case for all its ancestors
+    while ( item->GetSubtreeHeight() != -1 )
+    {
+        item->SetSubtreeHeight(-1);
+
+        wxGenericTreeItem * const parent = item->GetParent();
+        if ( !parent )
+            break;
+
+        parent->SyncLayout(m_layoutGen);
+
+        const int index = FindLaidOutChild(parent, item);
+        if ( index != wxNOT_FOUND )
+            parent->SetValidOffsets(index + 1);
+
+        item = parent;
+    }
+}
+
+void wxGenericTreeCtrl::InvalidateLayoutWidth()
+{
+    // the width can only grow while laying out the items, so it must be
+    // recomputed when the widest item could have been removed: do it only
+    // once, when adjusting the scrollbars, even if many items are removed
+    m_layoutWidthStale = true;
+    m_layoutWidthChanged = true;
+}
+
+int wxGenericTreeCtrl::GetMeasuredSubtreeWidth(wxGenericTreeItem *item,
+                                               int level) const
+{
+    // hidden root doesn't take any space but its children are always shown
+    const bool hiddenRoot = item == m_anchor && HasFlag(wxTR_HIDE_ROOT);
+
+    // the items which hadn't been measured yet have zero width and will
+    // update the layout width when they are laid out
+    int width = 0;
+    if ( !hiddenRoot && item->GetWidth() )
+        width = GetLevelX(level) + item->GetWidth();
+
+    if ( item->IsExpanded() || hiddenRoot )
+    {
+        const wxGenericTreeItems& children = item->GetChildren();
+        for ( size_t n = 0; n < children.size(); n++ )
+        {
+            width = wxMax(width,
+                          GetMeasuredSubtreeWidth(children[n], level + 1));
+        }
+    }
+
+    return width;
+}
+
+int wxGenericTreeCtrl::GetLevelX(int level) const
+{
+    int x = level*FromDIP(m_indent);
+    if (!HasFlag(wxTR_HIDE_ROOT))
+        x += FromDIP(m_indent);
+
+    return x + FromDIP(m_spacing);
+}
+
+void wxGenericTreeCtrl::CheckLayoutLineHeight() const
+{
+    if ( !HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) &&
+            m_lineHeight != m_layoutLineHeight )
+    {
+        wxConstCast(this, wxGenericTreeCtrl)->InvalidateLayout();
+    }
+}
+
+int wxGenericTreeCtrl::GetItemOwnHeight(wxGenericTreeItem *item,
+                                        wxReadOnlyDC *dc) const
+{
+    // hidden root doesn't take any space
+    if ( item == m_anchor && HasFlag(wxTR_HIDE_ROOT) )
+        return 0;
+
+    if ( dc && HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) )
+        item->CalculateSize(wxConstCast(this, wxGenericTreeCtrl), *dc);
+
+    return GetLineHeight(item);
+}
+
+int wxGenericTreeCtrl::GetSubtreeHeight(wxGenericTreeItem *item,
+                                        wxReadOnlyDC *dc) const
+{
+    item->SyncLayout(m_layoutGen);
+
+    int height = item->GetSubtreeHeight();
+    if ( height == -1 )
+    {
+        height = GetItemOwnHeight(item, dc);
+
+        // note that the children of the hidden root are always shown
+        const bool hiddenRoot = item == m_anchor && HasFlag(wxTR_HIDE_ROOT);
+        const wxGenericTreeItems& children = item->GetChildren();
+        if ( !children.empty() && (item->IsExpanded() || hiddenRoot) )
+        {
+            const size_t last = children.size() - 1;
+            height += GetChildOffset(item, last, dc) +
+                        GetSubtreeHeight(children[last], dc);
+        }
+
+        item->SetSubtreeHeight(height);
+    }
+
+    return height;
+}
+
+int wxGenericTreeCtrl::GetChildOffset(wxGenericTreeItem *parent,
+                                      size_t index,
+                                      wxReadOnlyDC *dc) const
+{
+    parent->SyncLayout(m_layoutGen);
+
+    const wxGenericTreeItems& children = parent->GetChildren();
+
+    size_t valid = parent->GetValidOffsets();
+    if ( valid <= index )
+    {
+        if ( !valid )
+        {
+            children[0]->SetOffset(0);
+            valid = 1;
+        }
+
+        for ( ; valid <= index; valid++ )
+        {
+            wxGenericTreeItem * const prev = children[valid - 1];
+            children[valid]->SetOffset(prev->GetOffset() +
+                                        GetSubtreeHeight(prev, dc));
+        }
+
+        parent->SetValidOffsets(valid);
+    }
+
+    return children[index]->GetOffset();
+}
+
+size_t wxGenericTreeCtrl::FindChildAt(wxGenericTreeItem *parent,
+                                      int offset,
+                                      wxReadOnlyDC *dc) const
+{
+    const wxGenericTreeItems& children = parent->GetChildren();
+    const size_t count = children.size();
+
+    // compute the offsets until we find a child starting after this offset
+    GetChildOffset(parent, 0, dc);
+    size_t valid = parent->GetValidOffsets();
+    while ( valid < count && children[valid - 1]->GetOffset() <= offset )
+    {
+        GetChildOffset(parent, valid, dc);
+        valid++;
+    }
+
+    const wxGenericTreeItems::const_iterator it =
+        std::upper_bound(children.begin(), children.begin() + valid, offset,
+                         [](int off, const wxGenericTreeItem* child)
+                         {
+                             return off < child->GetOffset();
+                         });
+
+    return it == children.begin() ? 0 : it - children.begin() - 1;
+}
+
+int wxGenericTreeCtrl::FindLaidOutChild(wxGenericTreeItem *parent,
+                                        wxGenericTreeItem *child) const
+{
+    // the offsets of the laid out children are strictly increasing, so we
+    // can use binary search, but the offset of the child being looked for
+    // may be out of date, so check that we really found it
+    const wxGenericTreeItems& children = parent->GetChildren();
+    const wxGenericTreeItems::const_iterator end =
+        children.begin() + parent->GetValidOffsets();
+
+    const wxGenericTreeItems::const_iterator it =
+        std::lower_bound(children.begin(), end, child->GetOffset(),
+                         [](const wxGenericTreeItem* item, int off)
+                         {
+                             return item->GetOffset() < off;
+                         });
+
+    return it != end && *it == child ? it - children.begin() : wxNOT_FOUND;
+}
+
+void wxGenericTreeCtrl::CalculateItemPosition(wxGenericTreeItem *item) const
+{
+    // measure the item first as this can change the line height
+    item->CalculateSize(wxConstCast(this, wxGenericTreeCtrl));
+    CheckLayoutLineHeight();
+
+    int level = 0;
+    int y = 2;
+    for ( wxGenericTreeItem *child = item, *parent = item->GetParent();
+          parent;
+          child = parent, parent = parent->GetParent() )
+    {
+        parent->SyncLayout(m_layoutGen);
+
+        int index = FindLaidOutChild(parent, child);
+        if ( index == wxNOT_FOUND )
+            index = FindItemIndex(parent->GetChildren(), child);
+
+        y += GetItemOwnHeight(parent) + GetChildOffset(parent, index);
+        level++;
+    }
+
+    SetItemPosition(item, level, y);
+}
+
+void wxGenericTreeCtrl::SetItemPosition(wxGenericTreeItem *item,
+                                        int level,
+                                        int y,
+                                        wxReadOnlyDC *dc) const
+{
+    wxGenericTreeCtrl * const self = wxConstCast(this, wxGenericTreeCtrl);
+    if ( dc )
+        item->CalculateSize(self, *dc);
+    else
+        item->CalculateSize(self);
+
+    item->SetX(GetLevelX(level));
+    item->SetY(y);
+
+    const int right = item->GetX() + item->GetWidth();
+    if ( right > m_layoutWidth )
+    {
+        m_layoutWidth = right;
+        m_layoutWidthChanged = true;
+    }
+}
+
+void wxGenericTreeCtrl::RecalculateItemSize(wxGenericTreeItem *item)
+{
+    const int lineHeight = m_lineHeight;
+    const int height = item->GetHeight();
+
+    item->CalculateSize(this);
+
+    // the positions of all the items below this one change if its height
+    // does, so relayout and redraw them too
+    if ( HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) )
+    {
+        if ( item->GetHeight() != height )
+        {
+            InvalidateItemLayout(item);
+            m_dirty = true;
+        }
+    }
+    else if ( m_lineHeight != lineHeight )
+    {
+        m_dirty = true;
+    }
+}
+
 void wxGenericTreeCtrl::PaintItem(wxGenericTreeItem *item, wxDC& dc)
 {
     item->SetFont(this, dc);
@@ -2732,7 +3074,9 @@ void
 wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
                               wxDC &dc,
                               int level,
-                              int &y)
+                              int y,
+                              int yStart,
+                              int yEnd)
 {
     int indent = FromDIP(m_indent);
     int spacing = FromDIP(m_spacing);
@@ -2745,31 +3089,32 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
     else if (level == 0)
     {
         // always expand hidden root
-        int origY = y;
         wxGenericTreeItems& children = item->GetChildren();
-        int count = children.size();
+        const size_t count = children.size();
         if (count > 0)
         {
-            int n = 0, oldY;
-            do {
-                oldY = y;
-                PaintLevel(children[n], dc, 1, y);
-            } while (++n < count);
-
-            if ( !HasFlag(wxTR_NO_LINES) && HasFlag(wxTR_LINES_AT_ROOT)
-                    && count > 0 )
+            for ( size_t n = FindChildAt(item, yStart - y, &dc); n < count; ++n )
+            {
+                const int yChild = y + GetChildOffset(item, n, &dc);
+                if ( yChild >= yEnd )
+                    break;
+
+                PaintLevel(children[n], dc, 1, yChild, yStart, yEnd);
+            }
+
+            if ( !HasFlag(wxTR_NO_LINES) && HasFlag(wxTR_LINES_AT_ROOT) )
             {
                 // draw line down to last child
-                origY += GetLineHeight(children[0])>>1;
-                oldY += GetLineHeight(children[n-1])>>1;
+                int origY = y + (GetLineHeight(children[0])>>1);
+                int oldY = y + GetChildOffset(item, count - 1) +
+                            (GetLineHeight(children[count - 1])>>1);
                 dc.DrawLine(3, origY, 3, oldY);
             }
         }
         return;
     }
 
-    item->SetX(x+spacing);
-    item->SetY(y);
+    SetItemPosition(item, level, y, &dc);
 
     int h = GetLineHeight(item);
     int y_top = y;
@@ -2779,7 +3124,8 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
     int exposed_x = dc.LogicalToDeviceX(0);
     int exposed_y = dc.LogicalToDeviceY(y_top);
 
-    if (IsExposed(exposed_x, exposed_y, 10000, h))  // 10000 = very much
+    if (y_top < yEnd && y > yStart &&
+            IsExposed(exposed_x, exposed_y, 10000, h))  // 10000 = very much
     {
         const wxPen *pen =
 #ifndef __WXMAC__
@@ -2889,20 +3235,25 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
     if (item->IsExpanded())
     {
         wxGenericTreeItems& children = item->GetChildren();
-        int count = children.size();
+        const size_t count = children.size();
         if (count > 0)
         {
-            int n = 0, oldY;
+            // only paint the children which can be visible
             ++level;
-            do {
-                oldY = y;
-                PaintLevel(children[n], dc, level, y);
-            } while (++n < count);
+            for ( size_t n = FindChildAt(item, yStart - y, &dc); n < count; ++n )
+            {
+                const int yChild = y + GetChildOffset(item, n, &dc);
+                if ( yChild >= yEnd )
+                    break;
 
-            if (!HasFlag(wxTR_NO_LINES) && count > 0)
+                PaintLevel(children[n], dc, level, yChild, yStart, yEnd);
+            }
+
+            if (!HasFlag(wxTR_NO_LINES))
             {
                 // draw line down to last child
-                oldY += GetLineHeight(children[n-1])>>1;
+                int oldY = y + GetChildOffset(item, count - 1) +
+                            (GetLineHeight(children[count - 1])>>1);
                 if (HasButtons())
                     y_mid += 5;
 
@@ -2970,6 +3321,8 @@ void wxGenericTreeCtrl::DrawBorder(const wxTreeItemId &item)
         m_dndEffectItem = nullptr;
     }
 
+    CalculateItemPosition(i);
+
     wxRect rect( i->GetX()-1, i->GetY()-1, i->GetWidth()+2, GetLineHeight(i)+2 );
     CalcScrolledPosition( rect.x, rect.y, &rect.x, &rect.y );
     RefreshRect( rect );
@@ -2995,6 +3348,8 @@ void wxGenericTreeCtrl::DrawLine(const wxTreeItemId &item, bool below)
         m_dndEffectItem = nullptr;
     }
 
+    CalculateItemPosition(i);
+
     wxRect rect( i->GetX()-1, i->GetY()-1, i->GetWidth()+2, GetLineHeight(i)+2 );
     CalcScrolledPosition( rect.x, rect.y, &rect.x, &rect.y );
     RefreshRect( rect );
@@ -3021,9 +3376,23 @@ void wxGenericTreeCtrl::OnPaint( wxPaintEvent &WXUNUSED(event) )
         return;
 
     dc.SetPen( m_dottedPen );
+    dc.SetFont( m_font );
 
-    int y = 2;
-    PaintLevel( m_anchor, dc, 0, y );
+    CheckLayoutLineHeight();
+    const int lineHeight = m_lineHeight;
+
+    // only the items intersecting the updated area need to be painted
+    const wxRect rect = GetUpdateRegion().GetBox();
+    int yStart, yEnd;
+    CalcUnscrolledPosition(0, rect.GetTop(), nullptr, &yStart);
+    CalcUnscrolledPosition(0, rect.GetBottom() + 1, nullptr, &yEnd);
+
+    PaintLevel( m_anchor, dc, 0, 2, yStart, yEnd );
+
+    // if painting changed the line height, the items positions must be
+    // recomputed
+    if ( !HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) && m_lineHeight != lineHeight )
+        m_dirty = true;
 }
 
 void wxGenericTreeCtrl::OnSetFocus( wxFocusEvent &event )
@@ -3456,6 +3825,7 @@ bool wxGenericTreeCtrl::GetBoundingRect(const wxTreeItemId& item,
                  "invalid item in wxGenericTreeCtrl::GetBoundingRect" );
 
     wxGenericTreeItem *i = GetItemPtr(item);
+    CalculateItemPosition(i);
 
     if ( textOnly )
     {
@@ -3971,48 +4341,46 @@ void wxGenericTreeCtrl::OnInternalIdle()
     // actually redraw the tree when everything is over
     if (m_dirty)
         DoDirtyProcessing();
+    else if (m_layoutWidthChanged && !IsFrozen())
+        AdjustMyScrollbars();
 }
 
 void
 wxGenericTreeCtrl::CalculateLevel(wxGenericTreeItem *item,
                                   wxReadOnlyDC &dc,
                                   int level,
-                                  int &y )
+                                  int y,
+                                  int yStart,
+                                  int yEnd)
 {
-    int indent = FromDIP(m_indent);
-    int spacing = FromDIP(m_spacing);
-
-    int x = level*indent;
-    if (!HasFlag(wxTR_HIDE_ROOT))
-    {
-        x += indent;
-    }
-    else if (level == 0)
+    if (!HasFlag(wxTR_HIDE_ROOT) || level != 0)
     {
         // a hidden root is not evaluated, but its
         // children are always calculated
-        goto Recurse;
-    }
-
-    item->CalculateSize(this, dc);
+        SetItemPosition(item, level, y, &dc);
 
-    // set its position
-    item->SetX( x+spacing );
-    item->SetY( y );
-    y += GetLineHeight(item);
-
-    if ( !item->IsExpanded() )
-    {
-        // we don't need to calculate collapsed branches
-        return;
+        if ( !item->IsExpanded() )
+        {
+            // we don't need to calculate collapsed branches
+            return;
+        }
     }
 
-  Recurse:
     wxGenericTreeItems& children = item->GetChildren();
-    size_t n, count = children.size();
+    const size_t count = children.size();
+    if ( !count )
+        return;
+
+    y += GetItemOwnHeight(item, &dc);
     ++level;
-    for (n = 0; n < count; ++n )
-        CalculateLevel( children[n], dc, level, y );  // recurse
+    for ( size_t n = FindChildAt(item, yStart - y, &dc); n < count; ++n )
+    {
+        const int yChild = y + GetChildOffset(item, n, &dc);
+        if ( yChild >= yEnd )
+            break;
+
+        CalculateLevel( children[n], dc, level, yChild, yStart, yEnd );
+    }
 }
 
 void wxGenericTreeCtrl::CalculatePositions()
@@ -4020,11 +4388,17 @@ void wxGenericTreeCtrl::CalculatePositions()
     if ( !m_anchor )
         return;
 
+    CheckLayoutLineHeight();
+
     wxInfoDC dc(this);
     PrepareDC( dc );
 
-    int y = 2;
-    CalculateLevel( m_anchor, dc, 0, y ); // start recursion
+    // only lay out the items in the visible part of the window, the positions
+    // of all the other ones are computed when they're needed
+    int yStart;
+    CalcUnscrolledPosition(0, 0, nullptr, &yStart);
+
+    CalculateLevel( m_anchor, dc, 0, 2, yStart, yStart + GetClientSize().y );
 }
 
 void wxGenericTreeCtrl::Refresh(bool eraseBackground, const wxRect *rect)
@@ -4040,6 +4414,8 @@ void wxGenericTreeCtrl::RefreshSubtree(wxGenericTreeItem *item)
 
     wxSize client = GetClientSize();
 
+    CalculateItemPosition(item);
+
     wxRect rect;
     CalcScrolledPosition(0, item->GetY(), nullptr, &rect.y);
     rect.width = client.x;
@@ -4055,6 +4431,8 @@ void wxGenericTreeCtrl::RefreshLine( wxGenericTreeItem *item )
     if (m_dirty || IsFrozen() )
         return;
 
+    CalculateItemPosition(item);
+
     wxRect rect;
     CalcScrolledPosition(0, item->GetY(), nullptr, &rect.y);
     rect.width = GetClientSize().x;
@@ -4132,7 +4510,8 @@ void wxGenericTreeCtrl::OnGetToolTip( wxTreeEvent &event )
 {
 #if wxUSE_TOOLTIPS
     wxTreeItemId itemId = event.GetItem();
-    const wxGenericTreeItem* const pItem = GetItemPtr(itemId);
+    wxGenericTreeItem* const pItem = GetItemPtr(itemId);
+    CalculateItemPosition(pItem);
 
     // Check if the item fits into the client area:
     if ( pItem->GetX() + pItem->GetWidth() > GetClientSize().x )
@@ -180,9 +180,11 @@ bool wxConsoleEventLoop::Dispatch()
 int wxConsoleEventLoop::DispatchTimeout(unsigned long timeout)
 {
 #if wxUSE_TIMER
-    // check if we need to decrease the timeout to account for a timer
+    // check if we need to decrease the timeout to account for a timer, this
+    // is unnecessary if the scheduler wakes us up on its own
+    wxTimerScheduler& scheduler = wxTimerScheduler::Get();
     wxUsecClock_t nextTimer;
-    if ( wxTimerScheduler::Get().GetNext(&nextTimer) )
+    if ( !scheduler.UsesTimerFD() && scheduler.GetNext(&nextTimer) )
     {
         unsigned long timeUntilNextTimer = wxMilliClockToLong(nextTimer / 1000);
         if ( timeUntilNextTimer < timeout )
@@ -193,7 +195,7 @@ int wxConsoleEventLoop::DispatchTimeout(unsigned long timeout)
     bool hadEvent = m_dispatcher->Dispatch(timeout) > 0;
 
 #if wxUSE_TIMER
-    if ( wxTimerScheduler::Get().NotifyExpired() )
+    if ( scheduler.NotifyExpired() )
         hadEvent = true;
 #endif // wxUSE_TIMER
 
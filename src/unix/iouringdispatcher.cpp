@@ -0,0 +1,613 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        src/unix/iouringdispatcher.cpp
+// Purpose:     implements dispatcher for io_uring() call
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#include "wx/unix/private/iouringdispatcher.h"
+
+#ifdef wxHAS_IO_URING_DISPATCHER
+
+#include "wx/stopwatch.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/log.h"
+    #include "wx/intl.h"
+    #include "wx/utils.h"
+#endif
+
+#include <sys/mman.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <memory>
+
+#define wxIoUringDispatcher_Trace wxT("iouringdispatcher")
+
+// ============================================================================
+// implementation
+// ============================================================================
+
+namespace
+{
+
+// the number of entries in the submission queue, the completion queue is
+// twice bigger and the kernel doesn't drop the completions even if it's full
+const unsigned QUEUE_SIZE = 256;
+
+// the user data of the requests whose completions we're not interested in
+const wxUint64 USER_DATA_IGNORE = static_cast<wxUint64>(-1);
+
+// the user data of the poll requests combines the descriptor and generation
+inline wxUint64 MakeUserData(int fd, wxUint32 generation)
+{
+    return (static_cast<wxUint64>(generation) << 32) | static_cast<wxUint32>(fd);
+}
+
+inline int GetFDFromUserData(wxUint64 userData)
+{
+    return static_cast<int>(userData & 0xffffffff);
+}
+
+inline wxUint32 GetGenerationFromUserData(wxUint64 userData)
+{
+    return static_cast<wxUint32>(userData >> 32);
+}
+
+// the ring head and tail are shared with the kernel and must be accessed
+// atomically
+inline unsigned LoadAcquire(const unsigned *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline void StoreRelease(unsigned *p, unsigned value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+// there are no wrappers for io_uring system calls in libc
+inline int IoUringSetup(unsigned entries, io_uring_params *params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+inline int IoUringEnter(int fd,
+                        unsigned toSubmit,
+                        unsigned minComplete,
+                        unsigned flags,
+                        const void *arg,
+                        size_t argSize)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit,
+                                    minComplete, flags, arg, argSize));
+}
+
+// return POLLxxx mask corresponding to the given flags in the format expected
+// in io_uring_sqe::poll32_events
+wxUint32 GetPollMask(int flags, int fd)
+{
+    wxUnusedVar(fd); // unused if wxLogTrace() disabled
+
+    wxUint32 mask = 0;
+
+    if ( flags & wxFDIO_INPUT )
+        mask |= POLLIN;
+
+    if ( flags & wxFDIO_OUTPUT )
+        mask |= POLLOUT;
+
+    if ( flags & wxFDIO_EXCEPTION )
+        mask |= POLLERR | POLLHUP;
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("Polling fd %d for events %#x"), fd, mask);
+
+#ifdef WORDS_BIGENDIAN
+    // the kernel expects the 16-bit halves of this field to be swapped
+    mask = (mask << 16) | (mask >> 16);
+#endif
+
+    return mask;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxIoUringDispatcher
+// ----------------------------------------------------------------------------
+
+/* static */
+wxIoUringDispatcher *wxIoUringDispatcher::Create()
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    const int ringDescriptor = IoUringSetup(QUEUE_SIZE, &params);
+    if ( ringDescriptor == -1 )
+    {
+        // this is not an error, io_uring may be not supported or disabled and
+        // epoll will be used instead then
+        wxLogTrace(wxIoUringDispatcher_Trace,
+                   wxT("io_uring not available: %s"), wxSysErrorMsgStr());
+        return nullptr;
+    }
+
+    std::unique_ptr<wxIoUringDispatcher>
+        dispatcher(new wxIoUringDispatcher(ringDescriptor));
+    if ( !dispatcher->MapRings(params) )
+        return nullptr;
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("io_uring fd %d created"), ringDescriptor);
+
+    return dispatcher.release();
+}
+
+wxIoUringDispatcher::wxIoUringDispatcher(int ringDescriptor)
+{
+    wxASSERT_MSG( ringDescriptor != -1, wxT("invalid descriptor") );
+
+    m_ringDescriptor = ringDescriptor;
+}
+
+wxIoUringDispatcher::~wxIoUringDispatcher()
+{
+    if ( m_sqes )
+        munmap(m_sqes, m_sqesSize);
+
+    if ( m_ring )
+        munmap(m_ring, m_ringSize);
+
+    if ( close(m_ringDescriptor) != 0 )
+    {
+        wxLogSysError(_("Error closing io_uring descriptor"));
+    }
+}
+
+bool wxIoUringDispatcher::MapRings(const io_uring_params& params)
+{
+    // all these features are available since Linux 5.11, which is also the
+    // first version supporting IORING_ENTER_EXT_ARG, so we just require them
+    // instead of dealing with their absence
+    const unsigned
+        required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ( (params.features & required) != required )
+    {
+        wxLogTrace(wxIoUringDispatcher_Trace,
+                   wxT("io_uring features %#x not supported"),
+                   required & ~params.features);
+        return false;
+    }
+
+    // with IORING_FEAT_SINGLE_MMAP both rings are mapped together
+    m_ringSize = wxMax(params.sq_off.array + params.sq_entries*sizeof(unsigned),
+                       params.cq_off.cqes + params.cq_entries*sizeof(io_uring_cqe));
+    void * const ring = mmap(nullptr, m_ringSize, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             m_ringDescriptor, IORING_OFF_SQ_RING);
+    if ( ring == MAP_FAILED )
+    {
+        wxLogSysError(_("Failed to map io_uring queues"));
+        return false;
+    }
+
+    m_ring = ring;
+
+    m_sqesSize = params.sq_entries*sizeof(io_uring_sqe);
+    void * const sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             m_ringDescriptor, IORING_OFF_SQES);
+    if ( sqes == MAP_FAILED )
+    {
+        wxLogSysError(_("Failed to map io_uring queues"));
+        return false;
+    }
+
+    m_sqes = static_cast<io_uring_sqe *>(sqes);
+
+    char * const p = static_cast<char *>(ring);
+    m_sqHead = reinterpret_cast<unsigned *>(p + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned *>(p + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned *>(p + params.sq_off.ring_mask);
+    m_sqEntries = params.sq_entries;
+    m_cqHead = reinterpret_cast<unsigned *>(p + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned *>(p + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned *>(p + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe *>(p + params.cq_off.cqes);
+
+    // we always use the submission queue entries in order, so the indirection
+    // array can be initialized once and for all
+    unsigned * const sqArray = reinterpret_cast<unsigned *>(p + params.sq_off.array);
+    for ( unsigned n = 0; n < m_sqEntries; n++ )
+        sqArray[n] = n;
+
+    return true;
+}
+
+bool wxIoUringDispatcher::QueueRequest(const io_uring_sqe& sqe)
+{
+    // only we modify the tail, so there is no need to load it atomically
+    const unsigned tail = *m_sqTail;
+    if ( tail - LoadAcquire(m_sqHead) == m_sqEntries )
+    {
+        // the queue is full, submit the requests in it to make room
+        if ( Enter(0) == -1 || tail - LoadAcquire(m_sqHead) == m_sqEntries )
+        {
+            wxLogSysError(_("Failed to submit io_uring requests"));
+            return false;
+        }
+    }
+
+    m_sqes[tail & m_sqMask] = sqe;
+    StoreRelease(m_sqTail, tail + 1);
+
+    // if we're called from another thread while Dispatch() is blocked, it
+    // won't submit this request until it wakes up, so do it ourselves
+    if ( m_waiting )
+        Enter(0);
+
+    return true;
+}
+
+bool wxIoUringDispatcher::QueuePoll(int fd, FDInfo& info)
+{
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = GetPollMask(info.flags, fd);
+    sqe.user_data = MakeUserData(fd, info.generation);
+
+    if ( !QueueRequest(sqe) )
+        return false;
+
+    info.armed = true;
+
+    return true;
+}
+
+bool wxIoUringDispatcher::QueuePollRemove(int fd, const FDInfo& info)
+{
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_POLL_REMOVE;
+    sqe.fd = -1;
+    sqe.addr = MakeUserData(fd, info.generation);
+    sqe.user_data = USER_DATA_IGNORE;
+
+    return QueueRequest(sqe);
+}
+
+int wxIoUringDispatcher::Enter(unsigned minComplete,
+                               unsigned flags,
+                               const io_uring_getevents_arg *arg) const
+{
+    // the tail may be modified by another thread if we're called from
+    // WaitForCompletions(), but the kernel never submits more requests than
+    // there are in the queue, so it doesn't matter if we use an outdated value
+    return IoUringEnter(m_ringDescriptor,
+                        LoadAcquire(m_sqTail) - LoadAcquire(m_sqHead),
+                        minComplete,
+                        flags,
+                        arg,
+                        arg ? sizeof(*arg) : 0);
+}
+
+void wxIoUringDispatcher::Submit() const
+{
+    if ( *m_sqTail != LoadAcquire(m_sqHead) )
+        Enter(0);
+}
+
+bool wxIoUringDispatcher::HasCompletions() const
+{
+    return LoadAcquire(m_cqTail) != *m_cqHead;
+}
+
+bool wxIoUringDispatcher::RegisterFD(int fd, wxFDIOHandler* handler, int flags)
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    const std::pair<FDInfoMap::iterator, bool> res = m_fds.emplace(fd, FDInfo());
+    wxCHECK_MSG( res.second, false, wxT("descriptor already registered") );
+
+    FDInfo& info = res.first->second;
+    info.handler = handler;
+    info.flags = flags;
+    info.generation = ++m_generation;
+
+    if ( !QueuePoll(fd, info) )
+    {
+        m_fds.erase(res.first);
+        return false;
+    }
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("Added fd %d (handler %p) to io_uring %d"),
+               fd, handler, m_ringDescriptor);
+
+    return true;
+}
+
+bool wxIoUringDispatcher::ModifyFD(int fd, wxFDIOHandler* handler, int flags)
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    const FDInfoMap::iterator it = m_fds.find(fd);
+    wxCHECK_MSG( it != m_fds.end(), false, wxT("modifying unregistered descriptor") );
+
+    FDInfo& info = it->second;
+    if ( info.armed )
+    {
+        if ( info.handler == handler && info.flags == flags )
+            return true;
+
+        if ( !QueuePollRemove(fd, info) )
+            return false;
+
+        info.armed = false;
+    }
+
+    info.handler = handler;
+    info.flags = flags;
+    info.generation = ++m_generation;
+
+    if ( !QueuePoll(fd, info) )
+        return false;
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("Modified fd %d (handler: %p) on io_uring %d"),
+               fd, handler, m_ringDescriptor);
+
+    return true;
+}
+
+bool wxIoUringDispatcher::UnregisterFD(int fd)
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    const FDInfoMap::iterator it = m_fds.find(fd);
+    if ( it == m_fds.end() )
+    {
+        wxLogTrace(wxIoUringDispatcher_Trace,
+                   wxT("fd %d not registered with io_uring %d"),
+                   fd, m_ringDescriptor);
+        return false;
+    }
+
+    if ( it->second.armed && QueuePollRemove(fd, it->second) )
+    {
+        // the poll request keeps a reference to the file, so cancel it
+        // immediately as the caller is likely to close the descriptor and
+        // expects this to really close it (if Dispatch() is blocked, this
+        // was already done by QueuePollRemove() itself)
+        Submit();
+    }
+
+    m_fds.erase(it);
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("removed fd %d from %d"), fd, m_ringDescriptor);
+
+    return true;
+}
+
+bool wxIoUringDispatcher::DoWait(int timeout)
+{
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        // don't wait at all if there are already some completions available,
+        // but still submit the queued requests, as the poll requests for the
+        // ready descriptors complete immediately
+        if ( timeout == 0 || HasCompletions() )
+        {
+            Submit();
+            return true;
+        }
+
+        m_waiting = true;
+    }
+
+    // don't block the other threads registering the descriptors while waiting
+    const bool ok = WaitForCompletions(timeout);
+
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    m_waiting = false;
+
+    return ok;
+}
+
+bool wxIoUringDispatcher::WaitForCompletions(int timeout) const
+{
+    wxMilliClock_t timeEnd;
+    if ( timeout > 0 )
+        timeEnd = wxGetLocalTimeMillis() + timeout;
+
+    for ( ;; )
+    {
+        __kernel_timespec ts;
+        io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+        if ( timeout != TIMEOUT_INFINITE )
+        {
+            ts.tv_sec = timeout / 1000;
+            ts.tv_nsec = (timeout % 1000)*1000000;
+            arg.ts = reinterpret_cast<wxUIntPtr>(&ts);
+        }
+
+        if ( Enter(1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg) != -1 )
+            return true;
+
+        switch ( errno )
+        {
+            case ETIME:
+                // the timeout expired, this is not an error
+                return true;
+
+            case EBUSY:
+                // the completion queue overflowed, we need to empty it first
+                return true;
+
+            case EINTR:
+                break;
+
+            default:
+                return false;
+        }
+
+        // we got interrupted, update the timeout and restart
+        if ( timeout > 0 )
+        {
+            timeout = wxMilliClockToLong(timeEnd - wxGetLocalTimeMillis());
+            if ( timeout <= 0 )
+                return true;
+        }
+    }
+}
+
+bool wxIoUringDispatcher::HasPending() const
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    Submit();
+
+    // notice that this can return true for the completions of the already
+    // cancelled requests, but this is harmless as Dispatch() just ignores them
+    return HasCompletions();
+}
+
+int wxIoUringDispatcher::Dispatch(int timeout)
+{
+    if ( !DoWait(timeout) )
+    {
+        wxLogSysError(_("Waiting for IO on io_uring descriptor %d failed"),
+                      m_ringDescriptor);
+        return -1;
+    }
+
+    // copy all the completions before calling any handlers as they can queue
+    // new requests or even call us recursively
+    wxVector<Completion> completions;
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        completions.swap(m_completions);
+
+        unsigned head = *m_cqHead;
+        const unsigned tail = LoadAcquire(m_cqTail);
+        for ( ; head != tail; head++ )
+        {
+            const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+
+            Completion completion;
+            completion.userData = cqe.user_data;
+            completion.result = cqe.res;
+            completions.push_back(completion);
+        }
+
+        StoreRelease(m_cqHead, head);
+    }
+
+    int numEvents = 0;
+    for ( size_t n = 0; n < completions.size(); n++ )
+    {
+        const Completion& completion = completions[n];
+        if ( completion.userData == USER_DATA_IGNORE )
+            continue;
+
+        const int fd = GetFDFromUserData(completion.userData);
+        const wxUint32 generation = GetGenerationFromUserData(completion.userData);
+
+        // the handlers are called without locking to allow them to block
+        // waiting for the other threads which may use this dispatcher too
+        wxFDIOHandler *handler;
+        {
+            wxCRIT_SECT_LOCKER(lock, m_cs);
+
+            // ignore the completions of the requests for the descriptors
+            // which were unregistered or modified since then
+            const FDInfoMap::iterator it = m_fds.find(fd);
+            if ( it == m_fds.end() || it->second.generation != generation )
+                continue;
+
+            it->second.armed = false;
+
+            // the request is only cancelled when we remove it ourselves
+            if ( completion.result == -ECANCELED )
+                continue;
+
+            handler = it->second.handler;
+        }
+
+        bool handled = true;
+        if ( completion.result < 0 )
+        {
+            wxLogSysError(-completion.result,
+                          _("Waiting for IO on descriptor %d failed"), fd);
+
+            // let the handler know about the problem, it will typically
+            // unregister the descriptor, otherwise we retry waiting for it
+            // below, as epoll would keep reporting it too
+            handler->OnExceptionWaiting();
+        }
+        else
+        {
+            const int events = completion.result;
+
+            // see the comment in wxEpollDispatcher::Dispatch() about POLLHUP
+            if ( events & (POLLIN | POLLHUP) )
+                handler->OnReadWaiting();
+            else if ( events & POLLOUT )
+                handler->OnWriteWaiting();
+            else if ( events & POLLERR )
+                handler->OnExceptionWaiting();
+            else
+                handled = false;
+        }
+
+        if ( handled )
+            numEvents++;
+
+        // poll requests are one-shot, so make a new one unless the handler
+        // has unregistered or modified the descriptor: if it is still ready,
+        // the new request completes immediately, which gives us the same
+        // level-triggered behaviour as with the other dispatchers
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        const FDInfoMap::iterator it = m_fds.find(fd);
+        if ( it != m_fds.end() &&
+                it->second.generation == generation &&
+                    !it->second.armed )
+        {
+            QueuePoll(fd, it->second);
+        }
+    }
+
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    completions.clear();
+    m_completions.swap(completions);
+
+    return numEvents;
+}
+
+#endif // wxHAS_IO_URING_DISPATCHER
@@ -37,6 +37,14 @@
 
 #include "wx/unix/private/timer.h"
 
+#if wxUSE_EPOLL_DISPATCHER
+    #include "wx/private/fdiodispatcher.h"
+
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+    #include <errno.h>
+#endif // wxUSE_EPOLL_DISPATCHER
+
 // trace mask for the debugging messages used here
 #define wxTrace_Timer wxT("timer")
 
@@ -44,27 +52,147 @@
 // wxTimerScheduler implementation
 // ============================================================================
 
+#if wxUSE_EPOLL_DISPATCHER
+
+// ----------------------------------------------------------------------------
+// wxTimerFDHandler: wakes up the event loop when the first timer expires
+// ----------------------------------------------------------------------------
+
+// The timers themselves are notified by the event loop calling NotifyExpired()
+// after dispatching the IO events, so all this handler needs to do is to make
+// the dispatcher return when the timer descriptor expires and reset it.
+class wxTimerFDHandler : public wxFDIOHandler
+{
+public:
+    wxTimerFDHandler()
+        : m_dispatcher(wxFDIODispatcher::Get())
+    {
+        m_fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+        if ( m_fd == -1 )
+        {
+            wxLogTrace(wxTrace_Timer, wxT("Failed to create timer fd: %s"),
+                       wxSysErrorMsgStr());
+            return;
+        }
+
+        if ( !m_dispatcher || !m_dispatcher->RegisterFD(m_fd, this, wxFDIO_INPUT) )
+        {
+            close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    virtual ~wxTimerFDHandler()
+    {
+        if ( m_fd != -1 )
+        {
+            m_dispatcher->UnregisterFD(m_fd);
+            close(m_fd);
+        }
+    }
+
+    virtual bool IsOk() const override { return m_fd != -1; }
+
+    // arm the descriptor to expire at the given absolute time or disarm it if
+    // the time is 0, return false if this failed
+    bool SetExpiration(wxUsecClock_t expiration)
+    {
+        if ( expiration == m_expiration )
+            return true;
+
+        itimerspec spec = {};
+        if ( expiration != 0 )
+        {
+            spec.it_value.tv_sec = static_cast<time_t>(
+                (expiration / 1000000).GetValue());
+            spec.it_value.tv_nsec = static_cast<long>(
+                (expiration % 1000000).GetValue()*1000);
+        }
+
+        if ( timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &spec, nullptr) == -1 )
+        {
+            wxLogTrace(wxTrace_Timer, wxT("Failed to set timer fd: %s"),
+                       wxSysErrorMsgStr());
+            return false;
+        }
+
+        m_expiration = expiration;
+
+        return true;
+    }
+
+    virtual void OnReadWaiting() override
+    {
+        // we don't need the number of expirations, just reset the descriptor
+        // state, and EAGAIN is harmless here
+        wxUint64 expirations;
+        if ( read(m_fd, &expirations, sizeof(expirations)) == -1 &&
+                errno != EAGAIN )
+        {
+            wxLogTrace(wxTrace_Timer, wxT("Failed to read timer fd: %s"),
+                       wxSysErrorMsgStr());
+        }
+
+        // the descriptor is not armed any more, so make sure it's re-armed by
+        // the next call to SetExpiration() even if it's for the same time,
+        // which could happen if the clock was set back since it expired
+        m_expiration = 0;
+    }
+
+    virtual void OnWriteWaiting() override { }
+    virtual void OnExceptionWaiting() override { }
+
+private:
+    wxFDIODispatcher * const m_dispatcher;
+
+    int m_fd;
+
+    // the time the descriptor is currently armed for or 0 if it isn't
+    wxUsecClock_t m_expiration = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxTimerFDHandler);
+};
+
+#endif // wxUSE_EPOLL_DISPATCHER
+
+// ============================================================================
+// wxTimerScheduler implementation
+// ============================================================================
+
 wxTimerScheduler *wxTimerScheduler::ms_instance = nullptr;
 
+wxTimerScheduler::wxTimerScheduler()
+{
+#if wxUSE_EPOLL_DISPATCHER
+    m_timerFD = new wxTimerFDHandler;
+    if ( !m_timerFD->IsOk() )
+        wxDELETE(m_timerFD);
+#endif // wxUSE_EPOLL_DISPATCHER
+}
+
+wxTimerScheduler::~wxTimerScheduler()
+{
+#if wxUSE_EPOLL_DISPATCHER
+    delete m_timerFD;
+#endif // wxUSE_EPOLL_DISPATCHER
+}
+
 void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
 {
     DoAddTimer(wxTimerSchedule(timer, expiration));
+
+    UpdateTimerFD();
 }
 
-void wxTimerScheduler::DoAddTimer(const wxTimerSchedule& s)
+void wxTimerScheduler::DoAddTimer(wxTimerSchedule s)
 {
-    // do an insertion sort to keep the list sorted in expiration order
-    wxTimerList::iterator node;
-    for ( node = m_timers.begin(); node != m_timers.end(); ++node )
-    {
-        wxASSERT_MSG( node->m_timer != s.m_timer,
-                      wxT("adding the same timer twice?") );
+    wxASSERT_MSG( s.m_timer->m_heapIndex == wxUnixTimerImpl::NOT_SCHEDULED,
+                  wxT("adding the same timer twice?") );
 
-        if ( node->m_expiration > s.m_expiration )
-            break;
-    }
+    s.m_sequence = m_nextSequence++;
 
-    m_timers.insert(node, s);
+    m_timers.push_back(s);
+    SiftUp(m_timers.size() - 1);
 
     wxLogTrace(wxTrace_Timer, wxT("Inserted timer %d expiring at %s"),
                s.m_timer->GetId(),
@@ -75,18 +203,95 @@ void wxTimerScheduler::RemoveTimer(wxUnixTimerImpl *timer)
 {
     wxLogTrace(wxTrace_Timer, wxT("Removing timer %d"), timer->GetId());
 
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+    const size_t n = timer->m_heapIndex;
+    wxCHECK_RET( n < m_timers.size() && m_timers[n].m_timer == timer,
+                 wxT("removing inexistent timer?") );
+
+    DoRemoveAt(n);
+
+    UpdateTimerFD();
+}
+
+void wxTimerScheduler::DoRemoveAt(size_t n)
+{
+    m_timers[n].m_timer->m_heapIndex = wxUnixTimerImpl::NOT_SCHEDULED;
+
+    // replace the removed timer with the last one and restore the heap order
+    const size_t last = m_timers.size() - 1;
+    if ( n != last )
     {
-        if ( node->m_timer == timer )
-        {
-            m_timers.erase(node);
-            return;
-        }
+        PlaceAt(n, m_timers[last]);
+        m_timers.pop_back();
+
+        if ( n > 0 && m_timers[n].IsBefore(m_timers[(n - 1) / 2]) )
+            SiftUp(n);
+        else
+            SiftDown(n);
     }
+    else
+    {
+        m_timers.pop_back();
+    }
+}
 
-    wxFAIL_MSG( wxT("removing inexistent timer?") );
+void wxTimerScheduler::PlaceAt(size_t n, const wxTimerSchedule& s)
+{
+    m_timers[n] = s;
+    s.m_timer->m_heapIndex = n;
+}
+
+void wxTimerScheduler::SiftUp(size_t n)
+{
+    const wxTimerSchedule s = m_timers[n];
+    while ( n > 0 )
+    {
+        const size_t parent = (n - 1) / 2;
+        if ( !s.IsBefore(m_timers[parent]) )
+            break;
+
+        PlaceAt(n, m_timers[parent]);
+        n = parent;
+    }
+
+    PlaceAt(n, s);
+}
+
+void wxTimerScheduler::SiftDown(size_t n)
+{
+    const wxTimerSchedule s = m_timers[n];
+    const size_t count = m_timers.size();
+    for ( ;; )
+    {
+        size_t child = 2*n + 1;
+        if ( child >= count )
+            break;
+
+        if ( child + 1 < count && m_timers[child + 1].IsBefore(m_timers[child]) )
+            child++;
+
+        if ( !m_timers[child].IsBefore(s) )
+            break;
+
+        PlaceAt(n, m_timers[child]);
+        n = child;
+    }
+
+    PlaceAt(n, s);
+}
+
+void wxTimerScheduler::UpdateTimerFD()
+{
+#if wxUSE_EPOLL_DISPATCHER
+    if ( !m_timerFD )
+        return;
+
+    if ( !m_timerFD->SetExpiration(m_timers.empty() ? wxUsecClock_t(0)
+                                                    : m_timers[0].m_expiration) )
+    {
+        // fall back to limiting the event loop timeout by GetNext()
+        wxDELETE(m_timerFD);
+    }
+#endif // wxUSE_EPOLL_DISPATCHER
 }
 
 bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
@@ -96,7 +301,7 @@ bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
 
     wxCHECK_MSG( remaining, false, wxT("null pointer") );
 
-    *remaining = m_timers.begin()->m_expiration - wxGetUTCTimeUSec();
+    *remaining = m_timers[0].m_expiration - wxGetUTCTimeUSec();
     if ( *remaining < 0 )
     {
         // timer already expired, don't wait at all before notifying it
@@ -115,28 +320,24 @@ bool wxTimerScheduler::NotifyExpired()
 
     typedef wxVector<wxUnixTimerImpl *> TimerImpls;
     TimerImpls toNotify;
-    for ( wxTimerList::iterator next,
-            cur = m_timers.begin(); cur != m_timers.end(); cur = next )
+    wxVector<wxTimerSchedule> toReschedule;
+    while ( !m_timers.empty() )
     {
-        wxTimerSchedule s = *cur;
+        wxTimerSchedule s = m_timers[0];
         if ( s.m_expiration > now )
         {
-            // as the list is sorted by expiration time, we can skip the rest
+            // as the first timer expires first, the others didn't expire yet
             break;
         }
 
-        // remember next as we will delete the node pointed to by cur
-        next = cur;
-        ++next;
-
-        m_timers.erase(cur);
+        DoRemoveAt(0);
 
         // check whether we need to keep this timer
         wxUnixTimerImpl * const timer = s.m_timer;
         if ( timer->IsOneShot() )
         {
             // the timer needs to be stopped but don't call its Stop() from
-            // here as it would attempt to remove the timer from our list and
+            // here as it would attempt to remove the timer from the heap and
             // we had already done it, so we just need to reset its state
             timer->MarkStopped();
         }
@@ -147,16 +348,23 @@ bool wxTimerScheduler::NotifyExpired()
             // expiration time because it could happen that we're late and the
             // current expiration time is (far) in the past
             s.m_expiration = now + timer->GetInterval()*1000;
-            DoAddTimer(s);
+
+            // don't add it back to the heap yet, as with a 0 interval it would
+            // expire again immediately and we'd never exit this loop
+            toReschedule.push_back(s);
         }
 
         // we can't notify the timer from this loop as the timer event handler
         // could modify m_timers (for example, but not only, by stopping this
-        // timer) which would render our iterators invalid, so do it after the
-        // loop end
+        // timer), so do it after the loop end
         toNotify.push_back(timer);
     }
 
+    for ( size_t n = 0; n < toReschedule.size(); n++ )
+        DoAddTimer(toReschedule[n]);
+
+    UpdateTimerFD();
+
     if ( toNotify.empty() )
         return false;
 
@@ -179,6 +387,7 @@ wxUnixTimerImpl::wxUnixTimerImpl(wxTimer* timer)
                : wxTimerImpl(timer)
 {
     m_isRunning = false;
+    m_heapIndex = NOT_SCHEDULED;
 }
 
 bool wxUnixTimerImpl::Start(int milliseconds, bool oneShot)
@@ -219,7 +428,15 @@ wxUnixTimerImpl::~wxUnixTimerImpl()
 class wxTimerUnixModule : public wxModule
 {
 public:
-    wxTimerUnixModule() {}
+    wxTimerUnixModule()
+    {
+#if wxUSE_EPOLL_DISPATCHER
+        // the scheduler timer descriptor must be unregistered from the
+        // dispatcher before it's destroyed
+        AddDependency("wxFDIODispatcherModule");
+#endif // wxUSE_EPOLL_DISPATCHER
+    }
+
     virtual bool OnInit() override { return true; }
     virtual void OnExit() override { wxTimerScheduler::Shutdown(); }
 
@@ -0,0 +1,146 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/events.cpp
+// Purpose:     Event-related benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/event.h"
+
+#include "bench.h"
+
+// ----------------------------------------------------------------------------
+// Dispatching events to dynamically bound handlers
+// ----------------------------------------------------------------------------
+
+wxDEFINE_EVENT(BenchEventType1, wxThreadEvent);
+wxDEFINE_EVENT(BenchEventType2, wxThreadEvent);
+
+namespace
+{
+
+const int NUM_EVENTS = 1000;
+
+// Handler with the given number of handlers bound to the consecutive ids of
+// each of the two event types and one more handler for any id of the second
+// type, similar to a frame handling the events from many menu items.
+class ManyHandlers : public wxEvtHandler
+{
+public:
+    explicit ManyHandlers(int numIds)
+    {
+        for ( int id = 1; id <= numIds; id++ )
+        {
+            Bind(BenchEventType1, &ManyHandlers::OnEvent, this, id);
+            Bind(BenchEventType2, &ManyHandlers::OnEvent, this, id);
+        }
+
+        Bind(BenchEventType2, &ManyHandlers::OnEvent, this);
+    }
+
+    long m_count = 0;
+
+private:
+    void OnEvent(wxThreadEvent&) { m_count++; }
+};
+
+bool DispatchEvents(ManyHandlers& handler, int numIds)
+{
+    wxThreadEvent event(BenchEventType1);
+
+    const long countOld = handler.m_count;
+    for ( int n = 0; n < NUM_EVENTS; n++ )
+    {
+        event.SetId(n % numIds + 1);
+        handler.ProcessEvent(event);
+    }
+
+    return handler.m_count == countOld + NUM_EVENTS;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(DispatchEventFewHandlers)
+{
+    static ManyHandlers s_handler(4);
+
+    return DispatchEvents(s_handler, 4);
+}
+
+BENCHMARK_FUNC(DispatchEventManyHandlers)
+{
+    static ManyHandlers s_handler(200);
+
+    return DispatchEvents(s_handler, 200);
+}
+
+// ----------------------------------------------------------------------------
+// Queuing events from multiple threads
+// ----------------------------------------------------------------------------
+
+#if wxUSE_THREADS
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Queue the number of events given by the numeric parameter, 100000 by
+// default, to the same handler from the given number of threads and process
+// them in the main thread while they're being queued.
+bool QueueEventsFromThreads(int numThreads)
+{
+    const long numEvents = Bench::GetNumericParameter(100000);
+    const long numEventsPerThread = numEvents / numThreads;
+
+    wxEvtHandler handler;
+
+    long count = 0;
+    handler.Bind(wxEVT_THREAD, [&count](wxThreadEvent&) { count++; });
+
+    std::atomic<int> done(0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < numThreads; t++ )
+    {
+        threads.emplace_back([&handler, &done, numEventsPerThread]()
+        {
+            for ( long n = 0; n < numEventsPerThread; n++ )
+                handler.QueueEvent(new wxThreadEvent());
+
+            done++;
+        });
+    }
+
+    while ( done < numThreads )
+        wxTheApp->ProcessPendingEvents();
+
+    for ( auto& thread : threads )
+        thread.join();
+
+    wxTheApp->ProcessPendingEvents();
+
+    return count == numEventsPerThread*numThreads;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(QueueEvent1Thread)
+{
+    return QueueEventsFromThreads(1);
+}
+
+BENCHMARK_FUNC(QueueEvent4Threads)
+{
+    return QueueEventsFromThreads(4);
+}
+
+BENCHMARK_FUNC(QueueEvent16Threads)
+{
+    return QueueEventsFromThreads(16);
+}
+
+#endif // wxUSE_THREADS
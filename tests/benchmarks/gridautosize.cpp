@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/gridautosize.cpp
+// Purpose:     Benchmarks for the different wxGrid auto-sizing modes
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/grid.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const int NUM_COLS = 4;
+
+// Return the grid with the number of rows given by the numeric parameter,
+// 100000 by default, filled with strings of different lengths.
+wxGrid& GetTestGrid()
+{
+    static wxGrid* s_grid = nullptr;
+    if ( !s_grid )
+    {
+        s_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+
+        const int
+            numRows = static_cast<int>(Bench::GetNumericParameter(100000));
+        s_grid->CreateGrid(numRows, NUM_COLS);
+
+        for ( int row = 0; row < numRows; row++ )
+        {
+            for ( int col = 0; col < NUM_COLS; col++ )
+            {
+                s_grid->SetCellValue(row, col,
+                                     wxString::Format("Cell %d:%d %s",
+                                                      row, col,
+                                                      wxString('x', row % 17)));
+            }
+        }
+    }
+
+    return *s_grid;
+}
+
+bool AutoSizeColumns(int mode)
+{
+    wxGrid& grid = GetTestGrid();
+
+    grid.SetAutoSizeMode(mode);
+    grid.AutoSizeColumns(false);
+
+    return grid.GetColSize(0) > 0;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(GridAutoSizeAll)
+{
+    return AutoSizeColumns(wxGRID_AUTOSIZE_ALL);
+}
+
+BENCHMARK_FUNC(GridAutoSizeSample)
+{
+    return AutoSizeColumns(wxGRID_AUTOSIZE_SAMPLE);
+}
+
+BENCHMARK_FUNC(GridAutoSizeParallel)
+{
+    return AutoSizeColumns(wxGRID_AUTOSIZE_PARALLEL);
+}
+
+BENCHMARK_FUNC(GridAutoSizeSampleParallel)
+{
+    return AutoSizeColumns(wxGRID_AUTOSIZE_SAMPLE | wxGRID_AUTOSIZE_PARALLEL);
+}
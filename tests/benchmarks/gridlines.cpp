@@ -0,0 +1,70 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/gridlines.cpp
+// Purpose:     Benchmarks for inserting and deleting wxGrid rows
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/grid.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// Return the grid with the number of rows given by the numeric parameter,
+// 1000000 by default, using different row heights, so that the grid has to
+// keep track of the row positions.
+wxGrid& GetTestGrid()
+{
+    static wxGrid* s_grid = nullptr;
+    if ( !s_grid )
+    {
+        s_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+
+        const int
+            numRows = static_cast<int>(Bench::GetNumericParameter(1000000));
+        s_grid->CreateGrid(numRows, 1);
+
+        for ( int row = 0; row < numRows; row += 10 )
+            s_grid->SetRowSize(row, s_grid->GetDefaultRowSize() + row % 7);
+    }
+
+    return *s_grid;
+}
+
+// Insert a row at the given position and delete it again.
+bool InsertAndDeleteRow(int pos)
+{
+    wxGrid& grid = GetTestGrid();
+
+    if ( !grid.InsertRows(pos) )
+        return false;
+
+    return grid.DeleteRows(pos);
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(GridInsertRowsStart)
+{
+    return InsertAndDeleteRow(0);
+}
+
+BENCHMARK_FUNC(GridInsertRowsMiddle)
+{
+    return InsertAndDeleteRow(GetTestGrid().GetNumberRows() / 2);
+}
+
+BENCHMARK_FUNC(GridAppendRows)
+{
+    wxGrid& grid = GetTestGrid();
+
+    if ( !grid.AppendRows() )
+        return false;
+
+    return grid.DeleteRows(grid.GetNumberRows() - 1);
+}
@@ -8,6 +8,8 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "wx/image.h"
+#include "wx/ffile.h"
+#include "wx/mstream.h"
 
 #include "bench.h"
 
@@ -43,6 +45,49 @@ BENCHMARK_FUNC(LoadPNG)
     return image.LoadFile("horse.png");
 }
 
+BENCHMARK_FUNC(LoadPNGThumbnail)
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_PNG) )
+        wxImage::AddHandler(new wxPNGHandler);
+
+    // This loads the image row by row reducing it while doing it.
+    wxImage image;
+    image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 50);
+    return image.LoadFile(Bench::GetStringParameter("horse.png"));
+}
+
+BENCHMARK_FUNC(DetectFormat)
+{
+    static wxMemoryBuffer s_data;
+    if ( s_data.IsEmpty() )
+    {
+        wxInitAllImageHandlers();
+
+        wxFFile file(Bench::GetStringParameter("horse.png"), "rb");
+        s_data.SetDataLen(file.Read(s_data.GetWriteBuf(file.Length()),
+                                    file.Length()));
+    }
+
+    // This checks the header against all handlers, as is done when loading
+    // the image without specifying its type.
+    wxMemoryInputStream stream(s_data.GetData(), s_data.GetDataLen());
+    return wxImage::CanRead(stream);
+}
+
+BENCHMARK_FUNC(FindHandler)
+{
+    static bool s_initialized = false;
+    if ( !s_initialized )
+    {
+        s_initialized = true;
+        wxInitAllImageHandlers();
+    }
+
+    return wxImage::FindHandler("png", wxBITMAP_TYPE_ANY) &&
+           wxImage::FindHandler(wxBITMAP_TYPE_PNG) &&
+           wxImage::FindHandlerMime("image/png");
+}
+
 #if wxUSE_LIBTIFF
 BENCHMARK_FUNC(LoadTIFF)
 {
@@ -95,6 +140,14 @@ BENCHMARK_FUNC(EnlargeHighQuality)
                        wxIMAGE_QUALITY_HIGH).IsOk();
 }
 
+BENCHMARK_FUNC(EnlargeLanczos)
+{
+    const wxImage& image = GetTestImage();
+    const double factor = Bench::GetNumericParameter(150) / 100.;
+    return image.Scale(factor*image.GetWidth(), factor*image.GetHeight(),
+                       wxIMAGE_QUALITY_LANCZOS).IsOk();
+}
+
 BENCHMARK_FUNC(ShrinkNormal)
 {
     const wxImage& image = GetTestImage();
@@ -118,3 +171,234 @@ BENCHMARK_FUNC(ShrinkHighQuality)
     return image.Scale(factor*image.GetWidth(), factor*image.GetHeight(),
                        wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+BENCHMARK_FUNC(ShrinkBicubic)
+{
+    const wxImage& image = GetTestImage();
+    const double factor = Bench::GetNumericParameter(50) / 100.;
+    return image.Scale(factor*image.GetWidth(), factor*image.GetHeight(),
+                       wxIMAGE_QUALITY_BICUBIC).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkLanczos)
+{
+    const wxImage& image = GetTestImage();
+    const double factor = Bench::GetNumericParameter(50) / 100.;
+    return image.Scale(factor*image.GetWidth(), factor*image.GetHeight(),
+                       wxIMAGE_QUALITY_LANCZOS).IsOk();
+}
+
+// The images used by the benchmarks above are too small for using multiple
+// threads, so use a big generated image with the ones below, which compare
+// the performance of processing it in a single thread and in parallel.
+static const wxImage& GetLargeTestImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        const int w = 6000,
+                  h = 4000;
+        s_image.Create(w, h, false);
+
+        unsigned char* p = s_image.GetData();
+        for ( int y = 0; y < h; y++ )
+        {
+            for ( int x = 0; x < w; x++ )
+            {
+                *p++ = x;
+                *p++ = y;
+                *p++ = x ^ y;
+            }
+        }
+    }
+
+    return s_image;
+}
+
+// Use as many threads as there are CPUs during this object lifetime.
+class ImageThreadsSetter
+{
+public:
+    ImageThreadsSetter()
+        : m_maxThreadsOrig(wxImage::GetMaxThreads())
+    {
+        wxImage::SetMaxThreads(0);
+    }
+
+    ~ImageThreadsSetter()
+    {
+        wxImage::SetMaxThreads(m_maxThreadsOrig);
+    }
+
+private:
+    const int m_maxThreadsOrig;
+};
+
+static bool ShrinkLarge(wxImageResizeQuality quality)
+{
+    const wxImage& image = GetLargeTestImage();
+    const double factor = Bench::GetNumericParameter(10) / 100.;
+    return image.Scale(factor*image.GetWidth(), factor*image.GetHeight(),
+                       quality).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkLargeNormal)
+{
+    return ShrinkLarge(wxIMAGE_QUALITY_NORMAL);
+}
+
+BENCHMARK_FUNC(ShrinkLargeNormalThreads)
+{
+    ImageThreadsSetter setThreads;
+    return ShrinkLarge(wxIMAGE_QUALITY_NORMAL);
+}
+
+BENCHMARK_FUNC(ShrinkLargeHighQuality)
+{
+    return ShrinkLarge(wxIMAGE_QUALITY_HIGH);
+}
+
+BENCHMARK_FUNC(ShrinkLargeHighQualityThreads)
+{
+    ImageThreadsSetter setThreads;
+    return ShrinkLarge(wxIMAGE_QUALITY_HIGH);
+}
+
+BENCHMARK_FUNC(ShrinkLargeLanczos)
+{
+    return ShrinkLarge(wxIMAGE_QUALITY_LANCZOS);
+}
+
+BENCHMARK_FUNC(ShrinkLargeLanczosThreads)
+{
+    ImageThreadsSetter setThreads;
+    return ShrinkLarge(wxIMAGE_QUALITY_LANCZOS);
+}
+
+BENCHMARK_FUNC(BlurLarge)
+{
+    return GetLargeTestImage().Blur(Bench::GetNumericParameter(5)).IsOk();
+}
+
+BENCHMARK_FUNC(BlurLargeThreads)
+{
+    ImageThreadsSetter setThreads;
+    return GetLargeTestImage().Blur(Bench::GetNumericParameter(5)).IsOk();
+}
+
+// The benchmarks below measure the speed of the operations processing all
+// the image pixels, which modify the image in place, so use a copy of it.
+static wxImage& GetPixelsTestImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+        s_image = GetTestImage().Copy();
+
+    return s_image;
+}
+
+BENCHMARK_FUNC(Replace)
+{
+    wxImage& image = GetPixelsTestImage();
+    image.Replace(0, 0, 0, 1, 1, 1);
+    image.Replace(1, 1, 1, 0, 0, 0);
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(ConvertAlphaToMask)
+{
+    static wxImage s_imageWithAlpha;
+    if ( !s_imageWithAlpha.IsOk() )
+    {
+        s_imageWithAlpha = GetTestImage().Copy();
+        s_imageWithAlpha.InitAlpha();
+
+        unsigned char* alpha = s_imageWithAlpha.GetAlpha();
+        const int w = s_imageWithAlpha.GetWidth(),
+                  h = s_imageWithAlpha.GetHeight();
+        for ( int y = 0; y < h; y++ )
+        {
+            for ( int x = 0; x < w; x++ )
+                *alpha++ = x ^ y;
+        }
+    }
+
+    // This includes the time needed to copy the image, as converting alpha
+    // to mask destroys it.
+    wxImage image = s_imageWithAlpha.Copy();
+    return image.ConvertAlphaToMask();
+}
+
+BENCHMARK_FUNC(ConvertToGreyscale)
+{
+    return GetTestImage().ConvertToGreyscale().IsOk();
+}
+
+BENCHMARK_FUNC(RotateHue)
+{
+    wxImage& image = GetPixelsTestImage();
+    image.RotateHue(0.25);
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(ChangeSaturation)
+{
+    wxImage& image = GetPixelsTestImage();
+    image.ChangeSaturation(0.1);
+    image.ChangeSaturation(-0.1);
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(ChangeBrightness)
+{
+    wxImage& image = GetPixelsTestImage();
+    image.ChangeBrightness(0.1);
+    image.ChangeBrightness(-0.1);
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(ChangeHSV)
+{
+    wxImage& image = GetPixelsTestImage();
+    image.ChangeHSV(0.25, 0.1, -0.1);
+    return image.IsOk();
+}
+
+// Return an image of the same size as the test image but filled with random
+// noise, i.e. having as many different colours as possible, which is the
+// worst case for the functions reusing the results for the same colours.
+static wxImage& GetManyColoursTestImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        const wxImage& image = GetTestImage();
+        s_image.Create(image.GetWidth(), image.GetHeight(), false);
+
+        unsigned char* data = s_image.GetData();
+        const size_t size = 3*static_cast<size_t>(image.GetWidth())*image.GetHeight();
+
+        wxUint32 seed = 1;
+        for ( size_t n = 0; n < size; n++ )
+        {
+            seed = seed*1103515245 + 12345;
+            *data++ = static_cast<unsigned char>(seed >> 16);
+        }
+    }
+
+    return s_image;
+}
+
+BENCHMARK_FUNC(RotateHueManyColours)
+{
+    wxImage& image = GetManyColoursTestImage();
+    image.RotateHue(0.25);
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(ChangeHSVManyColours)
+{
+    wxImage& image = GetManyColoursTestImage();
+    image.ChangeHSV(0.25, 0.1, -0.1);
+    return image.IsOk();
+}
@@ -106,3 +106,100 @@ BENCHMARK_FUNC(LogTraceInactive)
 
     return true;
 }
+
+BENCHMARK_FUNC(LogDebugDisabledWithComponents)
+{
+    static bool s_set = false;
+    if ( !s_set )
+    {
+        s_set = true;
+        wxLog::SetComponentLevel("logbench/quiet", wxLOG_Warning);
+        wxLog::SetComponentLevel("logbench/verbose", wxLOG_Info);
+    }
+
+    LogLevelSetter level(wxLOG_Info);
+
+    wxLogDebug("Ignored debug message: %s", NotCreated().AsStr());
+
+    return true;
+}
+
+#if wxUSE_THREADS
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Log target counting the messages instead of outputting them.
+class CountingLog : public wxLog
+{
+public:
+    std::atomic<long> m_count{0};
+
+protected:
+    virtual void DoLogRecord(wxLogLevel,
+                             const wxString&,
+                             const wxLogRecordInfo&) override
+    {
+        m_count++;
+    }
+};
+
+// Log the number of messages given by the numeric parameter, 10000 by
+// default, from 4 threads using the given log target.
+void LogFromThreads()
+{
+    const long numMessages = Bench::GetNumericParameter(10000);
+
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < 4; t++ )
+    {
+        threads.emplace_back([numMessages]()
+        {
+            for ( long n = 0; n < numMessages / 4; n++ )
+                wxLogMessage("Message %ld", n);
+        });
+    }
+
+    for ( auto& thread : threads )
+        thread.join();
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(LogFromThreadsBuffered)
+{
+    CountingLog* const log = new CountingLog;
+    wxLog* const logOld = wxLog::SetActiveTarget(log);
+
+    LogFromThreads();
+
+    // the messages are only logged when they're flushed
+    wxLog::FlushActive();
+    const bool ok = log->m_count == Bench::GetNumericParameter(10000) / 4 * 4;
+
+    delete wxLog::SetActiveTarget(logOld);
+
+    return ok;
+}
+
+BENCHMARK_FUNC(LogFromThreadsAsync)
+{
+    CountingLog* const log = new CountingLog;
+    wxLogAsync* const logAsync = new wxLogAsync(log);
+    wxLog* const logOld = wxLog::SetActiveTarget(logAsync);
+
+    LogFromThreads();
+
+    logAsync->Drain();
+    const bool ok = log->m_count == Bench::GetNumericParameter(10000) / 4 * 4;
+
+    delete wxLog::SetActiveTarget(logOld);
+
+    return ok;
+}
+
+#endif // wxUSE_THREADS
@@ -42,6 +42,39 @@ bool ConvertToMB(const wxMBConv& conv)
     return conv.FromWChar(buf.data(), outlen, TEST_STRING) == outlen;
 }
 
+// the test string converted to UTF-8 and a version of it containing some
+// non-ASCII characters too
+const char *TEST_STRING_UTF8 =
+    "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod"
+    "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim"
+    "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea"
+    "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate"
+    "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint"
+    "occaecat cupidatat non proident, sunt in culpa qui officia deserunt"
+    "mollit anim id est laborum."
+    ;
+
+const char *TEST_STRING_UTF8_MIXED =
+    "Lorem ipsum dolor sit amet, \xc3\xa9t\xc3\xa9 consectetur adipisicing"
+    "elit, sed do eiusmod \xe2\x82\xac tempor incididunt ut labore et dolore"
+    "\xd0\xbc\xd0\xb0\xd0\xb3\xd0\xbd\xd0\xb0 aliqua. Ut enim ad minim"
+    "veniam, quis \xe4\xb8\xad\xe6\x96\x87 nostrud exercitation ullamco"
+    "laboris nisi ut aliquip \xf0\x9f\x98\x80 ex ea commodo consequat."
+    ;
+
+// convert the given UTF-8 string to wide characters and back
+bool ConvertUTF8RoundTrip(const char *utf8)
+{
+    wxMBConvStrictUTF8 conv;
+
+    const wxWCharBuffer wbuf = conv.cMB2WC(utf8);
+    if ( !wbuf.data() )
+        return false;
+
+    const wxCharBuffer buf = conv.cWC2MB(wbuf);
+    return buf.data() && strcmp(buf.data(), utf8) == 0;
+}
+
 } // anonymous namespace
 
 BENCHMARK_FUNC(UTF16InitWX)
@@ -76,3 +109,38 @@ BENCHMARK_FUNC(UTF16Sys)
     return ConvertToMB(wxCSConv("UTF-16LE"));
 }
 
+
+BENCHMARK_FUNC(UTF8LenWX)
+{
+    return ComputeMBLength(wxMBConvStrictUTF8());
+}
+
+BENCHMARK_FUNC(UTF8WX)
+{
+    return ConvertToMB(wxMBConvStrictUTF8());
+}
+
+BENCHMARK_FUNC(UTF8ToWCharWX)
+{
+    wxMBConvStrictUTF8 conv;
+
+    const size_t len = strlen(TEST_STRING_UTF8) + 1;
+    wxWCharBuffer wbuf(len);
+    return conv.ToWChar(wbuf.data(), len, TEST_STRING_UTF8) == len;
+}
+
+BENCHMARK_FUNC(UTF8RoundTripASCII)
+{
+    return ConvertUTF8RoundTrip(TEST_STRING_UTF8);
+}
+
+BENCHMARK_FUNC(UTF8RoundTripMixed)
+{
+    return ConvertUTF8RoundTrip(TEST_STRING_UTF8_MIXED);
+}
+
+BENCHMARK_FUNC(UTF8StringRoundTrip)
+{
+    const wxString s = wxString::FromUTF8(TEST_STRING_UTF8_MIXED);
+    return strcmp(s.utf8_str(), TEST_STRING_UTF8_MIXED) == 0;
+}
@@ -0,0 +1,180 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/msgqueue.cpp
+// Purpose:     Message queue throughput benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/msgqueue.h"
+
+#include "bench.h"
+
+#if wxUSE_THREADS
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Helpers allowing to use the same code for both queue types: the bounded
+// queue can be full, so wait for the space in it if necessary.
+void PostMessage(wxMessageQueue<int>& queue, int msg)
+{
+    queue.Post(msg);
+}
+
+void PostMessage(wxBoundedMessageQueue<int>& queue, int msg)
+{
+    queue.PostTimeout(-1, msg);
+}
+
+// Pass the number of messages given by the numeric parameter, 100000 by
+// default, from the given number of producer threads to the same number of
+// consumer threads and check that all of them were received.
+template <typename Queue>
+bool PassMessages(Queue& queue, int numThreads)
+{
+    const int numMessages = Bench::GetNumericParameter(100000);
+    const int numMessagesPerThread = numMessages / numThreads;
+
+    std::atomic<long> received(0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < numThreads; t++ )
+    {
+        threads.emplace_back([&queue, numMessagesPerThread]()
+        {
+            for ( int n = 1; n <= numMessagesPerThread; n++ )
+                PostMessage(queue, n);
+        });
+
+        // the consumers stop when they get 0
+        threads.emplace_back([&queue, &received]()
+        {
+            for ( ;; )
+            {
+                int msg;
+                if ( queue.Receive(msg) != wxMSGQUEUE_NO_ERROR || !msg )
+                    break;
+
+                received++;
+            }
+        });
+    }
+
+    // wait for the producers before telling the consumers to stop
+    for ( int t = 0; t < numThreads; t++ )
+        threads[2*t].join();
+
+    for ( int t = 0; t < numThreads; t++ )
+        PostMessage(queue, 0);
+
+    for ( int t = 0; t < numThreads; t++ )
+        threads[2*t + 1].join();
+
+    return received == static_cast<long>(numMessagesPerThread)*numThreads;
+}
+
+// Same as above but using the batch functions of the bounded queue.
+bool PassMessagesBatch(wxBoundedMessageQueue<int>& queue, int numThreads)
+{
+    const int numMessages = Bench::GetNumericParameter(100000);
+    const int numMessagesPerThread = numMessages / numThreads;
+
+    static const size_t BATCH_SIZE = 32;
+
+    std::atomic<long> received(0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < numThreads; t++ )
+    {
+        threads.emplace_back([&queue, numMessagesPerThread]()
+        {
+            int msgs[BATCH_SIZE];
+            for ( int n = 1; n <= numMessagesPerThread; )
+            {
+                size_t count = 0;
+                while ( count < BATCH_SIZE && n <= numMessagesPerThread )
+                    msgs[count++] = n++;
+
+                const size_t posted = queue.PostMany(msgs, count);
+                for ( size_t i = posted; i < count; i++ )
+                    queue.PostTimeout(-1, msgs[i]);
+            }
+        });
+
+        threads.emplace_back([&queue, &received]()
+        {
+            int msgs[BATCH_SIZE];
+            for ( ;; )
+            {
+                size_t count;
+                if ( queue.ReceiveMany(msgs, BATCH_SIZE, count) != wxMSGQUEUE_NO_ERROR )
+                    break;
+
+                for ( size_t i = 0; i < count; i++ )
+                {
+                    if ( !msgs[i] )
+                    {
+                        // the remaining messages, if any, are the stop
+                        // messages for the other consumers
+                        for ( ++i; i < count; i++ )
+                            queue.PostTimeout(-1, msgs[i]);
+                        return;
+                    }
+
+                    received++;
+                }
+            }
+        });
+    }
+
+    for ( int t = 0; t < numThreads; t++ )
+        threads[2*t].join();
+
+    for ( int t = 0; t < numThreads; t++ )
+        queue.PostTimeout(-1, 0);
+
+    for ( int t = 0; t < numThreads; t++ )
+        threads[2*t + 1].join();
+
+    return received == static_cast<long>(numMessagesPerThread)*numThreads;
+}
+
+const size_t QUEUE_CAPACITY = 1024;
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(MessageQueue1Thread)
+{
+    wxMessageQueue<int> queue;
+    return PassMessages(queue, 1);
+}
+
+BENCHMARK_FUNC(MessageQueue4Threads)
+{
+    wxMessageQueue<int> queue;
+    return PassMessages(queue, 4);
+}
+
+BENCHMARK_FUNC(BoundedMessageQueue1Thread)
+{
+    wxBoundedMessageQueue<int> queue(QUEUE_CAPACITY);
+    return PassMessages(queue, 1);
+}
+
+BENCHMARK_FUNC(BoundedMessageQueue4Threads)
+{
+    wxBoundedMessageQueue<int> queue(QUEUE_CAPACITY);
+    return PassMessages(queue, 4);
+}
+
+BENCHMARK_FUNC(BoundedMessageQueueBatch4Threads)
+{
+    wxBoundedMessageQueue<int> queue(QUEUE_CAPACITY);
+    return PassMessagesBatch(queue, 4);
+}
+
+#endif // wxUSE_THREADS
@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/rowheightcache.cpp
+// Purpose:     Benchmarks for the row height cache used by wxDataViewCtrl
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/defs.h"
+
+#include "wx/generic/private/rowheightcache.h"
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+namespace
+{
+
+// Return the number of rows to use, 2 million by default.
+unsigned int GetRowCount()
+{
+    return static_cast<unsigned int>(Bench::GetNumericParameter(2000000));
+}
+
+// Return the height of the given row: make every 7th row taller to have
+// plenty of runs of rows of different heights.
+int GetRowHeight(unsigned int row)
+{
+    return row % 7 ? 20 : 40;
+}
+
+HeightCache& GetTestCache()
+{
+    static HeightCache s_cache;
+    static bool s_initialized = false;
+    if ( !s_initialized )
+    {
+        s_initialized = true;
+
+        const unsigned int count = GetRowCount();
+        for ( unsigned int row = 0; row < count; row++ )
+            s_cache.Put(row, GetRowHeight(row));
+    }
+
+    return s_cache;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(HeightCacheGetLineStart)
+{
+    const HeightCache& cache = GetTestCache();
+
+    int start;
+    return cache.GetLineStart(rand() % GetRowCount(), start);
+}
+
+BENCHMARK_FUNC(HeightCacheGetLineAt)
+{
+    const HeightCache& cache = GetTestCache();
+
+    // Average row height is slightly less than 23 pixels.
+    unsigned int row;
+    return cache.GetLineAt(rand() % (GetRowCount() * 22), row);
+}
+
+BENCHMARK_FUNC(HeightCachePut)
+{
+    HeightCache& cache = GetTestCache();
+
+    const unsigned int row = rand() % GetRowCount();
+    cache.Put(row, 60 - GetRowHeight(row));
+    cache.Put(row, GetRowHeight(row));
+
+    return true;
+}
+
+BENCHMARK_FUNC(HeightCacheInsertDelete)
+{
+    HeightCache& cache = GetTestCache();
+
+    const unsigned int row = rand() % GetRowCount();
+    cache.InsertRows(row, 1);
+    cache.Put(row, 30);
+    cache.DeleteRows(row, 1);
+
+    int start;
+    return cache.GetLineStart(GetRowCount(), start);
+}
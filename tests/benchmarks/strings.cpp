@@ -485,6 +485,41 @@ BENCHMARK_FUNC(CharBuffer)
            wxStrlen(str.wc_str()) == ASCIISTR_LEN;
 }
 
+// Repeatedly get the narrow representation of the same string, as is done
+// when passing it to C APIs: this shouldn't allocate memory every time.
+BENCHMARK_FUNC(UTF8StrRepeated)
+{
+    static wxString str(asciistr);
+
+    size_t len = 0;
+    for ( int n = 0; n < 10; n++ )
+        len += strlen(str.utf8_str());
+
+    return len == 10*ASCIISTR_LEN;
+}
+
+BENCHMARK_FUNC(UTF8StrRepeatedNonASCII)
+{
+    static wxString str = wxString::FromUTF8(utf8str);
+
+    size_t len = 0;
+    for ( int n = 0; n < 10; n++ )
+        len += strlen(str.utf8_str());
+
+    return len == 10*strlen(utf8str);
+}
+
+BENCHMARK_FUNC(MBStrRepeated)
+{
+    static wxString str(asciistr);
+
+    size_t len = 0;
+    for ( int n = 0; n < 10; n++ )
+        len += strlen(str.mb_str(wxConvISO8859_1));
+
+    return len == 10*ASCIISTR_LEN;
+}
+
 
 // ----------------------------------------------------------------------------
 // wxString::operator[] - parse large HTML page
@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/timer.cpp
+// Purpose:     wxTimer benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/timer.h"
+
+#include "bench.h"
+
+#if wxUSE_TIMER
+
+#include <memory>
+
+namespace
+{
+
+// The timers used here never expire during the benchmark, we only measure the
+// cost of starting and stopping them.
+const int TIMER_INTERVAL = 3600*1000;
+
+// Create the number of timers given by the numeric parameter, 1000 by default,
+// start all of them, restart each of them once and stop them in the order
+// which is different from the expiration one.
+bool ChurnTimers(bool oneShot)
+{
+    const long numTimers = Bench::GetNumericParameter(1000);
+
+    std::unique_ptr<wxTimer[]> timers(new wxTimer[numTimers]);
+
+    // use different intervals to avoid adding all timers to the end of the
+    // schedule
+    for ( long n = 0; n < numTimers; n++ )
+        timers[n].Start(TIMER_INTERVAL + (n*7919) % numTimers, oneShot);
+
+    for ( long n = 0; n < numTimers; n++ )
+        timers[n].Start(TIMER_INTERVAL + (n*104729) % numTimers, oneShot);
+
+    // stop every other timer first and then all the remaining ones, in the
+    // reverse order
+    for ( long n = 0; n < numTimers; n += 2 )
+        timers[n].Stop();
+
+    for ( long n = numTimers - 1; n >= 0; n-- )
+        timers[n].Stop();
+
+    for ( long n = 0; n < numTimers; n++ )
+    {
+        if ( timers[n].IsRunning() )
+            return false;
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(TimerChurn)
+{
+    return ChurnTimers(false);
+}
+
+BENCHMARK_FUNC(TimerChurnOneShot)
+{
+    return ChurnTimers(true);
+}
+
+#endif // wxUSE_TIMER
@@ -19,6 +19,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/fileconf.h"
+#include "wx/file.h"
 #include "wx/sstream.h"
 #include "wx/log.h"
 
@@ -641,6 +642,77 @@ TEST_CASE("wxFileConfig::LongLong", "[fileconfig][config][longlong]")
     CHECK( ll == val );
 }
 
+TEST_CASE("wxFileConfig::Journal", "[fileconfig][config]")
+{
+    const wxString file = "fileconfjournal.conf";
+    const wxString journal = file + ".journal";
+    const long style = wxCONFIG_USE_LOCAL_FILE |
+                       wxCONFIG_USE_RELATIVE_PATH |
+                       wxCONFIG_USE_JOURNAL;
+
+    if ( wxFileExists(file) )
+        wxRemoveFile(file);
+    if ( wxFileExists(journal) )
+        wxRemoveFile(journal);
+
+    const wxString multiline = "line 1\nline\t2\\";
+    {
+        wxFileConfig fc("", "", file, "", style);
+        fc.Write("/root/entry", "value");
+        fc.Write("/root/group/multi", multiline);
+        REQUIRE( fc.Flush() );
+
+        // Only the journal should have been written.
+        CHECK( !wxFileExists(file) );
+        CHECK( wxFileExists(journal) );
+
+        fc.Write("/root/number", 17);
+        fc.SetPath("/root");
+        CHECK( fc.RenameEntry("entry", "renamed") );
+        fc.SetPath("/");
+        fc.Write("/gone/entry", "value");
+        CHECK( fc.DeleteGroup("/gone") );
+        REQUIRE( fc.Flush() );
+
+        // Simulate a crash before the journal is merged into the file.
+        fc.DisableAutoSave();
+    }
+
+    CHECK( !wxFileExists(file) );
+
+    {
+        wxFileConfig fc("", "", file, "", style);
+        CHECK( fc.Read("/root/renamed", "") == "value" );
+        CHECK( !fc.HasEntry("/root/entry") );
+        CHECK( fc.Read("/root/group/multi", "") == multiline );
+        CHECK( fc.ReadLong("/root/number", 0) == 17 );
+        CHECK( !fc.HasGroup("/gone") );
+    }
+
+    // The journal is merged into the file when the object is destroyed.
+    CHECK( wxFileExists(file) );
+    CHECK( !wxFileExists(journal) );
+
+    // A journal which doesn't correspond to the file is ignored.
+    {
+        wxFile f(journal, wxFile::write);
+        REQUIRE( f.Write("#wxFileConfig journal none\nset\t/stale\tvalue\n") );
+    }
+
+    {
+        wxFileConfig fc("", "", file, "", wxCONFIG_USE_LOCAL_FILE |
+                                          wxCONFIG_USE_RELATIVE_PATH);
+        CHECK( fc.Read("/root/renamed", "") == "value" );
+        CHECK( fc.Read("/root/group/multi", "") == multiline );
+        CHECK( !fc.HasEntry("/stale") );
+
+        CHECK( fc.DeleteAll() );
+    }
+
+    CHECK( !wxFileExists(file) );
+    CHECK( !wxFileExists(journal) );
+}
+
 TEST_CASE_METHOD(LogTestCase, "wxFileConfig::Error", "[fileconfig][error]")
 {
     const auto checkWarning = [this](const char* contents, const char* expected)
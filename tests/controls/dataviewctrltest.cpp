@@ -26,6 +26,8 @@
 #include "testableframe.h"
 #include "asserthelper.h"
 
+#include <memory>
+
 // ----------------------------------------------------------------------------
 // test class
 // ----------------------------------------------------------------------------
@@ -861,6 +863,323 @@ TEST_CASE_METHOD(MultiColumnsDataViewCtrlTestCase,
     CHECK( m_lastColumn->GetWidth() >= lastColumnMinWidth );
 }
 
+TEST_CASE_METHOD(MultiSelectDataViewCtrlTestCase,
+                 "wxDVC::Batch",
+                 "[wxDataViewCtrl][batch]")
+{
+    wxDataViewModel* const model = m_dvc->GetModel();
+
+    m_dvc->Expand(m_child1);
+    m_dvc->Select(m_child1);
+    m_dvc->Select(m_grandchild);
+
+    EventCounter valueChanged(m_dvc, wxEVT_DATAVIEW_ITEM_VALUE_CHANGED);
+
+    model->BeginBatch();
+    CHECK( model->IsBatching() );
+
+    // Nested batches are allowed.
+    model->BeginBatch();
+    const wxDataViewItem child0 = m_dvc->PrependItem(m_root, "child0");
+    model->EndBatch();
+    CHECK( model->IsBatching() );
+
+    const wxDataViewItem child3 = m_dvc->AppendItem(m_root, "child3");
+    m_dvc->SetItemText(m_child2, "changed");
+    m_dvc->SetItemText(m_child2, "changed again");
+    m_dvc->SetItemText(m_grandchild, "changed");
+    m_dvc->DeleteItem(m_grandchild);
+    model->EndBatch();
+    CHECK( !model->IsBatching() );
+
+#ifdef wxHAS_GENERIC_DATAVIEWCTRL
+    // The value changed event is only sent once for the item which still
+    // exists and not at all for the deleted one.
+    CHECK( valueChanged.GetCount() == 1 );
+#endif // wxHAS_GENERIC_DATAVIEWCTRL
+    CHECK( m_dvc->GetItemText(m_child2) == "changed again" );
+
+    // The selection of the remaining item must have been preserved.
+    wxDataViewItemArray sel;
+    REQUIRE( m_dvc->GetSelections(sel) == 1 );
+    CHECK( sel[0] == m_child1 );
+
+    // And the new items must be shown at the right places.
+    m_dvc->Refresh();
+    m_dvc->Update();
+
+    const wxRect rect0 = m_dvc->GetItemRect(child0);
+    const wxRect rect1 = m_dvc->GetItemRect(m_child1);
+    const wxRect rect2 = m_dvc->GetItemRect(m_child2);
+    const wxRect rect3 = m_dvc->GetItemRect(child3);
+    CHECK( rect0.y < rect1.y );
+    CHECK( rect1.y < rect2.y );
+    CHECK( rect2.y < rect3.y );
+}
+
+#ifdef wxHAS_GENERIC_DATAVIEWCTRL
+
+namespace
+{
+
+// Virtual list model whose rows have the height given by their values when
+// shown by HeightRenderer below.
+class HeightsListModel : public wxDataViewVirtualListModel
+{
+public:
+    HeightsListModel()
+        : wxDataViewVirtualListModel(2)
+    {
+        m_heights.push_back(50);
+        m_heights.push_back(100);
+    }
+
+    // Simulate sorting the model in the reverse order.
+    void Reverse()
+    {
+        std::swap(m_heights[0], m_heights[1]);
+    }
+
+    virtual void GetValueByRow(wxVariant& variant,
+                               unsigned int row,
+                               unsigned int WXUNUSED(col)) const override
+    {
+        variant = m_heights[row];
+    }
+
+    virtual bool SetValueByRow(const wxVariant& WXUNUSED(variant),
+                               unsigned int WXUNUSED(row),
+                               unsigned int WXUNUSED(col)) override
+    {
+        return false;
+    }
+
+private:
+    wxVector<long> m_heights;
+};
+
+class HeightRenderer : public wxDataViewCustomRenderer
+{
+public:
+    HeightRenderer()
+        : wxDataViewCustomRenderer("long"),
+          m_height(0)
+    {
+    }
+
+    virtual bool SetValue(const wxVariant& value) override
+    {
+        m_height = value.GetLong();
+        return true;
+    }
+
+    virtual bool GetValue(wxVariant& value) const override
+    {
+        value = m_height;
+        return true;
+    }
+
+    virtual wxSize GetSize() const override
+    {
+        return wxSize(50, m_height);
+    }
+
+    virtual bool Render(wxRect WXUNUSED(rect),
+                        wxDC* WXUNUSED(dc),
+                        int WXUNUSED(state)) override
+    {
+        return true;
+    }
+
+private:
+    long m_height;
+};
+
+// Tree model using small integers as item IDs, which allows to simulate the
+// IDs being reused for the new items. Its top level items are given by
+// m_top and the item 1 is a container with the single child 2, unless it's
+// replaced by a leaf item with the same ID.
+class SmallIDsModel : public wxDataViewModel
+{
+public:
+    SmallIDsModel()
+        : m_isContainer(true)
+    {
+        m_top.push_back(1);
+    }
+
+    static wxDataViewItem GetItem(wxUIntPtr id)
+    {
+        return wxDataViewItem(wxUIntToPtr(id));
+    }
+
+    // Delete the item 1 and add a leaf item with the same ID.
+    void ReplaceFirst()
+    {
+        ItemDeleted(wxDataViewItem(), GetItem(1));
+        m_isContainer = false;
+        ItemAdded(wxDataViewItem(), GetItem(1));
+    }
+
+    void AddTop(wxUIntPtr id)
+    {
+        m_top.push_back(id);
+        ItemAdded(wxDataViewItem(), GetItem(id));
+    }
+
+    virtual void GetValue(wxVariant& variant,
+                          const wxDataViewItem& item,
+                          unsigned int WXUNUSED(col)) const override
+    {
+        variant = wxString::Format("%lu", (unsigned long)GetID(item));
+    }
+
+    virtual bool SetValue(const wxVariant& WXUNUSED(variant),
+                          const wxDataViewItem& WXUNUSED(item),
+                          unsigned int WXUNUSED(col)) override
+    {
+        return false;
+    }
+
+    virtual wxDataViewItem GetParent(const wxDataViewItem& item) const override
+    {
+        return GetID(item) == 2 ? GetItem(1) : wxDataViewItem();
+    }
+
+    virtual bool IsContainer(const wxDataViewItem& item) const override
+    {
+        return !item.IsOk() || (GetID(item) == 1 && m_isContainer);
+    }
+
+    virtual unsigned int GetChildren(const wxDataViewItem& item,
+                                     wxDataViewItemArray& children) const override
+    {
+        if ( !item.IsOk() )
+        {
+            for ( size_t n = 0; n < m_top.size(); n++ )
+                children.push_back(GetItem(m_top[n]));
+        }
+        else if ( IsContainer(item) )
+        {
+            children.push_back(GetItem(2));
+        }
+
+        return children.size();
+    }
+
+private:
+    static wxUIntPtr GetID(const wxDataViewItem& item)
+    {
+        return wxPtrToUInt(item.GetID());
+    }
+
+    wxVector<wxUIntPtr> m_top;
+    bool m_isContainer;
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxDVC::BatchVirtual", "[wxDataViewCtrl][batch]")
+{
+    std::unique_ptr<wxDataViewCtrl> dvc(new wxDataViewCtrl
+                                        (
+                                            wxTheApp->GetTopWindow(),
+                                            wxID_ANY,
+                                            wxDefaultPosition,
+                                            wxSize(400, 300),
+                                            wxDV_VARIABLE_LINE_HEIGHT
+                                        ));
+
+    HeightsListModel* const model = new HeightsListModel();
+    dvc->AssociateModel(model);
+    model->DecRef();
+
+    dvc->AppendColumn(new wxDataViewColumn("height", new HeightRenderer(), 0));
+
+    const wxDataViewItem item0 = model->GetItem(0);
+    CHECK( dvc->GetItemRect(item0).height == 50 );
+
+    // The resort requested during the batch must not be lost: the rows need
+    // to be measured again once the batch ends.
+    model->BeginBatch();
+    model->Reverse();
+    model->Resort();
+    model->EndBatch();
+
+    CHECK( dvc->GetItemRect(item0).height == 100 );
+}
+
+TEST_CASE("wxDVC::BatchReusedID", "[wxDataViewCtrl][batch]")
+{
+    std::unique_ptr<wxDataViewCtrl> dvc(new wxDataViewCtrl
+                                        (
+                                            wxTheApp->GetTopWindow(),
+                                            wxID_ANY,
+                                            wxDefaultPosition,
+                                            wxSize(400, 200)
+                                        ));
+
+    SmallIDsModel* const model = new SmallIDsModel();
+    dvc->AssociateModel(model);
+    model->DecRef();
+
+    dvc->AppendTextColumn("id", 0);
+
+    const wxDataViewItem item = SmallIDsModel::GetItem(1);
+    dvc->Expand(item);
+    REQUIRE( dvc->IsExpanded(item) );
+
+    // The new item must not inherit the children and the expanded state of
+    // the deleted one just because it has the same ID.
+    model->BeginBatch();
+    model->ReplaceFirst();
+    model->EndBatch();
+
+    CHECK( !dvc->IsExpanded(item) );
+    CHECK( dvc->GetItemRect(SmallIDsModel::GetItem(2)).IsEmpty() );
+}
+
+TEST_CASE("wxDVC::BatchChangeModel", "[wxDataViewCtrl][batch]")
+{
+    std::unique_ptr<wxDataViewCtrl> dvc(new wxDataViewCtrl
+                                        (
+                                            wxTheApp->GetTopWindow(),
+                                            wxID_ANY,
+                                            wxDefaultPosition,
+                                            wxSize(400, 200)
+                                        ));
+
+    dvc->AppendTextColumn("id", 0);
+
+    wxObjectDataPtr<SmallIDsModel> model1(new SmallIDsModel());
+    dvc->AssociateModel(model1.get());
+
+    // Switching to another model during a batch must not leave the control
+    // in the batch mode forever.
+    model1->BeginBatch();
+
+    wxObjectDataPtr<SmallIDsModel> model2(new SmallIDsModel());
+    dvc->AssociateModel(model2.get());
+
+    model2->AddTop(3);
+    CHECK( !dvc->GetItemRect(SmallIDsModel::GetItem(3)).IsEmpty() );
+
+    // Ending the batch of the old model must not affect the control either.
+    model1->AddTop(4);
+    model1->EndBatch();
+    CHECK( dvc->GetItemRect(SmallIDsModel::GetItem(4)).IsEmpty() );
+
+    // And the same thing when switching back from the model in a batch.
+    model2->BeginBatch();
+    dvc->AssociateModel(model1.get());
+    model2->EndBatch();
+
+    model1->AddTop(5);
+    CHECK( !dvc->GetItemRect(SmallIDsModel::GetItem(5)).IsEmpty() );
+}
+
+#endif // wxHAS_GENERIC_DATAVIEWCTRL
+
 #if wxUSE_UIACTIONSIMULATOR
 
 TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
@@ -18,6 +18,7 @@
 
 #include "wx/grid.h"
 #include "wx/headerctrl.h"
+#include "wx/generic/private/grid.h"
 #include "testableframe.h"
 #include "asserthelper.h"
 #include "wx/uiaction.h"
@@ -1267,6 +1268,86 @@ TEST_CASE_METHOD(GridTestCase, "Grid::ColumnVisibility", "[grid]")
     CHECK( m_grid->IsColShown(1) );
 }
 
+TEST_CASE_METHOD(GridTestCase, "Grid::LinePositions", "[grid]")
+{
+    // Grid has 10 rows by default, make them all of different heights.
+    for ( int row = 0; row < 10; row++ )
+        m_grid->SetRowSize(row, 40 + row);
+
+    // Check that row positions are consistent with their sizes.
+    const auto checkRows = [this]()
+    {
+        int y = 0;
+        for ( int pos = 0; pos < m_grid->GetNumberRows(); pos++ )
+        {
+            const int row = m_grid->GetRowAt(pos);
+            INFO("Row " << row << " at position " << pos);
+
+            const int height = m_grid->IsRowShown(row) ? m_grid->GetRowSize(row)
+                                                       : 0;
+            CHECK( m_grid->CellToRect(row, 0).y == y );
+
+            if ( height )
+            {
+                CHECK( m_grid->YToRow(y) == row );
+                CHECK( m_grid->YToRow(y + height - 1) == row );
+            }
+
+            y += height;
+        }
+
+        CHECK( m_grid->YToRow(y) == wxNOT_FOUND );
+    };
+
+    checkRows();
+
+    SECTION("Resize")
+    {
+        m_grid->SetRowSize(3, 50);
+        checkRows();
+    }
+
+    SECTION("Hide")
+    {
+        m_grid->HideRow(2);
+        checkRows();
+
+        m_grid->ShowRow(2);
+        checkRows();
+    }
+
+    SECTION("InsertDelete")
+    {
+        m_grid->InsertRows(1, 3);
+        CHECK( m_grid->GetRowSize(1) == m_grid->GetDefaultRowSize() );
+        CHECK( m_grid->GetRowSize(4) == 41 );
+        checkRows();
+
+        m_grid->DeleteRows(0, 5);
+        CHECK( m_grid->GetRowSize(0) == 42 );
+        checkRows();
+
+        m_grid->AppendRows(2);
+        checkRows();
+    }
+
+    SECTION("Reorder")
+    {
+        wxArrayInt order;
+        for ( int row = 9; row >= 0; row-- )
+            order.push_back(row);
+        m_grid->SetRowsOrder(order);
+        checkRows();
+
+        m_grid->SetRowSize(9, 30);
+        m_grid->HideRow(0);
+        checkRows();
+
+        m_grid->InsertRows(5, 2);
+        checkRows();
+    }
+}
+
 TEST_CASE_METHOD(GridTestCase, "Grid::LineFormatting", "[grid]")
 {
     CHECK(m_grid->GridLinesEnabled());
@@ -1884,6 +1965,69 @@ TEST_CASE_METHOD(GridTestCase, "Grid::AutoSizeColumn", "[grid]")
     }
 }
 
+TEST_CASE_METHOD(GridTestCase, "Grid::AutoSizeMode", "[grid]")
+{
+    // Use enough rows to measure them in several threads in parallel mode.
+    m_grid->AppendRows(9990);
+    m_grid->SetColLabelValue(0, wxString());
+
+    for ( int row = 0; row < m_grid->GetNumberRows(); row++ )
+        m_grid->SetCellValue(row, 0, "W");
+
+    SECTION("Sample")
+    {
+        m_grid->SetCellValue(5000, 0, wxString('W', 20));
+
+        m_grid->AutoSizeColumn(0, false);
+        const int widthAll = m_grid->GetColSize(0);
+
+        m_grid->SetAutoSizeMode(wxGRID_AUTOSIZE_SAMPLE);
+        m_grid->SetAutoSizeSample(wxGridAutoSizeSample(10, 10, 100, false));
+        m_grid->AutoSizeColumn(0, false);
+        CHECK( m_grid->GetColSize(0) < widthAll );
+
+        m_grid->SetAutoSizeSample(wxGridAutoSizeSample(5001, 0, 0, false));
+        m_grid->AutoSizeColumn(0, false);
+        CHECK( m_grid->GetColSize(0) == widthAll );
+
+        m_grid->SetAutoSizeSample(wxGridAutoSizeSample(0, 0, 0, true));
+        m_grid->MakeCellVisible(5000, 0);
+        m_grid->AutoSizeColumn(0, false);
+        CHECK( m_grid->GetColSize(0) == widthAll );
+    }
+
+    SECTION("Parallel")
+    {
+        const wxString longStr('W', 20);
+        m_grid->SetCellValue(9000, 0, longStr);
+
+        m_grid->AutoSizeColumn(0, false);
+        const int widthAll = m_grid->GetColSize(0);
+
+        m_grid->SetAutoSizeMode(wxGRID_AUTOSIZE_PARALLEL);
+        m_grid->AutoSizeColumn(0, false);
+
+        // The width of each character may be rounded differently when it's
+        // measured on its own, so allow for a small difference.
+        CHECK( std::abs(m_grid->GetColSize(0) - widthAll)
+                <= static_cast<int>(longStr.length()) );
+    }
+
+    SECTION("Parallel with non-Latin-1 text")
+    {
+        // This text can't be measured without using wxDC, so the result must
+        // be exactly the same as without using parallel mode.
+        m_grid->SetCellValue(9000, 0, wxString(wxUniChar(0x416), 20));
+
+        m_grid->AutoSizeColumn(0, false);
+        const int widthAll = m_grid->GetColSize(0);
+
+        m_grid->SetAutoSizeMode(wxGRID_AUTOSIZE_PARALLEL);
+        m_grid->AutoSizeColumn(0, false);
+        CHECK( m_grid->GetColSize(0) == widthAll );
+    }
+}
+
 TEST_CASE_METHOD(GridTestCase, "Grid::DrawInvalidCell", "[grid][multicell]")
 {
     // Set up a multicell with inside an overflowing cell.
@@ -1910,6 +2054,124 @@ TEST_CASE_METHOD(GridTestCase, "Grid::DrawInvalidCell", "[grid][multicell]")
     wxYield();
 }
 
+TEST_CASE_METHOD(GridTestCase, "Grid::DeferredRefresh", "[grid]")
+{
+    m_grid->EnableDeferredRefresh();
+    REQUIRE( m_grid->IsDeferredRefreshEnabled() );
+
+    m_grid->UseBackBuffer();
+    REQUIRE( m_grid->IsUsingBackBuffer() );
+
+    WaitForPaint waitForPaint(m_grid->GetGridWindow());
+
+    for ( int n = 0; n < 100; n++ )
+        m_grid->SetCellValue(n % 10, n % 2, wxString::Format("%d", n));
+
+    CHECK( m_grid->GetCellValue(9, 1) == "99" );
+
+    m_grid->FlushDeferredRefresh();
+    m_grid->Update();
+    waitForPaint.YieldUntilPainted();
+
+    // Check that disabling the features at run-time works too.
+    m_grid->SetCellValue(0, 0, "Last");
+    m_grid->EnableDeferredRefresh(false);
+    m_grid->UseBackBuffer(false);
+    CHECK( !m_grid->IsDeferredRefreshEnabled() );
+    CHECK( !m_grid->IsUsingBackBuffer() );
+
+    m_grid->Update();
+    wxYield();
+}
+
+TEST_CASE_METHOD(GridTestCase, "Grid::DamageBlocks", "[grid]")
+{
+    m_grid->AppendCols(8);
+
+    wxGridDamage damage;
+    CHECK( damage.TakeBlocks(*m_grid).empty() );
+
+    SECTION("Single cell")
+    {
+        damage.AddCell(3, 4);
+        damage.AddCell(3, 4);
+
+        const wxVector<wxGridBlockCoords> blocks = damage.TakeBlocks(*m_grid);
+        REQUIRE( blocks.size() == 1 );
+        CHECK( blocks[0] == wxGridBlockCoords(3, 4, 3, 4) );
+        CHECK( damage.IsEmpty() );
+    }
+
+    SECTION("Rectangle")
+    {
+        // Add the cells in the order not corresponding to their positions.
+        for ( int col = 5; col >= 2; col-- )
+        {
+            for ( int row = 1; row <= 3; row++ )
+                damage.AddCell(row, col);
+        }
+
+        const wxVector<wxGridBlockCoords> blocks = damage.TakeBlocks(*m_grid);
+        REQUIRE( blocks.size() == 1 );
+        CHECK( blocks[0] == wxGridBlockCoords(1, 2, 3, 5) );
+    }
+
+    SECTION("Disjoint")
+    {
+        damage.AddCell(0, 0);
+        damage.AddCell(0, 1);
+        damage.AddCell(0, 5);
+        damage.AddCell(1, 0);
+        damage.AddCell(1, 1);
+        damage.AddCell(2, 5);
+
+        const wxVector<wxGridBlockCoords> blocks = damage.TakeBlocks(*m_grid);
+        REQUIRE( blocks.size() == 3 );
+        CHECK( blocks[0] == wxGridBlockCoords(0, 0, 1, 1) );
+        CHECK( blocks[1] == wxGridBlockCoords(0, 5, 0, 5) );
+        CHECK( blocks[2] == wxGridBlockCoords(2, 5, 2, 5) );
+    }
+
+    SECTION("Rows")
+    {
+        damage.AddCell(4, 3);
+        damage.AddRow(4);
+        damage.AddRow(5);
+        damage.AddCell(6, 0);
+
+        const wxVector<wxGridBlockCoords> blocks = damage.TakeBlocks(*m_grid);
+        REQUIRE( blocks.size() == 2 );
+        CHECK( blocks[0] == wxGridBlockCoords(4, 0, 5, 9) );
+        CHECK( blocks[1] == wxGridBlockCoords(6, 0, 6, 0) );
+    }
+
+    SECTION("Reordered")
+    {
+        // Columns 7 and 2 become adjacent after reordering.
+        wxArrayInt order;
+        for ( int col = 0; col < 10; col++ )
+            order.push_back(col);
+        order[3] = 7;
+        order[7] = 3;
+        m_grid->SetColumnsOrder(order);
+
+        damage.AddCell(0, 2);
+        damage.AddCell(0, 7);
+
+        const wxVector<wxGridBlockCoords> blocks = damage.TakeBlocks(*m_grid);
+        REQUIRE( blocks.size() == 1 );
+        CHECK( blocks[0] == wxGridBlockCoords(0, 2, 0, 3) );
+    }
+
+    SECTION("Deleted")
+    {
+        damage.AddCell(9, 9);
+        m_grid->DeleteRows(5, 5);
+
+        CHECK( damage.TakeBlocks(*m_grid).empty() );
+    }
+}
+
 #define CHECK_ATTR_COUNT(n) CHECK( m_grid->GetCellAttrCount() == n )
 
 TEST_CASE_METHOD(GridTestCase, "Grid::CellAttribute", "[attr][cell][grid]")
@@ -2003,6 +2265,168 @@ TEST_CASE_METHOD(GridTestCase, "Grid::CellAttribute", "[attr][cell][grid]")
     }
 }
 
+TEST_CASE("GridCellAttrData::Runs", "[grid][attr]")
+{
+    wxGridCellAttrData data;
+
+    // Use the same attribute for the first 10 rows of the first 2 columns.
+    wxGridCellAttr* const attr = new wxGridCellAttr;
+    for ( int col = 0; col < 2; col++ )
+    {
+        for ( int row = 0; row < 10; row++ )
+        {
+            attr->IncRef();
+            data.SetAttr(attr, row, col);
+        }
+    }
+
+    // There must be only a single reference to the attribute per column.
+    CHECK( data.GetRunsCount() == 2 );
+    CHECK( attr->GetRefCount() == 3 );
+
+    wxGridCellAttr* const other = new wxGridCellAttr;
+    data.SetAttr(other, 5, 0);
+    CHECK( data.GetRunsCount() == 4 );
+    CHECK( attr->GetRefCount() == 4 );
+
+    wxGridCellAttr* got = data.GetAttr(5, 0);
+    CHECK( got == other );
+    got->DecRef();
+
+    SECTION("Reset")
+    {
+        attr->IncRef();
+        data.SetAttr(attr, 5, 0);
+        CHECK( data.GetRunsCount() == 2 );
+        CHECK( attr->GetRefCount() == 3 );
+
+        data.SetAttr(nullptr, 0, 1);
+        data.SetAttr(nullptr, 9, 1);
+        CHECK( data.GetRunsCount() == 2 );
+
+        got = data.GetAttr(0, 1);
+        CHECK( !got );
+    }
+
+    SECTION("InsertRows")
+    {
+        data.UpdateAttrRows(3, 2);
+        CHECK( data.GetRunsCount() == 6 );
+
+        got = data.GetAttr(3, 1);
+        CHECK( !got );
+
+        got = data.GetAttr(7, 0);
+        CHECK( got == other );
+        got->DecRef();
+
+        got = data.GetAttr(11, 1);
+        CHECK( got == attr );
+        got->DecRef();
+
+        got = data.GetAttr(12, 1);
+        CHECK( !got );
+    }
+
+    SECTION("DeleteRows")
+    {
+        // Deleting the row with the other attribute merges the runs again.
+        data.UpdateAttrRows(5, -1);
+        CHECK( data.GetRunsCount() == 2 );
+        CHECK( attr->GetRefCount() == 3 );
+
+        got = data.GetAttr(8, 0);
+        CHECK( got == attr );
+        got->DecRef();
+
+        got = data.GetAttr(9, 0);
+        CHECK( !got );
+
+        data.UpdateAttrRows(0, -20);
+        CHECK( data.GetRunsCount() == 0 );
+        CHECK( attr->GetRefCount() == 1 );
+    }
+
+    SECTION("InsertDeleteCols")
+    {
+        data.UpdateAttrCols(1, 3);
+
+        got = data.GetAttr(4, 4);
+        CHECK( got == attr );
+        got->DecRef();
+
+        data.UpdateAttrCols(0, -4);
+        CHECK( data.GetRunsCount() == 1 );
+
+        got = data.GetAttr(0, 0);
+        CHECK( got == attr );
+        got->DecRef();
+    }
+
+    attr->DecRef();
+}
+
+TEST_CASE("GridCellAttrData::MergeEqual", "[grid][attr]")
+{
+    wxGridCellAttrData data;
+
+    // Fill the column in descending order with different, but equal,
+    // attributes: they must all be merged into a single run.
+    for ( int row = 999; row >= 0; row-- )
+    {
+        wxGridCellAttr* const attr = new wxGridCellAttr;
+        attr->SetBackgroundColour(*wxRED);
+        data.SetAttr(attr, row, 0);
+    }
+
+    CHECK( data.GetRunsCount() == 1 );
+
+    // An attribute which is referenced elsewhere can't be merged.
+    wxGridCellAttr* const held = new wxGridCellAttr;
+    held->SetBackgroundColour(*wxRED);
+    held->IncRef();
+    data.SetAttr(held, 1000, 0);
+    CHECK( data.GetRunsCount() == 2 );
+    held->DecRef();
+
+    // Modifying the attribute of a single cell must not affect the others.
+    wxGridCellAttr* own = data.GetOwnAttr(500, 0);
+    REQUIRE( own );
+    own->SetBackgroundColour(*wxBLUE);
+    own->DecRef();
+    CHECK( data.GetRunsCount() == 4 );
+
+    wxGridCellAttr* got = data.GetAttr(499, 0);
+    CHECK( got->GetBackgroundColour() == *wxRED );
+    got->DecRef();
+
+    got = data.GetAttr(500, 0);
+    CHECK( got->GetBackgroundColour() == *wxBLUE );
+    got->DecRef();
+
+    // Once it becomes equal again, it is merged when a neighbour changes.
+    own = data.GetOwnAttr(500, 0);
+    own->SetBackgroundColour(*wxRED);
+    own->DecRef();
+
+    wxGridCellAttr* const attr = new wxGridCellAttr;
+    attr->SetBackgroundColour(*wxRED);
+    data.SetAttr(attr, 501, 0);
+    CHECK( data.GetRunsCount() == 1 );
+}
+
+TEST_CASE_METHOD(GridTestCase, "Grid::CellAttrMerge", "[grid][attr]")
+{
+    for ( int row = 0; row < m_grid->GetNumberRows(); row++ )
+        m_grid->SetCellBackgroundColour(row, 0, *wxRED);
+
+    m_grid->SetCellBackgroundColour(1, 0, *wxBLUE);
+
+    CHECK( m_grid->GetCellBackgroundColour(0, 0) == *wxRED );
+    CHECK( m_grid->GetCellBackgroundColour(1, 0) == *wxBLUE );
+    CHECK( m_grid->GetCellBackgroundColour(2, 0) == *wxRED );
+}
+
 namespace SetTable_ClearAttrCache
 {
 
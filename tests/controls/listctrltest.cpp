@@ -21,6 +21,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/listctrl.h"
+#include "wx/generic/listctrl.h"
 #include "wx/artprov.h"
 #include "wx/imaglist.h"
 #include "listbasetest.h"
@@ -126,6 +127,108 @@ TEST_CASE_METHOD(ListCtrlTestCase, "ListCtrl::SubitemRect", "[listctrl]")
     CHECK(rectLabel.GetRight() == rectItem.GetRight());
 }
 
+TEST_CASE("ListCtrl::SortByColumn", "[listctrl]")
+{
+    std::unique_ptr<wxGenericListCtrl>
+        listPtr(new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                      wxDefaultPosition, wxSize(400, 200),
+                                      wxLC_REPORT));
+    wxGenericListCtrl* const list = listPtr.get();
+
+    list->InsertColumn(0, "Name");
+    list->InsertColumn(1, "Size");
+
+    EventCounter inserted(list, wxEVT_LIST_INSERT_ITEM);
+
+    const auto makeRow = [](const wxString& name, const wxString& size)
+    {
+        wxArrayString row;
+        row.push_back(name);
+        row.push_back(size);
+        return row;
+    };
+
+    const auto getNames = [list]()
+    {
+        wxString names;
+        for ( int n = 0; n < list->GetItemCount(); n++ )
+        {
+            if ( n )
+                names += ' ';
+            names += list->GetItemText(n);
+        }
+        return names;
+    };
+
+    wxVector<wxArrayString> rows;
+    rows.push_back(makeRow("b", "10"));
+    rows.push_back(makeRow("C", "9"));
+    rows.push_back(makeRow("a", "10"));
+    rows.push_back(makeRow("d", "n/a"));
+    list->AppendItems(rows);
+
+    CHECK( inserted.GetCount() == 4 );
+    inserted.Clear();
+
+    CHECK( getNames() == "b C a d" );
+    CHECK( list->GetItemText(1, 1) == "9" );
+
+    // Sorting is case-sensitive by default.
+    CHECK( list->SortItemsByColumn(0) );
+    CHECK( getNames() == "C a b d" );
+
+    CHECK( list->SortItemsByColumn(0, wxLIST_SORT_NOCASE) );
+    CHECK( getNames() == "a b C d" );
+
+    // Sorting is stable and non-numbers come first.
+    CHECK( list->SortItemsByColumn(1, wxLIST_SORT_NUMERIC) );
+    CHECK( getNames() == "d C a b" );
+
+    CHECK( list->SortItemsByColumn(1, wxLIST_SORT_NUMERIC |
+                                      wxLIST_SORT_DESCENDING) );
+    CHECK( getNames() == "a b C d" );
+
+    // New items are inserted at their sorted positions and moved to their
+    // new positions when their value in the sort column changes.
+    CHECK( list->InsertItem(0, "e") == 4 );
+    CHECK( getNames() == "a b C d e" );
+    CHECK( inserted.GetCount() == 1 );
+    inserted.Clear();
+
+    list->SetItem(4, 1, "50");
+    CHECK( getNames() == "e a b C d" );
+
+    list->SetItem(0, 1, "9");
+    CHECK( getNames() == "a b C e d" );
+
+    // Changing the other columns doesn't move the items.
+    list->SetItem(3, 0, "z");
+    CHECK( getNames() == "a b C z d" );
+    list->SetItem(3, 0, "e");
+
+    rows.clear();
+    rows.push_back(makeRow("f", "1"));
+    rows.push_back(makeRow("g", "100"));
+    rows.push_back(makeRow("h", "10"));
+    list->AppendItems(rows);
+    CHECK( getNames() == "g a b h C e f d" );
+    CHECK( inserted.GetCount() == 3 );
+
+    // Inserting a column before the sort one doesn't change the sort order.
+    list->InsertColumn(0, "Extra");
+    list->InsertItem(0, "");
+    CHECK( list->GetItemCount() == 9 );
+    CHECK( list->GetItemText(8, 1) == "" );
+    list->DeleteColumn(0);
+
+    // Items are not kept sorted any more after resetting the sort column.
+    CHECK( list->SortItemsByColumn(wxNOT_FOUND) );
+    list->InsertItem(0, "i");
+    CHECK( list->GetItemText(0) == "i" );
+
+    WX_ASSERT_FAILS_WITH_ASSERT( list->SortItemsByColumn(2) );
+}
+
 TEST_CASE_METHOD(ListCtrlTestCase, "ListCtrl::ColumnCount", "[listctrl]")
 {
     CHECK(m_list->GetColumnCount() == 0);
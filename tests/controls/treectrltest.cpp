@@ -687,6 +687,89 @@ TEST_CASE_METHOD(TreeCtrlTestCase, "wxTreeCtrl::Scroll", "[treectrl]")
     m_tree->ScrollTo(m_root);
 }
 
+TEST_CASE_METHOD(TreeCtrlTestCase, "wxTreeCtrl::ItemRect", "[treectrl]")
+{
+    wxRect rectRoot, rectChild1, rectGrandchild, rectChild2;
+    REQUIRE(m_tree->GetBoundingRect(m_root, rectRoot));
+    REQUIRE(m_tree->GetBoundingRect(m_child1, rectChild1));
+    REQUIRE(m_tree->GetBoundingRect(m_grandchild, rectGrandchild));
+    REQUIRE(m_tree->GetBoundingRect(m_child2, rectChild2));
+
+    CHECK(rectRoot.y < rectChild1.y);
+    CHECK(rectChild1.y < rectGrandchild.y);
+    CHECK(rectGrandchild.y < rectChild2.y);
+
+    int flags = 0;
+    CHECK(m_tree->HitTest(rectChild2.GetPosition() + wxPoint(2, 2), flags)
+            == m_child2);
+
+    // The items below the collapsed one must move up.
+    m_tree->Collapse(m_child1);
+
+    wxRect rect;
+    REQUIRE(m_tree->GetBoundingRect(m_child2, rect));
+    CHECK(rect.y == rectGrandchild.y);
+
+    flags = 0;
+    CHECK(m_tree->HitTest(rect.GetPosition() + wxPoint(2, 2), flags)
+            == m_child2);
+
+    // And the items after the inserted one must move down.
+    const wxTreeItemId first = m_tree->InsertItem(m_root, 0, "first");
+
+    REQUIRE(m_tree->GetBoundingRect(first, rect));
+    CHECK(rect.y == rectChild1.y);
+
+    REQUIRE(m_tree->GetBoundingRect(m_child1, rect));
+    CHECK(rect.y == rectGrandchild.y);
+
+    // Expanding the item moves them down again.
+    m_tree->Expand(m_child1);
+
+    REQUIRE(m_tree->GetBoundingRect(m_child2, rect));
+    CHECK(rect.y > rectChild2.y);
+
+    m_tree->Delete(first);
+
+    REQUIRE(m_tree->GetBoundingRect(m_child2, rect));
+    CHECK(rect.y == rectChild2.y);
+}
+
+#ifdef wxHAS_GENERIC_TREECTRL
+
+TEST_CASE_METHOD(TreeCtrlTestCase, "wxTreeCtrl::LayoutWidth", "[treectrl]")
+{
+    const int width = m_tree->GetVirtualSize().x;
+
+    // Thawing the tree lays out the visible items and updates the scrollbars.
+    m_tree->Freeze();
+    const wxTreeItemId wide = m_tree->AppendItem(m_grandchild,
+                                                 wxString('W', 200));
+    m_tree->Expand(m_grandchild);
+    m_tree->Thaw();
+
+    CHECK(m_tree->GetVirtualSize().x > width);
+
+    // The scrollbars must shrink again once the wide item is hidden...
+    m_tree->Collapse(m_child1);
+    CHECK(m_tree->GetVirtualSize().x == width);
+
+    m_tree->Freeze();
+    m_tree->Expand(m_child1);
+    m_tree->Thaw();
+
+    CHECK(m_tree->GetVirtualSize().x > width);
+
+    // ... or deleted.
+    m_tree->Freeze();
+    m_tree->Delete(wide);
+    m_tree->Thaw();
+
+    CHECK(m_tree->GetVirtualSize().x == width);
+}
+
+#endif // wxHAS_GENERIC_TREECTRL
+
 TEST_CASE_METHOD(TreeCtrlTestCase, "wxTreeCtrl::Sort", "[treectrl]")
 {
     wxTreeItemId zitem = m_tree->AppendItem(m_root, "zzzz");
@@ -15,6 +15,12 @@
 
 #include "wx/event.h"
 
+#if wxUSE_THREADS
+    #include "wx/app.h"
+
+    #include <thread>
+#endif // wxUSE_THREADS
+
 // ----------------------------------------------------------------------------
 // test events and their handlers
 // ----------------------------------------------------------------------------
@@ -510,6 +516,197 @@ TEST_CASE("Event::UnbindFromHandler", "[event][bind][unbind]")
     handler.ProcessEvent(e);
 }
 
+// Records the calls of its handlers in the order in which they're called.
+class Recorder
+{
+public:
+    void OnAny(MyEvent& event) { Add("any", event); }
+    void OnId(MyEvent& event) { Add(wxString::Format("%d", event.GetId()), event); }
+    void OnRange(MyEvent& event) { Add("range", event); }
+    void OnLast(MyEvent& event) { Add("last", event); }
+
+    wxString m_calls;
+
+private:
+    void Add(const wxString& call, MyEvent& event)
+    {
+        if ( !m_calls.empty() )
+            m_calls += ' ';
+        m_calls += call;
+
+        event.Skip();
+    }
+};
+
+TEST_CASE("Event::BindMany", "[event][bind]")
+{
+    // Bind enough handlers to use the index of the dynamic event table.
+    MyHandler handler;
+    Recorder rec;
+
+    handler.Bind(MyEventType, &Recorder::OnAny, &rec);
+    for ( int id = 1; id <= 40; id++ )
+        handler.Bind(MyEventType, &Recorder::OnId, &rec, id);
+    handler.Bind(MyEventType, &Recorder::OnRange, &rec, 10, 20);
+    handler.Bind(wxEVT_IDLE, &MyHandler::OnIdle, &handler);
+    handler.Bind(MyEventType, &Recorder::OnLast, &rec, 15);
+
+    const auto send = [&handler, &rec](int id)
+    {
+        rec.m_calls.clear();
+
+        MyEvent e;
+        e.SetId(id);
+        handler.ProcessEvent(e);
+
+        return rec.m_calls;
+    };
+
+    // The handlers must be called in the reverse order of binding them.
+    CHECK( send(15) == "last range 15 any" );
+    CHECK( send(5) == "5 any" );
+    CHECK( send(41) == "any" );
+
+    CHECK( handler.Unbind(MyEventType, &Recorder::OnRange, &rec, 10, 20) );
+    CHECK( send(15) == "last 15 any" );
+    CHECK( send(20) == "20 any" );
+
+    handler.Bind(MyEventType, &Recorder::OnRange, &rec, 30, 50);
+    CHECK( send(41) == "range any" );
+    CHECK( send(30) == "range 30 any" );
+
+    CHECK( handler.Unbind(MyEventType, &Recorder::OnId, &rec, 30) );
+    CHECK( send(30) == "range any" );
+    CHECK( send(29) == "29 any" );
+
+    // Binding and unbinding the handlers for an event which is never sent
+    // must not affect the other ones when the unbound entries are removed.
+    for ( int n = 0; n < 100; n++ )
+    {
+        handler.Bind(wxEVT_IDLE, &MyHandler::OnIdle, &handler);
+        CHECK( handler.Unbind(wxEVT_IDLE, &MyHandler::OnIdle, &handler) );
+    }
+
+    CHECK( send(30) == "range any" );
+    CHECK( send(29) == "29 any" );
+
+    // Neither must unbinding many handlers at once.
+    for ( int id = 1; id <= 20; id++ )
+        CHECK( handler.Unbind(MyEventType, &Recorder::OnId, &rec, id) );
+
+    CHECK( send(15) == "last any" );
+    CHECK( send(5) == "any" );
+    CHECK( send(21) == "21 any" );
+}
+
+#if wxUSE_THREADS
+
+TEST_CASE("Event::QueueFromThreads", "[event][queue]")
+{
+    static const int NUM_THREADS = 8;
+    static const int NUM_EVENTS = 1000;
+
+    wxEvtHandler handler;
+
+    // The events queued by each thread must be processed in order.
+    std::vector<int> last(NUM_THREADS, -1);
+    int count = 0;
+    bool ordered = true;
+    handler.Bind(wxEVT_THREAD, [&](wxThreadEvent& event)
+    {
+        int& prev = last[event.GetExtraLong()];
+        if ( event.GetInt() != prev + 1 )
+            ordered = false;
+        prev = event.GetInt();
+        count++;
+    });
+
+    std::atomic<int> done(0);
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < NUM_THREADS; t++ )
+    {
+        threads.emplace_back([&handler, &done, t]()
+        {
+            for ( int n = 0; n < NUM_EVENTS; n++ )
+            {
+                wxThreadEvent* const event = new wxThreadEvent();
+                event->SetExtraLong(t);
+                event->SetInt(n);
+                handler.QueueEvent(event);
+            }
+
+            done++;
+        });
+    }
+
+    // Process the events while they're still being queued.
+    while ( done < NUM_THREADS )
+        wxTheApp->ProcessPendingEvents();
+
+    for ( auto& thread : threads )
+        thread.join();
+
+    wxTheApp->ProcessPendingEvents();
+
+    CHECK( count == NUM_THREADS*NUM_EVENTS );
+    CHECK( ordered );
+    CHECK( !wxTheApp->HasPendingEvents() );
+
+    // Check that the handler can still get new events after this.
+    wxThreadEvent* const event = new wxThreadEvent();
+    event->SetInt(NUM_EVENTS);
+    handler.QueueEvent(event);
+    CHECK( wxTheApp->HasPendingEvents() );
+
+    wxTheApp->ProcessPendingEvents();
+    CHECK( count == NUM_THREADS*NUM_EVENTS + 1 );
+    CHECK( ordered );
+}
+
+TEST_CASE("Event::QueueCoalescable", "[event][queue]")
+{
+    wxEvtHandler handler;
+
+    wxString received;
+    handler.Bind(wxEVT_THREAD, [&received](wxThreadEvent& event)
+    {
+        if ( !received.empty() )
+            received += ' ';
+        received += wxString::Format("%d:%d", event.GetId(), event.GetInt());
+    });
+
+    const auto queue = [&handler](int id, int value, bool coalescable)
+    {
+        wxThreadEvent* const event = new wxThreadEvent(wxEVT_THREAD, id);
+        event->SetInt(value);
+        event->SetCoalescable(coalescable);
+        handler.QueueEvent(event);
+    };
+
+    // The newer coalescable events replace the older ones with the same id,
+    // at their position, but not the non-coalescable events.
+    queue(1, 1, true);
+    queue(2, 1, true);
+    queue(1, 2, true);
+    queue(3, 1, false);
+    queue(1, 3, true);
+    queue(3, 2, false);
+    queue(2, 2, true);
+
+    wxTheApp->ProcessPendingEvents();
+    CHECK( received == "1:3 2:2 3:1 3:2" );
+
+    // Once the event is processed, the new events are queued again.
+    received.clear();
+    queue(1, 4, true);
+    queue(1, 5, true);
+
+    wxTheApp->ProcessPendingEvents();
+    CHECK( received == "1:5" );
+}
+
+#endif // wxUSE_THREADS
+
 // This is a compilation-time-only test: just check that a class inheriting
 // from wxEvtHandler non-publicly can use Bind() with its method, this used to
 // result in compilation errors.
@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/events/iouringdispatcher.cpp
+// Purpose:     Tests for the io_uring-based wxFDIODispatcher
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#include "wx/unix/private/iouringdispatcher.h"
+
+#ifdef wxHAS_IO_URING_DISPATCHER
+
+#ifndef WX_PRECOMP
+    #include "wx/log.h"
+    #include "wx/utils.h"
+#endif // WX_PRECOMP
+
+#include <memory>
+
+#if wxUSE_THREADS
+    #include <thread>
+#endif // wxUSE_THREADS
+
+#include <unistd.h>
+
+// ----------------------------------------------------------------------------
+// helper classes
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Owns both ends of a pipe.
+class Pipe
+{
+public:
+    Pipe()
+    {
+        if ( pipe(m_fds) != 0 )
+            m_fds[0] = m_fds[1] = -1;
+    }
+
+    ~Pipe()
+    {
+        Close(0);
+        Close(1);
+    }
+
+    bool IsOk() const { return m_fds[0] != -1; }
+
+    int GetReadFD() const { return m_fds[0]; }
+    int GetWriteFD() const { return m_fds[1]; }
+
+    void Close(int n)
+    {
+        if ( m_fds[n] != -1 )
+        {
+            close(m_fds[n]);
+            m_fds[n] = -1;
+        }
+    }
+
+private:
+    int m_fds[2];
+};
+
+// Handler counting the notifications it gets and reading all the data
+// available from the descriptor when it becomes readable.
+class CountingHandler : public wxFDIOHandler
+{
+public:
+    explicit CountingHandler(int fd)
+        : m_fd(fd)
+    {
+    }
+
+    virtual void OnReadWaiting() override
+    {
+        numRead++;
+
+        char buf[64];
+        const ssize_t rc = read(m_fd, buf, sizeof(buf));
+        if ( rc > 0 )
+            data += wxString::FromAscii(buf, rc);
+    }
+
+    virtual void OnWriteWaiting() override
+    {
+        numWrite++;
+    }
+
+    virtual void OnExceptionWaiting() override
+    {
+        numException++;
+    }
+
+    int numRead = 0;
+    int numWrite = 0;
+    int numException = 0;
+    wxString data;
+
+private:
+    const int m_fd;
+};
+
+// Create the dispatcher or return nullptr if io_uring is not available.
+wxIoUringDispatcher* CreateDispatcher()
+{
+    // don't show errors about io_uring not being supported
+    wxLogNull noLog;
+
+    wxIoUringDispatcher* const dispatcher = wxIoUringDispatcher::Create();
+    if ( !dispatcher )
+        WARN("Skipping test as io_uring is not available.");
+
+    return dispatcher;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// tests themselves
+// ----------------------------------------------------------------------------
+
+TEST_CASE("wxIoUringDispatcher::Pipe", "[fdiodispatcher][iouring]")
+{
+    std::unique_ptr<wxIoUringDispatcher> dispatcher(CreateDispatcher());
+    if ( !dispatcher )
+        return;
+
+    Pipe pipe;
+    REQUIRE( pipe.IsOk() );
+
+    CountingHandler reader(pipe.GetReadFD());
+    REQUIRE( dispatcher->RegisterFD(pipe.GetReadFD(), &reader, wxFDIO_INPUT) );
+
+    // Nothing happens before anything is written.
+    CHECK( !dispatcher->HasPending() );
+    CHECK( dispatcher->Dispatch(0) == 0 );
+    CHECK( reader.numRead == 0 );
+
+    REQUIRE( write(pipe.GetWriteFD(), "a", 1) == 1 );
+    CHECK( dispatcher->Dispatch(1000) == 1 );
+    CHECK( reader.numRead == 1 );
+    CHECK( reader.data == "a" );
+
+    // Poll requests are one-shot, check that the descriptor was re-armed.
+    REQUIRE( write(pipe.GetWriteFD(), "bc", 2) == 2 );
+    CHECK( dispatcher->Dispatch(1000) == 1 );
+    CHECK( reader.numRead == 2 );
+    CHECK( reader.data == "abc" );
+
+    // The write end is writable immediately.
+    CountingHandler writer(pipe.GetWriteFD());
+    REQUIRE( dispatcher->RegisterFD(pipe.GetWriteFD(), &writer, wxFDIO_OUTPUT) );
+    CHECK( dispatcher->Dispatch(1000) == 1 );
+    CHECK( writer.numWrite == 1 );
+    CHECK( reader.numRead == 2 );
+    CHECK( dispatcher->UnregisterFD(pipe.GetWriteFD()) );
+
+    // Closing the write end makes the read end readable (at EOF).
+    CHECK( dispatcher->Dispatch(0) == 0 );
+    pipe.Close(1);
+    CHECK( dispatcher->Dispatch(1000) == 1 );
+    CHECK( reader.numRead == 3 );
+    CHECK( writer.numWrite == 1 );
+
+    // And nothing is reported after unregistering the descriptor.
+    CHECK( dispatcher->UnregisterFD(pipe.GetReadFD()) );
+    CHECK( dispatcher->Dispatch(0) == 0 );
+    CHECK( reader.numRead == 3 );
+}
+
+TEST_CASE("wxIoUringDispatcher::Error", "[fdiodispatcher][iouring]")
+{
+    std::unique_ptr<wxIoUringDispatcher> dispatcher(CreateDispatcher());
+    if ( !dispatcher )
+        return;
+
+    Pipe pipe;
+    REQUIRE( pipe.IsOk() );
+
+    // Close the descriptor before the poll request for it is submitted to
+    // make it fail: the handler must be told about it.
+    CountingHandler handler(pipe.GetReadFD());
+    REQUIRE( dispatcher->RegisterFD(pipe.GetReadFD(), &handler, wxFDIO_INPUT) );
+    const int fd = pipe.GetReadFD();
+    pipe.Close(0);
+
+    {
+        wxLogNull noLog;
+        CHECK( dispatcher->Dispatch(1000) == 1 );
+    }
+
+    CHECK( handler.numException == 1 );
+    CHECK( handler.numRead == 0 );
+
+    CHECK( dispatcher->UnregisterFD(fd) );
+}
+
+#if wxUSE_THREADS
+
+TEST_CASE("wxIoUringDispatcher::Threads", "[fdiodispatcher][iouring]")
+{
+    std::unique_ptr<wxIoUringDispatcher> dispatcher(CreateDispatcher());
+    if ( !dispatcher )
+        return;
+
+    Pipe pipe;
+    REQUIRE( pipe.IsOk() );
+
+    // Registering a descriptor from another thread while Dispatch() is
+    // blocked must take effect immediately, as with epoll.
+    CountingHandler writer(pipe.GetWriteFD());
+    std::thread thread([&dispatcher, &pipe, &writer]()
+    {
+        wxMilliSleep(100);
+        dispatcher->RegisterFD(pipe.GetWriteFD(), &writer, wxFDIO_OUTPUT);
+    });
+
+    const int numEvents = dispatcher->Dispatch(2000);
+    thread.join();
+
+    CHECK( numEvents == 1 );
+    CHECK( writer.numWrite == 1 );
+
+    CHECK( dispatcher->UnregisterFD(pipe.GetWriteFD()) );
+}
+
+#endif // wxUSE_THREADS
+
+#endif // wxHAS_IO_URING_DISPATCHER
@@ -43,6 +43,8 @@
 
 #include "testimage.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 
 #define CHECK_EQUAL_COLOUR_RGB(c1, c2) \
@@ -211,6 +213,197 @@ TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadFromZipStream", "[image]")
     }
 }
 
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadAnyFromZipStream", "[image]")
+{
+    for ( const auto& file : g_testfiles )
+    {
+        // Only these handlers can recognize the format using just the header
+        // and load images from non-seekable streams.
+        switch ( file.type )
+        {
+            case wxBITMAP_TYPE_BMP:
+            case wxBITMAP_TYPE_ICO:
+            case wxBITMAP_TYPE_CUR:
+            case wxBITMAP_TYPE_JPEG:
+            case wxBITMAP_TYPE_PNG:
+                break;
+
+            default:
+                continue;
+        }
+
+        INFO("Loading " << file.file);
+
+        wxMemoryOutputStream memOut;
+        {
+            wxFileInputStream fileIn(file.file);
+            REQUIRE(fileIn.IsOk());
+
+            wxZlibOutputStream compressFilter(memOut, 5, wxZLIB_GZIP);
+            fileIn.Read(compressFilter);
+        }
+
+        wxMemoryInputStream memIn(memOut);
+        wxZlibInputStream decompressFilter(memIn, wxZLIB_GZIP);
+        REQUIRE( !decompressFilter.IsSeekable() );
+
+        wxImage img;
+        REQUIRE( img.LoadFile(decompressFilter) );
+        CHECK( img.GetType() == file.type );
+        CHECK_THAT( img, RGBSameAs(wxImage(file.file, file.type)) );
+    }
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::FindHandler", "[image]")
+{
+    // Check that the results are the same as with the linear search.
+    const wxList& handlers = wxImage::GetHandlers();
+    for ( wxList::compatibility_iterator node = handlers.GetFirst();
+          node;
+          node = node->GetNext() )
+    {
+        wxImageHandler* const handler = (wxImageHandler*)node->GetData();
+        INFO("Handler " << handler->GetName());
+
+        CHECK( wxImage::FindHandler(handler->GetName()) == handler );
+        CHECK( wxImage::FindHandler(handler->GetType()) == handler );
+        CHECK( wxImage::FindHandlerMime(handler->GetMimeType()) == handler );
+        CHECK( wxImage::FindHandlerMime(handler->GetMimeType().Upper()) == handler );
+        CHECK( wxImage::FindHandler(handler->GetExtension(),
+                                    handler->GetType()) == handler );
+        CHECK( wxImage::FindHandler(handler->GetExtension(),
+                                    wxBITMAP_TYPE_ANY) == handler );
+
+        for ( const wxString& ext : handler->GetAltExtensions() )
+        {
+            CHECK( wxImage::FindHandler(ext.Upper(),
+                                        handler->GetType()) == handler );
+        }
+    }
+
+    CHECK( wxImage::FindHandler("no such handler") == nullptr );
+    CHECK( wxImage::FindHandler("png", wxBITMAP_TYPE_BMP) == nullptr );
+    CHECK( wxImage::FindHandler("PNG", wxBITMAP_TYPE_PNG) == nullptr );
+    CHECK( wxImage::FindHandler("jpeg", wxBITMAP_TYPE_ANY) ==
+                wxImage::FindHandler(wxBITMAP_TYPE_JPEG) );
+    CHECK( wxImage::FindHandlerMime("image/no-such-type") == nullptr );
+
+    // Check that the index is updated when the handlers change.
+    REQUIRE( wxImage::RemoveHandler(wxImage::FindHandler(wxBITMAP_TYPE_PCX)->GetName()) );
+    CHECK( wxImage::FindHandler(wxBITMAP_TYPE_PCX) == nullptr );
+    CHECK( wxImage::FindHandler("pcx", wxBITMAP_TYPE_ANY) == nullptr );
+
+    wxImage::AddHandler(new wxPCXHandler);
+    CHECK( wxImage::FindHandler("pcx", wxBITMAP_TYPE_ANY) ==
+                wxImage::FindHandler(wxBITMAP_TYPE_PCX) );
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::CanReadHeader", "[image]")
+{
+    const unsigned char png[] = { 0x89, 'P', 'N', 'G', '\r', '\n' };
+    const unsigned char bmp[] = { 'B', 'M', 0, 0 };
+
+    wxImageHandler* const pngHandler = wxImage::FindHandler(wxBITMAP_TYPE_PNG);
+    wxImageHandler* const bmpHandler = wxImage::FindHandler(wxBITMAP_TYPE_BMP);
+
+    CHECK( pngHandler->CanReadHeader(png, sizeof(png)) );
+    CHECK_FALSE( pngHandler->CanReadHeader(png, 3) );
+    CHECK_FALSE( pngHandler->CanReadHeader(bmp, sizeof(bmp)) );
+
+    CHECK( bmpHandler->CanReadHeader(bmp, sizeof(bmp)) );
+    CHECK_FALSE( bmpHandler->CanReadHeader(png, sizeof(png)) );
+
+    // Check that the result is the same as when reading from the stream.
+    for ( const auto& file : g_testfiles )
+    {
+        wxImageHandler* const handler = wxImage::FindHandler(file.type);
+        if ( !handler || !handler->GetHeaderSize() )
+            continue;
+
+        INFO("Checking " << file.file);
+
+        wxFileInputStream stream(file.file);
+        unsigned char header[64];
+        REQUIRE( handler->GetHeaderSize() <= sizeof(header) );
+        stream.Read(header, sizeof(header));
+        CHECK( handler->CanReadHeader(header, stream.LastRead()) );
+    }
+}
+
+namespace
+{
+
+// PNG handler refusing all images, used to check that DoCanRead() overridden
+// in a class deriving from a standard handler is still called.
+class RejectingPNGHandler : public wxPNGHandler
+{
+public:
+    RejectingPNGHandler()
+    {
+        SetName("Rejecting PNG");
+    }
+
+    int numCalls = 0;
+
+protected:
+    virtual bool DoCanRead(wxInputStream& WXUNUSED(stream)) override
+    {
+        numCalls++;
+        return false;
+    }
+};
+
+// PNG handler needing more data than the header to recognize the images.
+class LongHeaderPNGHandler : public wxPNGHandler
+{
+public:
+    LongHeaderPNGHandler()
+    {
+        SetName("Long header PNG");
+    }
+
+    int numChecked = 0;
+
+protected:
+    virtual bool DoCanRead(wxInputStream& stream) override
+    {
+        unsigned char buf[64];
+        if ( !stream.ReadAll(buf, sizeof(buf)) )
+            return false;
+
+        numChecked++;
+        return memcmp(buf + 1, "PNG", 3) == 0;
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::DoCanReadOverride", "[image]")
+{
+    RejectingPNGHandler* const handler = new RejectingPNGHandler;
+    wxImage::InsertHandler(handler);
+
+    // The image is still loaded by the standard PNG handler, but only after
+    // asking the custom one first.
+    wxImage image;
+    CHECK( image.LoadFile("horse.png") );
+    CHECK( handler->numCalls == 1 );
+
+    CHECK( wxImage::CanRead("horse.png") );
+    CHECK( handler->numCalls == 2 );
+
+    REQUIRE( wxImage::RemoveHandler("Rejecting PNG") );
+
+    // If DoCanRead() needs more than the header, it must get the stream.
+    LongHeaderPNGHandler* const longHandler = new LongHeaderPNGHandler;
+    wxImage::InsertHandler(longHandler);
+
+    CHECK( wxImage::CanRead("horse.png") );
+    CHECK( longHandler->numChecked == 1 );
+
+    REQUIRE( wxImage::RemoveHandler("Long header PNG") );
+}
+
 TEST_CASE_METHOD(ImageHandlersInit, "wxImage::SizeImage", "[image]")
 {
    // Test the wxImage::Size() function which takes a rectangle from source and
@@ -1581,6 +1774,134 @@ TEST_CASE_METHOD(ImageHandlersInit, "wxImage::ScaleCompare", "[image]")
                                "image/cross_nearest_neighb_256x256.png");
 }
 
+TEST_CASE("wxImage::ScaleLanczos", "[image]")
+{
+    // Areas of uniform colour must remain unchanged.
+    wxImage image(37, 23);
+    image.SetRGB(wxRect(0, 0, 37, 23), 200, 10, 77);
+
+    wxImage scaled = image.Scale(100, 50, wxIMAGE_QUALITY_LANCZOS);
+    REQUIRE( scaled.GetSize() == wxSize(100, 50) );
+    CHECK( !scaled.HasAlpha() );
+    CHECK( scaled.GetRed(0, 0) == 200 );
+    CHECK( scaled.GetGreen(50, 25) == 10 );
+    CHECK( scaled.GetBlue(99, 49) == 77 );
+
+    scaled = image.Scale(10, 7, wxIMAGE_QUALITY_LANCZOS);
+    REQUIRE( scaled.GetSize() == wxSize(10, 7) );
+    CHECK( scaled.GetRed(9, 6) == 200 );
+
+    // The colour of the transparent pixels must not affect the result.
+    image.InitAlpha();
+    for ( int y = 0; y < 23; y++ )
+    {
+        for ( int x = 0; x < 37; x++ )
+        {
+            if ( (x + y) % 2 )
+            {
+                image.SetRGB(x, y, 0, 0, 0);
+                image.SetAlpha(x, y, wxALPHA_TRANSPARENT);
+            }
+        }
+    }
+
+    scaled = image.Scale(12, 8, wxIMAGE_QUALITY_LANCZOS);
+    REQUIRE( scaled.HasAlpha() );
+    CHECK( scaled.GetRed(5, 4) == 200 );
+    CHECK( scaled.GetGreen(5, 4) == 10 );
+    CHECK( scaled.GetBlue(5, 4) == 77 );
+    CHECK( abs(scaled.GetAlpha(5, 4) - 128) <= 1 );
+
+    // Sharp edges must remain sharp when enlarging the image.
+    wxImage edge(16, 1);
+    edge.SetRGB(wxRect(8, 0, 8, 1), 255, 255, 255);
+    scaled = edge.Scale(64, 1, wxIMAGE_QUALITY_LANCZOS);
+    CHECK( scaled.GetRed(0, 0) == 0 );
+    CHECK( scaled.GetRed(29, 0) == 0 );
+    CHECK( scaled.GetRed(31, 0) < scaled.GetRed(32, 0) );
+    CHECK( scaled.GetRed(34, 0) == 255 );
+    CHECK( scaled.GetRed(63, 0) == 255 );
+}
+
+// Return true if both images are exactly the same, including alpha.
+static bool AreImagesIdentical(const wxImage& image1, const wxImage& image2)
+{
+    const int w = image1.GetWidth(),
+              h = image1.GetHeight();
+    if ( image2.GetWidth() != w || image2.GetHeight() != h )
+        return false;
+
+    if ( memcmp(image1.GetData(), image2.GetData(), w*h*3) != 0 )
+        return false;
+
+    if ( image1.HasAlpha() != image2.HasAlpha() )
+        return false;
+
+    return !image1.HasAlpha() ||
+                memcmp(image1.GetAlpha(), image2.GetAlpha(), w*h) == 0;
+}
+
+#if wxUSE_THREADS
+
+TEST_CASE("wxImage::Threads", "[image][thread]")
+{
+    // Create an image big enough for the threads to be used even when
+    // shrinking it: the result must have more pixels than the minimum used
+    // by a single thread, which is currently 65536.
+    const int w = 2000,
+              h = 1500;
+    wxImage image(w, h);
+    image.InitAlpha();
+    for ( int y = 0; y < h; y++ )
+    {
+        for ( int x = 0; x < w; x++ )
+        {
+            image.SetRGB(x, y, x*y, x + y, x ^ y);
+            image.SetAlpha(x, y, (x*7 + y*3) & 0xff);
+        }
+    }
+
+    const wxImageResizeQuality qualities[] =
+    {
+        wxIMAGE_QUALITY_NORMAL,
+        wxIMAGE_QUALITY_BOX_AVERAGE,
+        wxIMAGE_QUALITY_BILINEAR,
+        wxIMAGE_QUALITY_BICUBIC,
+        wxIMAGE_QUALITY_LANCZOS,
+    };
+
+    // Use a smaller part of it for enlarging to keep the test fast.
+    const int ws = 400,
+              hs = 300;
+    const wxImage small = image.GetSubImage(wxRect(0, 0, ws, hs));
+
+    const int maxThreadsOrig = wxImage::GetMaxThreads();
+    CHECK( maxThreadsOrig == 1 );
+
+    for ( size_t n = 0; n < WXSIZEOF(qualities); n++ )
+    {
+        INFO("Quality " << qualities[n]);
+
+        wxImage::SetMaxThreads(1);
+        const wxImage shrunk1 = image.Scale(w/3, h/3, qualities[n]);
+        const wxImage enlarged1 = small.Scale(ws*2, hs*2, qualities[n]);
+
+        wxImage::SetMaxThreads(4);
+        CHECK( AreImagesIdentical(image.Scale(w/3, h/3, qualities[n]), shrunk1) );
+        CHECK( AreImagesIdentical(small.Scale(ws*2, hs*2, qualities[n]), enlarged1) );
+    }
+
+    wxImage::SetMaxThreads(1);
+    const wxImage blurred1 = image.Blur(5);
+
+    wxImage::SetMaxThreads(0);
+    CHECK( AreImagesIdentical(image.Blur(5), blurred1) );
+
+    wxImage::SetMaxThreads(maxThreadsOrig);
+}
+
+#endif // wxUSE_THREADS
+
 TEST_CASE_METHOD(ImageHandlersInit, "wxImage::CreateBitmapFromCursor", "[image]")
 {
 #if !defined __WXOSX_IPHONE__ && !defined __WXDFB__ && !defined __WXX11__
@@ -2463,6 +2784,171 @@ TEST_CASE_METHOD(ImageHandlersInit, "wxImage::ChangeColours", "[image]")
     CHECK_THAT(test, RGBSimilarToFile("image/toucan_mono_255_255_255.png"));
 }
 
+TEST_CASE("wxImage::PixelOps", "[image]")
+{
+    // Use an odd size to check that the pixels not handled by the vectorized
+    // code are processed correctly too and few colours to have many pixels
+    // matching them.
+    const int w = 67,
+              h = 29;
+    wxImage image(w, h);
+    image.InitAlpha();
+    for ( int y = 0; y < h; y++ )
+    {
+        for ( int x = 0; x < w; x++ )
+        {
+            image.SetRGB(x, y, (x % 3)*0x40, (y % 2)*0x80, ((x + y) % 5)*0x30);
+            image.SetAlpha(x, y, (x*17 + y*31) & 0xff);
+        }
+    }
+
+    // Apply the given function to all pixels of the image in the simplest
+    // possible way to compute the expected result.
+    const auto forEachPixel = [](wxImage& img,
+                                 const std::function<void (unsigned char*)>& func)
+    {
+        unsigned char* p = img.GetData();
+        for ( int n = 0; n < img.GetWidth()*img.GetHeight(); n++, p += 3 )
+            func(p);
+    };
+
+    SECTION("Replace")
+    {
+        wxImage expected = image.Copy();
+        forEachPixel(expected, [](unsigned char* p)
+        {
+            if ( p[0] == 0x40 && p[1] == 0x80 && p[2] == 0x60 )
+            {
+                p[0] = 1;
+                p[1] = 2;
+                p[2] = 3;
+            }
+        });
+
+        wxImage test = image.Copy();
+        test.Replace(0x40, 0x80, 0x60, 1, 2, 3);
+        CHECK( AreImagesIdentical(test, expected) );
+    }
+
+    SECTION("ConvertAlphaToMask")
+    {
+        wxImage expected = image.Copy();
+        const unsigned char* alpha = image.GetAlpha();
+        forEachPixel(expected, [&alpha](unsigned char* p)
+        {
+            if ( *alpha++ < 100 )
+            {
+                p[0] = 4;
+                p[1] = 5;
+                p[2] = 6;
+            }
+        });
+        expected.ClearAlpha();
+
+        wxImage test = image.Copy();
+        REQUIRE( test.ConvertAlphaToMask(4, 5, 6, 100) );
+        CHECK( test.HasMask() );
+        CHECK( AreImagesIdentical(test, expected) );
+    }
+
+    SECTION("ConvertToGreyscale")
+    {
+        wxImage expected = image.Copy();
+        forEachPixel(expected, [](unsigned char* p)
+        {
+            wxColour::MakeGrey(p, p + 1, p + 2, 0.299, 0.587, 0.114);
+        });
+        CHECK( AreImagesIdentical(image.ConvertToGreyscale(), expected) );
+
+        // Weights outside of the usual range are handled differently.
+        expected = image.Copy();
+        forEachPixel(expected, [](unsigned char* p)
+        {
+            wxColour::MakeGrey(p, p + 1, p + 2, 1.5, -0.5, 0.25);
+        });
+        CHECK( AreImagesIdentical(image.ConvertToGreyscale(1.5, -0.5, 0.25),
+                                  expected) );
+
+        // Pixels of the mask colour must be left unchanged.
+        wxImage masked = image.Copy();
+        masked.SetMaskColour(0x40, 0x80, 0x60);
+
+        expected = masked.Copy();
+        forEachPixel(expected, [](unsigned char* p)
+        {
+            if ( p[0] != 0x40 || p[1] != 0x80 || p[2] != 0x60 )
+                wxColour::MakeGrey(p, p + 1, p + 2, 0.299, 0.587, 0.114);
+        });
+        CHECK( AreImagesIdentical(masked.ConvertToGreyscale(), expected) );
+    }
+
+    SECTION("HSV")
+    {
+        // The image must be big enough for the results for the same colour
+        // to be reused, so make it larger.
+        image.Rescale(w*4, h*4);
+
+        wxImage expected = image.Copy();
+        forEachPixel(expected, [](unsigned char* p)
+        {
+            wxImage::HSVValue hsv = wxImage::RGBtoHSV(wxImage::RGBValue(p[0], p[1], p[2]));
+            hsv.hue += 0.25;
+            if ( hsv.hue > 1.0 )
+                hsv.hue -= 1.0;
+
+            const wxImage::RGBValue rgb = wxImage::HSVtoRGB(hsv);
+            p[0] = rgb.red;
+            p[1] = rgb.green;
+            p[2] = rgb.blue;
+        });
+
+        wxImage test = image.Copy();
+        test.RotateHue(0.25);
+        CHECK( AreImagesIdentical(test, expected) );
+    }
+
+    SECTION("HSVManyColours")
+    {
+        // Use an image with so many different colours that the cache of the
+        // results is not used for most of it.
+        wxImage noise(256, 256);
+        unsigned char* data = noise.GetData();
+        wxUint32 seed = 1;
+        for ( int n = 0; n < 256*256*3; n++ )
+        {
+            seed = seed*1103515245 + 12345;
+            *data++ = static_cast<unsigned char>(seed >> 16);
+        }
+
+        wxImage expected = noise.Copy();
+        forEachPixel(expected, [](unsigned char* p)
+        {
+            wxImage::HSVValue hsv = wxImage::RGBtoHSV(wxImage::RGBValue(p[0], p[1], p[2]));
+            hsv.hue += 0.538;
+            if ( hsv.hue > 1.0 )
+                hsv.hue -= 1.0;
+
+            wxImage::RGBValue rgb = wxImage::HSVtoRGB(hsv);
+
+            hsv = wxImage::RGBtoHSV(rgb);
+            hsv.saturation -= hsv.saturation * 0.41;
+            rgb = wxImage::HSVtoRGB(hsv);
+
+            hsv = wxImage::RGBtoHSV(rgb);
+            hsv.value -= hsv.value * 0.259;
+            rgb = wxImage::HSVtoRGB(hsv);
+
+            p[0] = rgb.red;
+            p[1] = rgb.green;
+            p[2] = rgb.blue;
+        });
+
+        wxImage test = noise.Copy();
+        test.ChangeHSV(0.538, -0.41, -0.259);
+        CHECK( AreImagesIdentical(test, expected) );
+    }
+}
+
 TEST_CASE("wxImage::Clear", "[image]")
 {
     wxImage image(2, 2);
@@ -2503,6 +2989,185 @@ TEST_CASE("wxImage::SizeLimits", "[image]")
 #endif // SIZEOF_VOID_P == 8
 }
 
+namespace
+{
+
+// Row sink storing the rows in an image and checking that they're passed to it
+// in order.
+class TestRowSink : public wxImageRowSink
+{
+public:
+    TestRowSink() = default;
+
+    virtual bool Start(int width, int height, bool hasAlpha) override
+    {
+        m_image.Create(width, height, false);
+        if ( hasAlpha )
+            m_image.SetAlpha();
+
+        return true;
+    }
+
+    virtual bool ProcessRow(int y,
+                            const unsigned char* data,
+                            const unsigned char* alpha) override
+    {
+        CHECK( y == m_nextRow );
+        m_nextRow++;
+
+        const int width = m_image.GetWidth();
+        memcpy(m_image.GetData() + 3*width*y, data, 3*width);
+        if ( alpha )
+            memcpy(m_image.GetAlpha() + width*y, alpha, width);
+
+        return m_nextRow != m_stopAtRow;
+    }
+
+    const wxImage& GetImage() const { return m_image; }
+    int GetRowCount() const { return m_nextRow; }
+
+    void StopAtRow(int row) { m_stopAtRow = row; }
+
+private:
+    wxImage m_image;
+    int m_nextRow = 0;
+    int m_stopAtRow = -1;
+};
+
+} // anonymous namespace
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadRows", "[image]")
+{
+    for ( const auto& file : g_testfiles )
+    {
+        wxImageHandler* const handler = wxImage::FindHandler(file.type);
+        if ( !handler )
+            continue;
+
+        INFO("Loading " << file.file);
+
+        wxImage image(file.file, file.type);
+        REQUIRE( image.IsOk() );
+
+        // Check loading the image at full size.
+        {
+            wxFileInputStream stream(file.file);
+            TestRowSink sink;
+            REQUIRE( handler->LoadRows(sink, stream) );
+            CHECK( sink.GetRowCount() == image.GetHeight() );
+            CHECK_THAT( sink.GetImage(), RGBSameAs(image) );
+        }
+
+        // Check loading the reduced image.
+        {
+            wxFileInputStream stream(file.file);
+            TestRowSink sink;
+            REQUIRE( handler->LoadRows(sink, stream, 2) );
+            CHECK( sink.GetRowCount() == image.GetHeight() / 2 );
+
+            const wxImage& reduced = sink.GetImage();
+            CHECK( reduced.GetWidth() == image.GetWidth() / 2 );
+            CHECK( reduced.GetHeight() == image.GetHeight() / 2 );
+
+            // JPEG handler uses DCT scaling which doesn't give exactly the
+            // same results as averaging the pixels and the images with alpha
+            // are averaged using alpha as weight, so only check the others.
+            if ( file.type != wxBITMAP_TYPE_JPEG && !image.HasAlpha() )
+            {
+                wxImage expected(reduced.GetWidth(), reduced.GetHeight());
+                const unsigned char* const src = image.GetData();
+                unsigned char* dst = expected.GetData();
+                const int w = image.GetWidth();
+                for ( int y = 0; y < expected.GetHeight(); y++ )
+                {
+                    for ( int x = 0; x < expected.GetWidth(); x++ )
+                    {
+                        for ( int c = 0; c < 3; c++ )
+                        {
+                            const unsigned char* p = src + 3*(2*y*w + 2*x) + c;
+                            *dst++ = (p[0] + p[3] + p[3*w] + p[3*w + 3] + 2) / 4;
+                        }
+                    }
+                }
+
+                CHECK_THAT( reduced, RGBSameAs(expected) );
+            }
+        }
+
+        // Check that loading can be stopped by the sink.
+        {
+            wxFileInputStream stream(file.file);
+            TestRowSink sink;
+            sink.StopAtRow(10);
+            wxLogNull noLog;
+            CHECK_FALSE( handler->LoadRows(sink, stream) );
+            CHECK( sink.GetRowCount() == 10 );
+        }
+    }
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadMaxSize", "[image]")
+{
+    const wxBitmapType types[] =
+    {
+        wxBITMAP_TYPE_PNG,
+        wxBITMAP_TYPE_JPEG,
+        wxBITMAP_TYPE_TIFF,
+    };
+
+    for ( const auto& file : g_testfiles )
+    {
+        if ( std::find(std::begin(types), std::end(types), file.type)
+                == std::end(types) )
+            continue;
+
+        INFO("Loading " << file.file);
+
+        wxImage image;
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 64);
+        REQUIRE( image.LoadFile(file.file, file.type) );
+        CHECK( image.GetWidth() == 50 );
+        CHECK( image.GetHeight() == 50 );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == 200 );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT) == 200 );
+    }
+
+    // PNG images with alpha channel only have alpha after loading if they
+    // are not fully opaque, whether they are reduced or not.
+    wxImage rgba(40, 40);
+    rgba.SetRGB(wxRect(0, 0, 40, 40), 0x12, 0x34, 0x56);
+    rgba.SetAlpha();
+    memset(rgba.GetAlpha(), 0xff, 40*40);
+
+    for ( int opaque = 1; opaque >= 0; opaque-- )
+    {
+        INFO("Opaque: " << opaque);
+
+        if ( !opaque )
+            rgba.SetAlpha(0, 0, 0x80);
+
+        wxMemoryOutputStream memOut;
+        REQUIRE( rgba.SaveFile(memOut, wxBITMAP_TYPE_PNG) );
+
+        wxImage full;
+        {
+            wxMemoryInputStream memIn(memOut);
+            REQUIRE( full.LoadFile(memIn, wxBITMAP_TYPE_PNG) );
+        }
+        CHECK( full.HasAlpha() == !opaque );
+
+        wxImage reduced;
+        reduced.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 10);
+        {
+            wxMemoryInputStream memIn(memOut);
+            REQUIRE( reduced.LoadFile(memIn, wxBITMAP_TYPE_PNG) );
+        }
+        CHECK( reduced.GetWidth() == 10 );
+        CHECK( reduced.HasAlpha() == full.HasAlpha() );
+        CHECK( reduced.GetRed(5, 5) == 0x12 );
+    }
+}
+
 // This can be used to test loading an arbitrary image file by setting the
 // environment variable WX_TEST_IMAGE_PATH to point to it.
 TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadPath", "[.]")
@@ -2614,6 +3279,8 @@ TEST_CASE_METHOD(ImageHandlersInit, "wxImage::ResizeQuality", "[.]")
                 initial.Scale(targetSize, wxIMAGE_QUALITY_BILINEAR)));
     wxFprintf(stderr, "  Bicubic:  %f\n", ComputeImageDiff(rendered,
                 initial.Scale(targetSize, wxIMAGE_QUALITY_BICUBIC)));
+    wxFprintf(stderr, "  Lanczos:  %f\n", ComputeImageDiff(rendered,
+                initial.Scale(targetSize, wxIMAGE_QUALITY_LANCZOS)));
 }
 
 #endif // wxHAS_SVG
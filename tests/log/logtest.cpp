@@ -20,6 +20,8 @@
 
 #include "wx/scopeguard.h"
 
+#include <thread>
+
 #if wxUSE_LOG
 
 #ifdef __WINDOWS__
@@ -101,6 +103,34 @@ TEST_CASE_METHOD(LogTestCase, "wxLog::Component", "[log]")
     #define wxLOG_COMPONENT "test"
 }
 
+TEST_CASE_METHOD(LogTestCase, "wxLog::ComponentAboveGlobal", "[log]")
+{
+    const wxLogLevel levelOld = wxLog::GetLogLevel();
+    wxON_BLOCK_EXIT1( wxLog::SetLogLevel, levelOld );
+
+    // only log errors by default but everything for one component
+    wxLog::SetLogLevel(wxLOG_Error);
+    wxLog::SetComponentLevel("test/verbose", wxLOG_Max);
+
+    wxLogMessage("Message");
+    CHECK( m_log->GetLog(wxLOG_Message) == "" );
+
+    CHECK( wxLog::IsLevelEnabled(wxLOG_Message, "test/verbose") );
+    CHECK( wxLog::IsLevelEnabled(wxLOG_Message, "test/verbose/sub") );
+    CHECK( !wxLog::IsLevelEnabled(wxLOG_Message, "test") );
+    CHECK( !wxLog::IsLevelEnabled(wxLOG_Message, "") );
+    CHECK( wxLog::IsLevelEnabled(wxLOG_Error, "test") );
+
+    #undef wxLOG_COMPONENT
+    #define wxLOG_COMPONENT "test/verbose"
+
+    wxLogMessage("Message");
+    CHECK( m_log->GetLog(wxLOG_Message) == "Message" );
+
+    #undef wxLOG_COMPONENT
+    #define wxLOG_COMPONENT "test"
+}
+
 #if wxDEBUG_LEVEL
 
 namespace
@@ -142,6 +172,59 @@ TEST_CASE_METHOD(LogTestCase, "wxLog::Trace", "[log]")
 
 #endif // wxDEBUG_LEVEL
 
+#if wxUSE_THREADS
+
+TEST_CASE("wxLogAsync", "[log]")
+{
+    // this target is only used from the wxLogAsync thread
+    class CollectingLog : public wxLog
+    {
+    public:
+        wxVector<wxString> m_messages;
+
+    protected:
+        virtual void DoLogRecord(wxLogLevel WXUNUSED(level),
+                                 const wxString& msg,
+                                 const wxLogRecordInfo& WXUNUSED(info)) override
+        {
+            m_messages.push_back(msg);
+        }
+    };
+
+    CollectingLog* const target = new CollectingLog;
+
+    // use a tiny queue to check that logging waits for the space in it
+    wxLogAsync* const logAsync = new wxLogAsync(target, 4);
+    CHECK( logAsync->GetTarget() == target );
+
+    wxLog* const logOld = wxLog::SetActiveTarget(logAsync);
+    wxON_BLOCK_EXIT1( wxLog::SetActiveTarget, logOld );
+
+    for ( int n = 0; n < 100; n++ )
+        wxLogMessage("Message %d", n);
+
+    // messages from the other threads are passed to the target directly
+    // instead of waiting for the main thread to flush them
+    std::thread thread([]()
+    {
+        for ( int n = 0; n < 100; n++ )
+            wxLogMessage("Thread message %d", n);
+    });
+    thread.join();
+
+    logAsync->Drain();
+
+    REQUIRE( target->m_messages.size() == 200 );
+    CHECK( target->m_messages[0] == "Message 0" );
+    CHECK( target->m_messages[99] == "Message 99" );
+    CHECK( target->m_messages[199] == "Thread message 99" );
+
+    wxLog::SetActiveTarget(logOld);
+    delete logAsync;
+}
+
+#endif // wxUSE_THREADS
+
 TEST_CASE_METHOD(LogTestCase, "wxLogSysError", "[log]")
 {
     wxString s;
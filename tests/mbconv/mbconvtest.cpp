@@ -1508,3 +1508,52 @@ TEST_CASE("wxMBConv::cMB2WC", "[mbconv][mb2wc]")
     CHECK( wxConvUTF7.cMB2WC(wxCharBuffer()).length() == 0 );
     CHECK( wxConvUTF7.cMB2WC("+AKM-").length() == 1 );
 }
+
+TEST_CASE("wxMBConv::UTF8Runs", "[mbconv][utf8]")
+{
+    // Check that long runs of ASCII characters, which are converted in bulk,
+    // interleaved with the other characters are handled correctly.
+    wxString s;
+    for ( int n = 0; n < 100; n++ )
+    {
+        s += wxString(static_cast<char>('a' + n % 26), n);
+        s += wxString::FromUTF8("\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+    }
+
+    const wxScopedCharBuffer utf8 = s.utf8_str();
+    CHECK( wxString::FromUTF8(utf8) == s );
+
+    wxMBConvStrictUTF8 conv;
+
+    const wxWCharBuffer wbuf = conv.cMB2WC(utf8);
+    CHECK( wbuf.length() == s.length() );
+    CHECK( wxString(wbuf) == s );
+
+    const wxCharBuffer buf = conv.cWC2MB(s.wc_str());
+    CHECK( buf.length() == utf8.length() );
+    CHECK( memcmp(buf.data(), utf8.data(), utf8.length()) == 0 );
+
+    size_t len;
+    CHECK( conv.cMB2WC(utf8.data(), wxNO_LEN, &len).data() );
+    CHECK( len == wbuf.length() );
+    CHECK( conv.cWC2MB(wbuf.data(), wxNO_LEN, &len).data() );
+    CHECK( len == utf8.length() );
+
+    CHECK( conv.cMB2WC("").length() == 0 );
+    CHECK( conv.cWC2MB(L"").length() == 0 );
+
+    // Invalid sequence after a long ASCII run must still be detected.
+    wxCharBuffer invalid(40);
+    memset(invalid.data(), 'x', 40);
+    invalid.data()[35] = '\xff';
+    CHECK( !conv.cMB2WC(invalid).data() );
+    CHECK( conv.ToWChar(nullptr, 0, invalid.data(), 40) == wxCONV_FAILED );
+
+    // And so must be too small output buffer.
+    wchar_t out[20];
+    CHECK( conv.ToWChar(out, WXSIZEOF(out), utf8.data(), 60) == wxCONV_FAILED );
+
+    const wxString head = wxString::FromUTF8(utf8.data(), 30);
+    CHECK( conv.ToWChar(out, WXSIZEOF(out), utf8.data(), 30) == head.length() );
+    CHECK( wxString(out, head.length()) == head );
+}
@@ -19,171 +19,7 @@
 
 #include "wx/generic/private/rowheightcache.h"
 
-// ----------------------------------------------------------------------------
-// TestRowRangesAdd
-// ----------------------------------------------------------------------------
-TEST_CASE("RowHeightCacheTestCase::TestRowRangesSimple", "[dataview][heightcache]")
-{
-    RowRanges rr;
-
-    CHECK(rr.CountAll() == 0);
-
-    for (unsigned int i = 0; i <= 10; i++)
-    {
-        CHECK(rr.Has(i) == false);
-
-        rr.Add(i);
-
-        CHECK(rr.CountAll() == i+1);
-        CHECK(rr.CountTo(i) == i);
-        CHECK(rr.Has(i) == true);
-    }
-
-    CHECK(rr.GetSize() == 1); // every row is sorted in the same range, so count == 1
-    CHECK(rr.CountAll() == 11); // 11 rows collected
-    CHECK(rr.CountTo(10) == 10);
-
-    rr.Add(5); // row 5 already contained -> does nothing
-
-    CHECK(rr.GetSize() == 1); // every row is sorted in the same range, so count == 1
-    CHECK(rr.CountAll() == 11); // 11 rows collected
-    CHECK(rr.CountTo(10) == 10);
-
-    for (int i = 10; i >= 0; i--)
-    {
-        CHECK(rr.CountAll() == (unsigned)i+1);
-        CHECK(rr.CountTo((unsigned)i) == (unsigned)i);
-
-        rr.Remove(i);
-
-        CHECK(rr.CountAll() == (unsigned)i);
-        CHECK(rr.CountTo((unsigned)i) == (unsigned)i);
-    }
-
-    CHECK(rr.CountAll() == 0); // everything removed, no row range is left behind
-    for (int i = 10; i > 0; i--)
-    {
-        CHECK(rr.CountTo(i) == 0);
-    }
-    CHECK(rr.GetSize() == 0);
-}
-
-// ----------------------------------------------------------------------------
-// TestRowRangesRemove
-// ----------------------------------------------------------------------------
-TEST_CASE("RowHeightCacheTestCase::TestRowRangesGapsMod2", "[dataview][heightcache]")
-{
-    RowRanges rr;
-    for (int i = 0; i < 100; i++)
-    {
-        CHECK(rr.Has(i) == false);
-
-        if (i % 2 == 0)
-        {
-            rr.Add(i);
-        }
-    }
-    CHECK(rr.CountAll() == 50);
-    CHECK(rr.CountTo(100) == 50);
-
-    for (unsigned int i = 99; i > 0; i--)
-    {
-        if (i % 2 == 0)
-        {
-            CHECK(rr.Has(i) == true);
-            rr.Remove(i);
-            CHECK(rr.Has(i) == false);
-        }
-        else
-        {
-            CHECK(rr.Has(i) == false);
-        }
-    }
-
-    // only row 0 is in the RowRanges, so remove 1 does nothing
-    rr.Remove(1);
-
-    CHECK(rr.CountAll() == 1);
-    CHECK(rr.CountTo(0) == 0);
-    CHECK(rr.CountTo(1) == 1);
-    CHECK(rr.CountTo(100) == 1);
-    CHECK(rr.GetSize() == 1);
-
-    rr.Remove(0); // last row is beeing removed
-
-    CHECK(rr.CountAll() == 0);
-    CHECK(rr.CountTo(0) == 0);
-    CHECK(rr.CountTo(1) == 0);
-    CHECK(rr.CountTo(100) == 0);
-    CHECK(rr.GetSize() == 0);
-
-    rr.Add(10);
-    CHECK(rr.GetSize() == 1);
-    CHECK(rr.CountTo(1) == 0); // tests CountTo first break
-    rr.Add(5); // inserts a range at the beginning
-    CHECK(rr.GetSize() == 2);
-    rr.Remove(10);
-    rr.Remove(5);
-    CHECK(rr.GetSize() == 0);
-}
-
-// ----------------------------------------------------------------------------
-// TestRowRangesCleanUp1
-// ----------------------------------------------------------------------------
-TEST_CASE("RowHeightCacheTestCase::TestRowRangesCleanUp1", "[dataview][heightcache]")
-{
-    RowRanges rr;
-    for (unsigned int i = 0; i < 100; i++)
-    {
-        CHECK(rr.Has(i) == false);
-
-        if (i % 2 == 0)
-        {
-            rr.Add(i);
-        }
-    }
-    CHECK(rr.GetSize() == 50); // adding 50 rows (only even) results in 50 range objects
-    CHECK(rr.CountAll() == 50);
-    CHECK(rr.CountTo(100) == 50);
-
-    for (unsigned int i = 0; i < 100; i++)
-    {
-        if (i % 2 == 1)
-        {
-            rr.Add(i);
-        }
-    }
-
-    CHECK(rr.GetSize() == 1); // adding 50 rows (only odd) should combined to 1 range object
-    CHECK(rr.CountAll() == 100);
-    CHECK(rr.CountTo(100) == 100);
-}
-
-// ----------------------------------------------------------------------------
-// TestRowRangesCleanUp2
-// ----------------------------------------------------------------------------
-TEST_CASE("RowHeightCacheTestCase::TestRowRangesCleanUp2", "[dataview][heightcache]")
-{
-    RowRanges rr;
-    for (unsigned int i = 0; i < 10; i++)
-    {
-        rr.Add(i);
-    }
-    CHECK(rr.GetSize() == 1); // adding 10 sequent rows results in 1 range objects
-    CHECK(rr.CountAll() == 10);
-    CHECK(rr.CountTo(100) == 10);
-
-    for (unsigned int i = 12; i < 20; i++)
-    {
-        rr.Add(i);
-    }
-
-    CHECK(rr.GetSize() == 2);
-    rr.Add(11); // tests extending a range at the beginning (to the left)
-    CHECK(rr.GetSize() == 2);
-    rr.Add(10); // extends a range and reduces them
-    CHECK(rr.GetSize() == 1);
-}
+#include <vector>
 
 // ----------------------------------------------------------------------------
 // TestHeightCache
@@ -270,3 +106,231 @@ TEST_CASE("RowHeightCacheTestCase::TestHeightCache", "[dataview][heightcache]")
     CHECK(hc.GetLineAt(22180, row) == false);
     CHECK(row == 666);
 }
+
+// ----------------------------------------------------------------------------
+// TestHeightCacheRuns
+// ----------------------------------------------------------------------------
+TEST_CASE("RowHeightCacheTestCase::TestHeightCacheRuns", "[dataview][heightcache]")
+{
+    HeightCache hc;
+
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+        hc.Put(i, 22);
+    }
+    CHECK(hc.GetRunsCount() == 1); // all rows have the same height
+
+    hc.Put(500, 42);
+    CHECK(hc.GetRunsCount() == 3); // the run is split in 3 parts
+
+    int start = 0;
+    CHECK(hc.GetLineStart(1000, start) == true);
+    CHECK(start == 999*22 + 42);
+
+    hc.Put(500, 22);
+    CHECK(hc.GetRunsCount() == 1); // and merged back together
+
+    hc.Invalidate(0);
+    CHECK(hc.GetRunsCount() == 2);
+    CHECK(hc.GetFirstUnknown() == 0);
+    CHECK(hc.GetLineStart(1, start) == false);
+
+    hc.Put(0, 22);
+    CHECK(hc.GetRunsCount() == 1);
+    CHECK(hc.GetFirstUnknown() == 1000);
+}
+
+// ----------------------------------------------------------------------------
+// TestHeightCacheGaps
+// ----------------------------------------------------------------------------
+TEST_CASE("RowHeightCacheTestCase::TestHeightCacheGaps", "[dataview][heightcache]")
+{
+    HeightCache hc;
+
+    for (unsigned int i = 0; i < 10; i++)
+    {
+        hc.Put(i, 20);
+    }
+    hc.Put(20, 20);
+
+    int start = 0;
+    int height = 0;
+    unsigned int row = 666;
+
+    CHECK(hc.GetFirstUnknown() == 10);
+
+    CHECK(hc.GetLineHeight(20, height) == true);
+    CHECK(height == 20);
+    CHECK(hc.GetLineHeight(15, height) == false);
+
+    // the start of row 10 is known even if its height is not
+    CHECK(hc.GetLineStart(10, start) == true);
+    CHECK(start == 200);
+    CHECK(hc.GetLineInfo(10, start, height) == false);
+
+    // but not the start of any rows after it
+    CHECK(hc.GetLineStart(11, start) == false);
+    CHECK(hc.GetLineStart(20, start) == false);
+
+    CHECK(hc.GetLineAt(199, row) == true);
+    CHECK(row == 9);
+
+    row = 666;
+    CHECK(hc.GetLineAt(200, row) == false);
+    CHECK(row == 666);
+
+    for (unsigned int i = 10; i < 20; i++)
+    {
+        hc.Put(i, 30);
+    }
+
+    CHECK(hc.GetFirstUnknown() == 21);
+    CHECK(hc.GetLineInfo(20, start, height) == true);
+    CHECK(start == 500);
+    CHECK(height == 20);
+    CHECK(hc.GetLineAt(510, row) == true);
+    CHECK(row == 20);
+}
+
+// ----------------------------------------------------------------------------
+// TestHeightCacheInsertDelete
+// ----------------------------------------------------------------------------
+TEST_CASE("RowHeightCacheTestCase::TestHeightCacheInsertDelete", "[dataview][heightcache]")
+{
+    HeightCache hc;
+
+    int total = 0;
+    for (unsigned int i = 0; i < 100; i++)
+    {
+        hc.Put(i, 10 + 10*(i % 3));
+        total += 10 + 10*(i % 3);
+    }
+
+    int start = 0;
+    int height = 0;
+
+    hc.InsertRows(50, 5);
+
+    CHECK(hc.GetFirstUnknown() == 50);
+    CHECK(hc.GetLineHeight(50, height) == false);
+    CHECK(hc.GetLineHeight(55, height) == true);
+    CHECK(height == 10 + 10*(50 % 3)); // height of the old row 50
+
+    CHECK(hc.GetLineStart(50, start) == true);
+    const int start50 = start;
+    CHECK(hc.GetLineStart(51, start) == false);
+
+    hc.DeleteRows(50, 5);
+
+    CHECK(hc.GetFirstUnknown() == 100);
+    CHECK(hc.GetLineStart(100, start) == true);
+    CHECK(start == total);
+
+    hc.DeleteRows(0, 50);
+    CHECK(hc.GetLineStart(50, start) == true);
+    CHECK(start == total - start50);
+    CHECK(hc.GetLineHeight(0, height) == true);
+    CHECK(height == 10 + 10*(50 % 3));
+
+    hc.DeleteRows(0, 100); // deleting more rows than exist is fine
+    CHECK(hc.GetRunsCount() == 0);
+    CHECK(hc.GetFirstUnknown() == 0);
+}
+
+// ----------------------------------------------------------------------------
+// TestHeightCacheRandom
+// ----------------------------------------------------------------------------
+TEST_CASE("RowHeightCacheTestCase::TestHeightCacheRandom", "[dataview][heightcache]")
+{
+    // Compare the cache with the trivial implementation using a vector of
+    // heights with 0 meaning unknown height.
+    HeightCache hc;
+    std::vector<int> heights;
+
+    srand(1234);
+    for ( int n = 0; n < 2000; n++ )
+    {
+        const unsigned int row = rand() % 200;
+        const unsigned int count = 1 + rand() % 10;
+        switch ( rand() % 6 )
+        {
+            case 0:
+            case 1:
+                {
+                    const int h = 10*(1 + rand() % 3);
+                    hc.Put(row, h);
+                    if ( row >= heights.size() )
+                        heights.resize(row + 1);
+                    heights[row] = h;
+                }
+                break;
+
+            case 2:
+                hc.Invalidate(row);
+                if ( row < heights.size() )
+                    heights[row] = 0;
+                break;
+
+            case 3:
+                hc.InsertRows(row, count);
+                if ( row < heights.size() )
+                    heights.insert(heights.begin() + row, count, 0);
+                break;
+
+            case 4:
+                hc.DeleteRows(row, count);
+                if ( row < heights.size() )
+                {
+                    const size_t end = row + count < heights.size()
+                                        ? row + count
+                                        : heights.size();
+                    heights.erase(heights.begin() + row, heights.begin() + end);
+                }
+                break;
+
+            case 5:
+                if ( rand() % 10 == 0 )
+                {
+                    hc.Remove(row);
+                    if ( row < heights.size() )
+                        heights.resize(row);
+                }
+                break;
+        }
+
+        unsigned int firstUnknown = 0;
+        while ( firstUnknown < heights.size() && heights[firstUnknown] )
+            firstUnknown++;
+
+        // Rows after the last one for which Put() was called may or may not
+        // be stored as unknown in the cache, so don't check them.
+        REQUIRE( hc.GetFirstUnknown() >= firstUnknown );
+        if ( firstUnknown < heights.size() )
+            REQUIRE( hc.GetFirstUnknown() == firstUnknown );
+
+        int y = 0;
+        for ( unsigned int i = 0; i < heights.size(); i++ )
+        {
+            int start = -1,
+                height = -1;
+            CHECK( hc.GetLineHeight(i, height) == (heights[i] != 0) );
+            if ( heights[i] )
+                CHECK( height == heights[i] );
+
+            CHECK( hc.GetLineStart(i, start) == (i <= firstUnknown) );
+            if ( i <= firstUnknown )
+                CHECK( start == y );
+
+            if ( i < firstUnknown )
+            {
+                unsigned int row = 0;
+                CHECK( hc.GetLineAt(y, row) );
+                CHECK( row == i );
+                CHECK( hc.GetLineAt(y + heights[i] - 1, row) );
+                CHECK( row == i );
+            }
+
+            y += heights[i];
+        }
+    }
+}
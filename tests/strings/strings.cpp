@@ -1385,3 +1385,42 @@ TEST_CASE("StringSupplementaryUniChar", "[wxString]")
          find_first_of, find_last_of, find_first_not_of, find_last_not_of
     */
 }
+
+TEST_CASE("StringRepeatedConversion", "[wxString]")
+{
+    // The buffer used for the conversions is reused, check that this works
+    // correctly when the string grows and shrinks between the conversions.
+    wxString s = wxString::FromUTF8("\xd0\xa6\xd0\xb5\xd0\xbb\xd0\xbe\xd0\xb5");
+    CHECK( strcmp(s.utf8_str(), "\xd0\xa6\xd0\xb5\xd0\xbb\xd0\xbe\xd0\xb5") == 0 );
+
+    s = "abc";
+    CHECK( s.utf8_str().length() == 3 );
+    CHECK( strcmp(s.utf8_str(), "abc") == 0 );
+
+    const char* const p = s.utf8_str();
+    s[1] = 'x';
+    CHECK( s.utf8_str().data() == p );
+    CHECK( strcmp(p, "axc") == 0 );
+
+    s += wxString::FromUTF8("\xe2\x82\xac");
+    CHECK( s.utf8_str().length() == 6 );
+    CHECK( strcmp(s.utf8_str(), "axc\xe2\x82\xac") == 0 );
+
+    s.clear();
+    CHECK( s.utf8_str().length() == 0 );
+    CHECK( strcmp(s.utf8_str(), "") == 0 );
+
+    s = "Hello";
+    CHECK( strcmp(s.mb_str(wxConvISO8859_1), "Hello") == 0 );
+    CHECK( s.mb_str(wxConvISO8859_1).length() == 5 );
+
+    // Long strings are converted differently, check them too.
+    wxString euros;
+    for ( int n = 0; n < 1000; n++ )
+        euros += wxString::FromUTF8("\xe2\x82\xac");
+    CHECK( euros.utf8_str().length() == 3000 );
+    CHECK( memcmp(euros.utf8_str(), "\xe2\x82\xac\xe2\x82\xac", 6) == 0 );
+
+    euros.resize(2);
+    CHECK( strcmp(euros.utf8_str(), "\xe2\x82\xac\xe2\x82\xac") == 0 );
+}
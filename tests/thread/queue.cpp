@@ -20,6 +20,9 @@
 
 #include "wx/msgqueue.h"
 
+#include <atomic>
+#include <thread>
+
 // ----------------------------------------------------------------------------
 // thread class used in the tests
 // ----------------------------------------------------------------------------
@@ -215,3 +218,117 @@ TEST_CASE("wxMessageQueue::NonCopyable", "[msgqueue]")
 
     CHECK( queue.ReceiveTimeout(0, nc2) == wxMSGQUEUE_TIMEOUT );
 }
+
+TEST_CASE("wxBoundedMessageQueue::Post", "[msgqueue]")
+{
+    wxBoundedMessageQueue<int> queue(3);
+    CHECK( queue.GetCapacity() == 4 );
+
+    for ( int i = 0; i < 4; ++i )
+        CHECK( queue.Post(i) == wxMSGQUEUE_NO_ERROR );
+
+    CHECK( queue.Post(4) == wxMSGQUEUE_FULL );
+    CHECK( queue.PostTimeout(10, 4) == wxMSGQUEUE_FULL );
+
+    int msg = -1;
+    CHECK( queue.Receive(msg) == wxMSGQUEUE_NO_ERROR );
+    CHECK( msg == 0 );
+
+    CHECK( queue.PostTimeout(10, 4) == wxMSGQUEUE_NO_ERROR );
+
+    int msgs[8];
+    size_t count = 0;
+    CHECK( queue.ReceiveManyTimeout(0, msgs, 8, count) == wxMSGQUEUE_NO_ERROR );
+    CHECK( count == 4 );
+    CHECK( msgs[0] == 1 );
+    CHECK( msgs[3] == 4 );
+
+    CHECK( queue.ReceiveTimeout(0, msg) == wxMSGQUEUE_TIMEOUT );
+    CHECK( queue.ReceiveTimeout(10, msg) == wxMSGQUEUE_TIMEOUT );
+
+    const int posted[] = { 1, 2, 3, 4, 5 };
+    CHECK( queue.PostMany(posted, 5) == 4 );
+
+    CHECK( queue.Clear() == wxMSGQUEUE_NO_ERROR );
+    CHECK( queue.ReceiveTimeout(0, msg) == wxMSGQUEUE_TIMEOUT );
+}
+
+TEST_CASE("wxBoundedMessageQueue::NonCopyable", "[msgqueue]")
+{
+    wxBoundedMessageQueue<std::unique_ptr<int>> queue(2);
+
+    CHECK( queue.Post(std::unique_ptr<int>(new int(1))) == wxMSGQUEUE_NO_ERROR );
+    CHECK( queue.Post(std::unique_ptr<int>(new int(2))) == wxMSGQUEUE_NO_ERROR );
+
+    // the message is not moved from if it couldn't be posted
+    std::unique_ptr<int> p(new int(3));
+    CHECK( queue.Post(std::move(p)) == wxMSGQUEUE_FULL );
+    REQUIRE( p );
+    CHECK( *p == 3 );
+
+    std::unique_ptr<int> received;
+    CHECK( queue.Receive(received) == wxMSGQUEUE_NO_ERROR );
+    REQUIRE( received );
+    CHECK( *received == 1 );
+}
+
+TEST_CASE("wxBoundedMessageQueue::Threads", "[msgqueue]")
+{
+    const int numThreads = 4;
+    const int msgCount = 10000;
+
+    wxBoundedMessageQueue<int> queue(16);
+
+    // each producer posts the numbers from 1 to msgCount and each consumer
+    // stops when it gets 0
+    std::vector<std::thread> threads;
+    for ( int i = 0; i < numThreads; ++i )
+    {
+        threads.emplace_back([&queue]()
+        {
+            for ( int n = 1; n <= msgCount; ++n )
+                queue.PostTimeout(-1, n);
+        });
+    }
+
+    std::atomic<long long> sum{0};
+    for ( int i = 0; i < numThreads; ++i )
+    {
+        threads.emplace_back([&queue, &sum, i]()
+        {
+            int msgs[8];
+            for ( ;; )
+            {
+                size_t count = 1;
+                if ( i % 2 )
+                    queue.Receive(msgs[0]);
+                else
+                    queue.ReceiveMany(msgs, WXSIZEOF(msgs), count);
+
+                for ( size_t n = 0; n < count; ++n )
+                {
+                    if ( !msgs[n] )
+                    {
+                        // let the other consumers see the remaining messages
+                        for ( ++n; n < count; ++n )
+                            queue.PostTimeout(-1, msgs[n]);
+                        return;
+                    }
+
+                    sum += msgs[n];
+                }
+            }
+        });
+    }
+
+    for ( int i = 0; i < numThreads; ++i )
+        threads[i].join();
+
+    for ( int i = 0; i < numThreads; ++i )
+        queue.PostTimeout(-1, 0);
+
+    for ( int i = numThreads; i < 2*numThreads; ++i )
+        threads[i].join();
+
+    CHECK( sum == static_cast<long long>(numThreads)*msgCount*(msgCount + 1)/2 );
+}
@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/thread/threadpool.cpp
+// Purpose:     Unit tests for wxThreadPool
+// Author:      wxWidgets team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#if wxUSE_THREADS
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+#endif // WX_PRECOMP
+
+#include "wx/threadpool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// helper functions
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Compute Fibonacci numbers recursively using a separate task for each call
+// to check that waiting for the tasks from inside other tasks works.
+int Fib(wxThreadPool& pool, int n)
+{
+    if ( n < 2 )
+        return n;
+
+    wxTaskFuture<int> f = pool.Run([&pool, n]() { return Fib(pool, n - 1); });
+    const int n2 = Fib(pool, n - 2);
+
+    return f.Get() + n2;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// tests themselves
+// ----------------------------------------------------------------------------
+
+TEST_CASE("wxThreadPool::Run", "[threadpool]")
+{
+    wxThreadPool pool(4);
+    CHECK( pool.GetThreadCount() == 4 );
+
+    wxTaskFuture<int> f = pool.Run([]() { return 17; });
+    CHECK( f.IsOk() );
+    CHECK( f.Get() == 17 );
+    CHECK( f.IsReady() );
+    CHECK( !f.IsCancelled() );
+
+    std::atomic<int> count{0};
+    std::vector<wxTaskFuture<void>> futures;
+    for ( int n = 0; n < 1000; n++ )
+        futures.push_back(pool.Run([&count]() { count++; }));
+
+    for ( auto& future : futures )
+        future.Wait();
+
+    CHECK( count == 1000 );
+
+    CHECK( Fib(pool, 15) == 610 );
+
+    CHECK( !wxTaskFuture<int>().IsOk() );
+}
+
+TEST_CASE("wxThreadPool::Exceptions", "[threadpool]")
+{
+    wxThreadPool pool(2);
+
+    wxTaskFuture<int> f = pool.Run([]() -> int
+    {
+        throw std::runtime_error("task failed");
+    });
+
+    f.Wait();
+    CHECK( f.IsReady() );
+    CHECK_THROWS_AS( f.Get(), std::runtime_error );
+}
+
+TEST_CASE("wxThreadPool::Cancel", "[threadpool]")
+{
+    wxThreadPool pool(1);
+
+    // block the only worker until we tell it to continue
+    std::atomic<bool> started{false},
+                      stop{false};
+    wxTaskFuture<void> blocker = pool.Run([&]()
+    {
+        started = true;
+        while ( !stop && !wxThreadPool::TestCancel() )
+            wxMilliSleep(1);
+    });
+
+    while ( !started )
+        wxMilliSleep(1);
+
+    // this task can't start before the first one is done
+    bool ran = false;
+    wxTaskFuture<void> pending = pool.Run([&ran]() { ran = true; });
+    CHECK( pending.Cancel() );
+    CHECK( pending.IsCancelled() );
+    CHECK( pending.IsReady() );
+
+    // the running task can't be cancelled but can see the cancellation request
+    CHECK( !blocker.Cancel() );
+    blocker.Wait();
+    CHECK( !blocker.IsCancelled() );
+
+    CHECK( !ran );
+
+    // the future of a cancelled task can still be waited for
+    pending.Wait();
+    CHECK( !wxThreadPool::TestCancel() );
+}
+
+TEST_CASE("wxThreadPool::ParallelFor", "[threadpool]")
+{
+    wxThreadPool pool(4);
+
+    const int count = 10000;
+    std::vector<std::atomic<int>> hits(count);
+    for ( auto& hit : hits )
+        hit = 0;
+
+    pool.ParallelFor(0, count, [&hits](int from, int to)
+    {
+        for ( int n = from; n < to; n++ )
+            hits[n]++;
+    });
+
+    int numWrong = 0;
+    for ( auto& hit : hits )
+    {
+        if ( hit != 1 )
+            numWrong++;
+    }
+    CHECK( numWrong == 0 );
+
+    SECTION("Nested")
+    {
+        std::atomic<int> total{0};
+        pool.ParallelFor(0, 10, [&](int from, int to)
+        {
+            for ( int n = from; n < to; n++ )
+            {
+                pool.ParallelFor(0, 100, [&total](int from2, int to2)
+                {
+                    total += to2 - from2;
+                });
+            }
+        });
+
+        CHECK( total == 1000 );
+    }
+
+    SECTION("SingleChunk")
+    {
+        int numCalls = 0;
+        pool.ParallelFor(5, 15, [&numCalls](int from, int to)
+        {
+            CHECK( from == 5 );
+            CHECK( to == 15 );
+            numCalls++;
+        }, 1);
+
+        CHECK( numCalls == 1 );
+    }
+
+    SECTION("Empty")
+    {
+        bool called = false;
+        pool.ParallelFor(3, 3, [&called](int, int) { called = true; });
+        CHECK( !called );
+    }
+
+    SECTION("NoCancel")
+    {
+        // the helpers still running when the calling thread is done with its
+        // chunks must not see a cancellation request
+        std::atomic<int> numCancelled{0};
+        pool.ParallelFor(0, 8, [&numCancelled](int, int)
+        {
+            wxMilliSleep(wxThread::IsMain() ? 1 : 50);
+
+            if ( wxThreadPool::TestCancel() )
+                numCancelled++;
+        });
+
+        CHECK( numCancelled == 0 );
+    }
+
+    SECTION("Exception")
+    {
+        CHECK_THROWS_AS
+        (
+            pool.ParallelFor(0, 100, [](int from, int to)
+            {
+                if ( from <= 50 && 50 < to )
+                    throw std::runtime_error("chunk failed");
+            }),
+            std::runtime_error
+        );
+    }
+}
+
+TEST_CASE("wxThreadPool::CallAfter", "[threadpool]")
+{
+    if ( !wxTheApp )
+        return;
+
+    wxThreadPool pool(2);
+
+    int result = 0;
+    wxTaskFuture<int> f = pool.Run([]() { return 42; });
+    f.CallAfter([&result](const wxTaskFuture<int>& done)
+    {
+        CHECK( wxThread::IsMain() );
+        result = done.Get();
+    });
+
+    // the continuation is called from the event loop, so process the events
+    // until it is executed
+    f.Wait();
+    for ( int n = 0; n < 1000 && !result; n++ )
+    {
+        wxTheApp->ProcessPendingEvents();
+        if ( !result )
+            wxMilliSleep(1);
+    }
+
+    CHECK( result == 42 );
+}
+
+TEST_CASE("wxThreadPool::Get", "[threadpool]")
+{
+    wxThreadPool& pool = wxThreadPool::Get();
+    CHECK( &pool == &wxThreadPool::Get() );
+    CHECK( pool.GetThreadCount() > 0 );
+
+    CHECK( pool.Run([]() { return 1; }).Get() == 1 );
+}
+
+#endif // wxUSE_THREADS